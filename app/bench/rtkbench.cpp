@@ -0,0 +1,977 @@
+/*------------------------------------------------------------------------------
+* rtkbench.cpp : micro-benchmarks of rtklib functions
+*
+* build  : compile with the sources of rnx2rtkp except app/main/rnx2rtkp.cpp
+*          and the same options, e.g.
+*          g++ -O2 -I src -I src/Nequick/lib/private -I src/Nequick/lib/public
+*              -DENAGLO -DENACMP -DENAGAL -DNFREQ=6 -DTRACE -o rtkbench
+*              app/bench/rtkbench.cpp src/(sources) -lpthread
+*
+*          -nequick uses the built-in modip/ccir tables (with
+*          -DFTR_MODIP_CCIR_FROM_FILES, NQfile beside the executable)
+*
+* version : $Revision: 1.4 $ $Date: 2025/07/26 $
+* history : 2025/07/05  1.0 new (str2num)
+*           2025/07/09  1.1 add -bdgim
+*           2025/07/16  1.2 add -nequick
+*           2025/07/20  1.3 add -iono, -obs, -tec, -j
+*           2025/07/26  1.4 add -eph
+*-----------------------------------------------------------------------------*/
+#include <stdarg.h>
+#include "rtklib.h"
+#include "bdgim.h"
+#include "common.h"
+
+#define PROGNAME    "rtkbench"          /* program name */
+#define NFIELD      1000000             /* number of fields per benchmark */
+#define NEPOCH      2880                /* number of epochs of bdgim benchmark */
+#define NQ_NSTA     16                  /* stations of synthetic nequick vectors */
+#define NQ_NEPOCH   12                  /* epochs of synthetic nequick vectors */
+#define NQ_NSAT     10                  /* satellites of synthetic nequick vectors */
+#define NQ_NREP     3                   /* repeats of nequick timing (best one) */
+#define IO_NLAT     5                   /* latitudes of synthetic iono stations */
+#define IO_NLON     6                   /* longitudes of synthetic iono stations */
+#define IO_NEPOCH   24                  /* epochs of synthetic iono geometry */
+#define IO_TINT     300.0               /* interval of iono geometry of obs (s) */
+#define IO_TMIN     500                 /* min time of iono timing per model (ms) */
+#define MAXTHREAD   64                  /* max number of threads */
+
+/* help text -----------------------------------------------------------------*/
+static const char *help[]={
+"",
+" usage: rtkbench [option]... [file ...]",
+"",
+" Run micro-benchmarks and check that the results are same as the reference",
+" implementations. With files, time reading of them (RINEX OBS/NAV/CLK, SP3",
+" or IONEX by the file extension).",
+"",
+" -str2num   benchmark of str2num()/str2nums() by F14.3, D19.12 and I5 fields",
+"            against sscanf() of the fields [on]",
+" -bdgim     benchmark of BDGIM delays of all satellites of an epoch by one call",
+"            of ionmodel_BDSK9n() against per-satellite evaluation by ASLEFU()",
+"            over a day of 30s epochs [off]",
+" -eph      benchmark of satellite positions of all ephemerides of an epoch",
+"            (except glonass and sbas) by one call of eph2pos_batch() against",
+"            per-satellite eph2pos() over a day of 30s epochs. needs -nav [off]",
+" -nav file  broadcast ephemeris for satellite positions of -bdgim, -iono and",
+"            -eph (e.g. BRDC00IGS_R_*_MN.rnx in IGS-Data). -iono also takes the",
+"            broadcast iono parameters of it [synthetic constellation]",
+" -nequick   deviation of NeQuick-G STEC by the fast integration modes from",
+"            the reference integration and time per ray [off]",
+" -nqfile file test vectors of -nequick in the format of NeQuickJRC -j (first",
+"            line a0 a1 a2, then lines of month UT station lon lat h satellite",
+"            lon lat h STEC) [synthetic vectors of 3 solar activity levels]",
+" -iono      time per call of ionocorr() by the broadcast (brdc), BDS",
+"            klobuchar (bdsk8), BDGIM (bdssh9), IONEX (ionex) and NeQuick-G",
+"            (galion) models over the same rays and STEC differences of the",
+"            models from IONEX. the result lines of the models are fields",
+"            separated by spaces and the other lines begin with % [off]",
+" -obs file  RINEX OBS for -iono. the rays are to the satellites of the",
+"            epochs every 300s from the approx position, with -nav [rays from",
+"            stations on 30deg x 60deg global grid x 24 hourly epochs]",
+" -tec file  IONEX TEC for -iono [no ionex model and differences]",
+" -j num     number of threads of -iono [1]",
+" -n num     number of fields [1000000]",
+" -x level   debug trace level (0:off) [0]"
+};
+/* dummy functions required by rtklib ----------------------------------------*/
+extern int showmsg(const char *format, ...)
+{
+    va_list arg;
+    va_start(arg,format); vfprintf(stderr,format,arg); va_end(arg);
+    fprintf(stderr,"\r");
+    return 0;
+}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+extern void init_nav(nav_t *nav);
+extern void init_obs(obs_t *obs);
+extern int satpos(const prcopt_t *opt, gtime_t time, gtime_t teph, int sat,
+                  int ephopt, const nav_t *nav, double *rs, double *dts,
+                  double *var, int *svh);
+
+/* print help ----------------------------------------------------------------*/
+static void printhelp(void)
+{
+    int i;
+    for (i=0;i<(int)(sizeof(help)/sizeof(*help));i++) fprintf(stderr,"%s\n",help[i]);
+    exit(0);
+}
+/* reference of str2num() by sscanf() ----------------------------------------*/
+static double str2num_ref(const char *s, int i, int n)
+{
+    double value;
+    char str[256],*p=str;
+
+    if (i<0||(int)strlen(s)<i||(int)sizeof(str)-1<n) return 0.0;
+    for (s+=i;*s&&--n>=0;s++) *p++=*s=='d'||*s=='D'?'E':*s;
+    *p='\0';
+    return sscanf(str,"%lf",&value)==1?value:0.0;
+}
+/* random number in [0,1) ----------------------------------------------------*/
+static double randu(void)
+{
+    return (double)rand()/((double)RAND_MAX+1.0);
+}
+/* generate record of fixed-width fields -------------------------------------*/
+static void genfield(int type, char *buff)
+{
+    double x=(randu()-0.5)*pow(10.0,(int)(randu()*12.0)-2);
+
+    if (randu()<0.05) { /* blank field */
+        sprintf(buff,"%*s",type==0?14:(type==1?19:5),"");
+        return;
+    }
+    switch (type) {
+        case 0: sprintf(buff,"%14.3f",x); break;
+        case 1: sprintf(buff,"%19.12E",x);
+                if (randu()<0.5) *strchr(buff,'E')='D';
+                break;
+        case 2: sprintf(buff,"%5d",(int)(x/1E6)%10000); break;
+    }
+}
+/* benchmark of str2num() ----------------------------------------------------*/
+static int bench_str2num(int n)
+{
+    const char *fmt[]={"F14.3","D19.12","I5"};
+    const int w[]={14,19,5};
+    char *buff,*p;
+    double *val,*ref,sum,t[3];
+    unsigned int tick;
+    int i,type,err=0,nerr;
+
+    /* records of 16 fields terminated by null */
+    if (!(buff=(char *)malloc((n/16+1)*(16*19+1)))||
+        !(val=(double *)malloc(sizeof(double)*n))||!(ref=(double *)malloc(sizeof(double)*n))) {
+        fprintf(stderr,"memory allocation error\n");
+        return 0;
+    }
+    printf("%-7s %10s %10s %10s %10s %8s\n","field","sscanf","str2num",
+           "str2nums","speed-up","error");
+
+    for (type=0;type<3;type++) {
+        srand(type+1);
+        for (i=0,p=buff;i<n;i++) {
+            genfield(type,p); p+=w[type];
+            if (i%16==15||i==n-1) *p++='\0';
+        }
+        tick=tickget(); sum=0.0;
+        for (i=0,p=buff;i<n;i++) {
+            ref[i]=str2num_ref(p,i%16*w[type],w[type]);
+            if (i%16==15) p+=16*w[type]+1;
+        }
+        t[0]=(tickget()-tick)*1E-3;
+
+        tick=tickget();
+        for (i=0,p=buff;i<n;i++) {
+            val[i]=str2num(p,i%16*w[type],w[type]);
+            if (i%16==15) p+=16*w[type]+1;
+        }
+        t[1]=(tickget()-tick)*1E-3;
+
+        for (i=nerr=0;i<n;i++) {
+            if (memcmp(val+i,ref+i,sizeof(double))) nerr++;
+        }
+        /* block of fields as a record line */
+        tick=tickget();
+        for (i=0,p=buff;i<n;i+=16,p+=16*w[type]+1) {
+            str2nums(p,0,w[type],n-i<16?n-i:16,val+i);
+        }
+        t[2]=(tickget()-tick)*1E-3;
+
+        for (i=0;i<n;i++) {
+            if (memcmp(val+i,ref+i,sizeof(double))) nerr++;
+            sum+=val[i];
+        }
+        printf("%-7s %9.3fs %9.3fs %9.3fs %9.1fx %8d\n",fmt[type],t[0],t[1],
+               t[2],t[1]>0.0?t[0]/t[1]:0.0,nerr);
+        trace(2,"bench_str2num: type=%s sum=%.3f\n",fmt[type],sum);
+        err+=nerr;
+    }
+    free(buff); free(val); free(ref);
+    return err==0;
+}
+/* sample BDSSH9 parameters -------------------------------------------------*/
+static const double bdgim_brd[]={
+    13.82642069,-1.78004616,5.17200000,3.13030940,-4.58961329,0.32483867,
+    -0.07802383,1.24312590,0.37763627
+};
+/* reference BDGIM delay by per-coefficient ASLEFU() -------------------------*/
+static double bdgim_ref(const double nonBrdCoef[NONBRDNUM][MAXGROUP],
+                        const double *brd, double mjd, double *sta, double *sat)
+{
+    static const int brddo[BRDPARANUM][2]={
+        {0,0},{1,0},{1,1},{1,-1},{2,0},{2,1},{2,-1},{2,2},{2,-2}
+    };
+    static const int nondo[NONBRDNUM][2]={
+        {3,0},{3,1},{3,-1},{3,2},{3,-2},{3,3},{3,-3},{4,0},{4,1},{4,-1},{4,2},
+        {4,-2},{5,0},{5,1},{5,-1},{5,2},{5,-2}
+    };
+    double ipp[3],b,l,e,el,gb,gl,vtec=0.0;
+    int i,g=BrdCoefGroupIndex(mjd);
+
+    if (g<0||!IPPBLH1(sta,sat,400000.0,ipp,&b,&l,&e,&el)) return 0.0;
+    EFLSFL(mjd,&b,&l,1,1,&gb,&gl);
+    for (i=0;i<BRDPARANUM;i++) vtec+=brd[i]*ASLEFU(gb,gl,brddo[i][0],brddo[i][1]);
+    for (i=0;i<NONBRDNUM;i++) {
+        vtec+=nonBrdCoef[i][g]*ASLEFU(gb,gl,nondo[i][0],nondo[i][1]);
+    }
+    if      (brd[0]>35.0) vtec=MAX(brd[0]/10.0,vtec);
+    else if (brd[0]>20.0) vtec=MAX(brd[0]/ 8.0,vtec);
+    else if (brd[0]>12.0) vtec=MAX(brd[0]/ 6.0,vtec);
+    else                  vtec=MAX(brd[0]/ 4.0,vtec);
+    vtec*=IonMapping(2,e,el,400000.0)*40.3E16/(FREQ1_BDS*FREQ1_BDS);
+    vtec*=FREQ1*FREQ1/FREQ1_CMP/FREQ1_CMP;
+    return vtec<0.0?0.0:vtec;
+}
+/* satellite positions of visible satellites ---------------------------------*/
+static int bdgim_sats(gtime_t time, const nav_t *nav, const double *sta,
+                      double *rs, int *sats)
+{
+    double r[6],dts[2],var,pos[3],e[3],azel[2],u,o,inc=55.0*D2R;
+    int i,n=0,svh;
+
+    ecef2pos(sta,pos);
+    for (i=0;i<MAXSAT&&n<MAXOBS;i++) {
+        if (nav) {
+            if (!satpos(&prcopt_default,time,time,i+1,EPHOPT_BRDC,nav,r,dts,&var,
+                        &svh)) continue;
+        }
+        else { /* 6 planes x 5 satellites on circular orbits */
+            if (i>=30) break;
+            u=2.0*PI*(time.time%43082)/43082.0+2.0*PI*(i%5)/5.0+0.3*(i/5);
+            o=2.0*PI*(i/5)/6.0;
+            r[0]=26560E3*(cos(u)*cos(o)-sin(u)*cos(inc)*sin(o));
+            r[1]=26560E3*(cos(u)*sin(o)+sin(u)*cos(inc)*cos(o));
+            r[2]=26560E3*sin(u)*sin(inc);
+        }
+        if (geodist(SYS_CMP,r,sta,e,&var)<=0.0||satazel(pos,e,azel)<10.0*D2R) continue;
+        matcpy(rs+n*6,r,3,1);
+        if (sats) sats[n]=i+1;
+        n++;
+    }
+    return n;
+}
+/* benchmark of BDGIM --------------------------------------------------------*/
+static int bench_bdgim(const char *navfile)
+{
+    static nav_t nav; /* too large for stack */
+    const double ep0[]={2025,5,1,0,0,0};
+    const double *brd=bdgim_brd;
+    const double sta[]={-2267750.0,5009154.0,3221290.0}; /* WUH2 */
+    double (*rs)[MAXOBS*6],*ion,*ref,pos[3],ep[6],sta_xyz[3],t[2],err=0.0;
+    double nonBrdCoef[NONBRDNUM][MAXGROUP];
+    gtime_t time;
+    MjdData mjd;
+    unsigned int tick;
+    int i,j,*ns,nsat=0,day=0;
+
+    init_nav(&nav);
+    if (*navfile&&readrnx(navfile,0,"",NULL,&nav,NULL)<=0) {
+        fprintf(stderr,"nav file read error: %s\n",navfile);
+        return 0;
+    }
+    if (!(rs=(double (*)[MAXOBS*6])malloc(sizeof(*rs)*NEPOCH))||
+        !(ns=(int *)malloc(sizeof(int)*NEPOCH))||
+        !(ion=(double *)malloc(sizeof(double)*MAXOBS*NEPOCH))||
+        !(ref=(double *)malloc(sizeof(double)*MAXOBS*NEPOCH))) {
+        fprintf(stderr,"memory allocation error\n");
+        return 0;
+    }
+    nav.ion_bdsk9->BrdIonCoefNum=9;
+    nav.ion_bdsk9->BrdIonCoefGroup=1;
+    for (i=0;i<9;i++) nav.ion_bdsk9->BrdIonCoef[i][0]=brd[i];
+    initbdgim(nav.ion_bdsk9);
+
+    /* day of the first ephemeris if read */
+    time=epoch2time(ep0);
+    if (nav.n>0) {
+        time2epoch(nav.eph[0].toe,ep);
+        ep[3]=ep[4]=ep[5]=0.0;
+        time=epoch2time(ep);
+    }
+    ecef2pos(sta,pos);
+    for (i=0;i<NEPOCH;i++) {
+        ns[i]=bdgim_sats(timeadd(time,30.0*i),*navfile?&nav:NULL,sta,rs[i],
+                         NULL);
+        nsat+=ns[i];
+    }
+    /* per-satellite evaluation by ASLEFU() */
+    tick=tickget();
+    for (i=0;i<NEPOCH;i++) {
+        time2epoch(gpst2bdt(timeadd(time,30.0*i)),ep);
+        UTC2MJD((int)ep[0],(int)ep[1],(int)ep[2],(int)ep[3],(int)ep[4],ep[5],&mjd);
+        if ((int)mjd.mjd!=day) {
+            CalNonBrdCoefDay(mjd.mjd,nonBrdCoef);
+            day=(int)mjd.mjd;
+        }
+        pos2ecef(pos,sta_xyz);
+        for (j=0;j<ns[i];j++) {
+            ref[i*MAXOBS+j]=bdgim_ref(nonBrdCoef,brd,mjd.mjd,sta_xyz,rs[i]+j*6);
+        }
+    }
+    t[0]=(tickget()-tick)*1E-3;
+
+    /* all satellites of an epoch by ionmodel_BDSK9n() */
+    tick=tickget();
+    for (i=0;i<NEPOCH;i++) {
+        ionmodel_BDSK9n(gpst2bdt(timeadd(time,30.0*i)),nav.ion_bdsk9,pos,rs[i],
+                        6,ns[i],ion+i*MAXOBS);
+    }
+    t[1]=(tickget()-tick)*1E-3;
+
+    for (i=0;i<NEPOCH;i++) for (j=0;j<ns[i];j++) {
+        err=MAX(err,fabs(ion[i*MAXOBS+j]-ref[i*MAXOBS+j]));
+    }
+    printf("%s : bdgim (%d epochs, %.1f sats/epoch, %s)\n",PROGNAME,NEPOCH,
+           (double)nsat/NEPOCH,*navfile?navfile:"synthetic");
+    printf("%-9s %12s %12s %10s %10s\n","","ASLEFU","BDSK9n","speed-up",
+           "max diff");
+    printf("%-9s %10.3fus %10.3fus %9.1fx %9.1Em\n","per epoch",
+           t[0]*1E6/NEPOCH,t[1]*1E6/NEPOCH,t[1]>0.0?t[0]/t[1]:0.0,err);
+
+    free(rs); free(ns); free(ion); free(ref);
+    free(nav.eph); free(nav.geph); free(nav.seph); free(nav.ion_bdsk9);
+    return err<1E-6;
+}
+/* benchmark of broadcast orbits ---------------------------------------------*/
+static int bench_eph(const char *navfile)
+{
+    static nav_t nav; /* too large for stack */
+    const eph_t **eph;
+    const ephc_t **ec;
+    gtime_t time,*ts;
+    double *rs,*dts,*var,*ref,ep[6],t[2],err=0.0;
+    unsigned int tick;
+    int i,j,k,n,*ns,sys,nsat=0;
+
+    init_nav(&nav);
+    if (!*navfile||readrnx(navfile,0,"",NULL,&nav,NULL)<=0||nav.n<=0) {
+        fprintf(stderr,"nav file read error: %s\n",navfile);
+        return 0;
+    }
+    uniqnav(&nav);
+    n=NEPOCH*MAXOBS;
+    if (!(eph=(const eph_t **)malloc(sizeof(eph_t *)*n))||
+        !(ec=(const ephc_t **)malloc(sizeof(ephc_t *)*n))||
+        !(ts=(gtime_t *)malloc(sizeof(gtime_t)*n))||
+        !(ns=(int *)malloc(sizeof(int)*NEPOCH))||
+        !(rs =(double *)calloc(n*3,sizeof(double)))||
+        !(ref=(double *)calloc(n*3,sizeof(double)))||
+        !(dts=(double *)calloc(n*2,sizeof(double)))||
+        !(var=(double *)calloc(n*2,sizeof(double)))) {
+        fprintf(stderr,"memory allocation error\n");
+        return 0;
+    }
+    time2epoch(nav.eph[0].toe,ep);
+    ep[3]=ep[4]=ep[5]=0.0;
+    time=epoch2time(ep);
+
+    /* ephemerides of toe closest to epochs */
+    for (i=0;i<NEPOCH;i++) {
+        ns[i]=0;
+        for (j=0;j<nav.n&&ns[i]<MAXOBS;j++) {
+            sys=satsys(nav.eph[j].sat,NULL);
+            if (sys==SYS_GLO||sys==SYS_SBS||nav.eph[j].A<=0.0) continue;
+            if (fabs(timediff(nav.eph[j].toe,timeadd(time,30.0*i)))>3600.0) continue;
+            for (k=0;k<ns[i];k++) {
+                if (eph[i*MAXOBS+k]->sat==nav.eph[j].sat) break;
+            }
+            if (k<ns[i]) continue;
+            eph[i*MAXOBS+ns[i]]=nav.eph+j;
+            ec [i*MAXOBS+ns[i]]=nav.ephidx->ec+j;
+            ts [i*MAXOBS+ns[i]++]=timeadd(time,30.0*i);
+        }
+        nsat+=ns[i];
+    }
+    /* per-satellite eph2pos() */
+    tick=tickget();
+    for (i=0;i<NEPOCH;i++) for (j=0;j<ns[i];j++) {
+        k=i*MAXOBS+j;
+        eph2pos(ts[k],eph[k],ref+k*3,dts+k,var+k);
+    }
+    t[0]=(tickget()-tick)*1E-3;
+
+    /* all satellites of an epoch by eph2pos_batch() */
+    tick=tickget();
+    for (i=0;i<NEPOCH;i++) {
+        k=i*MAXOBS;
+        eph2pos_batch(ts+k,eph+k,ec+k,ns[i],rs+k*3,dts+n+k,var+n+k);
+    }
+    t[1]=(tickget()-tick)*1E-3;
+
+    for (i=0;i<NEPOCH;i++) for (j=0;j<ns[i];j++) {
+        k=i*MAXOBS+j;
+        err=MAX(err,fabs(dts[n+k]-dts[k])*CLIGHT);
+        err=MAX(err,fabs(var[n+k]-var[k]));
+        for (sys=0;sys<3;sys++) err=MAX(err,fabs(rs[sys+k*3]-ref[sys+k*3]));
+    }
+    printf("%s : eph (%d epochs, %.1f sats/epoch, %s)\n",PROGNAME,NEPOCH,
+           (double)nsat/NEPOCH,navfile);
+    printf("%-9s %12s %12s %10s %10s\n","","eph2pos","batch","speed-up",
+           "max diff");
+    printf("%-9s %10.3fus %10.3fus %9.1fx %9.1Em\n","per epoch",
+           t[0]*1E6/NEPOCH,t[1]*1E6/NEPOCH,t[1]>0.0?t[0]/t[1]:0.0,err);
+
+    free(eph); free(ec); free(ts); free(ns); free(rs); free(ref); free(dts);
+    free(var);
+    freenav(&nav,0xFF); free(nav.ion_bdsk9);
+    return err==0.0;
+}
+/* nequick-g test vector -----------------------------------------------------*/
+typedef struct {
+    double ai[3];           /* effective ionisation level coefficients */
+    int month;              /* month */
+    double utc;             /* universal time (hours) */
+    double rpos[3],spos[3]; /* receiver/satellite {lat,lon,h} (rad,m) */
+    double stec;            /* expected stec (TECU) (0:none) */
+} nqvec_t;
+
+/* read nequick-g test vectors -----------------------------------------------*/
+static int nequick_readvec(const char *file, nqvec_t *vec, int nmax)
+{
+    FILE *fp;
+    char buff[1024];
+    double ai[3],v[8];
+    int n=0,month,nv;
+
+    if (!(fp=fopen(file,"r"))) return -1;
+    if (!fgets(buff,sizeof(buff),fp)||
+        sscanf(buff,"%lf %lf %lf",ai,ai+1,ai+2)<3) {
+        fclose(fp);
+        return -1;
+    }
+    while (n<nmax&&fgets(buff,sizeof(buff),fp)) {
+        if ((nv=sscanf(buff,"%d %lf %lf %lf %lf %lf %lf %lf %lf",&month,v,v+1,
+                       v+2,v+3,v+4,v+5,v+6,v+7))<8) continue;
+        if (nv<9) v[7]=0.0;
+        matcpy(vec[n].ai,ai,3,1);
+        vec[n].month=month;
+        vec[n].utc=v[0];
+        vec[n].rpos[0]=v[2]*D2R; vec[n].rpos[1]=v[1]*D2R; vec[n].rpos[2]=v[3];
+        vec[n].spos[0]=v[5]*D2R; vec[n].spos[1]=v[4]*D2R; vec[n].spos[2]=v[6];
+        vec[n++].stec=v[7];
+    }
+    fclose(fp);
+    return n;
+}
+/* synthetic nequick-g test vectors ------------------------------------------*/
+static int nequick_genvec(nqvec_t *vec)
+{
+    const double ai[3][3]={ /* high, medium and low solar activity */
+        {236.831641,-0.39362878,0.00402826613},
+        {121.129893,0.351254133,0.0134635348},
+        {2.580271,0.127628236,0.0252748384}
+    };
+    double el,az,psi,*rpos,*spos;
+    int i,j,k,n=0;
+
+    srand(1);
+    for (i=0;i<NQ_NSTA;i++) for (j=0;j<NQ_NEPOCH;j++) for (k=0;k<NQ_NSAT;k++) {
+        matcpy(vec[n].ai,ai[i%3],3,1);
+        vec[n].month=1+i%12;
+        vec[n].utc=24.0*j/NQ_NEPOCH;
+        rpos=vec[n].rpos; spos=vec[n].spos;
+        rpos[0]=(-80.0+160.0*i/(NQ_NSTA-1))*D2R;
+        rpos[1]=(-180.0+360.0*randu())*D2R;
+        rpos[2]=100.0*(i%4);
+
+        /* galileo satellite at the elevation and azimuth on a sphere */
+        el=(5.0+80.0*randu())*D2R;
+        az=2.0*PI*randu();
+        psi=PI/2.0-el-asin(RE_WGS84*cos(el)/(RE_WGS84+23222E3));
+        spos[0]=asin(sin(rpos[0])*cos(psi)+cos(rpos[0])*sin(psi)*cos(az));
+        spos[1]=rpos[1]+atan2(sin(az)*sin(psi)*cos(rpos[0]),
+                              cos(psi)-sin(rpos[0])*sin(spos[0]));
+        spos[2]=23222E3;
+        vec[n++].stec=0.0;
+    }
+    return n;
+}
+/* slant tec of test vectors -------------------------------------------------*/
+static int nequick_vecstec(void *nq, const nqvec_t *vec, int n, double *stec,
+                           int *stat)
+{
+    double spos[MAXOBS*3];
+    int i,j,k,nok=0;
+
+    /* vectors of the same epoch and receiver by one call */
+    for (i=0;i<n;i=j) {
+        for (j=i;j<n&&j-i<MAXOBS;j++) {
+            if (memcmp(vec[j].ai,vec[i].ai,sizeof(vec[i].ai))||
+                vec[j].month!=vec[i].month||vec[j].utc!=vec[i].utc||
+                memcmp(vec[j].rpos,vec[i].rpos,sizeof(vec[i].rpos))) break;
+            for (k=0;k<3;k++) spos[(j-i)*3+k]=vec[j].spos[k];
+        }
+        nok+=nequick_stecn(nq,vec[i].ai,vec[i].month,vec[i].utc,vec[i].rpos,
+                           spos,j-i,stec+i,stat+i);
+    }
+    return nok;
+}
+/* benchmark of nequick-g integration modes ----------------------------------*/
+static int bench_nequick(const char *file)
+{
+    const struct {
+        const char *name;
+        int mode;           /* nequick_setmode() mode (-1: by the parameters) */
+        double tolfact;     /* tolerance factor */
+        int nint;           /* fixed-order intervals */
+        double reuse;       /* profile reuse distance (km) */
+    } conf[]={
+        {"reference",0,1.0,0,0.0},
+        {"tol x3"   ,-1,3.0,0,0.0},
+        {"tol x10"  ,-1,10.0,0,0.0},
+        {"tol x100" ,-1,100.0,0,0.0},
+        {"fixed 1"  ,-1,1.0,1,0.0},
+        {"fixed 2"  ,-1,1.0,2,0.0},
+        {"fixed 4"  ,-1,1.0,4,0.0},
+        {"reuse 5"  ,-1,1.0,0,5.0},
+        {"reuse 10" ,-1,1.0,0,10.0},
+        {"reuse 20" ,-1,1.0,0,20.0},
+        {"fast"     ,1,3.0,0,10.0},  /* NQMODE_FAST */
+        {"fixed"    ,2,1.0,2,0.0}    /* NQMODE_FIXED */
+    };
+    nqvec_t *vec;
+    double *ref,*stec,d,dmax,rms,t,t0=0.0,emax=0.0;
+    void *nq;
+    unsigned int tick;
+    int i,j,k,n,nd,nok=0,*stat,*rstat,ret=1;
+
+    if (!(nq=nequick_open(NULL,NULL))) {
+        fprintf(stderr,"nequick-g modip/ccir data open error\n");
+        return 0;
+    }
+    n=*file?1000000:NQ_NSTA*NQ_NEPOCH*NQ_NSAT;
+    if (!(vec=(nqvec_t *)malloc(sizeof(nqvec_t)*n))) {
+        fprintf(stderr,"memory allocation error\n");
+        nequick_close(nq);
+        return 0;
+    }
+    if ((n=*file?nequick_readvec(file,vec,n):nequick_genvec(vec))<=0||
+        !(ref=(double *)malloc(sizeof(double)*n))||
+        !(stec=(double *)malloc(sizeof(double)*n))||
+        !(stat=(int *)malloc(sizeof(int)*n))||
+        !(rstat=(int *)malloc(sizeof(int)*n))) {
+        fprintf(stderr,"nequick test vectors error: %s\n",file);
+        free(vec); nequick_close(nq);
+        return 0;
+    }
+    printf("%s : nequick (%d rays, %s)\n",PROGNAME,n,*file?file:"synthetic");
+    printf("%-10s %8s %5s %7s %10s %9s %10s %10s\n","mode","tolfact","nint",
+           "reuse","per ray","speed-up","max diff","rms diff");
+
+    for (i=0;i<(int)(sizeof(conf)/sizeof(*conf));i++) {
+        if (!(conf[i].mode>=0?nequick_setmode(nq,conf[i].mode):
+              nequick_setint(nq,conf[i].tolfact,conf[i].nint,conf[i].reuse))) {
+            ret=0;
+            continue;
+        }
+        for (k=0,t=1E9;k<NQ_NREP;k++) {
+            tick=tickget();
+            nok=nequick_vecstec(nq,vec,n,i?stec:ref,i?stat:rstat);
+            t=MIN(t,(tickget()-tick)*1E-3);
+        }
+        if (i==0) t0=t;
+
+        for (j=nd=0,dmax=rms=0.0;j<n;j++) {
+            if (!rstat[j]) continue;
+            if (!stat[j]&&i) {
+                ret=0;
+                continue;
+            }
+            d=i?stec[j]-ref[j]:(vec[j].stec!=0.0?ref[j]-vec[j].stec:0.0);
+            dmax=MAX(dmax,fabs(d));
+            rms+=d*d;
+            nd++;
+        }
+        rms=nd>0?sqrt(rms/nd):0.0;
+        if (i==0) emax=dmax;
+        printf("%-10s %8.1f %5d %6.0fkm %8.1fus %8.2fx %6.3fTECU %6.3fTECU\n",
+               conf[i].name,conf[i].tolfact,conf[i].nint,conf[i].reuse,
+               nok>0?t*1E6/nok:0.0,t>0.0?t0/t:0.0,i?dmax:0.0,i?rms:0.0);
+    }
+    if (*file) {
+        printf("%s : reference max diff from the vector STEC %.5f TECU\n",
+               PROGNAME,emax);
+    }
+    free(vec); free(ref); free(stec); free(stat); free(rstat);
+    nequick_close(nq);
+    return ret;
+}
+/* ionosphere model ray ------------------------------------------------------*/
+typedef struct {
+    gtime_t time;           /* time (gpst) */
+    int sat;                /* satellite number */
+    double pos[3];          /* receiver {lat,lon,h} (rad,m) */
+    double rs[3];           /* satellite position (ecef) (m) */
+    double azel[2];         /* azimuth/elevation angle (rad) */
+} ionray_t;
+
+typedef struct {            /* ionosphere model thread */
+    const ionray_t *ray;    /* rays */
+    int n;                  /* number of rays */
+    int opt;                /* ionosphere option (IONOOPT_???) */
+    nav_t *nav;             /* navigation data of the thread */
+    double *ion;            /* ionospheric delays (m) */
+    int *stat;              /* status of ionocorr() */
+    double ncall;           /* number of calls */
+    double t;               /* time of calls (s) */
+    thread_t thread;        /* thread */
+    int run;                /* thread running */
+} ionthr_t;
+
+/* add rays from receiver to visible satellites ------------------------------*/
+static int iono_addrays(ionray_t **ray, int *n, int *nmax, gtime_t time,
+                        const double *rr, const double *rs, const int *sats,
+                        int ns)
+{
+    ionray_t *p;
+    double e[3],dr;
+    int i;
+
+    for (i=0;i<ns;i++) {
+        if (*n>=*nmax) {
+            *nmax=*nmax<=0?4096:*nmax*2;
+            if (!(p=(ionray_t *)realloc(*ray,sizeof(ionray_t)**nmax))) return 0;
+            *ray=p;
+        }
+        p=*ray+*n;
+        p->time=time;
+        p->sat=sats[i];
+        ecef2pos(rr,p->pos);
+        matcpy(p->rs,rs+i*6,3,1);
+        if (geodist(SYS_GPS,p->rs,rr,e,&dr)<=0.0||
+            satazel(p->pos,e,p->azel)<10.0*D2R) continue;
+        (*n)++;
+    }
+    return 1;
+}
+/* rays of iono benchmark by obs file or synthetic geometry ------------------*/
+static int iono_rays(const char *obsfile, nav_t *nav, ionray_t **ray)
+{
+    static obs_t obs;
+    sta_t sta={{0}};
+    gtime_t time,tlast={0};
+    double ep[6]={2025,5,1,0,0,0},rs[MAXOBS*6],r[6],dts[2],var,rr[3],pos[3];
+    int i,j,k,n=0,nmax=0,ns,sats[MAXOBS],svh;
+
+    *ray=NULL;
+
+    if (*obsfile) { /* satellites of the epochs of obs */
+        init_obs(&obs);
+        if (readrnx(obsfile,1,"",&obs,nav,&sta)<=0||obs.n<=0||
+            norm(sta.pos,3)<=0.0) {
+            fprintf(stderr,"obs file read error or no approx position: %s\n",
+                    obsfile);
+            free(obs.data);
+            return 0;
+        }
+        sortobs(&obs);
+        for (i=0;i<obs.n;i=j) {
+            time=obs.data[i].time;
+            for (j=i+1;j<obs.n;j++) {
+                if (timediff(obs.data[j].time,time)>DTTOL) break;
+            }
+            if (tlast.time&&timediff(time,tlast)<IO_TINT-DTTOL) continue;
+            tlast=time;
+            for (k=i,ns=0;k<j&&ns<MAXOBS;k++) {
+                if (!satpos(&prcopt_default,time,time,obs.data[k].sat,
+                            EPHOPT_BRDC,nav,r,dts,&var,&svh)) continue;
+                matcpy(rs+ns*6,r,3,1);
+                sats[ns++]=obs.data[k].sat;
+            }
+            if (!iono_addrays(ray,&n,&nmax,time,sta.pos,rs,sats,ns)) break;
+        }
+        free(obs.data);
+        return n;
+    }
+    /* day of the first ionex map or ephemeris if read */
+    if      (nav->nt>0) time2epoch(nav->tec[0].time,ep);
+    else if (nav->n >0) time2epoch(nav->eph[0].toe,ep);
+    ep[3]=ep[4]=ep[5]=0.0;
+    time=epoch2time(ep);
+
+    for (i=0;i<IO_NEPOCH;i++) for (j=0;j<IO_NLAT;j++) for (k=0;k<IO_NLON;k++) {
+        pos[0]=(-60.0+120.0*j/(IO_NLAT-1))*D2R;
+        pos[1]=(-180.0+360.0*k/IO_NLON)*D2R;
+        pos[2]=0.0;
+        pos2ecef(pos,rr);
+        ns=bdgim_sats(timeadd(time,3600.0*i),nav->n>0?nav:NULL,rr,rs,sats);
+        if (!iono_addrays(ray,&n,&nmax,timeadd(time,3600.0*i),rr,rs,sats,ns)) {
+            return n;
+        }
+    }
+    return n;
+}
+/* ionosphere model thread ---------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI ionothread(void *arg)
+#else
+static void *ionothread(void *arg)
+#endif
+{
+    ionthr_t *p=(ionthr_t *)arg;
+    const ionray_t *r;
+    unsigned int tick=tickget(),t;
+    double var;
+    int i;
+
+    /* repeat all rays to get a measurable time for fast models */
+    do {
+        for (i=0,r=p->ray;i<p->n;i++,r++) {
+            p->stat[i]=ionocorr(prcopt_default,r->time,p->nav,r->sat,r->pos,
+                                r->rs,r->azel,p->opt,p->ion+i,&var);
+        }
+        p->ncall+=p->n;
+    } while ((t=tickget()-tick)<IO_TMIN);
+    p->t=t*1E-3;
+    return 0;
+}
+/* benchmark of ionosphere models --------------------------------------------*/
+static int bench_iono(const char *obsfile, const char *navfile,
+                      const char *tecfile, int nthread)
+{
+    static nav_t nav; /* too large for stack */
+    const struct {
+        const char *name;
+        int opt;            /* ionosphere option (IONOOPT_???) */
+    } model[]={ /* ionex first as reference */
+        {"ionex" ,IONOOPT_TEC},
+        {"brdc"  ,IONOOPT_BRDC},
+        {"bdsk8" ,IONOOPT_BDSK8},
+        {"bdssh9",IONOOPT_BDSSH9},
+        {"galion",IONOOPT_GALION}
+    };
+    const double ai[]={121.129893,0.351254133,0.0134635348}; /* medium */
+    /* m -> TECU. ionocorr() gives delays for B1I as nav has no wavelengths */
+    const double fact=FREQ1_CMP*FREQ1_CMP/40.3E16;
+    ionthr_t thr[MAXTHREAD]={{0}};
+    nav_t *navs=NULL;
+    ionray_t *ray=NULL;
+    double *ion=NULL,*tec=NULL,ep[6],d,sum,mean,rms,dmax,cps;
+    int i,j,n=0,nd,nok,*stat=NULL,*tstat=NULL,ret=0;
+
+    init_nav(&nav);
+    if (*navfile&&readrnx(navfile,0,"",NULL,&nav,NULL)<=0) {
+        fprintf(stderr,"nav file read error: %s\n",navfile);
+        goto exit;
+    }
+    if (*tecfile&&(readtec(tecfile,&nav,0),nav.nt<=0)) {
+        fprintf(stderr,"ionex file read error: %s\n",tecfile);
+        goto exit;
+    }
+    if (*obsfile&&nav.n<=0) {
+        fprintf(stderr,"no ephemeris for -obs: specify -nav\n");
+        goto exit;
+    }
+    if ((n=iono_rays(obsfile,&nav,&ray))<=0) {
+        fprintf(stderr,"no rays of iono benchmark\n");
+        goto exit;
+    }
+    /* broadcast parameters of the day, or sample ones if none */
+    time2epoch(ray[0].time,ep);
+    if (uniqion(ep,nav.ion_bdsk9)!=1) {
+        nav.ion_bdsk9->BrdIonCoefNum=9;
+        nav.ion_bdsk9->BrdIonCoefGroup=1;
+        for (i=0;i<9;i++) nav.ion_bdsk9->BrdIonCoef[i][0]=bdgim_brd[i];
+        initbdgim(nav.ion_bdsk9);
+    }
+    if (norm(nav.ion_gal,3)<=0.0) matcpy(nav.ion_gal,ai,3,1);
+
+    nthread=nthread<1?1:(nthread>MAXTHREAD?MAXTHREAD:nthread);
+    if (nthread>n) nthread=n;
+
+    if (!(ion=(double *)malloc(sizeof(double)*n))||
+        !(tec=(double *)malloc(sizeof(double)*n))||
+        !(stat=(int *)malloc(sizeof(int)*n))||
+        !(tstat=(int *)malloc(sizeof(int)*n))||
+        !(navs=(nav_t *)calloc(nthread,sizeof(nav_t)))) {
+        fprintf(stderr,"memory allocation error\n");
+        goto exit;
+    }
+    /* bdgim model state and nequick-g context by thread */
+    for (i=0;i<nthread;i++) {
+        navs[i]=nav;
+        if (!(navs[i].ion_bdsk9=(BDSSH *)malloc(sizeof(BDSSH)))) {
+            fprintf(stderr,"memory allocation error\n");
+            goto exit;
+        }
+        *navs[i].ion_bdsk9=*nav.ion_bdsk9;
+        initbdgim(navs[i].ion_bdsk9);
+
+        if (!(navs[i].nequick=nequick_open(NULL,NULL))) {
+            fprintf(stderr,"nequick-g modip/ccir data open error\n");
+            goto exit;
+        }
+    }
+    printf("%% %s : iono (%d rays, %d threads, %s, ionex %s)\n",PROGNAME,n,
+           nthread,*obsfile?obsfile:"synthetic",*tecfile?tecfile:"none");
+    printf("%% %-6s %5s %6s %10s %12s %10s %6s %10s %10s %10s\n","model","opt",
+           "nok","ns/call","calls/s/thr","stec(TECU)","ndiff","mean(TECU)",
+           "rms(TECU)","max(TECU)");
+
+    for (i=0;i<(int)(sizeof(model)/sizeof(*model));i++) {
+        if (model[i].opt==IONOOPT_TEC&&!*tecfile) continue;
+
+        for (j=0;j<nthread;j++) {
+            thr[j].ray=ray+n*j/nthread;
+            thr[j].n=n*(j+1)/nthread-n*j/nthread;
+            thr[j].opt=model[i].opt;
+            thr[j].nav=navs+j;
+            thr[j].ion=ion+n*j/nthread;
+            thr[j].stat=stat+n*j/nthread;
+            thr[j].ncall=thr[j].t=0.0;
+#ifdef WIN32
+            thr[j].run=(thr[j].thread=CreateThread(NULL,0,ionothread,thr+j,0,
+                                                   NULL))!=NULL;
+#else
+            thr[j].run=!pthread_create(&thr[j].thread,NULL,ionothread,thr+j);
+#endif
+            if (!thr[j].run) ionothread(thr+j);
+        }
+        for (j=0,cps=0.0;j<nthread;j++) {
+            if (thr[j].run) {
+#ifdef WIN32
+                WaitForSingleObject(thr[j].thread,INFINITE);
+                CloseHandle(thr[j].thread);
+#else
+                pthread_join(thr[j].thread,NULL);
+#endif
+            }
+            cps+=thr[j].t>0.0?thr[j].ncall/thr[j].t/nthread:0.0;
+        }
+        if (model[i].opt==IONOOPT_TEC) {
+            for (j=0;j<n;j++) {
+                tec[j]=ion[j]*fact;
+                tstat[j]=stat[j]&&ion[j]>0.0;
+            }
+        }
+        /* mean stec and differences from ionex */
+        for (j=nok=nd=0,sum=mean=rms=dmax=0.0;j<n;j++) {
+            if (!stat[j]) continue;
+            nok++;
+            sum+=ion[j]*fact;
+            if (!*tecfile||!tstat[j]||model[i].opt==IONOOPT_TEC) continue;
+            d=ion[j]*fact-tec[j];
+            mean+=d;
+            rms+=d*d;
+            dmax=MAX(dmax,fabs(d));
+            nd++;
+        }
+        printf("%-8s %5d %6d %10.1f %12.0f %10.3f %6d %10.3f %10.3f %10.3f\n",
+               model[i].name,model[i].opt,nok,cps>0.0?1E9/cps:0.0,cps,
+               nok>0?sum/nok:0.0,nd,nd>0?mean/nd:0.0,nd>0?sqrt(rms/nd):0.0,dmax);
+        fflush(stdout);
+    }
+    ret=1;
+exit:
+    if (navs) {
+        for (i=0;i<nthread;i++) {
+            nequick_close(navs[i].nequick);
+            free(navs[i].ion_bdsk9);
+        }
+        free(navs);
+    }
+    free(ray); free(ion); free(tec); free(stat); free(tstat);
+    for (i=0;i<nav.nt;i++) {
+        free(nav.tec[i].data); free(nav.tec[i].rms);
+    }
+    free(nav.eph); free(nav.geph); free(nav.seph); free(nav.tec);
+    free(nav.ion_bdsk9);
+    return ret;
+}
+/* benchmark of reading file -------------------------------------------------*/
+static void bench_read(const char *file)
+{
+    static obs_t obs;
+    static nav_t nav; /* too large for stack */
+    sta_t sta={{0}};
+    const char *ext=strrchr(file,'.');
+    unsigned int tick;
+    int n=0;
+
+    init_nav(&nav); init_obs(&obs);
+    tick=tickget();
+
+    if (ext&&(!strcmp(ext,".sp3")||!strcmp(ext,".SP3")||!strcmp(ext,".eph"))) {
+        readsp3(file,&nav,0);
+        n=nav.ne;
+    }
+    else if (ext&&(!strcmp(ext,".clk")||!strcmp(ext,".CLK"))) {
+        readrnxc(file,&nav);
+        n=nav.nc;
+    }
+    else if (ext&&(strlen(ext)==4&&(ext[3]=='i'||ext[3]=='I'))) {
+        readtec(file,&nav,0);
+        n=nav.nt;
+    }
+    else {
+        readrnx(file,1,"",&obs,&nav,&sta);
+        n=obs.n+nav.n+nav.ng;
+    }
+    printf("%-48s : %8d records %8.3fs\n",file,n,(tickget()-tick)*1E-3);
+
+    free(obs.data); free(nav.eph); free(nav.geph); free(nav.seph);
+    free(nav.peph); free(nav.pclk); free(nav.tec); free(nav.ion_bdsk9);
+}
+/* rtkbench main -------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    int i,n=NFIELD,trace=0,ret=1,s2n=0,bdg=0,neq=0,ion=0,eph=0,nthread=1;
+    char navfile[1024]="",nqfile[1024]="",obsfile[1024]="",tecfile[1024]="";
+
+    for (i=1;i<argc;i++) {
+        if      (!strcmp(argv[i],"-str2num")) s2n=1;
+        else if (!strcmp(argv[i],"-bdgim")) bdg=1;
+        else if (!strcmp(argv[i],"-nequick")) neq=1;
+        else if (!strcmp(argv[i],"-iono")) ion=1;
+        else if (!strcmp(argv[i],"-eph")) eph=1;
+        else if (!strcmp(argv[i],"-nav")&&i+1<argc) strcpy(navfile,argv[++i]);
+        else if (!strcmp(argv[i],"-nqfile")&&i+1<argc) strcpy(nqfile,argv[++i]);
+        else if (!strcmp(argv[i],"-obs")&&i+1<argc) strcpy(obsfile,argv[++i]);
+        else if (!strcmp(argv[i],"-tec")&&i+1<argc) strcpy(tecfile,argv[++i]);
+        else if (!strcmp(argv[i],"-j")&&i+1<argc) nthread=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-n")&&i+1<argc) n=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-x")&&i+1<argc) trace=atoi(argv[++i]);
+        else if (*argv[i]=='-') printhelp();
+    }
+    if (trace>0) {
+        traceopen(PROGNAME ".trace");
+        tracelevel(trace);
+    }
+    if (n<16) n=16;
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-n")||!strcmp(argv[i],"-x")||
+            !strcmp(argv[i],"-nav")||!strcmp(argv[i],"-nqfile")||
+            !strcmp(argv[i],"-obs")||!strcmp(argv[i],"-tec")||
+            !strcmp(argv[i],"-j")) i++;
+        else if (*argv[i]!='-') bench_read(argv[i]);
+    }
+    if (s2n||(!bdg&&!neq&&!ion&&!eph)) {
+        printf("%s : str2num (%d fields)\n",PROGNAME,n);
+        if (!bench_str2num(n)) {
+            printf("%s : error : results different from sscanf()\n",PROGNAME);
+            ret=0;
+        }
+    }
+    if (bdg&&!bench_bdgim(navfile)) {
+        printf("%s : error : results different from ASLEFU()\n",PROGNAME);
+        ret=0;
+    }
+    if (neq&&!bench_nequick(nqfile)) {
+        printf("%s : error : nequick-g integration mode failed\n",PROGNAME);
+        ret=0;
+    }
+    if (eph&&!bench_eph(navfile)) {
+        printf("%s : error : results different from eph2pos()\n",PROGNAME);
+        ret=0;
+    }
+    if (ion&&!bench_iono(obsfile,navfile,tecfile,nthread)) {
+        printf("%% %s : error : iono benchmark failed\n",PROGNAME);
+        ret=0;
+    }
+    traceclose();
+    return ret?0:1;
+}
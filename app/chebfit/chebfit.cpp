@@ -0,0 +1,205 @@
+/*------------------------------------------------------------------------------
+* chebfit.cpp : chebyshev orbit/clock file generator
+*
+* build  : compile with the sources of rnx2rtkp except app/main/rnx2rtkp.cpp
+*          and the same options, e.g.
+*          g++ -O2 -I src -I src/Nequick/lib/private -I src/Nequick/lib/public
+*              -DENAGLO -DENACMP -DENAGAL -DNFREQ=6 -DTRACE -o chebfit
+*              app/chebfit/chebfit.cpp src/(sources) -lpthread
+*
+* version : $Revision: 1.0 $ $Date: 2025/08/02 $
+* history : 2025/08/02  1.0 new
+*-----------------------------------------------------------------------------*/
+#include <stdarg.h>
+#include "rtklib.h"
+
+#define PROGNAME    "chebfit"           /* program name */
+#define SQR(x)      ((x)*(x))
+
+/* help text -----------------------------------------------------------------*/
+static const char *help[]={
+"",
+" usage: chebfit [option]... -o file file [file ...]",
+"",
+" Fit chebyshev polynomials to the satellite orbits and clocks by satpos() of",
+" the input files (RINEX NAV/CLK or SP3 by the file extension) and write them",
+" to a chebyshev orbit/clock file, which is read by readcheb() and by",
+" rnx2rtkp as an input file with the extension .cheb (pos1-sateph=cheb).",
+"",
+" -e eph     ephemeris: brdc,precise [precise with SP3, else brdc]",
+" -ts y/m/d h:m:s  start time (GPST) [day of first ephemeris]",
+" -te y/m/d h:m:s  end time (GPST) [start time + 24h]",
+" -tb tblk   block length (s), multiple of 30s [3600]",
+" -deg n m   degree of orbit and clock polynomials [12 4]",
+" -tol tol   accuracy target of positions and clocks (m) [0.001]",
+" -ti tint   check interval of positions and clocks against satpos() by the",
+"            ephemeris of the blocks (s) (0:no check) [0]",
+" -o file    output chebyshev orbit/clock file",
+" -x level   debug trace level (0:off) [0]"
+};
+/* dummy functions required by rtklib ----------------------------------------*/
+extern int showmsg(const char *format, ...)
+{
+    va_list arg;
+    va_start(arg,format); vfprintf(stderr,format,arg); va_end(arg);
+    fprintf(stderr,"\r");
+    return 0;
+}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+extern void init_nav(nav_t *nav);
+extern int satpos(const prcopt_t *opt, gtime_t time, gtime_t teph, int sat,
+                  int ephopt, const nav_t *nav, double *rs, double *dts,
+                  double *var, int *svh);
+
+/* print help ----------------------------------------------------------------*/
+static void printhelp(void)
+{
+    int i;
+    for (i=0;i<(int)(sizeof(help)/sizeof(*help));i++) fprintf(stderr,"%s\n",help[i]);
+    exit(0);
+}
+/* ephemeris selection time of block (see fitcheb()) ------------------------*/
+static gtime_t blkteph(const cheb_t *cheb, gtime_t time)
+{
+    return timeadd(cheb->ts,(floor(timediff(time,cheb->ts)/cheb->tblk)+0.5)*
+                   cheb->tblk);
+}
+/* check chebyshev orbit/clock against satpos() ------------------------------*/
+static void checkcheb(const cheb_t *cheb, gtime_t ts, gtime_t te, double tint,
+                      const prcopt_t *opt, const nav_t *nav)
+{
+    gtime_t time;
+    double rs[6],dts[2],var,rc[6],dtc[2],varc,d,dmax[3]={0},tt[2]={0};
+    int i,j,k,n=0,svh,svhc;
+    unsigned int tick;
+    
+    for (k=0;k<2;k++) { /* 0:satpos(),1:chebpos() */
+        tick=tickget();
+        for (time=ts;timediff(time,te)<=0.0;time=timeadd(time,tint)) {
+            for (i=0;i<MAXSAT;i++) {
+                if (cheb->idx[i]<0) continue;
+                if (k==0) {
+                    satpos(opt,time,blkteph(cheb,time),i+1,opt->sateph,nav,rs,
+                           dts,&var,&svh);
+                }
+                else chebpos(time,i+1,cheb,rc,dtc,&varc,&svhc);
+            }
+        }
+        tt[k]=(double)(tickget()-tick);
+    }
+    for (time=ts;timediff(time,te)<=0.0;time=timeadd(time,tint)) {
+        for (i=0;i<MAXSAT;i++) {
+            if (cheb->idx[i]<0) continue;
+            if (!satpos(opt,time,blkteph(cheb,time),i+1,opt->sateph,nav,rs,dts,
+                        &var,&svh)||
+                !chebpos(time,i+1,cheb,rc,dtc,&varc,&svhc)) continue;
+            for (j=0,d=0.0;j<3;j++) d+=SQR(rs[j]-rc[j]);
+            if ((d=sqrt(d))>dmax[0]) dmax[0]=d;
+            for (j=3,d=0.0;j<6;j++) d+=SQR(rs[j]-rc[j]);
+            if ((d=sqrt(d))>dmax[1]) dmax[1]=d;
+            if (dtc[0]!=0.0&&(d=fabs(dts[0]-dtc[0])*CLIGHT)>dmax[2]) dmax[2]=d;
+            n++;
+        }
+    }
+    fprintf(stderr,"%s : check %d states: max diff pos=%.4fm vel=%.6fm/s "
+            "clk=%.4fm\n",PROGNAME,n,dmax[0],dmax[1],dmax[2]);
+    fprintf(stderr,"%s : time per state satpos=%.3fus chebpos=%.3fus\n",
+            PROGNAME,n>0?tt[0]*1E3/n:0.0,n>0?tt[1]*1E3/n:0.0);
+}
+/* chebfit main --------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    static nav_t nav; /* too large for stack */
+    cheb_t cheb={0};
+    prcopt_t opt=prcopt_default;
+    gtime_t ts={0},te={0};
+    double es[6]={2000,1,1,0,0,0},ee[6]={2000,1,1,0,0,0},tblk=3600.0;
+    double tol=1E-3,tint=0.0;
+    int i,n=0,deg[2]={12,4},trace=0,ret=0;
+    const char *infile[MAXEXFILE],*outfile="",*eph="",*ext;
+    
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-e")&&i+1<argc) eph=argv[++i];
+        else if (!strcmp(argv[i],"-ts")&&i+2<argc) {
+            sscanf(argv[++i],"%lf/%lf/%lf",es,es+1,es+2);
+            sscanf(argv[++i],"%lf:%lf:%lf",es+3,es+4,es+5);
+            ts=epoch2time(es);
+        }
+        else if (!strcmp(argv[i],"-te")&&i+2<argc) {
+            sscanf(argv[++i],"%lf/%lf/%lf",ee,ee+1,ee+2);
+            sscanf(argv[++i],"%lf:%lf:%lf",ee+3,ee+4,ee+5);
+            te=epoch2time(ee);
+        }
+        else if (!strcmp(argv[i],"-tb")&&i+1<argc) tblk=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-deg")&&i+2<argc) {
+            deg[0]=atoi(argv[++i]);
+            deg[1]=atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i],"-tol")&&i+1<argc) tol=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-ti")&&i+1<argc) tint=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-o")&&i+1<argc) outfile=argv[++i];
+        else if (!strcmp(argv[i],"-x")&&i+1<argc) trace=atoi(argv[++i]);
+        else if (*argv[i]!='-'&&n<MAXEXFILE) infile[n++]=argv[i];
+        else printhelp();
+    }
+    if (n<=0||!*outfile||tblk<30.0||tol<=0.0||tint<0.0||
+        (*eph&&strcmp(eph,"brdc")&&strcmp(eph,"precise"))) {
+        printhelp();
+    }
+    if (trace>0) {
+        traceopen(PROGNAME ".trace");
+        tracelevel(trace);
+    }
+    init_nav(&nav);
+    for (i=0;i<n;i++) {
+        if ((ext=strrchr(infile[i],'.'))&&
+            (!strcmp(ext,".sp3")||!strcmp(ext,".SP3")||
+             !strcmp(ext,".eph")||!strcmp(ext,".EPH"))) {
+            readsp3(infile[i],&nav,0);
+        }
+        else if (readrnx(infile[i],0,"",NULL,&nav,NULL)<=0) {
+            readrnxc(infile[i],&nav);
+        }
+    }
+    uniqnav(&nav);
+    
+    opt.sateph=*eph?(strcmp(eph,"brdc")?EPHOPT_PREC:EPHOPT_BRDC):
+               (nav.ne>0?EPHOPT_PREC:EPHOPT_BRDC);
+    
+    if ((opt.sateph==EPHOPT_PREC&&nav.ne<=0)||
+        (opt.sateph==EPHOPT_BRDC&&nav.n<=0&&nav.ng<=0)) {
+        fprintf(stderr,"no %s ephemeris\n",opt.sateph?"precise":"broadcast");
+        goto exit;
+    }
+    /* day of the first ephemeris if no start time */
+    if (ts.time==0) {
+        if      (opt.sateph==EPHOPT_PREC) time2epoch(nav.peph[0].time,es);
+        else if (nav.n>0) time2epoch(nav.eph[0].toe,es);
+        else time2epoch(nav.geph[0].toe,es);
+        es[3]=es[4]=es[5]=0.0;
+        ts=epoch2time(es);
+    }
+    if (te.time==0) te=timeadd(ts,86400.0);
+    
+    if (!fitcheb(ts,te,tblk,deg,tol,&opt,&nav,&cheb)) {
+        fprintf(stderr,"no chebyshev orbit/clock fitted\n");
+        goto exit;
+    }
+    fprintf(stderr,"%s : %s %d satellites %d blocks of %.0fs\n",PROGNAME,
+            opt.sateph?"precise":"brdc",cheb.n,cheb.nb,cheb.tblk);
+    
+    if (!writecheb(outfile,&cheb)) {
+        fprintf(stderr,"chebyshev orbit/clock file write error: %s\n",outfile);
+        goto exit;
+    }
+    if (tint>0.0) checkcheb(&cheb,ts,te,tint,&opt,&nav);
+    ret=1;
+exit:
+    freecheb(&cheb);
+    freenav(&nav,0xFF);
+    free(nav.ion_bdsk9);
+    traceclose();
+    return ret?0:1;
+}
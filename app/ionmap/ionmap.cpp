@@ -0,0 +1,346 @@
+/*------------------------------------------------------------------------------
+* ionmap.cpp : global tec maps of ionosphere models
+*
+* build  : compile with the sources of rnx2rtkp except app/main/rnx2rtkp.cpp
+*          and the same options, e.g.
+*          g++ -O2 -I src -I src/Nequick/lib/private -I src/Nequick/lib/public
+*              -DENAGLO -DENACMP -DENAGAL -DNFREQ=6 -DTRACE -o ionmap
+*              app/ionmap/ionmap.cpp src/(sources) -lpthread
+*
+* version : $Revision: 1.0 $ $Date: 2025/07/22 $
+* history : 2025/07/22  1.0 new
+*-----------------------------------------------------------------------------*/
+#include <stdarg.h>
+#include "rtklib.h"
+
+#define PROGNAME    "ionmap"            /* program name */
+#define MAXTHREAD   64                  /* max number of threads */
+#define HSAT        20200E3             /* height of virtual satellites (m) */
+
+/* help text -----------------------------------------------------------------*/
+static const char *help[]={
+"",
+" usage: ionmap [option]... -o file",
+"",
+" Evaluate an ionosphere model by ionocorr() on a lat/lon grid for the map",
+" epochs and write the tec maps as IONEX, which is read by readtec() and",
+" iontec(). The rays are vertical from the grid points on the ground (VTEC)",
+" or slant to an elevation/azimuth by -el (STEC of receivers on the grid).",
+"",
+" -m model   ionosphere model: brdc,bdsk8,bdssh9,galion,ionex [brdc]",
+" -nav file  RINEX NAV with the broadcast iono parameters [default ones]",
+" -tec file  IONEX TEC of -m ionex (regrid of the maps)",
+" -ts y/m/d h:m:s  first map epoch (GPST) [day of first nav/ionex data]",
+" -te y/m/d h:m:s  last map epoch (GPST) [first epoch + 24h]",
+" -ti tint   map interval (s) [3600]",
+" -lat lat1 lat2 dlat  latitude grid (deg) [87.5 -87.5 -2.5]",
+" -lon lon1 lon2 dlon  longitude grid (deg) [-180 180 5]",
+" -hgt hgt   height written to the maps (km) [450]",
+" -el el az  elevation and azimuth of rays (deg) [90 0]",
+" -j num     number of threads [1]",
+" -o file    output IONEX file",
+" -b file    output binary tec grid file (keeps values without rounding)",
+" -x level   debug trace level (0:off) [0]"
+};
+/* dummy functions required by rtklib ----------------------------------------*/
+extern int showmsg(const char *format, ...)
+{
+    va_list arg;
+    va_start(arg,format); vfprintf(stderr,format,arg); va_end(arg);
+    fprintf(stderr,"\r");
+    return 0;
+}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+extern void init_nav(nav_t *nav);
+extern void initbdgim(BDSSH *bdssh);
+extern char uniqion(double *ep, BDSSH *bdssh);
+
+typedef struct {            /* map thread type */
+    tec_t *tec;             /* tec maps */
+    int irow,nrow;          /* index/number of rows {map,lat} */
+    int opt;                /* ionosphere option (IONOOPT_???) */
+    double azel[2];         /* azimuth/elevation of rays (rad) */
+    nav_t nav;              /* navigation data of the thread */
+    thread_t thread;        /* thread */
+    int run;                /* thread running */
+} mapthr_t;
+
+/* print help ----------------------------------------------------------------*/
+static void printhelp(void)
+{
+    int i;
+    for (i=0;i<(int)(sizeof(help)/sizeof(*help));i++) fprintf(stderr,"%s\n",help[i]);
+    exit(0);
+}
+/* virtual satellite position along ray ----------------------------------------
+* position at the height HSAT on the line from rr to azimuth/elevation azel
+*-----------------------------------------------------------------------------*/
+static void raysat(const double *pos, const double *rr, const double *azel,
+                   double *rs)
+{
+    double enu[3],u[3],b,c,r=RE_WGS84+HSAT;
+    int i;
+
+    enu[0]=sin(azel[0])*cos(azel[1]);
+    enu[1]=cos(azel[0])*cos(azel[1]);
+    enu[2]=sin(azel[1]);
+    enu2ecef(pos,enu,u);
+
+    /* |rr+d*u|=r */
+    b=dot(rr,u,3);
+    c=dot(rr,rr,3)-r*r;
+    for (i=0;i<3;i++) rs[i]=rr[i]+(-b+sqrt(b*b-c))*u[i];
+}
+/* tec of rows of maps -------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI mapthread(void *arg)
+#else
+static void *mapthread(void *arg)
+#endif
+{
+    mapthr_t *p=(mapthr_t *)arg;
+    const double fact=FREQ1_CMP*FREQ1_CMP/40.3E16; /* m (B1I) -> TECU */
+    tec_t *tec;
+    double pos[3],rr[3],rs[3],ion,var;
+    int i,j,k,m;
+
+    for (k=p->irow;k<p->irow+p->nrow;k++) {
+        tec=p->tec+k/p->tec->ndata[0];
+        i=k%tec->ndata[0];
+        pos[0]=(tec->lats[0]+tec->lats[2]*i)*D2R;
+        pos[2]=0.0;
+        for (j=0;j<tec->ndata[1];j++) {
+            pos[1]=(tec->lons[0]+tec->lons[2]*j)*D2R;
+            pos2ecef(pos,rr);
+            raysat(pos,rr,p->azel,rs);
+            m=i+tec->ndata[0]*j;
+
+            /* ionocorr() gives delays for B1I as nav has no wavelengths */
+            if (!ionocorr(prcopt_default,tec->time,&p->nav,1,pos,rs,p->azel,
+                          p->opt,&ion,&var)) {
+                tec->data[m]=-1.0; /* not available */
+                continue;
+            }
+            tec->data[m]=ion*fact;
+            tec->rms [m]=(float)(sqrt(var)*fact);
+        }
+    }
+    return 0;
+}
+/* tec maps of model by threads ----------------------------------------------*/
+static int genmaps(tec_t *tec, int n, int opt, const double *azel,
+                   const nav_t *nav, int nthread)
+{
+    mapthr_t *thr;
+    int i,nrow=n*tec->ndata[0],ret=1;
+
+    if (nthread>nrow) nthread=nrow;
+
+    if (!(thr=(mapthr_t *)calloc(nthread,sizeof(mapthr_t)))) return 0;
+
+    /* bdgim model state and nequick-g context by thread */
+    for (i=0;i<nthread;i++) {
+        thr[i].tec=tec;
+        thr[i].irow=nrow*i/nthread;
+        thr[i].nrow=nrow*(i+1)/nthread-thr[i].irow;
+        thr[i].opt=opt;
+        thr[i].azel[0]=azel[0];
+        thr[i].azel[1]=azel[1];
+        thr[i].nav=*nav;
+        thr[i].nav.ion_bdsk9=NULL;
+        if (!(thr[i].nav.ion_bdsk9=(BDSSH *)malloc(sizeof(BDSSH)))) {
+            ret=0;
+            break;
+        }
+        *thr[i].nav.ion_bdsk9=*nav->ion_bdsk9;
+        initbdgim(thr[i].nav.ion_bdsk9);
+
+        if (opt==IONOOPT_GALION&&!(thr[i].nav.nequick=nequick_open(NULL,NULL))) {
+            fprintf(stderr,"nequick-g modip/ccir data open error\n");
+            ret=0;
+            break;
+        }
+    }
+    for (i=0;ret&&i<nthread;i++) {
+#ifdef WIN32
+        thr[i].run=(thr[i].thread=CreateThread(NULL,0,mapthread,thr+i,0,
+                                               NULL))!=NULL;
+#else
+        thr[i].run=!pthread_create(&thr[i].thread,NULL,mapthread,thr+i);
+#endif
+        if (!thr[i].run) mapthread(thr+i);
+    }
+    for (i=0;i<nthread;i++) {
+        if (thr[i].run) {
+#ifdef WIN32
+            WaitForSingleObject(thr[i].thread,INFINITE);
+            CloseHandle(thr[i].thread);
+#else
+            pthread_join(thr[i].thread,NULL);
+#endif
+        }
+        nequick_close(thr[i].nav.nequick);
+        free(thr[i].nav.ion_bdsk9);
+    }
+    free(thr);
+    return ret;
+}
+/* ionmap main ---------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    static nav_t nav; /* too large for stack */
+    const char *models[]={"brdc","bdsk8","bdssh9","galion","ionex"};
+    const int opts[]={
+        IONOOPT_BRDC,IONOOPT_BDSK8,IONOOPT_BDSSH9,IONOOPT_GALION,IONOOPT_TEC
+    };
+    const double ai[]={121.129893,0.351254133,0.0134635348}; /* medium */
+    tec_t *tec=NULL;
+    gtime_t ts={0},te={0},time;
+    double lats[3]={87.5,-87.5,-2.5},lons[3]={-180.0,180.0,5.0},hgt=450.0;
+    double es[6]={2000,1,1,0,0,0},ee[6]={2000,1,1,0,0,0},ep[6],tint=3600.0;
+    double azel[2]={0.0,90.0};
+    int i,j,n,nd,opt=IONOOPT_BRDC,nthread=1,trace=0,ret=0;
+    const char *navfile="",*tecfile="",*outfile="",*binfile="",*model="brdc";
+    char comment[256];
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-m")&&i+1<argc) model=argv[++i];
+        else if (!strcmp(argv[i],"-nav")&&i+1<argc) navfile=argv[++i];
+        else if (!strcmp(argv[i],"-tec")&&i+1<argc) tecfile=argv[++i];
+        else if (!strcmp(argv[i],"-ts")&&i+2<argc) {
+            sscanf(argv[++i],"%lf/%lf/%lf",es,es+1,es+2);
+            sscanf(argv[++i],"%lf:%lf:%lf",es+3,es+4,es+5);
+            ts=epoch2time(es);
+        }
+        else if (!strcmp(argv[i],"-te")&&i+2<argc) {
+            sscanf(argv[++i],"%lf/%lf/%lf",ee,ee+1,ee+2);
+            sscanf(argv[++i],"%lf:%lf:%lf",ee+3,ee+4,ee+5);
+            te=epoch2time(ee);
+        }
+        else if (!strcmp(argv[i],"-ti")&&i+1<argc) tint=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-lat")&&i+3<argc) {
+            for (j=0;j<3;j++) lats[j]=atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i],"-lon")&&i+3<argc) {
+            for (j=0;j<3;j++) lons[j]=atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i],"-hgt")&&i+1<argc) hgt=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-el")&&i+2<argc) {
+            azel[1]=atof(argv[++i]);
+            azel[0]=atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i],"-j")&&i+1<argc) nthread=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-o")&&i+1<argc) outfile=argv[++i];
+        else if (!strcmp(argv[i],"-b")&&i+1<argc) binfile=argv[++i];
+        else if (!strcmp(argv[i],"-x")&&i+1<argc) trace=atoi(argv[++i]);
+        else printhelp();
+    }
+    for (i=0;i<(int)(sizeof(models)/sizeof(*models));i++) {
+        if (!strcmp(model,models[i])) break;
+    }
+    if (i>=(int)(sizeof(models)/sizeof(*models))||(!*outfile&&!*binfile)||
+        tint<=0.0||lats[2]==0.0||lons[2]==0.0||azel[1]<=0.0||azel[1]>90.0) {
+        printhelp();
+    }
+    opt=opts[i];
+    azel[0]*=D2R; azel[1]*=D2R;
+    nthread=nthread<1?1:(nthread>MAXTHREAD?MAXTHREAD:nthread);
+
+    if (trace>0) {
+        traceopen(PROGNAME ".trace");
+        tracelevel(trace);
+    }
+    init_nav(&nav);
+    if (*navfile&&readrnx(navfile,0,"",NULL,&nav,NULL)<=0) {
+        fprintf(stderr,"nav file read error: %s\n",navfile);
+        goto exit;
+    }
+    if (*tecfile) readtec(tecfile,&nav,0);
+    if (opt==IONOOPT_TEC&&nav.nt<=0) {
+        fprintf(stderr,"no ionex tec data: specify -tec\n");
+        goto exit;
+    }
+    /* day of the first ionex map or ephemeris if no start time */
+    if (ts.time==0) {
+        if      (nav.nt>0) time2epoch(nav.tec[0].time,es);
+        else if (nav.n >0) time2epoch(nav.eph[0].toe,es);
+        else {
+            fprintf(stderr,"no map epoch: specify -ts\n");
+            goto exit;
+        }
+        es[3]=es[4]=es[5]=0.0;
+        ts=epoch2time(es);
+    }
+    if (te.time==0) te=timeadd(ts,86400.0);
+    if ((n=(int)floor(timediff(te,ts)/tint+1E-6)+1)<=0) {
+        fprintf(stderr,"invalid map epochs\n");
+        goto exit;
+    }
+    /* broadcast parameters of the day, or sample ones if none */
+    time2epoch(ts,ep);
+    if (uniqion(ep,nav.ion_bdsk9)!=1&&opt==IONOOPT_BDSSH9) {
+        fprintf(stderr,"no bdssh9 parameters: specify -nav\n");
+        goto exit;
+    }
+    if (norm(nav.ion_gal,3)<=0.0) matcpy(nav.ion_gal,ai,3,1);
+
+    /* tec maps */
+    if (!(tec=(tec_t *)calloc(n,sizeof(tec_t)))) goto exit;
+    for (i=0;i<n;i++) {
+        time=timeadd(ts,tint*i);
+        tec[i].time=time;
+        tec[i].rb=RE_WGS84/1E3;
+        for (j=0;j<3;j++) {
+            tec[i].lats[j]=lats[j];
+            tec[i].lons[j]=lons[j];
+        }
+        tec[i].hgts[0]=tec[i].hgts[1]=hgt;
+        tec[i].ndata[0]=(int)floor((lats[1]-lats[0])/lats[2]+0.5)+1;
+        tec[i].ndata[1]=(int)floor((lons[1]-lons[0])/lons[2]+0.5)+1;
+        tec[i].ndata[2]=1;
+        nd=tec[i].ndata[0]*tec[i].ndata[1];
+        if (tec[i].ndata[0]<=1||tec[i].ndata[1]<=1||
+            !(tec[i].data=(double *)calloc(nd,sizeof(double)))||
+            !(tec[i].rms=(float *)calloc(nd,sizeof(float)))) {
+            fprintf(stderr,"invalid grid or memory allocation error\n");
+            n=i+1;
+            goto exit;
+        }
+    }
+    fprintf(stderr,"%s : %s %d maps of %dx%d grid by %d threads\n",PROGNAME,
+            model,n,tec[0].ndata[0],tec[0].ndata[1],nthread);
+
+    if (!genmaps(tec,n,opt,azel,&nav,nthread)) {
+        fprintf(stderr,"tec map generation error\n");
+        goto exit;
+    }
+    sprintf(comment,"%s model tec by ionocorr() (B1I)\n%s az=%.1f el=%.1f deg",
+            model,azel[1]>=90.0*D2R-1E-9?"vertical tec":"slant tec of rays",
+            azel[0]*R2D,azel[1]*R2D);
+
+    if (*outfile&&!writetec(outfile,tec,n,0,comment)) {
+        fprintf(stderr,"ionex file write error: %s\n",outfile);
+        goto exit;
+    }
+    if (*binfile&&!writetec(binfile,tec,n,1,NULL)) {
+        fprintf(stderr,"binary tec grid file write error: %s\n",binfile);
+        goto exit;
+    }
+    ret=1;
+exit:
+    if (tec) {
+        for (i=0;i<n;i++) {
+            free(tec[i].data); free(tec[i].rms);
+        }
+        free(tec);
+    }
+    for (i=0;i<nav.nt;i++) {
+        free(nav.tec[i].data); free(nav.tec[i].rms);
+    }
+    free(nav.eph); free(nav.geph); free(nav.seph); free(nav.tec);
+    free(nav.ion_bdsk9);
+    traceclose();
+    return ret?0:1;
+}
@@ -16,12 +16,27 @@
 *           2015/05/15  1.8 -r or -l options for fixed or ppp-fixed mode
 *           2015/06/12  1.9 output patch level in header
 *           2016/09/07  1.10 add option -sys
+*           2025/06/10  1.11 add option -batch and -j
+*           2025/06/18  1.12 epoch-parallel single point positioning by -j
+*           2025/06/25  1.13 add option -w
+*           2025/07/08  1.14 add option -cache
+*           2025/08/03  1.15 create output directories of batch stations
+*           2025/08/04  1.16 search batch obs files in directory tree
+*                           default of option -j to 1 (0: number of cpus)
 *-----------------------------------------------------------------------------*/
 #include <stdarg.h>
+#include <sys/stat.h>
 #include "rtklib.h"
+#ifndef WIN32
+#include <unistd.h>
+#include <dirent.h>
+#endif
 
 #define PROGNAME    "rnx2rtkp"          /* program name */
 #define MAXFILE     16                  /* max number of input files */
+#define MAXBATCH    1024                /* max number of batch stations */
+#define MAXDIRLEV   8                   /* max levels of batch directory tree */
+#define MAXTHREAD   64                  /* max number of batch threads */
 
 /* help text -----------------------------------------------------------------*/
 static const char *help[]={
@@ -70,8 +85,37 @@ static const char *help[]={
 " -l lat lon hgt reference (base) receiver latitude/longitude/height (deg/m)",
 "           rover latitude/longitude/height for fixed or ppp-fixed mode",
 " -y level  output soltion status (0:off,1:states,2:residuals) [0]",
-" -x level  debug trace level (0:off) [0]"
+" -x level  debug trace level (0:off) [0]",
+" -batch f  batch mode. process every station obs file listed in manifest f",
+"           (one path per line, # for comment) or found in directory tree f",
+"           (e.g. JBDH/yyyy/doy/, up to 8 levels, 1024 stations). the",
+"           input files are read once as shared nav/sp3/clk products and the",
+"           outputs of each station go to <out>/JBDH/yyyy/doy/ [off]",
+" -j n      number of threads. stations in batch mode, epochs of single point",
+"           positioning and pipelined input/output otherwise (0:number of",
+"           cpus) [1]",
+" -w n      read obs data of forward solutions as stream through a window of",
+"           n epochs instead of loading all of them (0:off) [0]",
+" -cache    read input files through binary cache files <file>.rtkc written",
+"           next to them at the first reading [off]"
 };
+/* batch processing type -----------------------------------------------------*/
+typedef struct {
+    char *files[MAXBATCH];  /* station observation files */
+    int n;                  /* number of stations */
+    int next;               /* next station to process */
+    int nok;                /* number of stations processed without error */
+    int obswin;             /* obs data stream window (epochs) (0:off) */
+    gtime_t ts,te;          /* processing start/end time */
+    double ti;              /* processing interval (s) */
+    prcopt_t popt;          /* processing options */
+    solopt_t sopt;          /* solution options */
+    filopt_t fopt;          /* file options */
+    const postprod_t *prod; /* shared products */
+    char outfile[1024];     /* output path (see OutfilePathSet()) */
+    char logfile[1024];     /* log path (see LogfilePathSet()) */
+    lock_t lock;            /* lock for station index and status output */
+} batch_t;
 /* show message --------------------------------------------------------------*/
 //0ǻ
 extern int showmsg(const char *format, ...)
@@ -92,6 +136,340 @@ static void printhelp(void)
     exit(0);
 }
 
+/* rinex observation file? ---------------------------------------------------*/
+static int isobsfile(const char *file)
+{
+    char name[1024],*ext;
+    
+    sprintf(name,"%.1023s",file);
+    if (!(ext=strrchr(name,'.'))) return 0;
+    
+    /* strip compression extension */
+    if (!strcmp(ext,".gz")||!strcmp(ext,".GZ")||!strcmp(ext,".Z")||
+        !strcmp(ext,".z")||!strcmp(ext,".zip")||!strcmp(ext,".ZIP")) {
+        *ext='\0';
+        if (!(ext=strrchr(name,'.'))) return 0;
+    }
+    if (strlen(ext)==4&&isdigit((int)ext[1])&&isdigit((int)ext[2])&&
+        (ext[3]=='o'||ext[3]=='O'||ext[3]=='d'||ext[3]=='D')) return 1;
+    return strstr(name,"_MO.rnx")||strstr(name,"_MO.RNX")||
+           strstr(name,"_MO.crx")||strstr(name,"_MO.CRX");
+}
+/* add batch station ---------------------------------------------------------*/
+static int addbatch(batch_t *batch, const char *file)
+{
+    if (batch->n>=MAXBATCH) return 0;
+    if (!(batch->files[batch->n]=(char *)malloc(strlen(file)+1))) return 1;
+    strcpy(batch->files[batch->n++],file);
+    return 1;
+}
+/* search obs files in directory tree ----------------------------------------*/
+static int searchobs(const char *dir, int level, batch_t *batch);
+
+static int searchent(const char *dir, const char *name, int level,
+                     batch_t *batch)
+{
+    struct stat st;
+    char path[1024];
+    
+    if (*name=='.') return 1;
+    sprintf(path,"%.767s%c%.255s",dir,FILEPATHSEP,name);
+    if (stat(path,&st)) return 1;
+    if (st.st_mode&S_IFDIR) {
+        return level<MAXDIRLEV?searchobs(path,level+1,batch):1;
+    }
+    return isobsfile(path)?addbatch(batch,path):1;
+}
+static int searchobs(const char *dir, int level, batch_t *batch)
+{
+    int stat=1;
+#ifdef WIN32
+    WIN32_FIND_DATA file;
+    HANDLE h;
+    char path[1024];
+    
+    sprintf(path,"%.1020s%c*",dir,FILEPATHSEP);
+    if ((h=FindFirstFile((LPCTSTR)path,&file))==INVALID_HANDLE_VALUE) return 1;
+    do {
+        stat=searchent(dir,file.cFileName,level,batch);
+    } while (stat&&FindNextFile(h,&file));
+    FindClose(h);
+#else
+    struct dirent *d;
+    DIR *dp;
+    
+    if (!(dp=opendir(dir))) return 1;
+    while (stat&&(d=readdir(dp))) {
+        stat=searchent(dir,d->d_name,level,batch);
+    }
+    closedir(dp);
+#endif
+    return stat;
+}
+/* compare batch station files -----------------------------------------------*/
+static int cmpfile(const void *p1, const void *p2)
+{
+    return strcmp(*(char **)p1,*(char **)p2);
+}
+/* read batch station list from manifest or directory tree -------------------*/
+static int readbatch(const char *path, batch_t *batch)
+{
+    struct stat st;
+    FILE *fp;
+    char buff[1024],*p;
+    int stat_=1;
+    
+    batch->n=0;
+    
+    if (!stat(path,&st)&&(st.st_mode&S_IFDIR)) {
+        stat_=searchobs(path,0,batch);
+        qsort(batch->files,batch->n,sizeof(char *),cmpfile);
+    }
+    else {
+        if (!(fp=fopen(path,"r"))) {
+            showmsg("error : batch list open error %s\n",path);
+            return 0;
+        }
+        while (stat_&&fgets(buff,sizeof(buff),fp)) {
+            if ((p=strchr(buff,'#'))) *p='\0';
+            for (p=buff+strlen(buff)-1;p>=buff&&isspace((int)*p);p--) *p='\0';
+            for (p=buff;isspace((int)*p);p++) ;
+            if (*p) stat_=addbatch(batch,p);
+        }
+        fclose(fp);
+    }
+    if (!stat_) {
+        showmsg("warning : batch stations truncated to %d %s\n",MAXBATCH,path);
+    }
+    return batch->n;
+}
+/* create directories of file path -----------------------------------------*/
+static void makedirs(const char *file)
+{
+    char dir[1024],*p,c;
+    
+    sprintf(dir,"%.1023s",file);
+    
+    for (p=dir+1;*p;p++) {
+        if (*p!='/'&&*p!='\\') continue;
+        c=*p; *p='\0';
+#ifdef WIN32
+        CreateDirectory(dir,NULL);
+#else
+        mkdir(dir,0777);
+#endif
+        *p=c;
+    }
+}
+/* process one station of batch ----------------------------------------------*/
+static void procsta(batch_t *batch, const char *file)
+{
+    postctx_t *ctx;
+    prcopt_t popt=batch->popt;
+    struct stat st;
+    FILE *fp;
+    char *sfile[2],outfile[1024],logfile[1024],stm[64];
+    const char *infile[1];
+    unsigned int tick=tickget();
+    time_t t0;
+    int ret=-1;
+    
+    time(&t0);
+    strftime(stm,sizeof(stm),"%Y-%m-%d %H:%M:%S|",localtime(&t0));
+    
+    if (!(fp=fopen(file,"r"))) {
+        lock(&batch->lock);
+        fprintf(stdout,"%-48s : error : no obs file\n",file);
+        unlock(&batch->lock);
+        return;
+    }
+    fclose(fp);
+    
+    /* station position, antenna and output paths from obs header */
+    sfile[0]=sfile[1]=(char *)file;
+    strcpy(outfile,batch->outfile);
+    strcpy(logfile,batch->logfile);
+    ReadPosAndAnt(sfile,&popt);
+    OutfilePathSet(sfile,outfile,popt);
+    LogfilePathSet(sfile,logfile,popt);
+    infile[0]=file;
+    if (*outfile) makedirs(outfile);
+    
+    if ((ctx=(postctx_t *)malloc(sizeof(postctx_t)))) {
+        init_postctx(ctx);
+        ctx->prod=batch->prod;
+        ctx->obswin=batch->obswin;
+        ret=postpos_ctx(ctx,batch->ts,batch->te,batch->ti,0.0,&popt,&batch->sopt,
+                        &batch->fopt,infile,1,outfile,"","");
+        free_postctx(ctx);
+        
+        if (ret!=0) { /* retry with default settings as single station mode */
+            lock(&batch->lock);
+            OutLog(stm,t0,logfile,popt,ret);
+            unlock(&batch->lock);
+            popt.navsys=SYS_GPS|SYS_GLO|SYS_CMP|SYS_GAL;
+            popt.freqopt=5;
+            popt.ionoopt=IONOOPT_IFLC;
+            init_postctx(ctx);
+            ctx->prod=batch->prod;
+            ctx->obswin=batch->obswin;
+            ret=postpos_ctx(ctx,batch->ts,batch->te,batch->ti,0.0,&popt,
+                            &batch->sopt,&batch->fopt,infile,1,outfile,"","");
+            free_postctx(ctx);
+        }
+        free(ctx);
+    }
+    /* no solution file if output open error in postpos_ctx() */
+    if (!ret&&*outfile&&(stat(outfile,&st)||st.st_mtime<t0)) ret=-1;
+    
+    lock(&batch->lock);
+    OutLog(stm,t0,logfile,popt,ret);
+    if (!ret) batch->nok++;
+    fprintf(stdout,"%-48s : stat=%d time=%6.1fs out=%s\n",file,ret,
+            (tickget()-tick)*1E-3,outfile);
+    fflush(stdout);
+    unlock(&batch->lock);
+}
+/* batch worker thread -------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI batchthread(void *arg)
+#else
+static void *batchthread(void *arg)
+#endif
+{
+    batch_t *batch=(batch_t *)arg;
+    int i;
+    
+    for (;;) {
+        lock(&batch->lock);
+        i=batch->next++;
+        unlock(&batch->lock);
+        if (i>=batch->n) break;
+        procsta(batch,batch->files[i]);
+    }
+    return 0;
+}
+/* execute batch processing --------------------------------------------------
+* process the stations of a batch on a pool of nthread threads. the nav and
+* product files in infile are read once and shared by all of the stations.
+* the debug trace and the solution status are process-wide, so they are off
+* in batch mode and the geoid file is opened here once for all stations.
+*-----------------------------------------------------------------------------*/
+static int execbatch(const char *list, int nthread, int obswin, gtime_t ts, gtime_t te,
+                     double ti, const prcopt_t *popt, const solopt_t *sopt,
+                     const filopt_t *fopt, const char **infile, int n,
+                     const char *outfile, const char *logfile)
+{
+    batch_t *batch;
+    postprod_t *prod;
+    thread_t thread[MAXTHREAD];
+    unsigned int tick=tickget();
+    int i,nok,nt=0,geoid=0;
+    
+    if (!(batch=(batch_t *)calloc(1,sizeof(batch_t)))||
+        !(prod=(postprod_t *)calloc(1,sizeof(postprod_t)))) {
+        free(batch);
+        showmsg("error : memory allocation\n");
+        return -1;
+    }
+    if (!readbatch(list,batch)) {
+        showmsg("error : no station in batch %s\n",list);
+        free(batch); free(prod);
+        return -2;
+    }
+    batch->ts=ts; batch->te=te; batch->ti=ti;
+    batch->obswin=obswin;
+    batch->popt=*popt;
+    batch->sopt=*sopt;
+    batch->fopt=*fopt;
+    batch->sopt.trace=-1;
+    batch->sopt.sstat=0;
+    strcpy(batch->outfile,outfile);
+    strcpy(batch->logfile,logfile);
+    
+    /* station position and antenna delta are taken from each obs header */
+    for (i=0;i<3;i++) batch->popt.ru[i]=batch->popt.antdel[0][i]=0.0;
+    
+    if (batch->sopt.geoid>0&&*fopt->geoid) {
+        if (!(geoid=opengeoid(batch->sopt.geoid,fopt->geoid))) {
+            showmsg("error : no geoid data %s\n",fopt->geoid);
+        }
+        batch->fopt.geoid[0]='\0';
+    }
+    fprintf(stdout,"batch : reading products (%d files)...\n",n);
+    if (!readpostprod(prod,infile,n,&batch->popt,&batch->fopt)) {
+        freepostprod(prod);
+        for (i=0;i<batch->n;i++) free(batch->files[i]);
+        free(batch); free(prod);
+        if (geoid) closegeoid();
+        return -1;
+    }
+    batch->prod=prod;
+    initlock(&batch->lock);
+    
+    if (nthread<1) nthread=1;
+    if (nthread>MAXTHREAD) nthread=MAXTHREAD;
+    if (nthread>batch->n) nthread=batch->n;
+    fprintf(stdout,"batch : %d stations, %d threads\n",batch->n,nthread);
+    
+    for (i=0;i<nthread;i++) {
+#ifdef WIN32
+        if (!(thread[nt]=CreateThread(NULL,0,batchthread,batch,0,NULL))) break;
+#else
+        if (pthread_create(thread+nt,NULL,batchthread,batch)) break;
+#endif
+        nt++;
+    }
+    if (nt==0) batchthread(batch); /* no thread available */
+    
+    for (i=0;i<nt;i++) {
+#ifdef WIN32
+        WaitForSingleObject(thread[i],INFINITE);
+        CloseHandle(thread[i]);
+#else
+        pthread_join(thread[i],NULL);
+#endif
+    }
+    nok=batch->nok;
+    fprintf(stdout,"batch : %d/%d stations ok, time=%.1fs\n",nok,batch->n,
+            (tickget()-tick)*1E-3);
+    
+    freepostprod(prod);
+    if (geoid) closegeoid();
+    for (i=0;i<batch->n;i++) free(batch->files[i]);
+    n=batch->n;
+    free(batch); free(prod);
+    return nok==n?0:1;
+}
+/* post-processing of one session --------------------------------------------*/
+static int procses(int nthread, int obswin, gtime_t ts, gtime_t te, double ti,
+                   const prcopt_t *popt, const solopt_t *sopt, const filopt_t *fopt,
+                   const char **infile, int n, const char *outfile)
+{
+    postctx_t *ctx;
+    int ret;
+    
+    if (!(ctx=(postctx_t *)malloc(sizeof(postctx_t)))) return -1;
+    init_postctx(ctx);
+    ctx->nthread=nthread;
+    ctx->obswin=obswin;
+    ret=postpos_ctx(ctx,ts,te,ti,0.0,popt,sopt,fopt,infile,n,outfile,"","");
+    free_postctx(ctx);
+    free(ctx);
+    return ret;
+}
+/* number of cpus ------------------------------------------------------------*/
+static int numcpu(void)
+{
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n=sysconf(_SC_NPROCESSORS_ONLN);
+    return n>0?(int)n:1;
+#endif
+}
 /* rnx2rtkp main -------------------------------------------------------------*/
 int main(int argc, char ** argv)
 {
@@ -100,11 +478,11 @@ int main(int argc, char ** argv)
     filopt_t filopt={""};   /* file options type */
     gtime_t ts={0},te={0};
     double tint=0.0,es[]={2000,1,1,0,0,0},ee[]={2000,12,31,23,59,59},pos[3];
-    int i,j,n,ret;
+    int i,j,n,ret,nthread=1,obswin=0;
 	char ifs[MAXFILE][1024], cfgfile[1024];
     char* infile[MAXFILE] = { NULL }, * p;
-    char outfile[1024];
-    char logfile[1024]; // ڴ洢־ļ·
+    char outfile[1024]="", batchfile[1024]="";
+    char logfile[1024]=""; // ڴ洢־ļ·
 
     char stm[64] = { 0 }; // ڴ洢ʼʱַ
     time_t StartTime, EndTime;
@@ -190,6 +568,10 @@ int main(int argc, char ** argv)
         }
         else if (!strcmp(argv[i],"-y")&&i+1<argc) solopt.sstat=atoi(argv[++i]);
         else if (!strcmp(argv[i],"-x")&&i+1<argc) solopt.trace=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-batch")&&i+1<argc) strcpy(batchfile,argv[++i]);
+        else if (!strcmp(argv[i],"-j")&&i+1<argc) nthread=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-w")&&i+1<argc) obswin=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-cache")) setrdcache(1);
         else if (*argv[i]=='-') printhelp();
         else if (n<MAXFILE) infile[n++]=argv[i];
     }
@@ -200,6 +582,17 @@ int main(int argc, char ** argv)
         n = loadfiles(cfgfile, sysopts, infile, outfile, logfile);     //nΪļĿ
         for (int i = n; i < MAXFILE; i++)infile[i] = { NULL }; //ʣļ
 	}
+    if (nthread<=0) nthread=numcpu();
+    
+    /* batch processing of many stations with shared products */
+    if (*batchfile) {
+        const char *prodfile[MAXFILE];
+        for (i = 0; i < n; i++) prodfile[i] = infile[i];
+        if (!prcopt.navsys) prcopt.navsys = SYS_GPS;
+        solopt.navsys = prcopt.navsys;
+        return execbatch(batchfile, nthread, obswin, ts, te, tint, &prcopt, &solopt, &filopt,
+                         prodfile, n, outfile, logfile);
+    }
 
     ret = ReadPosAndAnt(infile, &prcopt);
     ret = OutfilePathSet(infile, outfile, prcopt);
@@ -226,14 +619,14 @@ int main(int argc, char ** argv)
 	solopt.navsys = prcopt.navsys;
 
     /* ret-״̬ 0:㣬1:޿ǣ */
-    ret = postpos(ts, te, tint, 0.0, &prcopt, &solopt, &filopt, real_infile, n, real_outfile, "", "");
+    ret = procses(nthread, obswin, ts, te, tint, &prcopt, &solopt, &filopt, real_infile, n, real_outfile);
     if (ret != 0)
     {
         OutLog(stm, EndTime, real_logfile, prcopt, ret);
         prcopt.navsys = SYS_GPS | SYS_GLO | SYS_CMP | SYS_GAL;
         prcopt.freqopt = 5;
         prcopt.ionoopt = IONOOPT_IFLC;
-        ret = postpos(ts, te, tint, 0.0, &prcopt, &solopt, &filopt, real_infile, n, real_outfile, "", "");
+        ret = procses(nthread, obswin, ts, te, tint, &prcopt, &solopt, &filopt, real_infile, n, real_outfile);
     }
     
     OutLog(stm, EndTime, real_logfile, prcopt, ret);
@@ -12,9 +12,7 @@ if errorlevel 1 (
 
 REM 编译主程序
 echo 编译主程序...
-g++ -o rnx2rtkp.exe ^
-    app/main/rnx2rtkp.cpp ^
-    src/bdgim.cpp ^
+set SRCS=src/bdgim.cpp ^
     src/bdssh.cpp ^
     src/common.cpp ^
     src/datum.cpp ^
@@ -43,6 +41,9 @@ g++ -o rnx2rtkp.exe ^
     src/test_src.cpp ^
     src/tides.cpp ^
     src/tle.cpp ^
+    src/uncomp.cpp ^
+    src/rdcache.cpp ^
+    src/chebeph.cpp ^
     src/Nequick/nequick_test.cpp ^
     src/Nequick/lib/NeQuickG_JRC.c ^
     src/Nequick/lib/CCIR/NeQuickG_JRC_CCIR.c ^
@@ -83,8 +84,8 @@ g++ -o rnx2rtkp.exe ^
     src/Nequick/lib/NeQuickG_JRC_TEC_integration.c ^
     src/Nequick/lib/NeQuickG_JRC_time.c ^
     src/Nequick/ionmodel_nequick.c ^
-    src/Nequick/ITU_R_P_371_8.c ^
-    -I src ^
+    src/Nequick/lib/ITU_R_P_371_8.c
+set OPTS=-I src ^
     -I src/Nequick/lib/private ^
     -I src/Nequick/lib/public ^
     -D WIN32 ^
@@ -98,16 +99,37 @@ g++ -o rnx2rtkp.exe ^
     -D TRACE ^
     -std=c++11 ^
     -O2
+g++ -o rnx2rtkp.exe app/main/rnx2rtkp.cpp %SRCS% %OPTS%
 
 if errorlevel 1 (
     echo 编译失败！
     pause
     exit /b 1
-) else (
-    echo 编译成功！生成 rnx2rtkp.exe
-    echo.
-    echo 运行程序...
-    rnx2rtkp.exe -k IGS-Data/GNSS_Option.opt -x 5
 )
 
+REM 编译工具程序
+echo 编译工具程序...
+g++ -o ionmap.exe app/ionmap/ionmap.cpp %SRCS% %OPTS%
+if errorlevel 1 (
+    echo 编译失败！
+    pause
+    exit /b 1
+)
+g++ -o rtkbench.exe app/bench/rtkbench.cpp %SRCS% %OPTS%
+if errorlevel 1 (
+    echo 编译失败！
+    pause
+    exit /b 1
+)
+g++ -o chebfit.exe app/chebfit/chebfit.cpp %SRCS% %OPTS%
+if errorlevel 1 (
+    echo 编译失败！
+    pause
+    exit /b 1
+)
+echo 编译成功！生成 rnx2rtkp.exe ionmap.exe rtkbench.exe chebfit.exe
+echo.
+echo 运行程序...
+rnx2rtkp.exe -k IGS-Data/GNSS_Option.opt -x 5
+
 pause
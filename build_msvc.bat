@@ -13,9 +13,7 @@ if errorlevel 1 (
 
 REM 编译主程序
 echo 编译主程序...
-cl /Fe:rnx2rtkp.exe ^
-    app/main/rnx2rtkp.cpp ^
-    src/bdgim.cpp ^
+set SRCS=src/bdgim.cpp ^
     src/bdssh.cpp ^
     src/common.cpp ^
     src/datum.cpp ^
@@ -44,6 +42,9 @@ cl /Fe:rnx2rtkp.exe ^
     src/test_src.cpp ^
     src/tides.cpp ^
     src/tle.cpp ^
+    src/uncomp.cpp ^
+    src/rdcache.cpp ^
+    src/chebeph.cpp ^
     src/Nequick/nequick_test.cpp ^
     src/Nequick/NeQuickG_JRC.c ^
     src/Nequick/NeQuickG_JRC_CCIR.c ^
@@ -82,8 +83,8 @@ cl /Fe:rnx2rtkp.exe ^
     src/Nequick/NeQuickG_JRC_solar.c ^
     src/Nequick/NeQuickG_JRC_solar_activity.c ^
     src/Nequick/NeQuickG_JRC_TEC_integration.c ^
-    src/Nequick/NeQuickG_JRC_time.c ^
-    /I src ^
+    src/Nequick/NeQuickG_JRC_time.c
+set OPTS=/I src ^
     /I src/Nequick/lib/private ^
     /I src/Nequick/lib/public ^
     /D WIN32 ^
@@ -97,18 +98,39 @@ cl /Fe:rnx2rtkp.exe ^
     /D TRACE ^
     /std:c++11 ^
     /O2
+cl /Fe:rnx2rtkp.exe app/main/rnx2rtkp.cpp %SRCS% %OPTS%
 
 if errorlevel 1 (
     echo 编译失败！
     pause
     exit /b 1
-) else (
-    echo 编译成功！生成 rnx2rtkp.exe
-    echo.
-    echo 运行程序...
-    rnx2rtkp.exe -k IGS-Data/GNSS_Option.opt -x 5
 )
 
+REM 编译工具程序
+echo 编译工具程序...
+cl /Fe:ionmap.exe app/ionmap/ionmap.cpp %SRCS% %OPTS%
+if errorlevel 1 (
+    echo 编译失败！
+    pause
+    exit /b 1
+)
+cl /Fe:rtkbench.exe app/bench/rtkbench.cpp %SRCS% %OPTS%
+if errorlevel 1 (
+    echo 编译失败！
+    pause
+    exit /b 1
+)
+cl /Fe:chebfit.exe app/chebfit/chebfit.cpp %SRCS% %OPTS%
+if errorlevel 1 (
+    echo 编译失败！
+    pause
+    exit /b 1
+)
+echo 编译成功！生成 rnx2rtkp.exe ionmap.exe rtkbench.exe chebfit.exe
+echo.
+echo 运行程序...
+rnx2rtkp.exe -k IGS-Data/GNSS_Option.opt -x 5
+
 pause
 
 
@@ -43,6 +43,9 @@ g++ -c -o solution.o src/solution.cpp -I src -I src/Nequick/lib/private -I src/N
 g++ -c -o test_src.o src/test_src.cpp -I src -I src/Nequick/lib/private -I src/Nequick/lib/public -D WIN32 -D NDEBUG -D _CONSOLE -D _CRT_SECURE_NO_DEPRECATE -D ENAGLO -D ENACMP -D ENAGAL -D NFREQ=6 -D TRACE -std=c++11 -O2
 g++ -c -o tides.o src/tides.cpp -I src -I src/Nequick/lib/private -I src/Nequick/lib/public -D WIN32 -D NDEBUG -D _CONSOLE -D _CRT_SECURE_NO_DEPRECATE -D ENAGLO -D ENACMP -D ENAGAL -D NFREQ=6 -D TRACE -std=c++11 -O2
 g++ -c -o tle.o src/tle.cpp -I src -I src/Nequick/lib/private -I src/Nequick/lib/public -D WIN32 -D NDEBUG -D _CONSOLE -D _CRT_SECURE_NO_DEPRECATE -D ENAGLO -D ENACMP -D ENAGAL -D NFREQ=6 -D TRACE -std=c++11 -O2
+g++ -c -o uncomp.o src/uncomp.cpp -I src -I src/Nequick/lib/private -I src/Nequick/lib/public -D WIN32 -D NDEBUG -D _CONSOLE -D _CRT_SECURE_NO_DEPRECATE -D ENAGLO -D ENACMP -D ENAGAL -D NFREQ=6 -D TRACE -std=c++11 -O2
+g++ -c -o rdcache.o src/rdcache.cpp -I src -I src/Nequick/lib/private -I src/Nequick/lib/public -D WIN32 -D NDEBUG -D _CONSOLE -D _CRT_SECURE_NO_DEPRECATE -D ENAGLO -D ENACMP -D ENAGAL -D NFREQ=6 -D TRACE -std=c++11 -O2
+g++ -c -o chebeph.o src/chebeph.cpp -I src -I src/Nequick/lib/private -I src/Nequick/lib/public -D WIN32 -D NDEBUG -D _CONSOLE -D _CRT_SECURE_NO_DEPRECATE -D ENAGLO -D ENACMP -D ENAGAL -D NFREQ=6 -D TRACE -std=c++11 -O2
 
 echo 所有源文件编译完成！
 
@@ -22,7 +22,7 @@ if errorlevel 1 (
     echo 链接失败！检查错误信息...
     echo.
     echo 尝试使用现有的.o文件进行链接...
-    g++ -o rnx2rtkp.exe main.o bdgim.o bdssh.o common.o datum.o DBSCAN.o ephemeris.o geoid.o ionex.o lambda.o options.o pntpos.o postpos.o ppp.o ppp_ar.o ppp_corr.o preceph.o qzslex.o rinex.o rtcm.o rtcm2.o rtcm3.o rtcm3e.o rtkcmn.o rtkpos.o sbas.o solution.o test_src.o tides.o tle.o
+    g++ -o rnx2rtkp.exe main.o bdgim.o bdssh.o common.o datum.o DBSCAN.o ephemeris.o geoid.o ionex.o lambda.o options.o pntpos.o postpos.o ppp.o ppp_ar.o ppp_corr.o preceph.o qzslex.o rinex.o rtcm.o rtcm2.o rtcm3.o rtcm3e.o rtkcmn.o rtkpos.o sbas.o solution.o test_src.o tides.o tle.o uncomp.o rdcache.o chebeph.o
 ) else (
     echo 链接成功！生成 rnx2rtkp.exe
     echo.
@@ -2,8 +2,6 @@
 #include "DBSCAN.h"  
 
 
-int clusterID = 0;
-
 void point::init()
 {
 	cluster = 0;
@@ -106,7 +104,7 @@ double  DBSCAN(vector<point> dataset, float Eps, int MinPts){
 	{
 		dataset[i].init();
 	}
-	clusterID = 0;
+	int clusterID = 0;
 	vector<vector <float>> distP2P(len);
 
 	//calculate pts  
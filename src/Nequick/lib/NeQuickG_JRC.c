@@ -50,12 +50,20 @@ static double_t get_modip_interface(NeQuickG_handle handle) {
  * @see {@link get_modip_impl}
  * @see {@link solar_activity_get}
  *
+ * The solar activity depends only on the coefficients and on the station,
+ * so it is kept until one of them is set again.
+ *
  * @param[in, out] pContext NeQuick context
  */
 static void get_solar_activity(
   NeQuickG_context_t* const pContext) {
+  if (pContext->is_solar_activity_valid) {
+    input_data_to_km(&pContext->input_data);
+    return;
+  }
   get_modip_impl(pContext);
   solar_activity_get(&pContext->solar_activity, pContext->modip.modip_degree);
+  pContext->is_solar_activity_valid = true;
 }
 
 /** Checks if the handle is valid
@@ -107,6 +115,14 @@ static int32_t init(
   NeQuickG_context_t* pContext = (NeQuickG_context_t*)(*pHandle);
   assert(pContext);
 
+  pContext->is_solar_activity_valid = false;
+  {
+    const NeQuickG_integration_t integration = NEQUICKG_INTEGRATION_REFERENCE;
+    pContext->integration = integration;
+  }
+  modip_cache_init(&pContext->modip);
+  NeQuickG_time_init(&pContext->input_data.time);
+
   int32_t ret;
 
 #ifndef FTR_MODIP_CCIR_AS_CONSTANTS
@@ -151,6 +167,8 @@ static int32_t set_solar_activity_coefficients(
     return ret;
   }
 
+  ((NeQuickG_context_t*)handle)->is_solar_activity_valid = false;
+
   return solar_activity_coefficients_set(
     &((NeQuickG_context_t*)handle)->solar_activity,
     pCoeff, coeff_count);
@@ -200,9 +218,14 @@ static int32_t set_time(
   }
 
   NeQuickG_context_t* pContext = (NeQuickG_context_t*)(handle);
-  ret = NeQuickG_time_set(&pContext->input_data.time, month, UTC);
 
-  pContext->profile.E.is_solar_declination_valid = false;
+  // the solar declination is kept while the time does not change
+  if ((pContext->input_data.time.month != month) ||
+      (pContext->input_data.time.utc != UTC)) {
+    pContext->profile.E.is_solar_declination_valid = false;
+  }
+
+  ret = NeQuickG_time_set(&pContext->input_data.time, month, UTC);
 
   return ret;
 }
@@ -220,6 +243,7 @@ static int32_t set_station_position(
   }
 
   NeQuickG_context_t* pContext = (NeQuickG_context_t*)(handle);
+  pContext->is_solar_activity_valid = false;
   return position_set(
     &pContext->input_data.station_position,
     longitude_degree,
@@ -249,6 +273,29 @@ static int32_t set_satellite_position(
     NEQUICK_G_JRC_HEIGHT_UNITS_METERS);
 }
 
+/** {@ref NeQuickG_library.set_integration} */
+static int32_t set_integration(
+  const NeQuickG_handle handle,
+  const NeQuickG_integration_t* const pIntegration) {
+
+  int32_t ret = check_handle(handle);
+  if (ret != NEQUICK_OK) {
+    return ret;
+  }
+
+  if (!pIntegration ||
+      !(pIntegration->tolerance_factor > 0.0) ||
+      !(pIntegration->profile_reuse_km >= 0.0)) {
+    NEQUICK_ERROR_RETURN(
+      NEQUICK_ERROR_SRC_INPUT_DATA,
+      NEQUICK_ERROR_CODE_BAD_INTEGRATION,
+      "Bad integration settings");
+  }
+
+  ((NeQuickG_context_t*)handle)->integration = *pIntegration;
+  return NEQUICK_OK;
+}
+
 /** {@ref NeQuickG_library.input_data_to_std_output} */
 static void input_data_to_std_output_impl(NeQuickG_chandle handle) {
   if (handle == NEQUICKG_INVALID_HANDLE) {
@@ -302,6 +349,7 @@ const struct NeQuickG_library NeQuickG = {
   .set_time = set_time,
   .set_receiver_position = set_station_position,
   .set_satellite_position = set_satellite_position,
+  .set_integration = set_integration,
   .get_modip = get_modip_interface,
   .get_total_electron_content = get_total_electron_content,
   .input_data_to_std_output = input_data_to_std_output_impl,
@@ -111,17 +111,28 @@ static bool is_error_within_tolerance(
 
 static int32_t get_total_electron_content(
   NeQuickG_context_t* const pNequick_Context,
-  double_t height_km,
+  const double_t* const pHeight_km,
   double_t* const pTotal_electron_content) {
 
   if (pNequick_Context->ray.is_vertical) {
-    *pTotal_electron_content = ray_vertical_get_electron_density(
-      pNequick_Context, height_km);
+    ray_vertical_get_electron_densities(
+      pNequick_Context,
+      pHeight_km,
+      NEQUICK_G_JRC_KRONROD_K15_POINT_COUNT,
+      pTotal_electron_content);
     return NEQUICK_OK;
-  } else {
-    return ray_slant_get_electron_density(
-      pNequick_Context, height_km, pTotal_electron_content);
   }
+
+  // each point of a slant ray has its own profile
+  size_t i;
+  for (i = 0; i < NEQUICK_G_JRC_KRONROD_K15_POINT_COUNT; i++) {
+    int32_t ret = ray_slant_get_electron_density(
+      pNequick_Context, pHeight_km[i], &pTotal_electron_content[i]);
+    if (ret != NEQUICK_OK) {
+      return ret;
+    }
+  }
+  return NEQUICK_OK;
 }
 
 int32_t Gauss_Kronrod_integrate(
@@ -140,23 +151,27 @@ int32_t Gauss_Kronrod_integrate(
   double_t G7_integration = 0.0;
   size_t G7_index = 0;
 
+  double_t height_km[NEQUICK_G_JRC_KRONROD_K15_POINT_COUNT];
+  double_t total_electron_content[NEQUICK_G_JRC_KRONROD_K15_POINT_COUNT];
+
   size_t i;
   for (i = 0; i < NEQUICK_G_JRC_KRONROD_K15_POINT_COUNT; i++) {
+    height_km[i] = mid_point + (half_diff * xi[i]);
+  }
 
-    double_t height_km = mid_point + (half_diff * xi[i]);
+  int32_t ret =
+    get_total_electron_content(
+      pNequick_Context, height_km, total_electron_content);
+  if (ret != NEQUICK_OK) {
+    return ret;
+  }
 
-    double_t total_electron_content;
-    int32_t ret =
-      get_total_electron_content(
-        pNequick_Context, height_km, &total_electron_content);
-    if (ret != NEQUICK_OK) {
-      return ret;
-    }
+  for (i = 0; i < NEQUICK_G_JRC_KRONROD_K15_POINT_COUNT; i++) {
 
-    K15_integration += (total_electron_content * wi[i]);
+    K15_integration += (total_electron_content[i] * wi[i]);
 
     if (IS_ODD(i)) {
-      G7_integration += (total_electron_content * wig[G7_index]);
+      G7_integration += (total_electron_content[i] * wig[G7_index]);
       G7_index++;
     }
   }
@@ -186,8 +201,6 @@ int32_t Gauss_Kronrod_integrate(
 
     double_t result;
 
-    int32_t ret;
-
     ret = Gauss_Kronrod_integrate(
       pContext,
       pNequick_Context,
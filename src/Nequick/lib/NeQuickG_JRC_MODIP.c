@@ -59,3 +59,20 @@ void modip_get(
   modip_grid_interpolate(
     &pContext->grid, pPosition, &pContext->modip_degree);
 }
+
+void modip_cache_init(modip_context_t* const pContext) {
+  modip_grid_cache_init(&pContext->cache);
+}
+
+void modip_get_cached(
+  modip_context_t* const pContext,
+  const position_t* const pPosition) {
+
+  if (handle_special_lat_cases(pContext, pPosition)) {
+    return;
+  }
+
+  modip_grid_interpolate_cached(
+    &pContext->grid, &pContext->cache,
+    pPosition, &pContext->modip_degree);
+}
@@ -282,4 +282,89 @@ void modip_grid_interpolate(
   *pModip_degree = grid_2D_interpolation(pGrid, &longitude, &latitude);
 }
 
+void modip_grid_cache_init(modip_grid_cache_t* const pCache) {
+  for (size_t i = 0;
+        i < NEQUICK_G_JRC_MODIP_GRID_CACHE_CELL_COUNT; i++) {
+    pCache->cell[i].is_valid = false;
+  }
+}
+
+#ifdef FTR_MODIP_CCIR_AS_CONSTANTS
+#define grid_get_cell(pGrid, pCache, pLongitude, pLatitude) \
+  grid_get_cell(pCache, pLongitude, pLatitude)
+#endif
+
+/** Returns the cell of the grid positions,
+ * computing the latitude interpolation of its columns if not cached
+ */
+static const modip_grid_cell_t* grid_get_cell(
+  const modip_grid_t* const pGrid,
+  modip_grid_cache_t* const pCache,
+  const grid_position_t* const pLongitude,
+  const grid_position_t* const pLatitude) {
+
+  modip_grid_cell_t* pCell =
+    &pCache->cell[(pLatitude->index + pLongitude->index) %
+                  NEQUICK_G_JRC_MODIP_GRID_CACHE_CELL_COUNT];
+
+  if (pCell->is_valid &&
+      (pCell->latitude_index == pLatitude->index) &&
+      (pCell->longitude_index == pLongitude->index)) {
+    return pCell;
+  }
+
+  for (size_t i = 0;
+        i < NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT; i++) {
+    double_t
+      lat_interpol_points[NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT];
+    size_t lat_grid_index = pLatitude->index;
+    for (size_t j = 0;
+          j < NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT; j++) {
+      lat_interpol_points[j] =
+#ifdef FTR_MODIP_CCIR_AS_CONSTANTS
+        g_corrected_modip_degree
+#else
+        pGrid->corrected_modip_degree
+#endif
+          [lat_grid_index++]
+          [pLongitude->index + i];
+    }
+    interpolation_third_order_get_coefficients(
+      lat_interpol_points,
+      &pCell->latitude[i]);
+  }
+  pCell->latitude_index = pLatitude->index;
+  pCell->longitude_index = pLongitude->index;
+  pCell->is_valid = true;
+  return pCell;
+}
+
+void modip_grid_interpolate_cached(
+  const modip_grid_t* const pGrid,
+  modip_grid_cache_t* const pCache,
+  const position_t* const pPosition,
+  double_t *pModip_degree) {
+
+  grid_position_t longitude;
+  grid_get_long_position(pPosition->longitude.degree, &longitude);
+
+  grid_position_t latitude;
+  grid_get_lat_position(pPosition->latitude.degree, &latitude);
+
+  const modip_grid_cell_t* const pCell =
+    grid_get_cell(pGrid, pCache, &longitude, &latitude);
+
+  double_t
+    lon_interpol_points[NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT];
+
+  for (size_t i = 0;
+        i < NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT; i++) {
+    lon_interpol_points[i] = interpolation_third_order_get(
+                              &pCell->latitude[i], latitude.offset);
+  }
+  *pModip_degree = interpolation_third_order(
+    lon_interpol_points,
+    longitude.offset);
+}
+
 #undef NEQUICK_G_JRC_MODIP_GRID_LONG_UNIQUE_COUNT
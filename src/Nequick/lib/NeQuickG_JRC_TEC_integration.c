@@ -67,6 +67,13 @@ static double_t get_point_zero_height(
   return get_point_height(pContext, temp);
 }
 
+/** Integrates a segment with the integration settings of the context.
+ *
+ * The adaptive integration uses the segment tolerance scaled by the
+ * tolerance factor. The fixed-order integration splits the segment in
+ * equal intervals and takes the K15 result of each one, the tolerance
+ * is not used.
+ */
 static int32_t Gauss_Kronrod_integrate_impl(
   gauss_kronrod_context_t* const pContext,
   NeQuickG_context_t* const pNequick_Context,
@@ -74,15 +81,54 @@ static int32_t Gauss_Kronrod_integrate_impl(
   const double_t point_2_height_km,
   double_t* const pTEC) {
 
-  pContext->recursion_level = 0;
-  pContext->recursion_max = NEQUICK_G_JRC_RECURSION_LIMIT_MAX;
+  const NeQuickG_integration_t* const pIntegration =
+    &pNequick_Context->integration;
 
-  return Gauss_Kronrod_integrate(
-    pContext,
-    pNequick_Context,
-    point_1_height_km,
-    point_2_height_km,
-    pTEC);
+  gauss_kronrod_context_t context;
+  context.tolerance = pContext->tolerance * pIntegration->tolerance_factor;
+  context.recursion_level = 0;
+
+  if (pIntegration->fixed_interval_count == 0) {
+    context.recursion_max = NEQUICK_G_JRC_RECURSION_LIMIT_MAX;
+
+    return Gauss_Kronrod_integrate(
+      &context,
+      pNequick_Context,
+      point_1_height_km,
+      point_2_height_km,
+      pTEC);
+  }
+
+  context.recursion_max = 0;
+
+  double_t step_km =
+    (point_2_height_km - point_1_height_km) /
+    (double_t)pIntegration->fixed_interval_count;
+  double_t total_electron_content = 0.0;
+
+  uint32_t i;
+  for (i = 0; i < pIntegration->fixed_interval_count; i++) {
+    double_t start_km = point_1_height_km + (step_km * i);
+    double_t end_km =
+      (i + 1 == pIntegration->fixed_interval_count) ?
+        point_2_height_km : (start_km + step_km);
+
+    double_t total_electron_content_;
+    int32_t ret =
+      Gauss_Kronrod_integrate(
+        &context,
+        pNequick_Context,
+        start_km,
+        end_km,
+        &total_electron_content_);
+    if (ret != NEQUICK_OK) {
+      return ret;
+    }
+    total_electron_content += total_electron_content_;
+  }
+
+  *pTEC = total_electron_content;
+  return NEQUICK_OK;
 }
 
 static int32_t both_below_first_integration_point(
@@ -239,8 +239,8 @@ static double_t bottom_side(
  *
  * @return electron content at the specified height in m<SUP>-3</SUP>
  */
-static double_t top_side(
-  iono_profile_t* const pProfile,
+static double_t top_side_get_exp_arg(
+  const iono_profile_t* const pProfile,
   const double_t height_km) {
 
   double_t height_above_F2_peak_km =
@@ -250,30 +250,49 @@ static double_t top_side(
     NEQUICK_G_JRC_ELE_DENSITY_TOP_CONST_1 *
     height_above_F2_peak_km;
 
-  double_t temp =
-    NeQuickG_exp(
-      height_above_F2_peak_km /
-       (pProfile->F2.layer.peak.thickness.top_km *
-         (1.0 +
-           ((NEQUICK_G_JRC_ELE_DENSITY_TOP_CONST_2 * delta_height) /
-              ((NEQUICK_G_JRC_ELE_DENSITY_TOP_CONST_2 *
-                pProfile->F2.layer.peak.thickness.top_km) +
-                delta_height)))));
-
-  if (temp > NEQUICK_G_JRC_ELE_DENSITY_TOP_APROXIMATION_EPSILON) {
-    temp = 1.0 / temp;
-  } else {
-    temp /= NeQuickG_square(1.0 + temp);
-  }
+  return (
+    height_above_F2_peak_km /
+     (pProfile->F2.layer.peak.thickness.top_km *
+       (1.0 +
+         ((NEQUICK_G_JRC_ELE_DENSITY_TOP_CONST_2 * delta_height) /
+            ((NEQUICK_G_JRC_ELE_DENSITY_TOP_CONST_2 *
+              pProfile->F2.layer.peak.thickness.top_km) +
+              delta_height)))));
+}
 
+static void top_side_get_peak_electron_density(
+  iono_profile_t* const pProfile) {
   if (isnan(pProfile->F2.layer.peak.electron_density)) {
     pProfile->F2.layer.peak.electron_density =
       bottom_side(pProfile, pProfile->F2.layer.peak.height_km);
   }
-  return (NEQUICKG_IONO_LAYER_GET_PEAK_AMPLITUDE(temp) *
+}
+
+static double_t top_side_get_electron_density(
+  const iono_profile_t* const pProfile,
+  double_t exponential) {
+
+  if (exponential > NEQUICK_G_JRC_ELE_DENSITY_TOP_APROXIMATION_EPSILON) {
+    exponential = 1.0 / exponential;
+  } else {
+    exponential /= NeQuickG_square(1.0 + exponential);
+  }
+
+  return (NEQUICKG_IONO_LAYER_GET_PEAK_AMPLITUDE(exponential) *
           pProfile->F2.layer.peak.electron_density);
 }
 
+static double_t top_side(
+  iono_profile_t* const pProfile,
+  const double_t height_km) {
+
+  double_t temp =
+    NeQuickG_exp(top_side_get_exp_arg(pProfile, height_km));
+
+  top_side_get_peak_electron_density(pProfile);
+  return top_side_get_electron_density(pProfile, temp);
+}
+
 double_t electron_density_get(
   iono_profile_t* const pProfile,
   const double_t height_km) {
@@ -285,6 +304,46 @@ double_t electron_density_get(
   }
 }
 
+void electron_density_get_batch(
+  iono_profile_t* const pProfile,
+  const double_t* const pHeight_km,
+  size_t count,
+  double_t* const pElectron_density) {
+
+  size_t i;
+  bool is_top_side = false;
+
+  // the exponential arguments of the topside heights first,
+  // the bottomside heights are done one by one
+  for (i = 0; i < count; i++) {
+    if (pHeight_km[i] > pProfile->F2.layer.peak.height_km) {
+      pElectron_density[i] = top_side_get_exp_arg(pProfile, pHeight_km[i]);
+      is_top_side = true;
+    } else {
+      pElectron_density[i] = bottom_side(pProfile, pHeight_km[i]);
+    }
+  }
+
+  if (!is_top_side) {
+    return;
+  }
+
+  top_side_get_peak_electron_density(pProfile);
+
+  for (i = 0; i < count; i++) {
+    if (pHeight_km[i] > pProfile->F2.layer.peak.height_km) {
+      pElectron_density[i] = NeQuickG_exp(pElectron_density[i]);
+    }
+  }
+
+  for (i = 0; i < count; i++) {
+    if (pHeight_km[i] > pProfile->F2.layer.peak.height_km) {
+      pElectron_density[i] =
+        top_side_get_electron_density(pProfile, pElectron_density[i]);
+    }
+  }
+}
+
 #undef NEQUICK_G_JRC_ELE_DENSITY_TO_ELECTRON_DENSITY
 
 #undef NEQUICK_G_JRC_ELE_DENSITY_BOTTOM_EPSILON
@@ -30,14 +30,9 @@
 /** Second Constant used in interpolation_third_order */
 #define NEQUICK_G_JRC_INTERPOL_SECOND_CONST (16.0)
 
-double_t interpolation_third_order(
+void interpolation_third_order_get_coefficients(
   const double_t interpol_points[NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT],
-  double_t offset) {
-  double_t result = 0.0;
-
-  if (fabs(offset) < NEQUICK_G_JRC_INTERPOL_EPSILON) {
-    return interpol_points[NEQUICK_G_JRC_INTERPOL_POINT_1_INDEX];
-  }
+  interpolation_third_order_t* const pInterpolation) {
 
   double_t sum_1_2 = interpol_points[NEQUICK_G_JRC_INTERPOL_POINT_2_INDEX] +
                    interpol_points[NEQUICK_G_JRC_INTERPOL_POINT_1_INDEX];
@@ -50,7 +45,7 @@ double_t interpolation_third_order(
                      interpol_points[NEQUICK_G_JRC_INTERPOL_POINT_0_INDEX])/
                      (double_t)((double_t)NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT - 1.0);
 
-  double_t coefficients[NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT];
+  double_t* const coefficients = pInterpolation->coefficients;
   {
      size_t i = 0;
      coefficients[i++] =
@@ -60,14 +55,40 @@ double_t interpolation_third_order(
      coefficients[i++] = (sum_3_0 - sum_1_2);
      coefficients[i] = (grad_3_0 - grad_2_1);
   }
+  pInterpolation->point_1 =
+    interpol_points[NEQUICK_G_JRC_INTERPOL_POINT_1_INDEX];
+}
+
+double_t interpolation_third_order_get(
+  const interpolation_third_order_t* const pInterpolation,
+  double_t offset) {
+  double_t result = 0.0;
+
+  if (fabs(offset) < NEQUICK_G_JRC_INTERPOL_EPSILON) {
+    return pInterpolation->point_1;
+  }
+
   double_t delta = (2.0 * offset) - 1.0;
   for (int_fast8_t i = NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT - 1;
        i >= 0x00 ; i--) {
-    result = (result * delta) + coefficients[i];
+    result = (result * delta) + pInterpolation->coefficients[i];
   }
   return (result / NEQUICK_G_JRC_INTERPOL_SECOND_CONST);
 }
 
+double_t interpolation_third_order(
+  const double_t interpol_points[NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT],
+  double_t offset) {
+
+  if (fabs(offset) < NEQUICK_G_JRC_INTERPOL_EPSILON) {
+    return interpol_points[NEQUICK_G_JRC_INTERPOL_POINT_1_INDEX];
+  }
+
+  interpolation_third_order_t interpolation;
+  interpolation_third_order_get_coefficients(interpol_points, &interpolation);
+  return interpolation_third_order_get(&interpolation, offset);
+}
+
 #undef NEQUICK_G_JRC_INTERPOL_EPSILON
 #undef NEQUICK_G_JRC_INTERPOL_POINT_0_INDEX
 #undef NEQUICK_G_JRC_INTERPOL_POINT_1_INDEX
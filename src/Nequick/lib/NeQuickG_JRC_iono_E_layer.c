@@ -94,6 +94,7 @@ void E_layer_get_critical_freq_MHz(
   {
     if (!pLayer->is_solar_declination_valid) {
       pLayer->solar_declination = solar_get_declination(pTime);
+      pLayer->is_solar_declination_valid = true;
     }
 
     solar_effective_angle_degree =
@@ -196,17 +196,20 @@ static void get_legrende_coeff_for_longitude(
   pCoeff_sinus[0] = pLongitude->sin;
   pCoeff_cosinus[0] = pLongitude->cos;
 
-  double_t n_long = 2.0 * pLongitude->rad;
-
+  //sin(nA) = sin[(n-1)A + A] with sin(A + B) = sin(A)cos(B) + cos(A)sin(B),
+  //cos(nA) = cos[(n-1)A + A] with cos(A + B) = cos(A)cos(B) - sin(A)sin(B).
   // to satisfy lint
   size_t coeff_count = NEQUICKG_JRC_IONO_F2_LAYER_LONG_COEFF_COUNT;
   for (
     size_t i = 1;
     i < coeff_count;
     i++) {
-    pCoeff_sinus[i] = sin(n_long);
-    pCoeff_cosinus[i] = cos(n_long);
-    n_long += pLongitude->rad;
+    pCoeff_sinus[i] =
+      (pCoeff_sinus[i - 1] * pLongitude->cos) +
+      (pCoeff_cosinus[i - 1] * pLongitude->sin);
+    pCoeff_cosinus[i] =
+      (pCoeff_cosinus[i - 1] * pLongitude->cos) -
+      (pCoeff_sinus[i - 1] * pLongitude->sin);
   }
 }
 
@@ -283,7 +283,7 @@ static int32_t interpolate_F2(
   int32_t ret;
 
 #ifdef FTR_MODIP_CCIR_AS_CONSTANTS
-  F2_coefficient_array_t* pF2;
+  const F2_coefficient_array_t* pF2;
   ret = CCIR_get_ionosonde_F2(pContext->time.month, &pF2);
   if (ret != NEQUICK_OK) {
     return ret;
@@ -325,7 +325,7 @@ static int32_t interpolate_Fm3(
   int32_t ret;
 
 #ifdef FTR_MODIP_CCIR_AS_CONSTANTS
-  Fm3_coefficient_array_t* pFm3;
+  const Fm3_coefficient_array_t* pFm3;
   ret = CCIR_get_ionosonde_Fm3(pContext->time.month, &pFm3);
   if (ret != NEQUICK_OK) {
     return ret;
@@ -38,7 +38,15 @@ void iono_profile_close(iono_profile_t * const pProfile) {
 }
 #endif
 
-static double_t iono_profile_get_amplitude_of_peak(
+/** Exponential term of the Epstein layer of a peak at a height.
+ * It depends only on the peak height and thickness, not on the amplitude.
+ *
+ * @param[in] pPeak layer peak
+ * @param[in] height_km height in km
+ *
+ * @return exponential term
+ */
+static double_t iono_profile_get_exp_of_peak(
   const peak_t* const pPeak,
   double_t height_km) {
 
@@ -47,17 +55,30 @@ static double_t iono_profile_get_amplitude_of_peak(
     pPeak->thickness.bottom_km :
     pPeak->thickness.top_km;
 
-  double_t electron_density =
-    NeQuickG_exp((height_km - pPeak->height_km) /
-                  thickness_param);
+  return NeQuickG_exp((height_km - pPeak->height_km) /
+                       thickness_param);
+}
 
-  electron_density =
-    (pPeak->amplitude * electron_density /
-      NeQuickG_square(electron_density + 1.0));
+static double_t iono_profile_get_amplitude_of_exp(
+  double_t amplitude,
+  double_t exponential) {
+
+  double_t electron_density =
+    (amplitude * exponential /
+      NeQuickG_square(exponential + 1.0));
 
   return NEQUICKG_IONO_LAYER_GET_PEAK_AMPLITUDE(electron_density);
 }
 
+static double_t iono_profile_get_amplitude_of_peak(
+  const peak_t* const pPeak,
+  double_t height_km) {
+
+  return iono_profile_get_amplitude_of_exp(
+    pPeak->amplitude,
+    iono_profile_get_exp_of_peak(pPeak, height_km));
+}
+
 static int32_t iono_profile_get_critical_freqs(
   iono_profile_t * const pProfile,
   const NeQuickG_time_t* const pTime,
@@ -155,13 +176,21 @@ void iono_profile_get_peak_amplitudes(
     pE_peak->amplitude =
         NEQUICKG_IONO_LAYER_GET_PEAK_AMPLITUDE(pE_peak->electron_density);
 
+    // only the amplitudes change in the iterations, so the exponential
+    // terms of each layer at the height of the other one are computed once
+    double_t E_exp_at_F1_height =
+      iono_profile_get_exp_of_peak(pE_peak, pF1_peak->height_km);
+    double_t F1_exp_at_E_height =
+      iono_profile_get_exp_of_peak(pF1_peak, pE_peak->height_km);
+
     for (
       size_t i = 0; i < NEQUICK_G_JRC_IONO_PEAK_AMPLITUDE_ITERATION_COUNT; i++) {
 
       // F1
       {
         double_t amplitude_E_at_F1_height =
-        iono_profile_get_amplitude_of_peak(pE_peak, pF1_peak->height_km);
+        iono_profile_get_amplitude_of_exp(
+          pE_peak->amplitude, E_exp_at_F1_height);
 
         pF1_peak->amplitude =
           F1_peak_amplitude_substracting_F2 -
@@ -181,7 +210,8 @@ void iono_profile_get_peak_amplitudes(
       // E
       pE_peak->amplitude =
         E_peak_amplitude_substracting_F2 -
-        iono_profile_get_amplitude_of_peak(pF1_peak, pE_peak->height_km);
+        iono_profile_get_amplitude_of_exp(
+          pF1_peak->amplitude, F1_exp_at_E_height);
     }
   } else {
     pF1_peak->amplitude = 0.0;
@@ -224,7 +254,7 @@ int32_t iono_profile_get(
   const solar_activity_t* const pSolar_activity,
   const position_t * const pCurrent_position) {
 
-  modip_get(pModip, pCurrent_position);
+  modip_get_cached(pModip, pCurrent_position);
 
   int32_t ret = iono_profile_get_critical_freqs(
     pProfile,
@@ -260,6 +260,8 @@ static int32_t on_slant_ray(ray_context_t* const pRay) {
   pRay->longitude = get_ray_longitude
     (&pRay->receiver_position, &sigma, &delta_p, &pRay->latitude);
 
+  pRay->slant.is_profile_valid = false;
+
   if (!pRay->is_vertical) {
     {
       // Replace sine and cosine of receiver end point
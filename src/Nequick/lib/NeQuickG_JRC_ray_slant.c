@@ -98,6 +98,17 @@ int32_t ray_slant_get_electron_density(
   position_t current_position =
     get_current_position(&pContext->ray, height_km);
 
+  // the profile of a near point of the ray is kept if the settings allow it,
+  // only the height of the current point is used
+  if (pContext->ray.slant.is_profile_valid &&
+      (fabs(height_km - pContext->ray.slant.profile_distance_km) <
+       pContext->integration.profile_reuse_km)) {
+    *pElectron_density = electron_density_get(
+      &pContext->profile,
+      current_position.height);
+    return NEQUICK_OK;
+  }
+
   // recalculate ionosphere information now that the latitude and longitude have
   // changed
   int32_t ret = iono_profile_get(
@@ -110,6 +121,8 @@ int32_t ray_slant_get_electron_density(
   if (ret != NEQUICK_OK) {
     return ret;
   }
+  pContext->ray.slant.profile_distance_km = height_km;
+  pContext->ray.slant.is_profile_valid = true;
 
   *pElectron_density = electron_density_get(
     &pContext->profile,
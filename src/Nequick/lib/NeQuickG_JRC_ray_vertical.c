@@ -42,3 +42,12 @@ double_t ray_vertical_get_electron_density(
   const double_t height_km) {
   return electron_density_get(&pContext->profile, height_km);
 }
+
+void ray_vertical_get_electron_densities(
+  NeQuickG_context_t* const pContext,
+  const double_t* const pHeight_km,
+  size_t count,
+  double_t* const pElectron_density) {
+  electron_density_get_batch(
+    &pContext->profile, pHeight_km, count, pElectron_density);
+}
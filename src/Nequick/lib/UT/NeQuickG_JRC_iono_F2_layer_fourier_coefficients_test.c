@@ -11,6 +11,7 @@
  */
 #include "NeQuickG_JRC_iono_F2_layer_fourier_coefficients_test.h"
 
+#include "NeQuickG_JRC_config.h"
 #ifdef FTR_MODIP_CCIR_AS_CONSTANTS
 #include "NeQuickG_JRC_CCIR.h"
 #endif
@@ -219,12 +220,12 @@ static bool ITU_F2_layer_coefficients_test_new_AZr(
   }
 
 #ifdef FTR_MODIP_CCIR_AS_CONSTANTS
-  F2_coefficient_array_t* pF2;
+  const F2_coefficient_array_t* pF2;
   if (CCIR_get_ionosonde_F2(pContext->time.month, &pF2) != NEQUICK_OK) {
     return false;
   }
 
-  Fm3_coefficient_array_t* pFm3;
+  const Fm3_coefficient_array_t* pFm3;
   if (CCIR_get_ionosonde_Fm3(pContext->time.month, &pFm3) != NEQUICK_OK) {
       return false;
   }
@@ -14,6 +14,8 @@
 
 #include <stdbool.h>
 
+#include "NeQuickG_JRC_config.h"
+
 #ifdef FTR_MODIP_CCIR_AS_CONSTANTS
 #define NeQuickG_API_test(pModip_file, pCCIR_folder) \
   NeQuickG_API_test()
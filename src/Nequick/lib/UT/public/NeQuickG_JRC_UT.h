@@ -15,6 +15,8 @@
 
 #include <stdbool.h>
 
+#include "NeQuickG_JRC_config.h"
+
 #ifdef FTR_MODIP_CCIR_AS_CONSTANTS
 #define NeQuickG_unit_test(pModip_file, pCCIR_folder) \
   NeQuickG_unit_test()
@@ -41,7 +41,9 @@ SOURCEFILES += \
   NeQuickG_JRC_TEC_integration \
   NeQuickG_JRC_time
 
-ifeq ($(FTR_MODIP_CCIR_AS_CONSTANTS),1)
+# the MODIP grid and CCIR maps are built in
+# unless FTR_MODIP_CCIR_FROM_FILES=1 (files read at run time)
+ifneq ($(FTR_MODIP_CCIR_FROM_FILES),1)
   SOURCEFILES += \
     NeQuickG_JRC_CCIR \
     NeQuickG_JRC_ccir11 \
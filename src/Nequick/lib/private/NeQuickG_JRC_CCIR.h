@@ -2,7 +2,8 @@
  * CCIR coefficients for the foF2 and M(3000)F2 models as preloaded constants.<br>
  *
  * The usage of the CCIR as preloaded constants instead of files is a customer requirement.
- * The modules are included with the compilation option FTR_MODIP_CCIR_AS_CONSTANTS=1<br>
+ * The modules are included by default (compilation option FTR_MODIP_CCIR_AS_CONSTANTS),
+ * and left out with FTR_MODIP_CCIR_FROM_FILES<br>
  *
  * These are Coefficients for the foF2 and M(3000)F2 models
  * recommended by the Comite Consultatif International des Radiocommunications (CCIR).
@@ -121,7 +122,7 @@ extern const Fm3_coefficient_array_t g_NeQuickG_ccir22_Fm3[ITU_F2_LAYER_SOLAR_AC
  */
 extern int32_t CCIR_get_ionosonde_F2(
   uint_fast8_t month,
-  F2_coefficient_array_t** ppF2);
+  const F2_coefficient_array_t** ppF2);
 
 /** Get the Fm3 coefficients for a given month
  * @param[in] month valid range is [@ref NEQUICK_G_JRC_MONTH_JANUARY - @ref NEQUICK_G_JRC_MONTH_DECEMBER]
@@ -130,6 +131,6 @@ extern int32_t CCIR_get_ionosonde_F2(
  */
 extern int32_t CCIR_get_ionosonde_Fm3(
   uint_fast8_t month,
-  Fm3_coefficient_array_t** ppFm3);
+  const Fm3_coefficient_array_t** ppFm3);
 
 #endif // NEQUICK_G_JRC_CCIR_H
@@ -37,6 +37,8 @@ typedef struct modip_context_st {
   /** modip grid context */
   modip_grid_t grid;
 #endif //!FTR_MODIP_CCIR_AS_CONSTANTS
+  /** grid cells visited by the sample points */
+  modip_grid_cache_t cache;
   /** calculated modip in degrees */
   double_t modip_degree;
 } modip_context_t;
@@ -62,4 +64,22 @@ extern void modip_get(
   modip_context_t* const pContext,
   const position_t* const pPosition);
 
+/** Empties the grid cell cache of the modip context
+ *
+ * @param[out] pContext modip context
+ */
+extern void modip_cache_init(modip_context_t* const pContext);
+
+/** Get modip of a sample point by grid interpolation, see 2.5.4.3.
+ *
+ * Same as #modip_get, but the latitude interpolation of the grid cell
+ * is kept in the context for the next points in the same cell.
+ *
+ * @param[in, out] pContext modip context
+ * @param[in] pPosition location at which the modip is required
+ */
+extern void modip_get_cached(
+  modip_context_t* const pContext,
+  const position_t* const pPosition);
+
 #endif // NEQUICK_G_JRC_MODIP_H
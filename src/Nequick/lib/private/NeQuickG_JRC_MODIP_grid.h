@@ -44,7 +44,9 @@
 #include <math.h>
 #include <stdbool.h>
 
+#include "NeQuickG_JRC_config.h"
 #include "NeQuickG_JRC_coordinates.h"
+#include "NeQuickG_JRC_interpolate.h"
 
 /** Number of grid points for the latitude */
 #define NEQUICK_G_JRC_MODIP_GRID_LAT_POINTS_COUNT (39)
@@ -58,6 +60,33 @@
 /** Size of latitude step in Modip grid. */
 #define NEQUICK_G_JRC_MODIP_GRID_LAT_STEP_DEGREE (5)
 
+/** Number of grid cells kept by #modip_grid_cache_t. */
+#define NEQUICK_G_JRC_MODIP_GRID_CACHE_CELL_COUNT (4)
+
+/** Latitude interpolation of the grid cell columns */
+typedef struct modip_grid_cell_st {
+  /** latitude grid index of the cell */
+  uint8_t latitude_index;
+  /** longitude grid index of the cell */
+  uint8_t longitude_index;
+  /** are the coefficients valid? */
+  bool is_valid;
+  /** latitude interpolation polynomial of the 4 longitude columns */
+  interpolation_third_order_t
+    latitude[NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT];
+} modip_grid_cell_t;
+
+/** Cache of grid cells.
+ *
+ * The sample points of a ray are close to each other, so most of them
+ * fall in a cell already visited and only the interpolation along the
+ * longitude has to be done for them.
+ */
+typedef struct modip_grid_cache_st {
+  /** cells, indexed by the grid indexes of the cell */
+  modip_grid_cell_t cell[NEQUICK_G_JRC_MODIP_GRID_CACHE_CELL_COUNT];
+} modip_grid_cache_t;
+
 #ifndef FTR_MODIP_CCIR_AS_CONSTANTS
 /** Modip grid loaded from file */
 typedef struct modip_grid_st {
@@ -95,4 +124,30 @@ extern void modip_grid_interpolate(
   const position_t* const pPosition,
   double_t *pModip_degree);
 
+/** Empties the cell cache
+ *
+ * @param[out] pCache cell cache
+ */
+extern void modip_grid_cache_init(modip_grid_cache_t* const pCache);
+
+#if defined(FTR_MODIP_CCIR_AS_CONSTANTS) && !defined(_doxygen)
+#define modip_grid_interpolate_cached(pGrid, pCache, pPosition, pHandle) \
+  modip_grid_interpolate_cached(pCache, pPosition, pHandle)
+#endif
+
+/** Modip grid interpolation reusing the cell interpolation, See 2.5.4.3.
+ *
+ * Same result as #modip_grid_interpolate.
+ *
+ * @param[in] pGrid modip grid context
+ * @param[in, out] pCache cell cache
+ * @param[in] pPosition location at which the modip is required
+ * @param[out] pModip_degree modip in degrees
+ */
+extern void modip_grid_interpolate_cached(
+  const modip_grid_t* const pGrid,
+  modip_grid_cache_t* const pCache,
+  const position_t* const pPosition,
+  double_t *pModip_degree);
+
 #endif // NEQUICK_G_JRC_MODIP_GRID_H
@@ -12,6 +12,7 @@
 #ifndef NEQUICK_G_JRC_CONTEXT_H
 #define NEQUICK_G_JRC_CONTEXT_H
 
+#include "NeQuickG_JRC.h"
 #include "NeQuickG_JRC_input_data.h"
 #include "NeQuickG_JRC_iono_profile.h"
 #include "NeQuickG_JRC_MODIP.h"
@@ -26,12 +27,16 @@ typedef struct NeQuickG_context_st {
   modip_context_t modip;
   /** solar activity contex.*/
   solar_activity_t solar_activity;
+  /** is the solar activity valid for the coefficients and the station? */
+  bool is_solar_activity_valid;
   /** ionospheric profile contex.*/
   iono_profile_t profile;
   /** calculated ray contex.*/
   ray_context_t ray;
   /** input data contex.*/
   input_data_t input_data;
+  /** STEC integration settings.*/
+  NeQuickG_integration_t integration;
 } NeQuickG_context_t;
 
 #endif // NEQUICK_G_JRC_CONTEXT_H
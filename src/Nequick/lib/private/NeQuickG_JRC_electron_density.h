@@ -12,6 +12,7 @@
 #define NEQUICK_G_JRC_ELECTRON_DENSITY_H
 
 #include <math.h>
+#include <stddef.h>
 
 #include "NeQuickG_JRC_iono_profile.h"
 
@@ -33,4 +34,21 @@ extern double_t electron_density_get(
   iono_profile_t* const pProfile,
   const double_t height_km);
 
+/** Returns the electron densities at several heights of the same ionospheric profile,
+ * e.g. the integration points of a vertical ray.<br>
+ * The profile parameters of the topside are computed once for all the heights,
+ * and the topside exponentials of all the heights are evaluated in one loop.
+ * The results are the same as #electron_density_get at each height.
+ *
+ * @param[in, out] pProfile ionospheric profile
+ * @param[in] pHeight_km heights in km
+ * @param[in] count number of heights
+ * @param[out] pElectron_density electron densities in m<SUP>-3</SUP>
+ */
+extern void electron_density_get_batch(
+  iono_profile_t* const pProfile,
+  const double_t* const pHeight_km,
+  size_t count,
+  double_t* const pElectron_density);
+
 #endif // NEQUICK_G_JRC_ELECTRON_DENSITY_H
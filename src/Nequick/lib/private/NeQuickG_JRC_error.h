@@ -11,6 +11,8 @@
 #ifndef NEQUICK_G_JRC_ERROR_H
 #define NEQUICK_G_JRC_ERROR_H
 
+#include "NeQuickG_JRC_config.h"
+
 /** The source of the error code is the memory. */
 #define NEQUICK_ERROR_SRC_MEMORY (-1)
 /** The source of the error code is the input data. */
@@ -61,6 +63,9 @@
 /** Error code: invalid Nequick handle */
 #define NEQUICK_HANDLE_NULL (11)
 
+/** Error code: bad STEC integration settings */
+#define NEQUICK_ERROR_CODE_BAD_INTEGRATION (12)
+
 /** Log an error in the standard error.
  * @param[in] error_src error source
  * @param[in] error_code error code
@@ -9,11 +9,22 @@
  *  Questions? Submit your query at https://www.gsc-europa.eu/contact-us/helpdesk
  * @file
  */
+#ifndef NEQUICK_G_JRC_INTERPOLATE_H
+#define NEQUICK_G_JRC_INTERPOLATE_H
+
 #include <math.h>
 
 /** Number of points used in the interpolation */
 #define NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT (4)
 
+/** Third Order Interpolation polynomial of a set of points */
+typedef struct interpolation_third_order_st {
+  /** polynomial coefficients a<SUB>0</SUB>, a<SUB>1</SUB>, a<SUB>2</SUB> and a<SUB>3</SUB> */
+  double_t coefficients[NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT];
+  /** interpolation point z<SUB>2</SUB> */
+  double_t point_1;
+} interpolation_third_order_t;
+
 /** Third Order Interpolation function, See 2.5.7.1.
  *
  * Be P<SUB>1</SUB> = (-1,z<SUB>1</SUB>),
@@ -44,3 +55,28 @@
 extern double_t interpolation_third_order(
   const double_t interpol_points[NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT],
   double_t offset);
+
+/** Third Order Interpolation polynomial, See 2.5.7.1.
+ *
+ * Computes the coefficients a<SUB>0</SUB> .. a<SUB>3</SUB> of #interpolation_third_order,
+ * so that points sharing the same interpolation points can be evaluated
+ * with #interpolation_third_order_get without computing them again.
+ *
+ * @param[in] interpol_points 4 interpolation points: z<SUB>1</SUB>, z<SUB>2</SUB>, z<SUB>3</SUB> and z<SUB>4</SUB>
+ * @param[out] pInterpolation interpolation polynomial
+ */
+extern void interpolation_third_order_get_coefficients(
+  const double_t interpol_points[NEQUICK_G_JRC_INTERPOLATE_POINT_COUNT],
+  interpolation_third_order_t* const pInterpolation);
+
+/** Evaluates a Third Order Interpolation polynomial, See 2.5.7.1.
+ *
+ * @param[in] pInterpolation interpolation polynomial
+ * @param[in] offset position x where x&isin;[0,1]
+ * @return interpolated value z<SUB>x</SUB>, the same as #interpolation_third_order
+ */
+extern double_t interpolation_third_order_get(
+  const interpolation_third_order_t* const pInterpolation,
+  double_t offset);
+
+#endif // NEQUICK_G_JRC_INTERPOLATE_H
@@ -69,6 +69,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "NeQuickG_JRC_config.h"
 #include "NeQuickG_JRC_solar_activity.h"
 #include "NeQuickG_JRC_time.h"
 
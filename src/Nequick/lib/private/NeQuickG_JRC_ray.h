@@ -35,6 +35,10 @@ typedef struct NeQuickG_ray_slant_info_st {
   double_t receiver_distance_km;
   /** Distance from satellite to ray perigee in km */
   double_t satellite_distance_km;
+  /** Distance to ray perigee in km of the point of the current profile */
+  double_t profile_distance_km;
+  /** is there a profile of a point of the ray? */
+  bool is_profile_valid;
 } NeQuickG_ray_slant_info_t;
 
 /** Ray context */
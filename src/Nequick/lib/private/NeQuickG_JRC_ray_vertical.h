@@ -38,4 +38,19 @@ extern double_t ray_vertical_get_electron_density(
   NeQuickG_context_t* const pContext,
   const double_t height_km);
 
+/** Electron densities at several points along a vertical ray.
+ * The profile is the same for all the points,
+ * so they are evaluated together with #electron_density_get_batch
+ *
+ * @param[in, out] pContext NeQuick context
+ * @param[in] pHeight_km heights of the points in km
+ * @param[in] count number of points
+ * @param[out] pElectron_density N<SUB>e</SUB> in electrons/m<SUP>3</SUP>
+ */
+extern void ray_vertical_get_electron_densities(
+  NeQuickG_context_t* const pContext,
+  const double_t* const pHeight_km,
+  size_t count,
+  double_t* const pElectron_density);
+
 #endif // NEQUICK_G_JRC_RAY_VERTICAL_H
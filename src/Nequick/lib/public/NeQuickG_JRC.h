@@ -27,11 +27,15 @@
  * Kronrod G<SUB>7</SUB>-K<SUB>15</SUB> adaptive quadrature with the default tolerances defined in the specification.
  * See section F.2.6.<br>
  * The maximum recursion level for the integration routine is #NEQUICK_G_JRC_RECURSION_LIMIT_MAX<br>
+ * A faster, less accurate integration can be selected with #NeQuickG_library.set_integration.<br>
  *
- * When the compilation flag FTR_MODIP_CCIR_AS_CONSTANTS is set to 1 the CCIR grid and the MODIP files are
+ * By default (compilation flag FTR_MODIP_CCIR_AS_CONSTANTS) the CCIR grid and the MODIP files are
  *  preloaded as constants in the library (no need for external files):
  *  - MODIP matrix available at its first release dated on year 2001 and calculated at a height of 300 km.
  *
+ * With the compilation flag FTR_MODIP_CCIR_FROM_FILES they are loaded from the files given to
+ *  #NeQuickG_library.init instead, see NeQuickG_JRC_config.h.
+ *
  * @mainpage NeQuick-G (Galileo)
  * @author Angela Aragon-Angel (maria-angeles.aragon@ec.europa.eu)
  * @bug No known bugs.
@@ -58,6 +62,7 @@
 #endif
 #endif
 
+#include "NeQuickG_JRC_config.h"
 
 /** This is NequickG JRC version 0.1*/
 #define NEQUICKG_VERSION (0.1)
@@ -81,6 +86,31 @@
 /** NeQuick success */
 #define NEQUICK_OK 0
 
+/** STEC integration settings, see #NeQuickG_library.set_integration.
+ *
+ * The reference settings (#NEQUICKG_INTEGRATION_REFERENCE) are the ones of the
+ * specification and the only ones the conformance tests are valid for.
+ */
+typedef struct NeQuickG_integration_st {
+  /** Factor applied to the Kronrod G<SUB>7</SUB>-K<SUB>15</SUB> tolerances of the
+   *  adaptive integration (1: specification tolerances)
+   */
+  double_t tolerance_factor;
+  /** Number of equal K<SUB>15</SUB> intervals of each integration segment
+   *  (0, 1000 km, 2000 km and the satellite) integrated without error control
+   *  (0: adaptive integration)
+   */
+  uint32_t fixed_interval_count;
+  /** Distance along a slant ray (km) within which the vertical profile of a point
+   *  is reused for the next points, only the height changes
+   *  (0: profile at each point)
+   */
+  double_t profile_reuse_km;
+} NeQuickG_integration_t;
+
+/** Reference STEC integration settings */
+#define NEQUICKG_INTEGRATION_REFERENCE {1.0, 0, 0.0}
+
 /** NequickG JRC handle */
 typedef void* NeQuickG_handle;
 
@@ -218,6 +248,19 @@ struct NeQuickG_library {
     const double_t latitude_degree,
     const double_t height_meters);
 
+  /** Sets the STEC integration settings.
+   *  The settings are kept until set again, the default are the reference ones.
+   *
+   * @param[in] NeQuickG_handle NequickG JRC handle
+   * @param[in] pIntegration integration settings, the tolerance factor
+   *  has to be positive and the profile reuse distance not negative
+   *
+   * @return on success NEQUICK_OK
+   */
+  int32_t (*set_integration)(
+    const NeQuickG_handle,
+    const NeQuickG_integration_t* const pIntegration);
+
   /** Gets the receiver MODIP.
    * Needs a previous call to set_receiver_position.
    *
@@ -0,0 +1,29 @@
+/** NeQuickG build configuration
+ *
+ * The MODIP grid and the CCIR maps are compiled into the library by default
+ * (FTR_MODIP_CCIR_AS_CONSTANTS), so no data file is needed at run time.<br>
+ * Building with FTR_MODIP_CCIR_FROM_FILES selects the original behaviour,
+ * i.e. the MODIP grid file and the CCIR folder are given to
+ * #NeQuickG_library.init and are read from disk.
+ *
+ * Every header testing FTR_MODIP_CCIR_AS_CONSTANTS includes this file first.
+ *
+ * @ingroup NeQuickG_JRC
+ * @copyright Joint Research Centre (JRC), 2019<br>
+ *  This software has been released as free and open source software
+ *  under the terms of the European Union Public Licence (EUPL), version 1.<br>
+ *  Questions? Submit your query at https://www.gsc-europa.eu/contact-us/helpdesk
+ * @file
+ */
+#ifndef NEQUICK_G_JRC_CONFIG_H
+#define NEQUICK_G_JRC_CONFIG_H
+
+#ifdef FTR_MODIP_CCIR_FROM_FILES
+#ifdef FTR_MODIP_CCIR_AS_CONSTANTS
+#error "FTR_MODIP_CCIR_FROM_FILES and FTR_MODIP_CCIR_AS_CONSTANTS are exclusive"
+#endif
+#elif !defined(FTR_MODIP_CCIR_AS_CONSTANTS)
+#define FTR_MODIP_CCIR_AS_CONSTANTS
+#endif
+
+#endif // NEQUICK_G_JRC_CONFIG_H
@@ -20,8 +20,6 @@ const double LON_POLE = -72.58;               // east longitude of north geomagn
 const double Hion_bdgim = 400000.0;           // heigth of Ionospheric layer [unit:m]
 const double EARTH_RADIUS = 6378137.0;     	  // the average radius of earth,for compute the IPP [unit:m]
 
-static double Init_mjd = 0.0;                 // initial mjd every day for determining whether recalculate non-broadcast parameters
-
 /**** BDGIM Periodic Table for Non-Broadcast Coefficient Forecast. Corresponds to degree/order [ 3/0 3/1 3/-1 3/2 ... 5/2 5/-2 ] ****/
 const double NonBrdPara_table[NONBRDNUM][TRISERINUM] = {
 	{-0.610000,-0.510000, 0.230000,-0.060000, 0.020000, 0.010000, 0.000000,-0.010000,-0.000000, 0.000000, 0.010000,-0.190000,-0.090000,-0.180000, 0.150000, 1.090000, 0.500000,-0.340000, 0.000000,-0.130000, 0.050000,-0.060000, 0.030000,-0.030000, 0.040000},
@@ -286,23 +284,21 @@ void SetNonBrdCoefPeriod(NonBrdIonData* nonBrdData)
 }
 
 /*****************************************************************************
-* Description : Calculate the non-broadcast BDGIM parameters at the first compute epoch every day
+* Description : Calculate the non-broadcast BDGIM parameters of all 12 groups of the day of the compute epoch
 * Parameters : 
 *		double mjd		            I		the compute epoch [in mjd]
-*       NonBrdIonData* nonBrdData   I       BDGIM Non-Broadcast Ionospheric Parameters
+*       NonBrdIonData* nonBrdData   IO      BDGIM Non-Broadcast Ionospheric Parameters
 *****************************************************************************/
 int CalNonBrdCoef(double mjd, NonBrdIonData* nonBrdData)
 {
-	if (mjd >= Init_mjd && (mjd - Init_mjd) < 1.0)
-		return 1;
-
 	double tmjd = 0.0, dmjd = 0.0, coef=0.0;
 	int n=0, igroup = 0, icoef=0, ipar=0;
 
 	dmjd = 2.0 / 24.0;
 
-	for (tmjd = (int)(mjd); tmjd<(int)(mjd) + 1; tmjd = tmjd + dmjd)
+	for (igroup = 0; igroup < MAXGROUP; igroup++)
 	{
+		tmjd = (int)(mjd) + igroup * dmjd;
 	// set the non-broadcast parameter
 		for (icoef=0;icoef<NONBRDNUM;icoef++)
 		{
@@ -320,50 +316,49 @@ int CalNonBrdCoef(double mjd, NonBrdIonData* nonBrdData)
 			}
 			nonBrdData->nonBrdCoef[icoef][igroup] = coef;
 		}
-		igroup++;
 	}
-
-	Init_mjd = (int)(mjd);
 	return 1;
 }
 
 /*****************************************************************************
-* Description : find BDGIM non-broadcast coefficients group according to the mjd, and set the non-broadcast parameter
-*		for BDGIM  model
+* Description : Calculate the non-broadcast BDGIM coefficients of the day by the forecast period table
+* Parameters : 
+*		double mjd		            I		the compute epoch [in mjd]
+*       double nonBrdCoef[][]       O       non-broadcast coefficients of 12 groups of the day
+*****************************************************************************/
+void CalNonBrdCoefDay(double mjd, double nonBrdCoef[NONBRDNUM][MAXGROUP])
+{
+	NonBrdIonData nonBrdData;
+
+	memcpy(nonBrdData.perdTable, NonBrdPara_table, sizeof(NonBrdPara_table));
+	SetNonBrdCoefPeriod(&nonBrdData);
+	CalNonBrdCoef(mjd, &nonBrdData);
+	memcpy(nonBrdCoef, nonBrdData.nonBrdCoef, sizeof(nonBrdData.nonBrdCoef));
+}
+
+/*****************************************************************************
+* Description : find BDGIM non-broadcast coefficients group of the day according to the mjd
 * Parameters  :
 *		double mjd		            I		the compute epoch (in mjd)
-*       NonBrdIonData* nonBrdData   I       BDGIM Non-Broadcast Ionospheric Parameters
 * return :    
-*		int group		O		the session group of the current epoch
+*		int group		O		the session group of the current epoch (-1: error)
 *
 *****************************************************************************/
-int BrdCoefGroupIndex(double mjd, NonBrdIonData* nonBrdData)
+int BrdCoefGroupIndex(double mjd)
 {
 	double tmjd = 0.0, dmjd = 0.0;
-	int igroup = -1;
-
-	// calculate the non-broadcast parameters of BDGIM model
-	if (mjd<Init_mjd || mjd>Init_mjd + 1.0)
-		CalNonBrdCoef(mjd, nonBrdData);
+	int igroup;
 
 	// set the sh coefficient group time interval
 	dmjd = 2.0 / 24.0;
 
-	for (tmjd = (int)(Init_mjd); tmjd<(int)(Init_mjd) + 1; tmjd = tmjd + dmjd)
+	for (igroup = 0; igroup < MAXGROUP; igroup++)
 	{
+		tmjd = (int)(mjd) + igroup * dmjd;
 		if (mjd >= tmjd && mjd < tmjd + dmjd)
-		{
-			igroup++;
-			break;
-		}
-		else
-			igroup++;
+			return igroup;
 	}
-
-	if (igroup > 11)
-		igroup = -1;
-
-	return igroup;
+	return -1;
 }
 
 /*****************************************************************************
@@ -379,48 +374,142 @@ int BrdCoefGroupIndex(double mjd, NonBrdIonData* nonBrdData)
  *****************************************************************************/
 int VtecBrdSH(NonBrdIonData* nonBrdData, BrdIonData* brdData,double mjd,double ipp_b,double ipp_l, double* vtec)
 {
-	double temp =0.0;
-	int ipar=0, igroup = 0;
-	double ipp_b1=0.0,ipp_l1=0.0;
-	double vtec_brd=0.0, vtec_A0=0.0;
+	int ipar=0;
 	*vtec = 0.0;
-	
-	// obtains BDGIM model session group according to the mjd
-	igroup = BrdCoefGroupIndex(mjd, nonBrdData);
 
-	if (igroup == -1)
-		return 0;
+	for (ipar = 0; ipar < BRDPARANUM; ipar++)
+	{
+		if (brdData->degOrd[ipar][1] > brdData->degOrd[ipar][0])
+			return 0;
+	}
+	for (ipar = 0; ipar < NONBRDNUM; ipar++)
+	{
+		if (nonBrdData->degOrd[ipar][1] > nonBrdData->degOrd[ipar][0])
+			return 0;
+	}
+	return VtecBrdSHCoef(nonBrdData->nonBrdCoef, brdData->brdIonCoef, mjd, &ipp_b, &ipp_l, 1, vtec);
+}
+
+/*****************************************************************************
+* Description : Set the recursion constants of the normalized associated legendre functions up to MAXSHDEG.
+*               The functions are normalized in the same way as ASLEFU():
+*               sqrt(2*(2n+1)/(1+delta(m))*(n-m)!/(n+m)!) without Condon-Shortley phase
+*****************************************************************************/
+static double ShDiag[MAXSHDEG+1];				// Pmm   = ShDiag[m]*cos(lat)*P(m-1)(m-1)
+static double ShSub[MAXSHDEG+1];				// P(m+1)m = ShSub[m]*sin(lat)*Pmm
+static double ShA[MAXSHDEG+1][MAXSHDEG+1];		// Pnm   = ShA[n][m]*sin(lat)*P(n-1)m-ShB[n][m]*P(n-2)m
+static double ShB[MAXSHDEG+1][MAXSHDEG+1];
 
-	ipp_b1 = ipp_b;
-	ipp_l1 = ipp_l;
+static int SetShRecursion(void)
+{
+	int n, m;
 
-	// calculate the VTEC computed from the broadcast coefficients
-	for(ipar=0;ipar< BRDPARANUM;ipar++)
+	ShDiag[0] = 1.0;
+	ShDiag[1] = sqrt(3.0);
+	for (m = 2; m <= MAXSHDEG; m++) ShDiag[m] = sqrt((2.0*m + 1.0) / (2.0*m));
+	for (m = 0; m <= MAXSHDEG; m++) ShSub[m] = sqrt(2.0*m + 3.0);
+	for (n = 2; n <= MAXSHDEG; n++) for (m = 0; m <= n - 2; m++)
 	{
-		if(brdData->degOrd[ipar][1]> brdData->degOrd[ipar][0])
-			return 0;
-		vtec_brd = vtec_brd + brdData->brdIonCoef[ipar]*(ASLEFU(ipp_b1,ipp_l1, brdData->degOrd[ipar][0], brdData->degOrd[ipar][1]));
+		ShA[n][m] = sqrt((2.0*n - 1.0)*(2.0*n + 1.0) / ((n - m)*(n + m)));
+		ShB[n][m] = sqrt((2.0*n + 1.0)*(n + m - 1.0)*(n - m - 1.0) / ((n - m)*(n + m)*(2.0*n - 3.0)));
 	}
+	return 1;
+}
+static const int ShInit = SetShRecursion();	// set once at program start
 
-	// calculate the VTEC coomputed from the non-broadcast coefficients
-	for (ipar=0;ipar<NONBRDNUM;ipar++)
+/*****************************************************************************
+* Description : Normalized spherical harmonic functions of all degree/order up to MAXSHDEG at a point
+* Parameters  :
+*		double lat		I		latitude  [arc]
+*		double lon		I		longitude [arc]
+*		double cnm[][]	O		Pnm(sin(lat))*cos(m*lon) (degree n, order m)
+*		double snm[][]	O		Pnm(sin(lat))*sin(m*lon)
+*****************************************************************************/
+static void ShBasis(double lat, double lon, double cnm[MAXSHDEG+1][MAXSHDEG+1], double snm[MAXSHDEG+1][MAXSHDEG+1])
+{
+	double x = sin(lat), y = cos(lat), c1 = cos(lon), s1 = sin(lon);
+	double pnm[MAXSHDEG+1][MAXSHDEG+1], cm[MAXSHDEG+1], sm[MAXSHDEG+1];
+	int n, m;
+
+	pnm[0][0] = 1.0;
+	for (m = 1; m <= MAXSHDEG; m++) pnm[m][m] = ShDiag[m] * y*pnm[m - 1][m - 1];
+	for (m = 0; m < MAXSHDEG; m++) pnm[m + 1][m] = ShSub[m] * x*pnm[m][m];
+	for (m = 0; m <= MAXSHDEG - 2; m++) for (n = m + 2; n <= MAXSHDEG; n++)
 	{
-		if(nonBrdData->degOrd[ipar][1]>nonBrdData->degOrd[ipar][0])
-			return 0;
-		vtec_A0 = vtec_A0 + nonBrdData->nonBrdCoef[ipar][igroup]*(ASLEFU(ipp_b1,ipp_l1,nonBrdData->degOrd[ipar][0],nonBrdData->degOrd[ipar][1]));
+		pnm[n][m] = ShA[n][m] * x*pnm[n - 1][m] - ShB[n][m] * pnm[n - 2][m];
+	}
+	// cos(m*lon) and sin(m*lon) by the angle-sum recursion
+	cm[0] = 1.0; sm[0] = 0.0;
+	for (m = 1; m <= MAXSHDEG; m++)
+	{
+		cm[m] = cm[m - 1] * c1 - sm[m - 1] * s1;
+		sm[m] = sm[m - 1] * c1 + cm[m - 1] * s1;
+	}
+	for (n = 0; n <= MAXSHDEG; n++) for (m = 0; m <= n; m++)
+	{
+		cnm[n][m] = pnm[n][m] * cm[m];
+		snm[n][m] = pnm[n][m] * sm[m];
 	}
+}
+
+/* spherical harmonic function of degree/order (order<0: sine term) */
+#define SHTERM(cnm,snm,deg,ord)	((ord)>=0?(cnm)[deg][ord]:(snm)[deg][-(ord)])
 
-	*vtec = vtec_brd + vtec_A0;
+/*****************************************************************************
+ * Description : Obtains the vertical ionospheric TEC of IPPs using BDGIM ionospheric mode with the non-broadcast
+ *               coefficients of the day computed in advance. The spherical harmonic functions of each IPP are
+ *               computed once by the recursions for all coefficients.
+ * Parameters  :
+ *      double nonBrdCoef[][]       I               non-broadcast coefficients of 12 groups of the day
+ *      double *brdIonCoef          I               broadcast coefficients (9)
+ *		double mjd					I	[MJD]		The calculate time (Modified Julian Day)
+ *		double *lat					I	[arc]		The geomagnetic latitude of the Ionospheric Puncture Points (IPP)
+ *		double *lon                 I	[arc]		The geomagnetic longitude of the Ionospheric Puncture Points (IPP) 
+ *		int n						I				number of IPPs
+ *		double *vtec			    O   [TECU]	    Ionospheric correction in TECU (in electrons per area unit)
+ * return : int  1:ok, 0:error
+ *****************************************************************************/
+int VtecBrdSHCoef(const double nonBrdCoef[NONBRDNUM][MAXGROUP], const double* brdIonCoef, double mjd, const double* ipp_b, const double* ipp_l, int n, double* vtec)
+{
+	double cnm[MAXSHDEG+1][MAXSHDEG+1], snm[MAXSHDEG+1][MAXSHDEG+1], coef[NONBRDNUM];
+	double vtec_brd, vtec_A0, vtec_min;
+	int i, ipar, igroup;
 
-	if (brdData->brdIonCoef[0]  > 35.0)
-		*vtec = MAX(brdData->brdIonCoef[0] / 10.0, *vtec);
-	else if (brdData->brdIonCoef[0] > 20.0)
-		*vtec = MAX(brdData->brdIonCoef[0] / 8.0, *vtec);
-	else if (brdData->brdIonCoef[0] > 12.0)
-		*vtec = MAX(brdData->brdIonCoef[0] / 6.0, *vtec);
+	for (i = 0; i < n; i++) vtec[i] = 0.0;
+
+	// obtains BDGIM model session group according to the mjd
+	igroup = BrdCoefGroupIndex(mjd);
+
+	if (igroup == -1)
+		return 0;
+
+	for (ipar = 0; ipar < NONBRDNUM; ipar++) coef[ipar] = nonBrdCoef[ipar][igroup];
+
+	if (brdIonCoef[0] > 35.0)
+		vtec_min = brdIonCoef[0] / 10.0;
+	else if (brdIonCoef[0] > 20.0)
+		vtec_min = brdIonCoef[0] / 8.0;
+	else if (brdIonCoef[0] > 12.0)
+		vtec_min = brdIonCoef[0] / 6.0;
 	else
-		*vtec = MAX(brdData->brdIonCoef[0] / 4.0, *vtec);
+		vtec_min = brdIonCoef[0] / 4.0;
 
+	for (i = 0; i < n; i++)
+	{
+		ShBasis(ipp_b[i], ipp_l[i], cnm, snm);
+
+		// calculate the VTEC computed from the broadcast coefficients
+		for (ipar = 0, vtec_brd = 0.0; ipar < BRDPARANUM; ipar++)
+		{
+			vtec_brd += brdIonCoef[ipar] * SHTERM(cnm, snm, BrdPara_degord_table[ipar][0], BrdPara_degord_table[ipar][1]);
+		}
+		// calculate the VTEC coomputed from the non-broadcast coefficients
+		for (ipar = 0, vtec_A0 = 0.0; ipar < NONBRDNUM; ipar++)
+		{
+			vtec_A0 += coef[ipar] * SHTERM(cnm, snm, NonBrdPara_degord_table[ipar][0], NonBrdPara_degord_table[ipar][1]);
+		}
+		vtec[i] = MAX(vtec_min, vtec_brd + vtec_A0);
+	}
 	return 1;
 }
 
@@ -538,6 +627,7 @@ extern int IonBdsBrdModel(NonBrdIonData* nonBrdData, BrdIonData* brdData, double
 		brdData->brdIonCoef[i] = brdPara[i];
 	}
 	SetNonBrdCoefPeriod(nonBrdData);
+	CalNonBrdCoef(mjd, nonBrdData);
 
 	// 2:calculate IPP information
 	IPPBLH1(sta_xyz, sat_xyz, Hion_bdgim, ipp_xyz, &ipp_b, &ipp_l, &ipp_e,&sat_ele);
@@ -559,3 +649,49 @@ extern int IonBdsBrdModel(NonBrdIonData* nonBrdData, BrdIonData* brdData, double
 
 	return 1;
 }
+
+/*****************************************************************************
+* Description : obtains the slant ionospheric delays in B1C of satellites using BDGIM ionospheric model with the
+*               non-broadcast coefficients of the day computed in advance by CalNonBrdCoefDay()
+* Parameters  :
+*      double nonBrdCoef[][]       I    non-broadcast coefficients of 12 groups of the day
+*	   double* brdPara		       I	broadcast ionospheric parameters [const: 9 parameters model]
+*	   double mjd			       I	current epoch
+*	   double* sta_xyz		       I	station x,y,z
+*	   double* sat_xyz		       I	satellite x,y,z of satellites (sat_xyz[i*stride+0..2])
+*	   int stride			       I	stride of satellites in sat_xyz (3: packed)
+*	   int n				       I	number of satellites
+*	   double* ion_delay	       O	ionospheric delays in B1C [m] (0.0: no delay)
+* return: int  number of satellites with the delays
+*****************************************************************************/
+int IonBdsBrdModelCoef(const double nonBrdCoef[NONBRDNUM][MAXGROUP], const double* brdPara, double mjd, double* sta_xyz, const double* sat_xyz, int stride, int n, double* ion_delay)
+{
+	double ipp_xyz[3], ipp_b, ipp_l, ipp_e, sat_ele, sat[3];
+	double geomag_b[SHBLOCK], geomag_l[SHBLOCK], mf[SHBLOCK], vtec[SHBLOCK];
+	double K = 40.3e16 / (1.0*pow(FREQ1_BDS, 2));
+	int i, j, k, m, idx[SHBLOCK], nok = 0;
+
+	for (i = 0; i < n; i++) ion_delay[i] = 0.0;
+
+	for (i = 0; i < n; i += SHBLOCK)
+	{
+		// 1:calculate IPP information and transform it to sun-fixed and geomagnetic coordinate
+		for (j = i, m = 0; j < n && j < i + SHBLOCK; j++)
+		{
+			for (k = 0; k < 3; k++) sat[k] = sat_xyz[j*stride + k];
+			if (!IPPBLH1(sta_xyz, sat, Hion_bdgim, ipp_xyz, &ipp_b, &ipp_l, &ipp_e, &sat_ele))
+				continue;
+			EFLSFL(mjd, &ipp_b, &ipp_l, 1, 1, geomag_b + m, geomag_l + m);
+			mf[m] = IonMapping(2, ipp_e, sat_ele, Hion_bdgim);
+			idx[m++] = j;
+		}
+		// 2:Calcute the vertical ionospheric TEC of the IPPs at once
+		if (m <= 0 || !VtecBrdSHCoef(nonBrdCoef, brdPara, mjd, geomag_b, geomag_l, m, vtec))
+			continue;
+
+		// 3:calculate the ionospheric Delay in BDS B1C frequency
+		for (j = 0; j < m; j++) ion_delay[idx[j]] = mf[j] * K * vtec[j];
+		nok += m;
+	}
+	return nok;
+}
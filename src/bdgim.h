@@ -21,7 +21,9 @@
 
 /*********** define some basic consts **************************/
 
+#ifndef PI
 #define PI	          (4.0*atan(1.0)) 
+#endif
 #define MIN(a,b)   (((a)>(b))?(b):(a))    // minimum between a and b
 #define MAX(a,b)  (((a)<(b))?(b):(a))     // maximum between a and b
 #define FREQ1_BDS       1575420000.0      // BDS-3 B1C  frequency (Hz) 
@@ -30,6 +32,8 @@
 #define TRISERINUM    (PERIODNUM*2-1)     // Trigonometric series number 
 #define NONBRDNUM      17                 // Number of non-broadcast one group
 #define MAXGROUP       12                 // 12 groups non-broadcast coefficient every day
+#define MAXSHDEG        5                 // max degree of spherical harmonic functions of BDGIM
+#define SHBLOCK        32                 // number of IPPs evaluated at once
 
 /*********** BDGIM Non-Broadcast Ionospheric Parameters Struct **************************/
 typedef struct{
@@ -51,8 +55,12 @@ typedef struct{
  int IonBdsBrdModel(NonBrdIonData* nonBrdData, BrdIonData* brdData, double mjd, double* sta_xyz, double* sat_xyz, double* brdPara, double* ion_delay);
 
 
+/* obtains the slant ionospheric delays in B1C of satellites using BDGIM with the non-broadcast coefficients of the day */
+int IonBdsBrdModelCoef(const double nonBrdCoef[NONBRDNUM][MAXGROUP], const double* brdPara, double mjd, double* sta_xyz, const double* sat_xyz, int stride, int n, double* ion_delay);
+
 /* obtains the vertical ionospheric tec using BDGIM ionospheric mode */
 int VtecBrdSH(NonBrdIonData* nonBrdData, BrdIonData* brdData, double mjd, double ipp_b, double ipp_l, double* vtec);
+int VtecBrdSHCoef(const double nonBrdCoef[NONBRDNUM][MAXGROUP], const double* brdIonCoef, double mjd, const double* ipp_b, const double* ipp_l, int n, double* vtec);
 
 /* transform earth-fixed latitude/longitude into sun-fixed latitude/longitude */
 void EFLSFL(double mjd, double* lat, double* lon, int geomag, int sunframe, double* lat1, double* lon1);
@@ -66,8 +74,9 @@ int IPPBLH1(double* sta, double* sat, double Hion, double* IPPXYZ, double* IPP_B
 /* calculate latitude, longitude and elevation of the IPP (approximate) according to user latitude ,longitude and satellite elevation, azimuth */
 int IPPBLH2(double lat_u, double lon_u, double hion, double sat_ele, double sat_azimuth, double* ipp_b, double* ipp_l, double* ipp_e);
 
-int BrdCoefGroupIndex(double mjd, NonBrdIonData* nonBrdData);	// obtains non-broadcast coefficient session group according to the mjd
-int CalNonBrdCoef(double mjd, NonBrdIonData* nonBrdData);		// calculate the non-broadcast BDGIM coefficients at the first compute epoch
+int BrdCoefGroupIndex(double mjd);							    // obtains non-broadcast coefficient session group according to the mjd
+int CalNonBrdCoef(double mjd, NonBrdIonData* nonBrdData);		// calculate the non-broadcast BDGIM coefficients of the day
+void CalNonBrdCoefDay(double mjd, double nonBrdCoef[NONBRDNUM][MAXGROUP]); // calculate the non-broadcast BDGIM coefficients of the day by the period table
 void SetNonBrdCoefPeriod(NonBrdIonData* nonBrdData);		    // Set the period term of the non-broadcast perdTable for BDGIM model
 double ASLEFU(double XLAT,double XLON,int INN,int IMM);		    // Normalized legendre polynomial
 double FAKULT(int N);										    // compute the factorial of N
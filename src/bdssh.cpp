@@ -4,6 +4,9 @@
 #include "common.h"
 #include "rtklib.h"
 
+/* sizes of BDGIM model state in bdssh.h */
+typedef char bdgim_size_check[NONBRDCOUNT==NONBRDNUM&&NONBRDGROUP==MAXGROUP&&BRDCOUNT==BRDPARANUM?1:-1];
+
 //BDSSH::BDSSH(void)	BDSSH初始化放在readobsnav函数中
 //{
 //	int i;
@@ -66,6 +69,17 @@ int  selemajority(double *tmp, int n){
 	return -1;
 }
 
+/* initialize BDGIM model state ------------------------------------------------
+* the state is computed again from the broadcast coefficients at the next call
+* of ionmodel_BDSK9()
+*-----------------------------------------------------------------------------*/
+void initbdgim(BDSSH* bdssh)
+{
+	bdssh->bdgim.mjd = 0;
+	bdssh->bdgim.hour = -1;
+	bdssh->bdgim.brdGroup = -1;
+}
+
 char uniqion(double* ep, BDSSH* bdssh)
 {
 	int i, j, k;
@@ -78,6 +92,8 @@ char uniqion(double* ep, BDSSH* bdssh)
 
 	trace(3, "uniqion:\n");
 
+	initbdgim(bdssh);
+
 	if (bdssh->bds_ion.nsh9 <= 0)return -1;
 	//if (bds_ion.nsh9 <= 0)return -1;
 
@@ -191,56 +207,99 @@ extern double ionmodel_BDSK8(gtime_t t, const double *ion, const double *pos,
 	return CLIGHT*f*vtime*varr;
 }
 
-/* BDSSH9 for B1I */
-extern double ionmodel_BDSK9(gtime_t time, const BDSSH *bdssh, const double *pos, const double *satxyz)
+/* select BDSSH9 broadcast coefficients of the hour ---------------------------*/
+static void selbrdcoef(bdgim_t *bdgim, const BDSSH *bdsk9, int hour)
 {
+	double ionsh9[9], dt = 48.0;
+	int i, j;
 
-	MjdData mjdData;
-	NonBrdIonData nonBrdData;				 // non-broadcast parameter structure
-	BrdIonData brdData;                      // broadcast parameter structure
-	double ep[6], brdPara[9], sta_xyz[3], sat_xyz[3],iondelay=0.0;
-	memset(&mjdData, 0, sizeof(MjdData));
-	memset(&nonBrdData, 0, sizeof(NonBrdIonData));
-	memset(&brdData, 0, sizeof(BrdIonData));
-	BDSSH *bdsk9 = (BDSSH*)bdssh;
-	int igroup = -1,i,j;
-	double ionsh9[9],dt;
-
-	time2epoch(time, ep);
-	
+	bdgim->hour = hour;
+	bdgim->brdGroup = -1;
 
 	/* select reference ion par and ref hour */
 	if (bdsk9->BrdIonCoefGroup == 1){
-		igroup = 0;
-		for (i = 0; i < bdsk9->BrdIonCoefNum; i++)brdPara[i] = bdsk9->BrdIonCoef[i][0];
+		bdgim->brdGroup = 0;
+		for (i = 0; i < bdsk9->BrdIonCoefNum; i++)bdgim->brdCoef[i] = bdsk9->BrdIonCoef[i][0];
 	}
 	else if (bdsk9->BrdIonCoefGroup == 24){
-		dt = 48.0;
 		for (i = 0; i<24; i++){
 			for (j = 0; j < bdsk9->BrdIonCoefNum; j++)ionsh9[j] = bdsk9->BrdIonCoef[j][i];
 			if (norm(ionsh9, bdsk9->BrdIonCoefNum) == 0.0)continue;
-			if (fabs(ep[3] - i) < dt){
-				dt = fabs(ep[3] - i);
-				igroup = i;
-				for (j = 0; j < bdsk9->BrdIonCoefNum; j++)brdPara[j] = ionsh9[j];
+			if (fabs((double)(hour - i)) < dt){
+				dt = fabs((double)(hour - i));
+				bdgim->brdGroup = i;
+				for (j = 0; j < bdsk9->BrdIonCoefNum; j++)bdgim->brdCoef[j] = ionsh9[j];
 			}
 		}
 	}
-	if (dt >= 48.0 || igroup<0)return 0.0;
+}
 
+/* update BDGIM model state at the time -------------------------------------*/
+static int updbdgim(gtime_t time, const BDSSH *bdssh, double *mjd)
+{
+	MjdData mjdData;
+	bdgim_t *bdgim = (bdgim_t *)&bdssh->bdgim; /* model state updated */
+	double ep[6];
+
+	time2epoch(time, ep);
+
+	if (bdgim->hour != (int)ep[3]) selbrdcoef(bdgim, bdssh, (int)ep[3]);
+	if (bdgim->brdGroup < 0)return 0;
 
 	UTC2MJD((int)ep[0], (int)ep[1], (int)ep[2], (int)ep[3], (int)ep[4], ep[5], &mjdData);
+
+	if (bdgim->mjd != (int)mjdData.mjd) {
+		CalNonBrdCoefDay(mjdData.mjd, bdgim->nonBrdCoef);
+		bdgim->mjd = (int)mjdData.mjd;
+	}
+	*mjd = mjdData.mjd;
+	return 1;
+}
+
+/* BDSSH9 for B1I --------------------------------------------------------------
+* the broadcast coefficients are selected once per hour and the non-broadcast
+* coefficients of 12 groups are computed once per day. they are kept in
+* bdssh->bdgim, so the function is not reentrant for the same bdssh
+*-----------------------------------------------------------------------------*/
+extern double ionmodel_BDSK9(gtime_t time, const BDSSH *bdssh, const double *pos, const double *satxyz)
+{
+	double ion;
+
+	ionmodel_BDSK9n(time, bdssh, pos, satxyz, 3, 1, &ion);
+	return ion;
+}
+
+/* BDSSH9 for B1I of satellites ------------------------------------------------
+* compute ionospheric delays of all satellites of an epoch by BDGIM at once
+* args   : gtime_t t        I   time (bdt)
+*          BDSSH  *bdssh    I   BDSSH9 parameters and BDGIM model state
+*          double *pos      I   receiver position {lat,lon,h} (rad,m)
+*          double *rs       I   satellite positions (rs[i*stride+0..2]) (ecef) (m)
+*          int    stride    I   stride of satellites in rs (3:positions,
+*                               6:positions and velocities)
+*          int    n         I   number of satellites
+*          double *ion      O   ionospheric delays (B1I) (m) (0.0: no delay)
+* return : number of satellites with the delays
+*-----------------------------------------------------------------------------*/
+extern int ionmodel_BDSK9n(gtime_t time, const BDSSH *bdssh, const double *pos,
+	const double *rs, int stride, int n, double *ion)
+{
+	const bdgim_t *bdgim = &bdssh->bdgim;
+	double mjd, sta_xyz[3], k = FREQ1*FREQ1 / FREQ1_CMP / FREQ1_CMP;
+	int i, nok;
+
+	for (i = 0; i < n; i++) ion[i] = 0.0;
+
+	if (!updbdgim(time, bdssh, &mjd))return 0;
+
 	pos2ecef(pos, sta_xyz);
-	for (i = 0; i < 3; i++)sat_xyz[i] = satxyz[i];
 
-	IonBdsBrdModel(&nonBrdData, &brdData, mjdData.mjd, sta_xyz, sat_xyz, brdPara, &iondelay);
-	//printf(" the ionosphere delay in B1C : %7.2lf [m]\n", iondelay);
+	nok = IonBdsBrdModelCoef(bdgim->nonBrdCoef, bdgim->brdCoef, mjd, sta_xyz, rs, stride, n, ion);
 
 	// B1C to B1I 
-	double k = FREQ1*FREQ1/ FREQ1_CMP / FREQ1_CMP;
-	iondelay = iondelay*k;
+	for (i = 0; i < n; i++) ion[i] = ion[i] < 0.0 ? 0.0 : ion[i] * k;
 
-	return iondelay<0.0 ? 0.0 : iondelay;
+	return nok;
 }
 
 /* BDSSH9 for B1I */
@@ -27,6 +27,9 @@
 #define MAXPERIODCOUNT  20
 #endif
 
+#define NONBRDCOUNT			17		// number of BDGIM non-broadcast coefficients (NONBRDNUM)
+#define NONBRDGROUP			12		// number of 2-hour groups of non-broadcast coefficients a day (MAXGROUP)
+
 typedef struct {        /* GPS/QZS/GAL broadcast ephemeris type */
 	int sat;            /* satellite number */
 	int iodi;     /* IODI,reserved */
@@ -71,6 +74,14 @@ typedef struct {        /* navigation data type */
 //private:
 //};
 
+typedef struct {        /* BDGIM model state */
+	int mjd;            /* day of non-broadcast coefficients [MJD] (0: not computed) */
+	int hour;           /* hour of selected broadcast coefficients (-1: not selected) */
+	int brdGroup;       /* selected broadcast coefficient group (-1: none) */
+	double brdCoef[BRDCOUNT];                   /* selected broadcast coefficients */
+	double nonBrdCoef[NONBRDCOUNT][NONBRDGROUP]; /* non-broadcast coefficients of the day */
+} bdgim_t;
+
 typedef struct
 {
 	int i;
@@ -78,6 +89,8 @@ typedef struct
 	double BrdIonCoef[BRDCOUNT][24];			// the body array for storing the bdssh broadcast parameter
 	bds_ion_t bds_ion;
 	int BrdIonCoefGroup;
+	bdgim_t bdgim;								// BDGIM model state computed from the coefficients
 }BDSSH;
 char uniqion(double* ep, BDSSH* bdssh);
+void initbdgim(BDSSH* bdssh);
 #endif
@@ -0,0 +1,446 @@
+/*------------------------------------------------------------------------------
+* chebeph.c : chebyshev orbit/clock functions
+*
+* references :
+*     [1] J.C.Mason, D.C.Handscomb, Chebyshev Polynomials, Chapman & Hall/CRC,
+*         2003
+*     [2] X.X.Newhall, Numerical Representation of Planetary Ephemerides,
+*         Celestial Mechanics 45, 1989
+*
+* version : $Revision:$ $Date:$
+* history : 2025/08/02 1.0  new
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define SQR(x)      ((x)*(x))
+
+#define MAXDEG      20              /* max degree of chebyshev polynomials */
+#define TSEGMIN     30.0            /* min segment length (s) */
+#define CHEB_ID     "RTKCHEB1"      /* id of chebyshev orbit/clock file */
+
+extern int satpos(const prcopt_t *opt, gtime_t time, gtime_t teph, int sat,
+                  int ephopt, const nav_t *nav, double *rs, double *dts,
+                  double *var, int *svh);
+
+/* chebyshev polynomials and derivatives at x --------------------------------*/
+static void chebpoly(double x, int deg, double *T, double *D)
+{
+    int j;
+    
+    T[0]=1.0; D[0]=0.0;
+    if (deg<1) return;
+    T[1]=x; D[1]=1.0;
+    for (j=2;j<=deg;j++) {
+        T[j]=2.0*x*T[j-1]-T[j-2];
+        D[j]=2.0*T[j-1]+2.0*x*D[j-1]-D[j-2];
+    }
+}
+/* satellite orbit/clock sample (series 0:orbit,1:clock) ---------------------*/
+static int chebsmp(const prcopt_t *opt, const nav_t *nav, gtime_t time,
+                   gtime_t teph, int sat, int k, double *f, double *var,
+                   int *svh)
+{
+    double rs[6],dts[2];
+    
+    if (!satpos(opt,time,teph,sat,opt->sateph,nav,rs,dts,var,svh)) return 0;
+    
+    if (k==0) {f[0]=rs[0]; f[1]=rs[1]; f[2]=rs[2];}
+    else f[0]=dts[0]*CLIGHT;
+    return 1;
+}
+/* fit chebyshev series of block by m segments ---------------------------------
+* interpolate at chebyshev-gauss nodes and test at inner chebyshev-lobatto
+* points and at every TSEGMIN from the start of segment to find jumps
+* args   : double *c        O   coefficients of segments (m*nc*(deg+1))
+*          double *var      O   max variance of samples (m^2)
+*          int    *svh      O   sv health of first sample
+* return : max fitting error (m) (-1:no data)
+*-----------------------------------------------------------------------------*/
+static double fitblk(const prcopt_t *opt, const nav_t *nav, gtime_t t0,
+                     double tblk, int sat, int k, int deg, int nc, int m,
+                     double *c, double *var, int *svh)
+{
+    gtime_t teph=timeadd(t0,tblk/2.0);
+    double h=tblk/m,f[(MAXDEG+1)*3],g[3],x,T[MAXDEG+1],D[MAXDEG+1];
+    double v,err=0.0,e;
+    int i,j,l,q,n=deg+1,ng=(int)ceil(h/TSEGMIN-1E-6),s;
+    
+    *var=0.0;
+    for (j=0;j<m;j++) {
+        double *cj=c+j*nc*n;
+    
+        /* samples at chebyshev-gauss nodes */
+        for (i=0;i<n;i++) {
+            x=cos(PI*(i+0.5)/n);
+            if (!chebsmp(opt,nav,timeadd(t0,(j+0.5*(1.0+x))*h),teph,sat,k,
+                         f+i*nc,&v,&s)) return -1.0;
+            if (v>*var) *var=v;
+            if (j==0&&i==0) *svh=s;
+        }
+        for (q=0;q<nc;q++) for (l=0;l<n;l++) {
+            for (i=0,cj[l+q*n]=0.0;i<n;i++) {
+                cj[l+q*n]+=f[q+i*nc]*cos(PI*l*(i+0.5)/n);
+            }
+            cj[l+q*n]*=(l?2.0:1.0)/n;
+        }
+        /* errors at inner chebyshev-lobatto points and TSEGMIN grid */
+        for (i=1;i<n+ng;i++) {
+            x=i<n?cos(PI*i/n):2.0*(i-n)*TSEGMIN/h-1.0;
+            if (!chebsmp(opt,nav,timeadd(t0,(j+0.5*(1.0+x))*h),teph,sat,k,f,
+                         &v,&s)) return -1.0;
+            chebpoly(x,deg,T,D);
+            for (q=0;q<nc;q++) {
+                for (l=0,g[q]=0.0;l<n;l++) g[q]+=cj[l+q*n]*T[l];
+                g[q]-=f[q];
+            }
+            if ((e=nc==3?norm(g,3):fabs(g[0]))>err) err=e;
+        }
+    }
+    return err;
+}
+/* add segments of block to series -------------------------------------------*/
+static int addseg(chebs_t *s, int b, int m, const double *c, int *nmax)
+{
+    double *c_;
+    int n=s->nc*(s->deg+1);
+    
+    if (s->ns+m>*nmax) {
+        *nmax=(*nmax<=0?256:*nmax*2)+m;
+        if (!(c_=(double *)realloc(s->c,sizeof(double)*n*(*nmax)))) {
+            return 0;
+        }
+        s->c=c_;
+    }
+    memcpy(s->c+s->ns*n,c,sizeof(double)*n*m);
+    s->m[b]=m;
+    s->off[b]=s->ns;
+    s->ns+=m;
+    return 1;
+}
+/* fit chebyshev series of satellite -----------------------------------------*/
+static int fitseries(const cheb_t *cheb, const prcopt_t *opt, const nav_t *nav,
+                     int sat, int k, chebs_t *s, int *svh)
+{
+    double *c,err=-1.0,var=0.0;
+    int b,i,nm=0,m[256],N,nmax=0,svh_=0,ok=0;
+    
+    N=(int)floor(cheb->tblk/TSEGMIN+0.5);
+    for (i=1;i<=N&&nm<256;i++) if (N%i==0) m[nm++]=i; /* candidates */
+    
+    if (!(s->m=(int *)calloc(cheb->nb,sizeof(int)))||
+        !(s->off=(int *)calloc(cheb->nb,sizeof(int)))||
+        !(s->var=(float *)calloc(cheb->nb,sizeof(float)))||
+        !(c=(double *)malloc(sizeof(double)*s->nc*(s->deg+1)*N))) {
+        return -1;
+    }
+    for (b=0;b<cheb->nb;b++) {
+        gtime_t t0=timeadd(cheb->ts,b*cheb->tblk);
+    
+        for (i=0;i<nm;i++) {
+            if ((err=fitblk(opt,nav,t0,cheb->tblk,sat,k,s->deg,s->nc,m[i],c,
+                            &var,&svh_))<0.0) break;
+            if (err<=cheb->tol||i==nm-1) break;
+        }
+        if (err<0.0) continue;
+        if (err>cheb->tol) {
+            trace(2,"chebyshev fit error sat=%2d k=%d %s err=%.4f\n",sat,k,
+                  time_str(t0,0),err);
+        }
+        if (!addseg(s,b,m[i],c,&nmax)) {free(c); return -1;}
+        s->var[b]=(float)((k==0?var:0.0)+SQR(err));
+        if (k==0) svh[b]=svh_;
+        ok=1;
+    }
+    free(c);
+    return ok;
+}
+/* free chebyshev arc --------------------------------------------------------*/
+static void freearc(chebarc_t *arc)
+{
+    int k;
+    
+    free(arc->svh); arc->svh=NULL;
+    for (k=0;k<2;k++) {
+        free(arc->s[k].m  ); arc->s[k].m  =NULL;
+        free(arc->s[k].off); arc->s[k].off=NULL;
+        free(arc->s[k].var); arc->s[k].var=NULL;
+        free(arc->s[k].c  ); arc->s[k].c  =NULL;
+        arc->s[k].ns=0;
+    }
+}
+/* fit chebyshev orbit/clock ---------------------------------------------------
+* fit chebyshev polynomials of satellite orbits and clocks computed by satpos()
+* args   : gtime_t ts       I   start time (gpst)
+*          gtime_t te       I   end time (gpst)
+*          double tblk      I   block length (s) (multiple of 30s)
+*          int    *deg      I   degree of polynomials {orbit,clock}
+*          double tol       I   accuracy target of positions and clocks (m)
+*          prcopt_t *opt    I   processing options (opt->sateph: ephemeris)
+*          nav_t  *nav      I   navigation data
+*          cheb_t *cheb     O   chebyshev orbit/clock (free by freecheb())
+* return : number of satellite arcs (0:no data or error)
+* notes  : a block is split into the segments of the fewest candidates
+*          (divisors of tblk/30s) to fit in tol. the errors of the blocks not
+*          in tol are added to the variances.
+*          orbits and clocks of a block are computed by the broadcast
+*          ephemeris selected at the center of the block, so the arcs are
+*          continuous in a block and may differ from satpos() by the switch
+*          of ephemeris near the ends of the block.
+*          jumps of precise clocks are fitted if they are on the boundaries
+*          of the segments, for which ts is aligned to a multiple of tblk.
+*          satellites without orbits or clocks have no arcs.
+*-----------------------------------------------------------------------------*/
+extern int fitcheb(gtime_t ts, gtime_t te, double tblk, const int *deg,
+                   double tol, const prcopt_t *opt, const nav_t *nav,
+                   cheb_t *cheb)
+{
+    chebarc_t *arc;
+    int i,k,stat;
+    
+    trace(3,"fitcheb : ts=%s tblk=%.0f deg=%d %d tol=%.4f\n",time_str(ts,0),
+          tblk,deg[0],deg[1],tol);
+    
+    memset(cheb,0,sizeof(cheb_t));
+    for (i=0;i<MAXSAT;i++) cheb->idx[i]=-1;
+    
+    if (tblk<TSEGMIN||deg[0]<1||deg[0]>MAXDEG||deg[1]<1||deg[1]>MAXDEG||
+        tol<=0.0||timediff(te,ts)<=0.0) {
+        return 0;
+    }
+    cheb->ts.time=(time_t)(floor(ts.time/tblk)*tblk);
+    cheb->tblk=tblk;
+    cheb->tol=tol;
+    cheb->nb=(int)ceil(timediff(te,cheb->ts)/tblk);
+    
+    if (!(cheb->arc=(chebarc_t *)calloc(MAXSAT,sizeof(chebarc_t)))) return 0;
+    
+    for (i=0;i<MAXSAT;i++) {
+        if (opt->exsats[i]==1) continue;
+    
+        arc=cheb->arc+cheb->n;
+        arc->sat=i+1;
+        if (!(arc->svh=(int *)calloc(cheb->nb,sizeof(int)))) {
+            freecheb(cheb);
+            return 0;
+        }
+        for (k=0,stat=1;k<2&&stat>0;k++) {
+            arc->s[k].deg=deg[k];
+            arc->s[k].nc=k?1:3;
+            stat=fitseries(cheb,opt,nav,i+1,k,arc->s+k,arc->svh);
+        }
+        if (stat<0) {
+            freearc(arc);
+            freecheb(cheb);
+            return 0;
+        }
+        if (arc->s[0].ns<=0||arc->s[1].ns<=0) { /* no orbit or clock */
+            freearc(arc);
+            continue;
+        }
+        cheb->idx[i]=cheb->n++;
+    }
+    return cheb->n;
+}
+/* satellite position and clock by chebyshev orbit/clock -----------------------
+* compute satellite position, velocity and clock by chebyshev orbit/clock
+* args   : gtime_t time     I   time (gpst)
+*          int    sat       I   satellite number
+*          cheb_t *cheb     I   chebyshev orbit/clock
+*          double *rs       O   sat position and velocity (ecef)
+*                               {x,y,z,vx,vy,vz} (m|m/s)
+*          double *dts      O   sat clock {bias,drift} (s|s/s)
+*          double *var      O   sat position and clock error variance (m^2)
+*          int    *svh      O   sat health flag
+* return : status (1:ok,0:no orbit or clock at the time)
+* notes  : velocity and clock drift are derivatives of the polynomials.
+*-----------------------------------------------------------------------------*/
+extern int chebpos(gtime_t time, int sat, const cheb_t *cheb, double *rs,
+                   double *dts, double *var, int *svh)
+{
+    const chebarc_t *arc;
+    const chebs_t *s;
+    const double *c;
+    double t,tb,h,x,T[MAXDEG+1],D[MAXDEG+1],f,df;
+    int i,j,k,l,b,n;
+    
+    if (!cheb||sat<=0||MAXSAT<sat||cheb->idx[sat-1]<0) return 0;
+    
+    arc=cheb->arc+cheb->idx[sat-1];
+    t=timediff(time,cheb->ts);
+    b=(int)floor(t/cheb->tblk);
+    if (b==cheb->nb&&t<=cheb->nb*cheb->tblk) b--;
+    if (b<0||b>=cheb->nb||!arc->s[0].m[b]||!arc->s[1].m[b]) return 0;
+    tb=t-b*cheb->tblk;
+    
+    *var=0.0;
+    for (k=0;k<2;k++) {
+        s=arc->s+k;
+        h=cheb->tblk/s->m[b];
+        j=(int)(tb/h); if (j>=s->m[b]) j=s->m[b]-1;
+        x=2.0*(tb-(j+0.5)*h)/h;
+        n=s->deg+1;
+        c=s->c+(s->off[b]+j)*s->nc*n;
+        chebpoly(x,s->deg,T,D);
+    
+        for (i=0;i<s->nc;i++) {
+            for (l=0,f=df=0.0;l<n;l++) {
+                f +=c[l+i*n]*T[l];
+                df+=c[l+i*n]*D[l];
+            }
+            if (k==0) {rs[i]=f; rs[i+3]=df*2.0/h;}
+            else {dts[0]=f/CLIGHT; dts[1]=df*2.0/h/CLIGHT;}
+        }
+        *var+=s->var[b];
+    }
+    *svh=arc->svh[b];
+    return 1;
+}
+/* read chebyshev orbit/clock file ---------------------------------------------
+* read chebyshev orbit/clock file written by writecheb()
+* args   : char   *file     I   file path
+*          cheb_t *cheb     O   chebyshev orbit/clock (free by freecheb())
+* return : status (1:ok,0:error)
+*-----------------------------------------------------------------------------*/
+extern int readcheb(const char *file, cheb_t *cheb)
+{
+    FILE *fp;
+    chebarc_t *arc;
+    chebs_t *s;
+    double t[4];
+    int i,j,k,n,ns,stat=1;
+    char id[8];
+    
+    trace(3,"readcheb: file=%s\n",file);
+    
+    memset(cheb,0,sizeof(cheb_t));
+    for (i=0;i<MAXSAT;i++) cheb->idx[i]=-1;
+    
+    if (!(fp=fopen(file,"rb"))) {
+        trace(2,"chebyshev file open error: %s\n",file);
+        return 0;
+    }
+    if (fread(id,1,8,fp)!=8||strncmp(id,CHEB_ID,8)||
+        fread(t,sizeof(double),4,fp)!=4||fread(&cheb->nb,sizeof(int),1,fp)!=1||
+        fread(&n,sizeof(int),1,fp)!=1||cheb->nb<=0||n<=0||n>MAXSAT||
+        !(cheb->arc=(chebarc_t *)calloc(n,sizeof(chebarc_t)))) {
+        trace(2,"chebyshev file format error: %s\n",file);
+        fclose(fp);
+        return 0;
+    }
+    cheb->ts.time=(time_t)t[0];
+    cheb->ts.sec=t[1];
+    cheb->tblk=t[2];
+    cheb->tol=t[3];
+    
+    for (i=0;i<n&&stat;i++) {
+        arc=cheb->arc+i;
+        if (fread(&arc->sat,sizeof(int),1,fp)!=1||arc->sat<=0||
+            arc->sat>MAXSAT||!(arc->svh=(int *)malloc(sizeof(int)*cheb->nb))||
+            fread(arc->svh,sizeof(int),cheb->nb,fp)!=(size_t)cheb->nb) {
+            stat=0;
+            break;
+        }
+        cheb->idx[arc->sat-1]=i;
+        cheb->n=i+1;
+    
+        for (k=0;k<2&&stat;k++) {
+            s=arc->s+k;
+            if (fread(&s->deg,sizeof(int),1,fp)!=1||
+                fread(&s->nc ,sizeof(int),1,fp)!=1||
+                fread(&s->ns ,sizeof(int),1,fp)!=1||s->deg<0||s->deg>MAXDEG||
+                (s->nc!=1&&s->nc!=3)||s->ns<0||
+                !(s->m  =(int   *)malloc(sizeof(int  )*cheb->nb))||
+                !(s->off=(int   *)malloc(sizeof(int  )*cheb->nb))||
+                !(s->var=(float *)malloc(sizeof(float)*cheb->nb))||
+                !(s->c=(double *)malloc(sizeof(double)*s->nc*(s->deg+1)*
+                                        (s->ns>0?s->ns:1)))||
+                fread(s->m  ,sizeof(int  ),cheb->nb,fp)!=(size_t)cheb->nb||
+                fread(s->var,sizeof(float),cheb->nb,fp)!=(size_t)cheb->nb||
+                fread(s->c,sizeof(double),s->nc*(s->deg+1)*s->ns,fp)!=
+                (size_t)(s->nc*(s->deg+1)*s->ns)) {
+                stat=0;
+                break;
+            }
+            for (j=ns=0;j<cheb->nb;j++) {
+                s->off[j]=ns;
+                ns+=s->m[j];
+            }
+            if (ns!=s->ns) stat=0;
+        }
+    }
+    fclose(fp);
+    
+    if (!stat) {
+        trace(2,"chebyshev file read error: %s\n",file);
+        freecheb(cheb);
+        return 0;
+    }
+    return 1;
+}
+/* write chebyshev orbit/clock file --------------------------------------------
+* write chebyshev orbit/clock to binary file read by readcheb()
+* args   : char   *file     I   file path
+*          cheb_t *cheb     I   chebyshev orbit/clock
+* return : status (1:ok,0:error)
+* notes  : the fields are written in the native byte order
+*-----------------------------------------------------------------------------*/
+extern int writecheb(const char *file, const cheb_t *cheb)
+{
+    FILE *fp;
+    const chebarc_t *arc;
+    const chebs_t *s;
+    double t[4];
+    int i,k,n,stat=1;
+    
+    trace(3,"writecheb: file=%s n=%d\n",file,cheb->n);
+    
+    if (cheb->n<=0) return 0;
+    
+    if (!(fp=fopen(file,"wb"))) {
+        trace(2,"chebyshev file open error: %s\n",file);
+        return 0;
+    }
+    t[0]=(double)cheb->ts.time;
+    t[1]=cheb->ts.sec;
+    t[2]=cheb->tblk;
+    t[3]=cheb->tol;
+    
+    if (fwrite(CHEB_ID,1,8,fp)!=8||fwrite(t,sizeof(double),4,fp)!=4||
+        fwrite(&cheb->nb,sizeof(int),1,fp)!=1||
+        fwrite(&cheb->n,sizeof(int),1,fp)!=1) stat=0;
+    
+    for (i=0;i<cheb->n&&stat;i++) {
+        arc=cheb->arc+i;
+        if (fwrite(&arc->sat,sizeof(int),1,fp)!=1||
+            fwrite(arc->svh,sizeof(int),cheb->nb,fp)!=(size_t)cheb->nb) {
+            stat=0;
+        }
+        for (k=0;k<2&&stat;k++) {
+            s=arc->s+k;
+            n=s->nc*(s->deg+1)*s->ns;
+            if (fwrite(&s->deg,sizeof(int),1,fp)!=1||
+                fwrite(&s->nc ,sizeof(int),1,fp)!=1||
+                fwrite(&s->ns ,sizeof(int),1,fp)!=1||
+                fwrite(s->m  ,sizeof(int  ),cheb->nb,fp)!=(size_t)cheb->nb||
+                fwrite(s->var,sizeof(float),cheb->nb,fp)!=(size_t)cheb->nb||
+                fwrite(s->c,sizeof(double),n,fp)!=(size_t)n) stat=0;
+        }
+    }
+    if (ferror(fp)) stat=0;
+    fclose(fp);
+    return stat;
+}
+/* free chebyshev orbit/clock --------------------------------------------------
+* free memory for chebyshev orbit/clock
+* args   : cheb_t *cheb     IO  chebyshev orbit/clock
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void freecheb(cheb_t *cheb)
+{
+    int i;
+    
+    for (i=0;i<cheb->n;i++) freearc(cheb->arc+i);
+    free(cheb->arc); cheb->arc=NULL;
+    cheb->n=0;
+    for (i=0;i<MAXSAT;i++) cheb->idx[i]=-1;
+}
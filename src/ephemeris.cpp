@@ -58,6 +58,12 @@
 *                           support ura value in var_uraeph() for galileo
 *                           test eph->flag to recognize beidou geo
 *                           add api satseleph() for ephemeris selection
+*           2025/07/24 1.14 select ephemeris by index nav->ephidx
+*           2025/07/26 1.15 add api compeph(),eph2pos_batch()
+*                           compute broadcast orbits of satposs() by batch
+*           2025/07/28 1.16 cache glonass orbit integration of geph2pos()
+*           2025/07/30 1.17 compute precise orbits of satposs() by batch
+*           2025/08/02 1.18 add ephemeris option EPHOPT_CHEB
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -92,8 +98,10 @@
 #define STD_GAL_NAPA 500.0        /* error of galileo ephemeris for NAPA (m) */
 
 #define MAX_ITER_KEPLER 30        /* max number of iteration of Kelpler */
+#define NBATCH   32               /* batch size of eph2pos_batch() */
+#define NGLOSTEP 31               /* max cached steps of glonass orbit */
 
-static int dscode;                  /* GAL CODE 1: I/NAV, 2:F/NAV */
+static thread_local int dscode;     /* GAL CODE 1: I/NAV, 2:F/NAV */
 /* ephemeris selections ------------------------------------------------------*/
 static int eph_sel[]={ /* GPS,GLO,GAL,QZS,BDS,SBS */
     0,0,1,0,0,0
@@ -191,103 +199,211 @@ extern double eph2clk(gtime_t time, const eph_t *eph)
     }
     return eph->f0+eph->f1*t+eph->f2*t*t;
 }
-/* broadcast ephemeris to satellite position and clock bias --------------------
-* compute satellite position and clock bias with broadcast ephemeris (gps,
-* galileo, qzss)
-* args   : gtime_t time     I   time (gpst)
-*          eph_t *eph       I   broadcast ephemeris
-*          double *rs       O   satellite position (ecef) {x,y,z} (m)
-*          double *dts      O   satellite clock bias (s)
-*          double *var      O   satellite position and clock variance (m^2)
+/* sine and cosine -----------------------------------------------------------*/
+static void sin_cos(double x, double *s, double *c)
+{
+#ifdef __GLIBC__
+    sincos(x,s,c);
+#else
+    *s=sin(x); *c=cos(x);
+#endif
+}
+/* compile broadcast ephemeris -------------------------------------------------
+* compile broadcast ephemeris to the constants for orbit computation
+* args   : eph_t  *eph      I   broadcast ephemeris
+*          ephc_t *ec       O   compiled ephemeris
 * return : none
-* notes  : see ref [1],[7],[8]
-*          satellite clock includes relativity correction without code bias
-*          (tgd or bgd)
+* notes  : uniqnav() compiles all ephemerides to nav->ephidx->ec
 *-----------------------------------------------------------------------------*/
-extern void eph2pos(gtime_t time, const eph_t *eph, double *rs, double *dts,
-                    double *var)
+extern void compeph(const eph_t *eph, ephc_t *ec)
 {
-    double tk,M,E,Ek,sinE,cosE,u,r,i,O,sin2u,cos2u,x,y,sinO,cosO,cosi,mu,omge;
-    double xg,yg,zg,sino,coso;
-    int n,sys,prn;
-	static double A_ref_igso = 42162200, A_ref_meo = 27906100;
-	double na, delta_na, A0, Ak, n0;
-
-
-   // trace(4,"eph2pos : time=%s sat=%2d\n",time_str(time,3),eph->sat);
-    
-    if (eph->A<=0.0) {
-        rs[0]=rs[1]=rs[2]=*dts=*var=0.0;
-        return;
-    }
-    tk=timediff(time,eph->toe);
+    int prn;
     
-    switch ((sys=satsys(eph->sat,&prn))) {
-        case SYS_GAL: mu=MU_GAL; omge=OMGE_GAL; break;
-        case SYS_CMP: mu=MU_CMP; omge=OMGE_CMP; break;
-        default:      mu=MU_GPS; omge=OMGE;     break;
+    ec->sys=satsys(eph->sat,&prn);
+    switch (ec->sys) {
+        case SYS_GAL: ec->mu=MU_GAL; ec->omge=OMGE_GAL; break;
+        case SYS_CMP: ec->mu=MU_CMP; ec->omge=OMGE_CMP; break;
+        default:      ec->mu=MU_GPS; ec->omge=OMGE;     break;
     }
-
-	if (sys == SYS_CMP&&eph->code>0)
-    {
-		A0 = eph->A;
-		Ak = A0 + eph->Adot*tk;
-		n0 = sqrt(mu / A0 / A0 / A0);
-		delta_na = eph->deln + 0.5*eph->ndot*tk;
-		na = n0 + delta_na;
-		M = eph->M0 + na*tk;
-	}
-	else{
-		M = eph->M0 + (sqrt(mu / (eph->A*eph->A*eph->A)) + eph->deln)*tk;
-	}
+    ec->cnav=ec->sys==SYS_CMP&&eph->code>0;
+    ec->geo=ec->sys==SYS_CMP&&(eph->flag==1||(eph->flag==0&&(prn<=5||prn>=59)));
+    ec->n=ec->sqe=ec->rel=0.0;
     
-    for (n=0,E=M,Ek=0.0;fabs(E-Ek)>RTOL_KEPLER&&n<MAX_ITER_KEPLER;n++) {
-        Ek=E; E-=(E-eph->e*sin(E)-M)/(1.0-eph->e*cos(E));
+    if (eph->A>0.0) {
+        if (ec->cnav) ec->n=sqrt(ec->mu/eph->A/eph->A/eph->A);
+        else ec->n=sqrt(ec->mu/(eph->A*eph->A*eph->A))+eph->deln;
+        ec->sqe=sqrt(1.0-eph->e*eph->e);
+        ec->rel=2.0*sqrt(ec->mu*eph->A)*eph->e;
     }
-    if (n>=MAX_ITER_KEPLER) {
-       // trace(2,"eph2pos: kepler iteration overflow sat=%2d\n",eph->sat);
-        return;
+    ec->OMGd=ec->geo?eph->OMGd:eph->OMGd-ec->omge;
+    ec->OMGt=ec->omge*eph->toes;
+    ec->var=var_uraeph(ec->sys,eph->sva);
+}
+/* mean anomaly and semi-major axis at time ----------------------------------*/
+static double meananom(const eph_t *eph, const ephc_t *ec, double tk,
+                       double *A)
+{
+    if (ec->cnav) {
+        *A=eph->A+eph->Adot*tk;
+        return eph->M0+(ec->n+(eph->deln+0.5*eph->ndot*tk))*tk;
     }
-    sinE=sin(E); cosE=cos(E);
-    
-   // trace(4,"kepler: sat=%2d e=%8.5f n=%2d del=%10.3e\n",eph->sat,eph->e,n,E-Ek);
+    *A=eph->A;
+    return eph->M0+ec->n*tk;
+}
+/* satellite position and clock bias by eccentric anomaly --------------------*/
+static void kepler2pos(gtime_t time, const eph_t *eph, const ephc_t *ec,
+                       double tk, double A, double E, double *rs, double *dts,
+                       double *var)
+{
+    double sinE,cosE,u,r,i,O,sin2u,cos2u,sinu,cosu,x,y,sinO,cosO,sini,cosi;
+    double xg,yg,zg,sino,coso;
     
-    u=atan2(sqrt(1.0-eph->e*eph->e)*sinE,cosE-eph->e)+eph->omg;
-	r = ((sys == SYS_CMP&&eph->code>0) ? Ak : eph->A)*(1.0 - eph->e*cosE);
+    sin_cos(E,&sinE,&cosE);
+    u=atan2(ec->sqe*sinE,cosE-eph->e)+eph->omg;
+    r=A*(1.0-eph->e*cosE);
     i=eph->i0+eph->idot*tk;
-    sin2u=sin(2.0*u); cos2u=cos(2.0*u);
+    sin_cos(2.0*u,&sin2u,&cos2u);
     u+=eph->cus*sin2u+eph->cuc*cos2u;
     r+=eph->crs*sin2u+eph->crc*cos2u;
     i+=eph->cis*sin2u+eph->cic*cos2u;
-    x=r*cos(u); y=r*sin(u); cosi=cos(i);
+    sin_cos(u,&sinu,&cosu);
+    sin_cos(i,&sini,&cosi);
+    x=r*cosu; y=r*sinu;
+    O=eph->OMG0+ec->OMGd*tk-ec->OMGt;
+    sin_cos(O,&sinO,&cosO);
     
     /* beidou geo satellite */
-    if (sys==SYS_CMP&&(eph->flag==1||(eph->flag==0&&(prn<=5||prn>=59)))) {
-        O=eph->OMG0+eph->OMGd*tk-omge*eph->toes;
-        sinO=sin(O); cosO=cos(O);
+    if (ec->geo) {
         xg=x*cosO-y*cosi*sinO;
         yg=x*sinO+y*cosi*cosO;
-        zg=y*sin(i);
-        sino=sin(omge*tk); coso=cos(omge*tk);
+        zg=y*sini;
+        sin_cos(ec->omge*tk,&sino,&coso);
         rs[0]= xg*coso+yg*sino*COS_5+zg*sino*SIN_5;
         rs[1]=-xg*sino+yg*coso*COS_5+zg*coso*SIN_5;
         rs[2]=-yg*SIN_5+zg*COS_5;
     }
     else {
-        O=eph->OMG0+(eph->OMGd-omge)*tk-omge*eph->toes;
-        sinO=sin(O); cosO=cos(O);
         rs[0]=x*cosO-y*cosi*sinO;
         rs[1]=x*sinO+y*cosi*cosO;
-        rs[2]=y*sin(i);
+        rs[2]=y*sini;
     }
     tk=timediff(time,eph->toc);
     *dts=eph->f0+eph->f1*tk+eph->f2*tk*tk;
     
     /* relativity correction */
-	*dts -= 2.0*sqrt(mu*((sys == SYS_CMP&&eph->code>0) ? Ak : eph->A))*eph->e*sinE / SQR(CLIGHT);
-
+    *dts-=(ec->cnav?2.0*sqrt(ec->mu*A)*eph->e:ec->rel)*sinE/SQR(CLIGHT);
+    
     /* position and clock error variance */
-    *var=var_uraeph(sys,eph->sva);
+    *var=ec->var;
+}
+/* satellite position and clock bias by compiled ephemeris -------------------*/
+static void ephc2pos(gtime_t time, const eph_t *eph, const ephc_t *ec,
+                     double *rs, double *dts, double *var)
+{
+    ephc_t ecl;
+    double tk,M,E,Ek,A,sinE,cosE;
+    int n;
+    
+    if (eph->A<=0.0) {
+        rs[0]=rs[1]=rs[2]=*dts=*var=0.0;
+        return;
+    }
+    if (!ec) {
+        compeph(eph,&ecl);
+        ec=&ecl;
+    }
+    tk=timediff(time,eph->toe);
+    M=meananom(eph,ec,tk,&A);
+    
+    for (n=0,E=M,Ek=0.0;fabs(E-Ek)>RTOL_KEPLER&&n<MAX_ITER_KEPLER;n++) {
+        Ek=E; sin_cos(E,&sinE,&cosE); E-=(E-eph->e*sinE-M)/(1.0-eph->e*cosE);
+    }
+    if (n>=MAX_ITER_KEPLER) {
+       // trace(2,"eph2pos: kepler iteration overflow sat=%2d\n",eph->sat);
+        return;
+    }
+    kepler2pos(time,eph,ec,tk,A,E,rs,dts,var);
+}
+/* broadcast ephemeris to satellite position and clock bias --------------------
+* compute satellite position and clock bias with broadcast ephemeris (gps,
+* galileo, qzss)
+* args   : gtime_t time     I   time (gpst)
+*          eph_t *eph       I   broadcast ephemeris
+*          double *rs       O   satellite position (ecef) {x,y,z} (m)
+*          double *dts      O   satellite clock bias (s)
+*          double *var      O   satellite position and clock variance (m^2)
+* return : none
+* notes  : see ref [1],[7],[8]
+*          satellite clock includes relativity correction without code bias
+*          (tgd or bgd)
+*-----------------------------------------------------------------------------*/
+extern void eph2pos(gtime_t time, const eph_t *eph, double *rs, double *dts,
+                    double *var)
+{
+    ephc2pos(time,eph,NULL,rs,dts,var);
+}
+/* broadcast ephemerides to satellite positions and clock biases ---------------
+* compute satellite positions and clock biases with broadcast ephemerides for
+* a batch of satellites and times
+* args   : gtime_t *time    I   times (gpst) {time[0],time[1],...}
+*          eph_t  **eph     I   broadcast ephemerides {eph[0],eph[1],...}
+*          ephc_t **ec      I   compiled ephemerides (NULL or ec[i]=NULL: not
+*                               compiled)
+*          int    n         I   number of batch
+*          double *rs       O   satellite positions (ecef) {x,y,z,...} (m)
+*          double *dts      O   satellite clock biases {dts[0],...} (s)
+*          double *var      O   satellite position and clock variances (m^2)
+* return : none
+* notes  : same as eph2pos() for each of the batch. the kepler equations of
+*          the batch are solved in lockstep by newton's method. the outputs
+*          are not changed by the kepler iteration overflow
+*-----------------------------------------------------------------------------*/
+extern void eph2pos_batch(const gtime_t *time, const eph_t **eph,
+                          const ephc_t **ec, int n, double *rs, double *dts,
+                          double *var)
+{
+    ephc_t ecl[NBATCH];
+    const ephc_t *c[NBATCH];
+    double tk[NBATCH],A[NBATCH],M[NBATCH],E[NBATCH],Ek[NBATCH],e[NBATCH];
+    double sinE,cosE;
+    int i,j,k,m,na,it[NBATCH];
+    
+    for (k=0;k<n;k+=NBATCH) {
+        m=n-k<NBATCH?n-k:NBATCH;
+        
+        /* mean anomalies */
+        for (i=0;i<m;i++) {
+            j=k+i;
+            it[i]=MAX_ITER_KEPLER;
+            if (eph[j]->A<=0.0) {
+                rs[j*3]=rs[1+j*3]=rs[2+j*3]=dts[j]=var[j]=0.0;
+                continue;
+            }
+            if (ec&&ec[j]) c[i]=ec[j];
+            else {
+                compeph(eph[j],ecl+i);
+                c[i]=ecl+i;
+            }
+            tk[i]=timediff(time[j],eph[j]->toe);
+            M[i]=meananom(eph[j],c[i],tk[i],A+i);
+            E[i]=M[i]; Ek[i]=0.0; e[i]=eph[j]->e; it[i]=0;
+        }
+        /* kepler equations with convergence test for each */
+        for (na=1;na>0;) {
+            for (i=na=0;i<m;i++) {
+                if (it[i]>=MAX_ITER_KEPLER||!(fabs(E[i]-Ek[i])>RTOL_KEPLER)) continue;
+                Ek[i]=E[i];
+                sin_cos(E[i],&sinE,&cosE);
+                E[i]-=(E[i]-e[i]*sinE-M[i])/(1.0-e[i]*cosE);
+                it[i]++; na++;
+            }
+        }
+        for (i=0;i<m;i++) {
+            j=k+i;
+            if (eph[j]->A<=0.0||it[i]>=MAX_ITER_KEPLER) continue;
+            kepler2pos(time[j],eph[j],c[i],tk[i],A[i],E[i],rs+j*3,dts+j,var+j);
+        }
+    }
 }
 /* glonass orbit differential equations --------------------------------------*/
 static void deq(const double *x, double *xdot, const double *acc)
@@ -319,6 +435,46 @@ static void glorbit(double t, double *x, const double *acc)
     deq(w,k4,acc);
     for (i=0;i<6;i++) x[i]+=(k1[i]+2.0*k2[i]+2.0*k3[i]+k4[i])*t/6.0;
 }
+/* glonass orbit integration states --------------------------------------------
+* states of glonass orbit integration at toe+-k*TSTEP (k=0,1,...) cached for
+* each satellite and ephemeris. geph2pos() starts from the cached state of the
+* last full step instead of toe. the states are same as the integration from
+* toe in geph2pos() since the same steps are taken in the same order.
+*-----------------------------------------------------------------------------*/
+typedef struct {        /* glonass orbit integration cache type */
+    int sat;            /* satellite number (0:none) */
+    gtime_t toe;        /* epoch of ephemerides (gpst) */
+    double pos[3],vel[3],acc[3]; /* ephemeris state and acceleration */
+    int n[2];           /* number of cached steps (0:backward,1:forward) */
+    double x[2][NGLOSTEP+1][6]; /* states at toe-k*TSTEP,toe+k*TSTEP */
+} glocache_t;
+
+static thread_local glocache_t glocache[MAXPRNGLO+1]; /* cache by prn */
+
+/* glonass orbit integration cache of ephemeris ------------------------------*/
+static glocache_t *glocacheof(const geph_t *geph)
+{
+    glocache_t *c;
+    int i,prn;
+    
+    if (satsys(geph->sat,&prn)!=SYS_GLO||prn<1||prn>MAXPRNGLO) return NULL;
+    c=glocache+prn;
+    
+    if (c->sat!=geph->sat||c->toe.time!=geph->toe.time||c->toe.sec!=geph->toe.sec||
+        memcmp(c->pos,geph->pos,sizeof(c->pos))||
+        memcmp(c->vel,geph->vel,sizeof(c->vel))||
+        memcmp(c->acc,geph->acc,sizeof(c->acc))) {
+        c->sat=geph->sat;
+        c->toe=geph->toe;
+        for (i=0;i<3;i++) {
+            c->pos[i]=c->x[0][0][i  ]=c->x[1][0][i  ]=geph->pos[i];
+            c->vel[i]=c->x[0][0][i+3]=c->x[1][0][i+3]=geph->vel[i];
+            c->acc[i]=geph->acc[i];
+        }
+        c->n[0]=c->n[1]=0;
+    }
+    return c;
+}
 /* glonass ephemeris to satellite clock bias -----------------------------------
 * compute satellite clock bias with glonass ephemeris
 * args   : gtime_t time     I   time by satellite clock (gpst)
@@ -349,12 +505,15 @@ extern double geph2clk(gtime_t time, const geph_t *geph)
 *          double *var      O   satellite position and clock variance (m^2)
 * return : none
 * notes  : see ref [2]
+*          the integration starts from the cached state of the satellite and
+*          ephemeris nearest to time (not thread shared)
 *-----------------------------------------------------------------------------*/
 extern void geph2pos(gtime_t time, const geph_t *geph, double *rs, double *dts,
                      double *var)
 {
+    glocache_t *c;
     double t,tt,x[6];
-    int i;
+    int i,j,k,d;
     
     //trace(4,"geph2pos: time=%s sat=%2d\n",time_str(time,3),geph->sat);
     
@@ -362,13 +521,32 @@ extern void geph2pos(gtime_t time, const geph_t *geph, double *rs, double *dts,
     
     *dts=-geph->taun+geph->gamn*t;
     
-    for (i=0;i<3;i++) {
-        x[i  ]=geph->pos[i];
-        x[i+3]=geph->vel[i];
+    tt=t<0.0?-TSTEP:TSTEP;
+    
+    if ((c=glocacheof(geph))) {
+        
+        /* full steps to time and state of the last cached step */
+        for (k=0;fabs(t)>1E-9&&fabs(t)>=TSTEP;k++) t-=tt;
+        d=tt>0.0;
+        for (j=c->n[d];j<k&&j<NGLOSTEP;j++) {
+            matcpy(c->x[d][j+1],c->x[d][j],6,1);
+            glorbit(tt,c->x[d][j+1],geph->acc);
+        }
+        if (c->n[d]<j) c->n[d]=j;
+        j=k<NGLOSTEP?k:NGLOSTEP;
+        matcpy(x,c->x[d][j],6,1);
+        for (;j<k;j++) glorbit(tt,x,geph->acc);
+        if (fabs(t)>1E-9) glorbit(t,x,geph->acc);
     }
-    for (tt=t<0.0?-TSTEP:TSTEP;fabs(t)>1E-9;t-=tt) {
-        if (fabs(t)<TSTEP) tt=t;
-        glorbit(tt,x,geph->acc);
+    else {
+        for (i=0;i<3;i++) {
+            x[i  ]=geph->pos[i];
+            x[i+3]=geph->vel[i];
+        }
+        for (;fabs(t)>1E-9;t-=tt) {
+            if (fabs(t)<TSTEP) tt=t;
+            glorbit(tt,x,geph->acc);
+        }
     }
     for (i=0;i<3;i++) rs[i]=x[i];
     
@@ -529,6 +707,139 @@ extern double gettgd(int sat, const nav_t *nav, int f, int *galcode)
 	return 0.0;
 }
 
+/* ephemeris index -------------------------------------------------------------
+* lists of nav->ephidx are sorted by toe. the selections from the lists are
+* same as the linear searches of nav->eph/geph: the closest toe within tmin,
+* the last one in nav->eph/geph for the same distance, or the first one in
+* nav->eph/geph for the specified iode. the list position of the last search
+* is kept for each satellite as a hint of the next one.
+*-----------------------------------------------------------------------------*/
+static thread_local int idxhint[MAXSAT][NEPHIDX+1]; /* last list positions */
+
+/* ephemeris index available -------------------------------------------------*/
+static int ephidxok(const nav_t *nav, int glo)
+{
+    const ephidx_t *x=nav->ephidx;
+    
+    if (!x) return 0;
+    return glo?x->geph==nav->geph&&x->ng==nav->ng:x->eph==nav->eph&&x->n==nav->n;
+}
+/* toe of ephemeris in index list --------------------------------------------*/
+static gtime_t idxtoe(const nav_t *nav, int glo, int i)
+{
+    return glo?nav->geph[i].toe:nav->eph[i].toe;
+}
+/* list position of first toe at or after time -------------------------------*/
+static int idxsearch(const nav_t *nav, int glo, const int *idx, int n,
+                     gtime_t time, int *hint)
+{
+    int p=*hint,l,r,m;
+    
+    if (p<0||p>n||(p>0&&timediff(idxtoe(nav,glo,idx[p-1]),time)>=0.0)||
+        (p<n&&timediff(idxtoe(nav,glo,idx[p]),time)<0.0)) {
+        for (l=0,r=n;l<r;) {
+            m=(l+r)/2;
+            if (timediff(idxtoe(nav,glo,idx[m]),time)<0.0) l=m+1; else r=m;
+        }
+        p=l;
+    }
+    return *hint=p;
+}
+/* select ephemeris of toe closest to time in index list ---------------------
+* mask: required bits of eph->code (0: none), chkttr: transmission time <= time
+*-----------------------------------------------------------------------------*/
+static int idxselect(const nav_t *nav, int glo, const int *idx, int n,
+                     int *hint, gtime_t time, int mask, int chkttr, double tmax,
+                     double *tmin)
+{
+    double tl,tr,t,tb=0.0;
+    int l,r,i,j=-1;
+    
+    r=idxsearch(nav,glo,idx,n,time,hint);
+    
+    /* lists on both sides of time in order of distance */
+    for (l=r-1;;) {
+        tl=l>=0?-timediff(idxtoe(nav,glo,idx[l]),time):1E300;
+        tr=r<n ? timediff(idxtoe(nav,glo,idx[r]),time):1E300;
+        if (tl<=tr) {t=tl; i=idx[l--];} else {t=tr; i=idx[r++];}
+        
+        if (t>tmax||t>*tmin||(j>=0&&t>tb)) break;
+        if (mask&&!(nav->eph[i].code&mask)) continue;
+        if (chkttr&&timediff(nav->eph[i].ttr,time)>0.0) continue;
+        if (i>j) {j=i; tb=t;}
+    }
+    if (j>=0) *tmin=tb;
+    return j;
+}
+/* select ephemeris of iode in index list ------------------------------------*/
+static int idxiode(const nav_t *nav, int glo, const int *idx, int n,
+                   gtime_t time, int iode, int mask, double tmax)
+{
+    int i,k,j=-1;
+    
+    for (k=0;k<n;k++) {
+        i=idx[k];
+        if (j>=0&&i>j) continue;
+        if ((glo?nav->geph[i].iode:nav->eph[i].iode)!=iode) continue;
+        if (mask&&!(nav->eph[i].code&mask)) continue;
+        if (fabs(timediff(idxtoe(nav,glo,i),time))>tmax) continue;
+        j=i;
+    }
+    return j;
+}
+/* select ephemeris by index -------------------------------------------------*/
+static eph_t *selephidx(gtime_t time, int sat, int iode, const nav_t *nav,
+                        int sys, int sel, int type, double tmax)
+{
+    const ephidx_t *x=nav->ephidx;
+    const int *idx;
+    double tmin=tmax+1.0;
+    int i,k,n,j=-1,j_E5b=-1,j_E5a=-1,mask=sys==SYS_GAL&&sel==1?1<<9:0;
+    
+    /* lnav (or cnav by type) */
+    k=(sat-1)*NEPHIDX+type;
+    idx=x->idx+x->ie[k];
+    n=x->ie[k+1]-x->ie[k];
+    
+    if (sys==SYS_GAL&&sel) {
+        for (i=0;i<n;i++) {
+            if (iode>=0&&nav->eph[idx[i]].iode!=iode) continue;
+            dscode=1;
+            break;
+        }
+    }
+    if (iode>=0) {
+        if ((j=idxiode(nav,0,idx,n,time,iode,mask,tmax))>=0) return nav->eph+j;
+    }
+    else {
+        j_E5b=idxselect(nav,0,idx,n,idxhint[sat-1]+type,time,mask,1,tmax,&tmin);
+    }
+    /* if E5a SPP, the F/NAV are perferred */
+    if (sys==SYS_GAL) {
+        k=(sat-1)*NEPHIDX+EPHIDX_FNAV;
+        idx=x->idx+x->ie[k];
+        n=x->ie[k+1]-x->ie[k];
+        
+        if (iode>=0) {
+            if ((j=idxiode(nav,0,idx,n,time,iode,0,tmax))>=0) return nav->eph+j;
+        }
+        else {
+            j_E5a=idxselect(nav,0,idx,n,idxhint[sat-1]+EPHIDX_FNAV,time,0,0,
+                            tmax,&tmin);
+        }
+        if (nav->galfreq&(1 << 1) && j_E5b >= 0){ j = j_E5b; dscode = 2; }
+        else if (nav->galfreq&(1 << 2) && j_E5a >= 0){ j = j_E5a; dscode = 2; }
+        else { j = j_E5b >= 0 ? j_E5b : (j_E5a >= 0 ? j_E5a : -1); }
+    }
+    else j=j_E5b;
+    
+    if (iode>=0||j<0) {
+        trace(3,"no broadcast ephemeris: %s sat=%2d iode=%3d\n",time_str(time,0),
+              sat,iode);
+        return NULL;
+    }
+    return nav->eph+j;
+}
 /* select ephememeris --------------------------------------------------------*/
 #if 0
 static eph_t *seleph(gtime_t time, int sat, int iode, const nav_t *nav)
@@ -630,6 +941,8 @@ static eph_t *seleph(const prcopt_t *opt,gtime_t time, int sat, int iode, const
 		else if (test_freq(opt->freqopt, 5)){ mesgType = 0; }
 	}
 #endif
+	if (ephidxok(nav, 0)) return selephidx(time, sat, iode, nav, sys, sel, mesgType, tmax);
+
 	for (i = 0; i<nav->n; i++) {
         // ѰһǺͬЧڵЧIODE汾Ŵ0&&timetoeСֵtmin
 		if (nav->eph[i].sat != sat) continue;
@@ -685,12 +998,22 @@ static eph_t *seleph(const prcopt_t *opt,gtime_t time, int sat, int iode, const
 /* select glonass ephememeris ------------------------------------------------*/
 static geph_t *selgeph(gtime_t time, int sat, int iode, const nav_t *nav)
 {
+    const ephidx_t *x;
+    const int *idx;
     double t,tmax=MAXDTOE_GLO,tmin=tmax+1.0;
-    int i,j=-1;
+    int i,n,j=-1;
     
     trace(4,"selgeph : time=%s sat=%2d iode=%2d\n",time_str(time,3),sat,iode);
     
-    for (i=0;i<nav->ng;i++) {
+    if (ephidxok(nav,1)) {
+        x=nav->ephidx;
+        idx=x->idx+x->ig[sat-1];
+        n=x->ig[sat]-x->ig[sat-1];
+        if (iode>=0) j=idxiode(nav,1,idx,n,time,iode,0,tmax);
+        else j=idxselect(nav,1,idx,n,idxhint[sat-1]+NEPHIDX,time,0,0,tmax,&tmin);
+        if (iode>=0&&j>=0) return nav->geph+j;
+    }
+    else for (i=0;i<nav->ng;i++) {
         if (nav->geph[i].sat!=sat) continue;
         if (iode>=0&&nav->geph[i].iode!=iode) continue;
         if ((t=fabs(timediff(nav->geph[i].toe,time)))>tmax) continue;
@@ -723,6 +1046,11 @@ static seph_t *selseph(gtime_t time, int sat, const nav_t *nav)
     }
     return nav->seph+j;
 }
+/* compiled ephemeris of selected ephemeris ----------------------------------*/
+static const ephc_t *selephc(const eph_t *eph, const nav_t *nav)
+{
+    return ephidxok(nav,0)?nav->ephidx->ec+(eph-nav->eph):NULL;
+}
 /* satellite clock with broadcast ephemeris ----------------------------------*/
 static int ephclk(const prcopt_t *opt,gtime_t time, gtime_t teph, int sat, const nav_t *nav,
                   double *dts)
@@ -762,6 +1090,7 @@ static int ephpos(const prcopt_t *opt,gtime_t time, gtime_t teph, int sat, const
     eph_t  *eph;
     geph_t *geph;
     seph_t *seph;
+    const ephc_t *ec;
     double rst[3],dtst[1],tt=1E-3;
     int i,sys;
     
@@ -773,9 +1102,10 @@ static int ephpos(const prcopt_t *opt,gtime_t time, gtime_t teph, int sat, const
     
     if (sys==SYS_GPS||sys==SYS_GAL||sys==SYS_QZS||sys==SYS_CMP) {
         if (!(eph=seleph(opt,teph,sat,iode,nav))) return 0;
-        eph2pos(time,eph,rs,dts,var);
+        ec=selephc(eph,nav);
+        ephc2pos(time,eph,ec,rs,dts,var);
         time=timeadd(time,tt);      //0.001sλãڼٶ
-        eph2pos(time,eph,rst,dtst,var);
+        ephc2pos(time,eph,ec,rst,dtst,var);
         *svh=eph->svh;
     }
     else if (sys==SYS_GLO) {
@@ -959,6 +1289,8 @@ extern int satpos(const prcopt_t *opt,gtime_t time, gtime_t teph, int sat, int e
             if (!peph2pos(time,sat,nav,1,rs,dts,var)) break; else return 1;
         case EPHOPT_LEX   :
             if (!lexeph2pos(time,sat,nav,rs,dts,var)) break; else return 1;
+        case EPHOPT_CHEB  :
+            if (!chebpos(time,sat,nav->cheb,rs,dts,var,svh)) break; else return 1;
     }
     *svh=-1;
     return 0;
@@ -986,13 +1318,22 @@ extern int satpos(const prcopt_t *opt,gtime_t time, gtime_t teph, int sat, int e
 *          satellite clock does not include code bias correction (tgd or bgd)
 *          any pseudorange and broadcast ephemeris are always needed to get
 *          signal transmission time
+*          broadcast orbits (except glonass and sbas) are computed by
+*          eph2pos_batch() and precise orbits by peph2pos_batch() for all of
+*          obs[]
+*          chebyshev orbits (EPHOPT_CHEB) get signal transmission time by the
+*          chebyshev clocks without broadcast ephemeris
 *-----------------------------------------------------------------------------*/
 extern void satposs(gtime_t teph, const obsd_t *obs, int n, const nav_t *nav,
 	const prcopt_t *opt,int ephopt, double *rs, double *dts, double *var, int *svh)
 {
-    gtime_t time[2*MAXOBS]={{0}};
-    double dt,pr;
-    int i,j;
+    gtime_t time[2*MAXOBS]={{0}},tb[4*MAXOBS],tp[2*MAXOBS];
+    const eph_t *eb[4*MAXOBS],*eph[2*MAXOBS]={0};
+    const ephc_t *cb[4*MAXOBS];
+    double dt,pr,rb[12*MAXOBS],db[4*MAXOBS],vb[4*MAXOBS],tt=1E-3;
+    double rp[12*MAXOBS],dp[4*MAXOBS],vp[2*MAXOBS];
+    int i,j,k,nb=0,np=0,sys,ok[2*MAXOBS]={0},ib[2*MAXOBS],ip[2*MAXOBS];
+    int sp[2*MAXOBS],stat[2*MAXOBS];
 	int prn;
    // trace(3,"satposs : teph=%s n=%d ephopt=%d\n",time_str(teph,3),n,ephopt);
     
@@ -1011,6 +1352,43 @@ extern void satposs(gtime_t teph, const obsd_t *obs, int n, const nav_t *nav,
         /* transmission time by satellite clock */
         time[i]=timeadd(obs[i].time,-pr/CLIGHT);
         
+        sys=satsys(obs[i].sat,NULL);
+        
+        /* broadcast orbits of gps, galileo, qzss and beidou by batch */
+        if (ephopt==EPHOPT_BRDC&&
+            (sys==SYS_GPS||sys==SYS_GAL||sys==SYS_QZS||sys==SYS_CMP)) {
+            if (!(eph[i]=seleph(opt,teph,obs[i].sat,-1,nav))) {
+                trace(3,"no broadcast clock %s sat=%2d\n",time_str(time[i],3),obs[i].sat);
+                continue;
+            }
+            time[i]=timeadd(time[i],-eph2clk(time[i],eph[i]));
+            
+            /* satellite position at transmission time and after tt */
+            for (k=0;k<2;k++,nb++) {
+                tb[nb]=k?timeadd(time[i],tt):time[i];
+                eb[nb]=eph[i];
+                cb[nb]=selephc(eph[i],nav);
+                for (j=0;j<3;j++) rb[j+nb*3]=0.0;
+                db[nb]=vb[nb]=0.0;
+            }
+            ib[nb/2-1]=i;
+            svh[i]=eph[i]->svh;
+            ok[i]=1;
+            continue;
+        }
+        /* chebyshev orbits and clocks need no broadcast ephemeris */
+        if (ephopt==EPHOPT_CHEB) {
+            if (!chebpos(time[i],obs[i].sat,nav->cheb,rs+i*6,dts+i*2,var+i,
+                         svh+i)) {
+                trace(3,"no chebyshev orbit %s sat=%2d\n",time_str(time[i],3),obs[i].sat);
+                svh[i]=-1;
+                continue;
+            }
+            time[i]=timeadd(time[i],-dts[i*2]);
+            chebpos(time[i],obs[i].sat,nav->cheb,rs+i*6,dts+i*2,var+i,svh+i);
+            ok[i]=1;
+            continue;
+        }
         /* satellite clock bias by broadcast ephemeris */
         if (!ephclk(opt,time[i],teph,obs[i].sat,nav,&dt)) {
             trace(3,"no broadcast clock %s sat=%2d\n",time_str(time[i],3),obs[i].sat);
@@ -1018,15 +1396,59 @@ extern void satposs(gtime_t teph, const obsd_t *obs, int n, const nav_t *nav,
         }
         time[i]=timeadd(time[i],-dt);
         
+        /* precise orbits and clocks by batch */
+        if (ephopt==EPHOPT_PREC) {
+            tp[np]=time[i];
+            sp[np]=obs[i].sat;
+            ip[np++]=i;
+            continue;
+        }
         /* satellite position and clock at transmission time */
         if (!satpos(opt,time[i],teph,obs[i].sat,ephopt,nav,rs+i*6,dts+i*2,var+i,
                     svh+i)) {
             trace(3,"no ephemeris %s sat=%2d\n",time_str(time[i],3),obs[i].sat);
             continue;
         }
+        ok[i]=1;
+    }
+    if (nb>0) {
+        eph2pos_batch(tb,eb,cb,nb,rb,db,vb);
+        
+        /* satellite velocity and clock drift by differential approx */
+        for (k=0;k<nb;k+=2) {
+            i=ib[k/2];
+            for (j=0;j<3;j++) {
+                rs[j+i*6]=rb[j+k*3];
+                rs[j+3+i*6]=(rb[j+(k+1)*3]-rb[j+k*3])/tt;
+            }
+            dts[i*2]=db[k];
+            dts[1+i*2]=(db[k+1]-db[k])/tt;
+            var[i]=vb[k+1];
+        }
+    }
+    if (np>0) {
+        peph2pos_batch(tp,sp,np,nav,1,rp,dp,vp,stat);
+        
+        for (k=0;k<np;k++) {
+            i=ip[k];
+            if (!stat[k]) {
+                svh[i]=-1;
+                trace(3,"no ephemeris %s sat=%2d\n",time_str(time[i],3),obs[i].sat);
+                continue;
+            }
+            for (j=0;j<6;j++) rs[j+i*6]=rp[j+k*6];
+            for (j=0;j<2;j++) dts[j+i*2]=dp[j+k*2];
+            var[i]=vp[k];
+            ok[i]=1;
+        }
+    }
+    for (i=0;i<n&&i<2*MAXOBS;i++) {
+        if (!ok[i]) continue;
+        
         /* if no precise clock available, use broadcast clock instead */
         if (dts[i*2]==0.0) {
-            if (!ephclk(opt,time[i],teph,obs[i].sat,nav,dts+i*2)) continue;
+            if (eph[i]) dts[i*2]=eph2clk(time[i],eph[i]);
+            else if (!ephclk(opt,time[i],teph,obs[i].sat,nav,dts+i*2)) continue;
             dts[1+i*2]=0.0;
             *var=SQR(STD_BRDCCLK);
         }
@@ -15,6 +15,12 @@
 *           2013/03/05 1.1 change api readtec()
 *                          fix problem in case of lat>85deg or lat<-85deg
 *           2014/02/22 1.2 fix problem on compiled as C++
+*           2025/07/06 1.3 read compressed ionex files (.Z,.gz) in memory
+*           2025/07/18 1.4 search tec grid epochs by bisection
+*                          share pierce points by bracketing tec grids
+*                          add api iontecn()
+*           2025/07/22 1.5 add api writetec()
+*                          read binary tec grid by readtec()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -22,6 +28,8 @@
 #define VAR_NOTEC   SQR(30.0)   /* variance of no tec */
 #define MIN_EL      0.0         /* min elevation angle (rad) */
 #define MIN_HGT     -1000.0     /* min user height (m) */
+#define TEC_EXP     -1          /* exponent of output ionex values */
+#define TECB_ID     "RTKTECB1"  /* id of binary tec grid file */
 
 /* get index -----------------------------------------------------------------*/
 static int getindex(double value, const double *range)
@@ -170,7 +178,7 @@ static int readionexb(FILE *fp, const double *lats, const double *lons,
 {
     tec_t *p=NULL;
     gtime_t time={0};
-    double lat,lon[3],hgt,x;
+    double lat,lon[3],hgt,x,vals[16];
     int i,j,k,n,m,index,type=0;
     char buff[1024],*label=buff+60;
     
@@ -221,12 +229,15 @@ static int readionexb(FILE *fp, const double *lats, const double *lons,
             n=nitem(lon);
             
             for (m=0;m<n;m++) {
-                if (m%16==0&&!fgets(buff,sizeof(buff),fp)) break;
+                if (m%16==0) {
+                    if (!fgets(buff,sizeof(buff),fp)) break;
+                    str2nums(buff,0,5,16,vals);
+                }
                 
                 j=getindex(lon[0]+lon[2]*m,p->lons);
                 if ((index=dataindex(i,j,k,p->ndata))<0) continue;
                 
-                if ((x=str2num(buff,m%16*5,5))==9999.0) continue;
+                if ((x=vals[m%16])==9999.0) continue;
                 
                 if (type==1) p->data[index]=x*pow(10.0,nexp);
                 else p->rms[index]=(float)(x*pow(10.0,nexp));
@@ -235,6 +246,42 @@ static int readionexb(FILE *fp, const double *lats, const double *lons,
     }
     return 1;
 }
+/* read binary tec grid ------------------------------------------------------*/
+static int readtecb(FILE *fp, nav_t *nav)
+{
+    tec_t *p;
+    double t[2],rb,lats[3],lons[3],hgts[3];
+    int ndata[3],n;
+    
+    trace(3,"readtecb:\n");
+    
+    while (fread(ndata,sizeof(int),3,fp)==3&&fread(t,sizeof(double),2,fp)==2&&
+           fread(&rb,sizeof(double),1,fp)==1&&
+           fread(lats,sizeof(double),3,fp)==3&&
+           fread(lons,sizeof(double),3,fp)==3&&
+           fread(hgts,sizeof(double),3,fp)==3) {
+        
+        if (!(p=addtec(lats,lons,hgts,rb,nav))) return 0;
+        
+        if (p->ndata[0]!=ndata[0]||p->ndata[1]!=ndata[1]||
+            p->ndata[2]!=ndata[2]) {
+            trace(2,"binary tec grid size error\n");
+            free(p->data); free(p->rms); nav->nt--;
+            return 0;
+        }
+        p->time.time=(time_t)t[0];
+        p->time.sec=t[1];
+        n=ndata[0]*ndata[1]*ndata[2];
+        
+        if (fread(p->data,sizeof(double),n,fp)!=(size_t)n||
+            fread(p->rms ,sizeof(float ),n,fp)!=(size_t)n) {
+            trace(2,"binary tec grid read error\n");
+            free(p->data); free(p->rms); nav->nt--;
+            return 0;
+        }
+    }
+    return 1;
+}
 /* combine tec grid data -----------------------------------------------------*/
 static void combtec(nav_t *nav)
 {
@@ -274,14 +321,17 @@ static void combtec(nav_t *nav)
 *          int    opt         I   read option (1: no clear of tec data,0:clear)
 * return : none
 * notes  : see ref [1]
+*          the files may be compressed by gzip or compress (.gz,.GZ,.Z,.z)
+*          binary tec grid files by writetec() are also read
 *-----------------------------------------------------------------------------*/
 extern void readtec(const char *file, nav_t *nav, int opt)
 {
     FILE *fp;
+    uncfile_t unc;
     double lats[3]={0},lons[3]={0},hgts[3]={0},rb=0.0,nexp=-1.0;
     double dcb[MAXSAT]={0},rms[MAXSAT]={0};
     int i,n;
-    char *efiles[MAXEXFILE];
+    char *efiles[MAXEXFILE],id[8];
     
     trace(3,"readtec : file=%s\n",file);
     
@@ -299,19 +349,31 @@ extern void readtec(const char *file, nav_t *nav, int opt)
     n=expath(file,efiles,MAXEXFILE);
     
     for (i=0;i<n;i++) {
-        if (!(fp=fopen(efiles[i],"r"))) {
+        /* binary tec grid */
+        if ((fp=fopen(efiles[i],"rb"))) {
+            if (fread(id,1,8,fp)==8&&!strncmp(id,TECB_ID,8)) {
+                if (!readtecb(fp,nav)) {
+                    trace(2,"binary tec grid format error %s\n",efiles[i]);
+                }
+                fclose(fp);
+                continue;
+            }
+            fclose(fp);
+        }
+        if (!(fp=open_uncfile(&unc,efiles[i],0))) {
             trace(2,"ionex file open error %s\n",efiles[i]);
             continue;
         }
         /* read ionex header */
         if (readionexh(fp,lats,lons,hgts,&rb,&nexp,dcb,rms)<=0.0) {
             trace(2,"ionex file format error %s\n",efiles[i]);
+            close_uncfile(&unc);
             continue;
         }
         /* read ionex body */
         readionexb(fp,lats,lons,hgts,rb,nexp,nav);
         
-        fclose(fp);
+        close_uncfile(&unc);
     }
     for (i=0;i<MAXEXFILE;i++) free(efiles[i]);
     
@@ -323,6 +385,169 @@ extern void readtec(const char *file, nav_t *nav, int opt)
         nav->cbias[i][0]=CLIGHT*dcb[i]*1E-9; /* ns->m */
     }
 }
+/* output ionex tec/rms map --------------------------------------------------*/
+static void outionexmap(FILE *fp, const tec_t *tec, int index, int type)
+{
+    double ep[6],x;
+    int i,j,k,m;
+    
+    time2epoch(tec->time,ep);
+    fprintf(fp,"%6d%54s%-20s\n",index,"",
+            type?"START OF RMS MAP":"START OF TEC MAP");
+    fprintf(fp,"%6d%6d%6d%6d%6d%6d%24s%-20s\n",(int)ep[0],(int)ep[1],
+            (int)ep[2],(int)ep[3],(int)ep[4],(int)floor(ep[5]+0.5),"",
+            "EPOCH OF CURRENT MAP");
+    
+    for (k=0;k<tec->ndata[2];k++) for (i=0;i<tec->ndata[0];i++) {
+        fprintf(fp,"  %6.1f%6.1f%6.1f%6.1f%6.1f%28s%-20s\n",
+                tec->lats[0]+tec->lats[2]*i,tec->lons[0],tec->lons[1],
+                tec->lons[2],tec->hgts[0]+tec->hgts[2]*k,"",
+                "LAT/LON1/LON2/DLON/H");
+        
+        for (j=0;j<tec->ndata[1];j++) {
+            m=dataindex(i,j,k,tec->ndata);
+            x=(type?tec->rms[m]:tec->data[m])/pow(10.0,TEC_EXP);
+            
+            /* negative or too large tec as non-available (9999) */
+            fprintf(fp,"%5d",x<0.0||x>=9998.5?9999:(int)floor(x+0.5));
+            if (j%16==15||j==tec->ndata[1]-1) fprintf(fp,"\n");
+        }
+    }
+    fprintf(fp,"%6d%54s%-20s\n",index,"",
+            type?"END OF RMS MAP":"END OF TEC MAP");
+}
+/* output ionex file ---------------------------------------------------------*/
+static void outionex(FILE *fp, const tec_t *tec, int n, const char *comment)
+{
+    gtime_t time;
+    double ep[6];
+    int i,m,rms=0;
+    char date[32],buff[61];
+    const char *p,*q;
+    
+    trace(3,"outionex: n=%d\n",n);
+    
+    time=timeget();
+    time.sec=0.0;
+    time2epoch(time,ep);
+    sprintf(date,"%04.0f%02.0f%02.0f %02.0f%02.0f%02.0f UTC",ep[0],ep[1],ep[2],
+            ep[3],ep[4],ep[5]);
+    
+    fprintf(fp,"%8.1f%12s%-20s%-20s%-20s\n",1.0,"","I","GNS",
+            "IONEX VERSION / TYPE");
+    fprintf(fp,"%-20.20s%-20.20s%-20.20s%-20s\n","RTKLIB " VER_RTKLIB,"",date,
+            "PGM / RUN BY / DATE");
+    for (p=comment;p&&*p;p=*q?q+1:q) {
+        if (!(q=strchr(p,'\n'))) q=p+strlen(p);
+        sprintf(buff,"%.*s",(int)(q-p<60?q-p:60),p);
+        fprintf(fp,"%-60s%-20s\n",buff,"COMMENT");
+    }
+    time2epoch(tec[0].time,ep);
+    fprintf(fp,"%6d%6d%6d%6d%6d%6d%24s%-20s\n",(int)ep[0],(int)ep[1],
+            (int)ep[2],(int)ep[3],(int)ep[4],(int)floor(ep[5]+0.5),"",
+            "EPOCH OF FIRST MAP");
+    time2epoch(tec[n-1].time,ep);
+    fprintf(fp,"%6d%6d%6d%6d%6d%6d%24s%-20s\n",(int)ep[0],(int)ep[1],
+            (int)ep[2],(int)ep[3],(int)ep[4],(int)floor(ep[5]+0.5),"",
+            "EPOCH OF LAST MAP");
+    fprintf(fp,"%6d%54s%-20s\n",n>1?(int)floor(timediff(tec[1].time,
+            tec[0].time)+0.5):0,"","INTERVAL");
+    fprintf(fp,"%6d%54s%-20s\n",n,"","# OF MAPS IN FILE");
+    fprintf(fp,"  %-4s%54s%-20s\n","NONE","","MAPPING FUNCTION");
+    fprintf(fp,"%8.1f%52s%-20s\n",0.0,"","ELEVATION CUTOFF");
+    fprintf(fp,"%-60s%-20s\n","","OBSERVABLES USED");
+    fprintf(fp,"%8.1f%52s%-20s\n",tec[0].rb,"","BASE RADIUS");
+    fprintf(fp,"%6d%54s%-20s\n",tec[0].ndata[2]>1?3:2,"","MAP DIMENSION");
+    fprintf(fp,"  %6.1f%6.1f%6.1f%40s%-20s\n",tec[0].hgts[0],
+            tec[0].hgts[0]+tec[0].hgts[2]*(tec[0].ndata[2]-1),tec[0].hgts[2],
+            "","HGT1 / HGT2 / DHGT");
+    fprintf(fp,"  %6.1f%6.1f%6.1f%40s%-20s\n",tec[0].lats[0],tec[0].lats[1],
+            tec[0].lats[2],"","LAT1 / LAT2 / DLAT");
+    fprintf(fp,"  %6.1f%6.1f%6.1f%40s%-20s\n",tec[0].lons[0],tec[0].lons[1],
+            tec[0].lons[2],"","LON1 / LON2 / DLON");
+    fprintf(fp,"%6d%54s%-20s\n",TEC_EXP,"","EXPONENT");
+    fprintf(fp,"%60s%-20s\n","","END OF HEADER");
+    
+    for (i=0;i<n;i++) outionexmap(fp,tec+i,i+1,0);
+    
+    /* rms maps if any */
+    for (i=0;i<n&&!rms;i++) {
+        m=tec[i].ndata[0]*tec[i].ndata[1]*tec[i].ndata[2];
+        while (m>0&&!rms) rms=tec[i].rms[--m]>0.0f;
+    }
+    if (rms) for (i=0;i<n;i++) outionexmap(fp,tec+i,i+1,1);
+    
+    fprintf(fp,"%60s%-20s\n","","END OF FILE");
+}
+/* output binary tec grid ----------------------------------------------------*/
+static int outtecb(FILE *fp, const tec_t *tec, int n)
+{
+    double t[2];
+    int i,m;
+    
+    trace(3,"outtecb: n=%d\n",n);
+    
+    if (fwrite(TECB_ID,1,8,fp)!=8) return 0;
+    
+    for (i=0;i<n;i++) {
+        t[0]=(double)tec[i].time.time;
+        t[1]=tec[i].time.sec;
+        m=tec[i].ndata[0]*tec[i].ndata[1]*tec[i].ndata[2];
+        
+        if (fwrite(tec[i].ndata,sizeof(int),3,fp)!=3||
+            fwrite(t,sizeof(double),2,fp)!=2||
+            fwrite(&tec[i].rb,sizeof(double),1,fp)!=1||
+            fwrite(tec[i].lats,sizeof(double),3,fp)!=3||
+            fwrite(tec[i].lons,sizeof(double),3,fp)!=3||
+            fwrite(tec[i].hgts,sizeof(double),3,fp)!=3||
+            fwrite(tec[i].data,sizeof(double),m,fp)!=(size_t)m||
+            fwrite(tec[i].rms ,sizeof(float ),m,fp)!=(size_t)m) return 0;
+    }
+    return 1;
+}
+/* write tec grid file ---------------------------------------------------------
+* write tec grid data to ionex or binary tec grid file
+* args   : char   *file       I   tec grid file
+*          tec_t  *tec        I   tec grid data (time order, same grid)
+*          int    n           I   number of tec grid data
+*          int    opt         I   write option (0:ionex,1:binary tec grid)
+*          char   *comment    I   ionex comment lines separated by '\n'
+*                                 (NULL: no comment)
+* return : status (1:ok,0:error)
+* notes  : ionex tec/rms values are rounded to 0.1 TECU. the binary tec grid
+*          keeps the tec_t fields in the native byte order without rounding.
+*          readtec() reads both of the formats.
+*-----------------------------------------------------------------------------*/
+extern int writetec(const char *file, const tec_t *tec, int n, int opt,
+                    const char *comment)
+{
+    FILE *fp;
+    int i,stat=1;
+    
+    trace(3,"writetec: file=%s n=%d opt=%d\n",file,n,opt);
+    
+    if (n<=0) return 0;
+    
+    for (i=1;i<n;i++) {
+        if (memcmp(tec[i].ndata,tec[0].ndata,sizeof(tec[0].ndata))||
+            memcmp(tec[i].lats,tec[0].lats,sizeof(tec[0].lats))||
+            memcmp(tec[i].lons,tec[0].lons,sizeof(tec[0].lons))||
+            memcmp(tec[i].hgts,tec[0].hgts,sizeof(tec[0].hgts))) {
+            trace(2,"tec grid differs: %s\n",time_str(tec[i].time,0));
+            return 0;
+        }
+    }
+    if (!(fp=fopen(file,opt?"wb":"w"))) {
+        trace(2,"tec grid file open error: %s\n",file);
+        return 0;
+    }
+    if (opt) stat=outtecb(fp,tec,n);
+    else outionex(fp,tec,n,comment);
+    
+    if (ferror(fp)) stat=0;
+    fclose(fp);
+    return stat;
+}
 /* interpolate tec grid data -------------------------------------------------*/
 static int interptec(const tec_t *tec, int k, const double *posp, double *value,
                      double *rms)
@@ -370,12 +595,30 @@ static int interptec(const tec_t *tec, int k, const double *posp, double *value,
     }
     return 1;
 }
+/* ionospheric pierce point of a tec grid layer ------------------------------*/
+static double ionlayer(const tec_t *tec, int i, const double *pos,
+                       const double *azel, int opt, double *posp)
+{
+    double fs,hion,rp;
+    
+    hion=tec->hgts[0]+tec->hgts[2]*i;
+    
+    /* ionospheric pierce point position */
+    fs=ionppp(pos,azel,tec->rb,hion,posp);
+    
+    if (opt&2) {
+        /* modified single layer mapping function (M-SLM) ref [2] */
+        rp=tec->rb/(tec->rb+hion)*sin(0.9782*(PI/2.0-azel[1]));
+        fs=1.0/sqrt(1.0-rp*rp);
+    }
+    return fs;
+}
 /* ionosphere delay by tec grid data -----------------------------------------*/
 static int iondelay(gtime_t time, const tec_t *tec, const double *pos,
                     const double *azel, int opt, double *delay, double *var)
 {
     const double fact=40.30E16/FREQ1/FREQ1; /* tecu->L1 iono (m) */
-    double fs,posp[3]={0},vtec,rms,hion,rp;
+    double fs,posp[3]={0},vtec,rms;
     int i;
     
     trace(3,"iondelay: time=%s pos=%.1f %.1f azel=%.1f %.1f\n",time_str(time,0),
@@ -385,16 +628,8 @@ static int iondelay(gtime_t time, const tec_t *tec, const double *pos,
     
     for (i=0;i<tec->ndata[2];i++) { /* for a layer */
         
-        hion=tec->hgts[0]+tec->hgts[2]*i;
+        fs=ionlayer(tec,i,pos,azel,opt,posp);
         
-        /* ionospheric pierce point position */
-        fs=ionppp(pos,azel,tec->rb,hion,posp);
-        
-        if (opt&2) {
-            /* modified single layer mapping function (M-SLM) ref [2] */
-            rp=tec->rb/(tec->rb+hion)*sin(0.9782*(PI/2.0-azel[1]));
-            fs=1.0/sqrt(1.0-rp*rp);
-        }
         if (opt&1) {
             /* earth rotation correction (sun-fixed coordinate) */
             posp[1]+=2.0*PI*timediff(time,tec->time)/86400.0;
@@ -409,6 +644,101 @@ static int iondelay(gtime_t time, const tec_t *tec, const double *pos,
     
     return 1;
 }
+/* ionosphere delays by bracketing tec grid data -------------------------------
+* same as iondelay() for tec[0] and tec[1]. the pierce points are computed once
+* for both tec grids if they have the same layers
+*-----------------------------------------------------------------------------*/
+static void iondelay2(gtime_t time, const tec_t *tec, const double *pos,
+                      const double *azel, int opt, double *dels, double *vars,
+                      int *stat)
+{
+    const double fact=40.30E16/FREQ1/FREQ1; /* tecu->L1 iono (m) */
+    double fs,posp[3]={0},posq[3],vtec,rms;
+    int i,j;
+    
+    if (tec[0].rb!=tec[1].rb||tec[0].ndata[2]!=tec[1].ndata[2]||
+        tec[0].hgts[0]!=tec[1].hgts[0]||tec[0].hgts[2]!=tec[1].hgts[2]) {
+        for (j=0;j<2;j++) {
+            stat[j]=iondelay(time,tec+j,pos,azel,opt,dels+j,vars+j);
+        }
+        return;
+    }
+    for (j=0;j<2;j++) {
+        dels[j]=vars[j]=0.0;
+        stat[j]=1;
+    }
+    for (i=0;i<tec->ndata[2];i++) { /* for a layer */
+        
+        fs=ionlayer(tec,i,pos,azel,opt,posp);
+        
+        for (j=0;j<2;j++) {
+            if (!stat[j]) continue;
+            
+            posq[0]=posp[0]; posq[1]=posp[1]; posq[2]=posp[2];
+            
+            if (opt&1) {
+                /* earth rotation correction (sun-fixed coordinate) */
+                posq[1]+=2.0*PI*timediff(time,tec[j].time)/86400.0;
+            }
+            /* interpolate tec grid data */
+            if (!interptec(tec+j,i,posq,&vtec,&rms)) {
+                stat[j]=0;
+                continue;
+            }
+            dels[j]+=fact*fs*vtec;
+            vars[j]+=fact*fact*fs*fs*rms*rms;
+        }
+    }
+}
+/* tec grid time index ---------------------------------------------------------
+* index of the first tec grid after time by bisection (tec grids are sorted by
+* combtec())
+*-----------------------------------------------------------------------------*/
+static int tecindex(const nav_t *nav, gtime_t time)
+{
+    int i=0,j=nav->nt,k;
+    
+    while (i<j) {
+        k=(i+j)/2;
+        if (timediff(nav->tec[k].time,time)>0.0) j=k; else i=k+1;
+    }
+    return i;
+}
+/* ionosphere delay by bracketing tec grid data ------------------------------*/
+static int iontecb(gtime_t time, const nav_t *nav, int i, double tt,
+                   const double *pos, const double *azel, int opt,
+                   double *delay, double *var)
+{
+    double dels[2],vars[2],a;
+    int stat[2];
+    
+    /* ionospheric delay by tec grid data */
+    iondelay2(time,nav->tec+i-1,pos,azel,opt,dels,vars,stat);
+    
+    if (!stat[0]&&!stat[1]) {
+        trace(2,"%s: tec grid out of area pos=%6.2f %7.2f azel=%6.1f %5.1f\n",
+              time_str(time,0),pos[0]*R2D,pos[1]*R2D,azel[0]*R2D,azel[1]*R2D);
+        return 0;
+    }
+    if (stat[0]&&stat[1]) { /* linear interpolation by time */
+        a=timediff(time,nav->tec[i-1].time)/tt;
+        *delay=dels[0]*(1.0-a)+dels[1]*a;
+        *var  =vars[0]*(1.0-a)+vars[1]*a;
+    }
+    else if (stat[0]) { /* nearest-neighbour extrapolation by time */
+        *delay=dels[0];
+        *var  =vars[0];
+    }
+    else {
+        *delay=dels[1];
+        *var  =vars[1];
+    }
+	/*transfer GPS L1 to BDS B1I */
+	double k = FREQ1 * FREQ1/FREQ1_CMP/FREQ1_CMP;
+	*delay = *delay*k;
+    trace(3,"iontec  : delay=%5.2f std=%5.2f\n",*delay,sqrt(*var));
+    return 1;
+}
 /* ionosphere model by tec grid data -------------------------------------------
 * compute ionospheric delay by tec grid data
 * args   : gtime_t time     I   time (gpst)
@@ -427,8 +757,8 @@ static int iondelay(gtime_t time, const tec_t *tec, const double *pos,
 extern int iontec(gtime_t time, const nav_t *nav, const double *pos,
                   const double *azel, int opt, double *delay, double *var)
 {
-    double dels[2],vars[2],a,tt;
-    int i,stat[2];
+    double tt;
+    int i;
     
     trace(3,"iontec  : time=%s pos=%.1f %.1f azel=%.1f %.1f\n",time_str(time,0),
           pos[0]*R2D,pos[1]*R2D,azel[0]*R2D,azel[1]*R2D);
@@ -438,9 +768,8 @@ extern int iontec(gtime_t time, const nav_t *nav, const double *pos,
         *var=VAR_NOTEC;
         return 1;
     }
-    for (i=0;i<nav->nt;i++) {
-        if (timediff(nav->tec[i].time,time)>0.0) break;
-    }
+    i=tecindex(nav,time);
+    
     if (i==0||i>=nav->nt) {
         trace(2,"%s: tec grid out of period\n",time_str(time,0));
         return 0;
@@ -449,31 +778,58 @@ extern int iontec(gtime_t time, const nav_t *nav, const double *pos,
         trace(2,"tec grid time interval error\n");
         return 0;
     }
-    /* ionospheric delay by tec grid data */
-    stat[0]=iondelay(time,nav->tec+i-1,pos,azel,opt,dels  ,vars  );
-    stat[1]=iondelay(time,nav->tec+i  ,pos,azel,opt,dels+1,vars+1);
+    return iontecb(time,nav,i,tt,pos,azel,opt,delay,var);
+}
+/* ionosphere model by tec grid data for satellites ----------------------------
+* compute ionospheric delays of satellites by tec grid data
+* args   : gtime_t time     I   time (gpst)
+*          nav_t  *nav      I   navigation data
+*          double *pos      I   receiver position {lat,lon,h} (rad,m)
+*          double *azel     I   azimuth/elevation angles {az,el,...} (rad)
+*          int    n         I   number of satellites
+*          int    opt       I   model option (see iontec())
+*          double *delay    O   ionospheric delays (B1I) {delay,...} (m)
+*          double *var      O   ionospheric dealy (B1I) variances (m^2)
+*          int    *stat     O   status (1:ok,0:error) {stat,...}
+* return : number of satellites with status ok
+* notes  : same as iontec() for each satellite. the bracketing tec grids are
+*          searched once for all satellites
+*-----------------------------------------------------------------------------*/
+extern int iontecn(gtime_t time, const nav_t *nav, const double *pos,
+                   const double *azel, int n, int opt, double *delay,
+                   double *var, int *stat)
+{
+    double tt=0.0;
+    int i,j,m=0;
     
-    if (!stat[0]&&!stat[1]) {
-        trace(2,"%s: tec grid out of area pos=%6.2f %7.2f azel=%6.1f %5.1f\n",
-              time_str(time,0),pos[0]*R2D,pos[1]*R2D,azel[0]*R2D,azel[1]*R2D);
-        return 0;
-    }
-    if (stat[0]&&stat[1]) { /* linear interpolation by time */
-        a=timediff(time,nav->tec[i-1].time)/tt;
-        *delay=dels[0]*(1.0-a)+dels[1]*a;
-        *var  =vars[0]*(1.0-a)+vars[1]*a;
+    trace(3,"iontecn : time=%s pos=%.1f %.1f n=%d\n",time_str(time,0),
+          pos[0]*R2D,pos[1]*R2D,n);
+    
+    for (j=0;j<n;j++) {
+        delay[j]=var[j]=0.0;
+        stat[j]=0;
     }
-    else if (stat[0]) { /* nearest-neighbour extrapolation by time */
-        *delay=dels[0];
-        *var  =vars[0];
+    i=tecindex(nav,time);
+    
+    if (pos[2]>=MIN_HGT) {
+        if (i==0||i>=nav->nt) {
+            trace(2,"%s: tec grid out of period\n",time_str(time,0));
+            i=0;
+        }
+        else if ((tt=timediff(nav->tec[i].time,nav->tec[i-1].time))==0.0) {
+            trace(2,"tec grid time interval error\n");
+            i=0;
+        }
     }
-    else {
-        *delay=dels[1];
-        *var  =vars[1];
+    for (j=0;j<n;j++) {
+        if (azel[1+j*2]<MIN_EL||pos[2]<MIN_HGT) {
+            var[j]=VAR_NOTEC;
+            stat[j]=1;
+        }
+        else if (i>0) {
+            stat[j]=iontecb(time,nav,i,tt,pos,azel+j*2,opt,delay+j,var+j);
+        }
+        if (stat[j]) m++;
     }
-	/*transfer GPS L1 to BDS B1I */
-	double k = FREQ1 * FREQ1/FREQ1_CMP/FREQ1_CMP;
-	*delay = *delay*k;
-    trace(3,"iontec  : delay=%5.2f std=%5.2f\n",*delay,sqrt(*var));
-    return 1;
+    return m;
 }
@@ -24,6 +24,8 @@
 *           2016/06/10  1.9  add ant2-maxaveep,ant2-initrst
 *           2016/07/31  1.10 add out-outsingle,out-maxsolstd
 *           2017/06/14  1.11 add out-outvel
+*           2025/07/16  1.12 add pos1-nqmode
+*           2025/08/02  1.13 add cheb as pos1-sateph option
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -54,7 +56,7 @@ static char snrmask_[NFREQ][1024];
 #define TYPOPT  "0:forward,1:backward,2:combined"
 #define IONOPT  "0:off,1:brdc,2:sbas,3:dual-freq,4:est-stec,5:ionex-tec,6:qzs-brdc,7:qzs-lex,8:vtec_sf,9:vtec_ef,10:gtec,11:bdsk8,12:bdssh9,13:bdsion,14:galion"
 #define TRPOPT  "0:off,1:saas,2:sbas,3:est-ztd,4:est-ztdgrad,5:ztd"
-#define EPHOPT  "0:brdc,1:precise,2:brdc+sbas,3:brdc+ssrapc,4:brdc+ssrcom"
+#define EPHOPT  "0:brdc,1:precise,2:brdc+sbas,3:brdc+ssrapc,4:brdc+ssrcom,6:cheb"
 #define NAVOPT  "1:gps+2:sbas+4:glo+8:gal+16:qzs+32:comp"
 #define GAROPT  "0:off,1:on,2:autocal"
 #define SOLOPT  "0:llh,1:xyz,2:enu,3:nmea"
@@ -69,6 +71,7 @@ static char snrmask_[NFREQ][1024];
 #define POSOPT  "0:llh,1:xyz,2:single,3:posfile,4:rinexhead,5:rtcm,6:raw"
 #define TIDEOPT "0:off,1:on,2:otl"
 #define PHWOPT  "0:off,1:on,2:precise"
+#define NQMOPT  "0:reference,1:fast,2:fixed"
 #define IGMASOPT "0:off,1:on"
 #define SATOPT   "0:off,1:on"
 
@@ -85,6 +88,7 @@ EXPORT opt_t sysopts[]={
     {"pos1-dynamics",   3,  (void *)&prcopt_.dynamics,   SWTOPT },
     {"pos1-tidecorr",   3,  (void *)&prcopt_.tidecorr,   TIDEOPT},
     {"pos1-ionoopt",    3,  (void *)&prcopt_.ionoopt,    IONOPT },
+    {"pos1-nqmode",     3,  (void *)&prcopt_.nqmode,     NQMOPT },
     {"pos1-tropopt",    3,  (void *)&prcopt_.tropopt,    TRPOPT },
     {"pos1-sateph",     3,  (void *)&prcopt_.sateph,     EPHOPT },
     {"pos1-posopt1",    3,  (void *)&prcopt_.posopt[0],  SWTOPT },
@@ -17,6 +17,9 @@
 *           2014/05/26 1.4  support galileo and beidou
 *           2015/03/19 1.5  fix bug on ionosphere correction for GLO and BDS
 *           2018/10/10 1.6  support api change of satexclude()
+*           2025/07/09 1.7  compute bdgim delays of all satellites at once
+*           2025/07/10 1.8  use nequick-g context of navigation data
+*           2025/07/14 1.9  compute nequick-g delays of all satellites at once
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -35,11 +38,6 @@
 #define REL_HUMI    0.7         /* relative humidity for saastamoinen model */
 
 
-extern "C" {
-	extern double ionmodel_nequick(double * galionpar, int month, double UTC, double usr_longitude_degree, double usr_latitude_degree, double usr_height_meters,
-		double sat_longitude_degree, double sat_latitude_degree, double sat_height_meters);
-}
-
 /* pseudorange measurement error variance ------------------------------------*/
 static double varerr(const prcopt_t *opt, double el, int sys)
 {
@@ -206,6 +204,20 @@ static int selion(const char *modelname, gtime_t time, bds_ion_t bds_ion)
 	}
 }
 
+/* ionospheric delay factor to the first frequency of satellite (B1I ref) ---*/
+static double ionfactor(const prcopt_t *opt, const nav_t *nav, int sat)
+{
+	prcopt_t opt2 = *opt;
+	int fidx[MAXFREQ] = { 0 };
+	double freq;
+
+	opt2.ionoopt = IONOOPT_IFLC;
+	frqidx(opt2, fidx);
+
+	freq = nav->lam[sat - 1][fidx[0]] > 0 ? CLIGHT / nav->lam[sat - 1][fidx[0]] : FREQ1_CMP;
+
+	return FREQ1_CMP*FREQ1_CMP/freq/freq;
+}
 /* ionospheric correction ------------------------------------------------------
 * compute ionospheric correction
 * args   : gtime_t time     I   time
@@ -230,15 +242,8 @@ extern int ionocorr(const prcopt_t opt, gtime_t time, const nav_t *nav, int sat,
 	double ep[6];
 	double ionk8[8] = { 0.0 };
 	double ionsh9[9] = { 0.0 };
-	prcopt_t opt2 = opt;
-	opt2.ionoopt = IONOOPT_IFLC;
-	int fidx[MAXFREQ] = { 0 };
-	double freq = 0;
-	frqidx(opt2, fidx);
-
-	freq = nav->lam[sat - 1][fidx[0]] > 0 ? CLIGHT / nav->lam[sat - 1][fidx[0]] : FREQ1_CMP;
 
-	k = FREQ1_CMP*FREQ1_CMP/freq/freq;
+	k = ionfactor(&opt, nav, sat);
     /* broadcast model */
     if (ionoopt==IONOOPT_BRDC) {
         *ion=k*ionmodel(time,nav->ion_gps,pos,azel);
@@ -290,42 +295,17 @@ extern int ionocorr(const prcopt_t opt, gtime_t time, const nav_t *nav, int sat,
 		return 1;
 	}
 	if (ionoopt == IONOOPT_GALION){
-		double ionpar[3],tec=0.0;
-		double satepos[3];
-		int i;
-		double ep[6];
-
+		double satepos[3],ep[6],tec;
 
 		/*transfer xyz to blh */
 		ecef2pos(satpos, satepos);
+		time2epoch(time, ep);
 
-		for (i = 0; i < 3; i++){
-			satepos[i] = i<2?satepos[i]*R2D: satepos[i];
-			ionpar[i] = nav->ion_gal[i];
+		if (!nequick_stec(nav->nequick, nav->ion_gal, (int)ep[1],
+			ep[3] + ep[4] / 60.0 + ep[5] / 3600.0, pos, satepos, &tec)) {
+			trace(2, "nequick-g error: %s sat=%2d\n", time_str(time, 0), sat);
+			return 0;
 		}
-		time2epoch(time, ep);/*
-#if 0
-		double coef[3] = { 236.831641, -0.39362878, 0.00402826613 };
-		for (i = 0; i < 3; i++) {
-			ionpar[i] = coef[i];
-		}
-		ep[0] = 0; ep[1] = 4; ep[3] = 0.0; ep[4] = 0.0; ep[5] = 0.0;
-		int month = 1;
-		double UTC = 0.0;
-		double usr_longitude_degree = 297.66;
-		double usr_latitude_degree = 82.49;
-		double usr_height_meters = 78.11;
-
-		double sat_longitude_degree = 8.23;
-		double sat_latitude_degree = 54.29;
-		double sat_height_meters = 20281546.18;
-		tec = ionmodel_nequick(ionpar, ep[1], ep[3] + ep[4] / 60.0 + ep[5] / 3600.0,
-		usr_longitude_degree, usr_latitude_degree, usr_height_meters, sat_longitude_degree, sat_latitude_degree, sat_height_meters);
-		printf("%lf \n", tec);
-#endif*/
-
-		tec = ionmodel_nequick(ionpar, ep[1], ep[3] + ep[4] / 60.0 + ep[5] / 3600.0,pos[1] * R2D, pos[0] * R2D, pos[2], satepos[1], satepos[0], satepos[2]);
-
 		/*transfer to B1I */
 		/* switch to BDS B1I */
 		tec = tec*40.28e16 / FREQ1_CMP / FREQ1_CMP;
@@ -375,6 +355,87 @@ extern int tropcorr(gtime_t time, const nav_t *nav, const double *pos,
     *var=tropopt==TROPOPT_OFF?SQR(ERR_TROP):0.0;
     return 1;
 }
+/* nequick-g ionospheric delays of satellites ----------------------------------
+* compute nequick-g ionospheric delays (B1I) of the satellites above the
+* elevation mask of an epoch at once. the station and epoch state of the model
+* is shared by the rays
+*-----------------------------------------------------------------------------*/
+static void galionn(const obsd_t *obs, int n, const double *rs,
+                    const nav_t *nav, const prcopt_t *opt, const double *rr,
+                    const double *pos, double *ion, int *stat)
+{
+    double ep[6],e[3],azel[2],dr,spos[MAXOBS*3],stec[MAXOBS],tec;
+    int i,j,m=0,sys,idx[MAXOBS],st[MAXOBS];
+    
+    for (i=0;i<n;i++) {ion[i]=0.0; stat[i]=0;}
+    
+    for (i=0;i<n;i++) {
+        if (!(sys=satsys(obs[i].sat,NULL))) continue;
+        
+        /* duplicated observation data rejected by rescode() */
+        if (i<n-1&&obs[i].sat==obs[i+1].sat) {i++; continue;}
+        
+        if (geodist(sys,rs+i*6,rr,e,&dr)<=0.0||
+            satazel(pos,e,azel)<opt->elmin) continue;
+        
+        ecef2pos(rs+i*6,spos+m*3);
+        idx[m++]=i;
+    }
+    if (m<=0) return;
+    
+    time2epoch(obs[0].time,ep);
+    
+    nequick_stecn(nav->nequick,nav->ion_gal,(int)ep[1],
+                  ep[3]+ep[4]/60.0+ep[5]/3600.0,pos,spos,m,stec,st);
+    
+    for (j=0;j<m;j++) {
+        if (!st[j]) {
+            trace(2,"nequick-g error: %s sat=%2d\n",time_str(obs[0].time,0),
+                  obs[idx[j]].sat);
+            continue;
+        }
+        /* tec to delay of BDS B1I */
+        tec=stec[j]*40.28e16/FREQ1_CMP/FREQ1_CMP;
+        ion[idx[j]]=tec<0?0.0:tec;
+        stat[idx[j]]=1;
+    }
+}
+/* ionex tec ionospheric delays of satellites ----------------------------------
+* compute ionex tec ionospheric delays (B1I) and variances of the satellites
+* above the elevation mask of an epoch at once. the tec grids bracketing the
+* epoch are searched once for all satellites
+*-----------------------------------------------------------------------------*/
+static void iontecs(const obsd_t *obs, int n, const double *rs,
+                    const nav_t *nav, const prcopt_t *opt, const double *rr,
+                    const double *pos, double *ion, double *var)
+{
+    double e[3],azel[MAXOBS*2],dr,dels[MAXOBS],vars[MAXOBS];
+    int i,j,m=0,sys,idx[MAXOBS],st[MAXOBS];
+    
+    for (i=0;i<n;i++) ion[i]=var[i]=0.0;
+    
+    for (i=0;i<n;i++) {
+        if (!(sys=satsys(obs[i].sat,NULL))) continue;
+        
+        /* duplicated observation data rejected by rescode() */
+        if (i<n-1&&obs[i].sat==obs[i+1].sat) {i++; continue;}
+        
+        if (geodist(sys,rs+i*6,rr,e,&dr)<=0.0||
+            satazel(pos,e,azel+m*2)<opt->elmin) continue;
+        
+        idx[m++]=i;
+    }
+    if (m<=0) return;
+    
+    iontecn(obs[0].time,nav,pos,azel,m,1,dels,vars,st);
+    
+    /* delay and variance kept zero on error as ionocorr() */
+    for (j=0;j<m;j++) {
+        if (!st[j]) continue;
+        ion[idx[j]]=dels[j];
+        var[idx[j]]=vars[j];
+    }
+}
 /* pseudorange residuals -----------------------------------------------------*/
 static int rescode(int iter, const obsd_t *obs, int n, const double *rs,
                    const double *dts, const double *vare, const int *svh,
@@ -383,7 +444,8 @@ static int rescode(int iter, const obsd_t *obs, int n, const double *rs,
 				   double *resp, int *ns,int *sat)
 {
     double r,dion,dtrp,vmeas,vion,vtrp,rr[3],pos[3],dtr,e[3],P,lam_L1;
-    int i,j,nv=0,sys,mask[4]={0};
+    double ionb[MAXOBS],ionv[MAXOBS];
+    int i,j,nv=0,sys,mask[4]={0},bdgim,galion,ionex,ionstat[MAXOBS];
 	char cprn[128];
 	double res, tgd1, tgd2, dr;
 
@@ -395,6 +457,19 @@ static int rescode(int iter, const obsd_t *obs, int n, const double *rs,
 
     ecef2pos(rr,pos);
     
+    /* BDGIM delays of all satellites of the epoch at once */
+    if ((bdgim=iter>0&&opt->ionoopt==IONOOPT_BDSSH9&&n>0)) {
+        ionmodel_BDSK9n(gpst2bdt(obs[0].time),nav->ion_bdsk9,pos,rs,6,
+                        n<MAXOBS?n:MAXOBS,ionb);
+    }
+    /* NeQuick-G delays of the satellites above the elevation mask at once */
+    if ((galion=iter>0&&opt->ionoopt==IONOOPT_GALION&&n>0)) {
+        galionn(obs,n<MAXOBS?n:MAXOBS,rs,nav,opt,rr,pos,ionb,ionstat);
+    }
+    /* IONEX TEC delays of the satellites above the elevation mask at once */
+    if ((ionex=iter>0&&opt->ionoopt==IONOOPT_TEC&&n>0)) {
+        iontecs(obs,n<MAXOBS?n:MAXOBS,rs,nav,opt,rr,pos,ionb,ionv);
+    }
 	for (i = *ns = 0; i < n&&i < MAXOBS; i++) {
 		vsat[i] = 0; azel[i * 2] = azel[1 + i * 2] = resp[i] = 0.0;
 		if (!(sys = satsys(obs[i].sat, NULL))) continue;
@@ -426,7 +501,16 @@ static int rescode(int iter, const obsd_t *obs, int n, const double *rs,
         if (satexclude(obs[i].sat,vare[i],svh[i],opt)) continue;
         
         /* ionospheric corrections */
-		if (!ionocorr(*opt, obs[i].time, nav, obs[i].sat, pos, rs + i * 6, azel + i * 2,
+        if (bdgim||galion) {
+            if (galion&&!ionstat[i]) continue;
+            dion=ionfactor(opt,nav,obs[i].sat)*ionb[i];
+            vion=SQR(dion*ERR_BRDCI);
+        }
+        else if (ionex) {
+            dion=ionfactor(opt,nav,obs[i].sat)*ionb[i];
+            vion=ionv[i];
+        }
+		else if (!ionocorr(*opt, obs[i].time, nav, obs[i].sat, pos, rs + i * 6, azel + i * 2,
                       iter>0?opt->ionoopt:IONOOPT_BRDC,&dion,&vion)) continue;
         
         /* tropospheric corrections */
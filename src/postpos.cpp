@@ -39,7 +39,12 @@
 *           2016/08/29  1.21 suppress warnings
 *           2016/10/10  1.22 fix bug on identification of file fopt->blq
 *           2017/06/13  1.23 add smoother of velocity solution
+*           2025/08/02  1.24 read chebyshev orbit/clock files (.cheb)
+*                           fix bug on double fclose() of dop file and free
+*                           obs/nav data at end of satellite visibility output
+*           2025/08/03  1.25 own bdgim model state of combined-backward pass
 *-----------------------------------------------------------------------------*/
+#include <atomic>
 #include "rtklib.h"
 
 #define MIN(x,y)    ((x)<(y)?(x):(y))
@@ -48,37 +53,6 @@
 #define MAXPRCDAYS  100          /* max days of continuous processing */
 #define MAXINFILE   1000         /* max number of input files */
 
-/* constants/global variables ------------------------------------------------*/
-
-static pcvs_t pcvss={0};        /* satellite antenna parameters */
-static pcvs_t pcvsr={0};        /* receiver antenna parameters */
-static obs_t obss={0};          /* observation data */
-static nav_t navs={0};          /* navigation data */
-static sbs_t sbss={0};          /* sbas messages */
-static lex_t lexs={0};          /* lex messages */
-static sta_t stas[MAXRCV];      /* station infomation */
-static int nepoch=0;            /* number of observation epochs */
-static int iobsu =0;            /* current rover observation data index */
-static int iobsr =0;            /* current reference observation data index */
-static int isbs  =0;            /* current sbas message index */
-static int ilex  =0;            /* current lex message index */
-static int revs  =0;            /* analysis direction (0:forward,1:backward) */
-static int prgbar = 0;          /* progress bar /  */
-static int aborts=0;            /* abort status */
-static sol_t *solf;             /* forward solutions */
-static sol_t *solb;             /* backward solutions */
-static double *rbf;             /* forward base positions */
-static double *rbb;             /* backward base positions */
-static int isolf=0;             /* current forward solutions index */
-static int isolb=0;             /* current backward solutions index */
-static char proc_rov [64]="";   /* rover for current processing */
-static char proc_base[64]="";   /* base station for current processing */
-static char rtcm_file[1024]=""; /* rtcm data file */
-static char rtcm_path[1024]=""; /* rtcm data path */
-static rtcm_t rtcm;             /* rtcm control struct */
-static FILE *fp_rtcm=NULL;      /* rtcm data file pointer */
-static char outsppfile[1024];
-static char SolFlag = 0;        /* ״̬ 0:㣬1:޿ǣ */
 
 /* ʼҪĽṹ */
 void init_nav(nav_t* nav) 
@@ -102,6 +76,7 @@ void init_nav(nav_t* nav)
     nav->ion_bdsk9->bds_ion.nk8 = 0;
     nav->ion_bdsk9->bds_ion.nk14 = 0;
     nav->ion_bdsk9->bds_ion.nsh9 = 0;// the total parameter number for SH resolution [26 in default]
+    initbdgim(nav->ion_bdsk9);
     nav->igmasta = -1;
 }
 void init_obs(obs_t* obs)
@@ -113,9 +88,39 @@ void init_obs(obs_t* obs)
 
     // ʼ data ָԱ,Ҫ
 }
+/* initialize/free processing session -----------------------------------------
+* initialize or free a post-processing session for postpos_ctx()
+* args   : postctx_t *ctx   IO  processing session
+* return : none
+* notes  : postpos_ctx() releases its data on return. free_postctx() only
+*          releases what an aborted session may have left behind.
+*-----------------------------------------------------------------------------*/
+extern void init_postctx(postctx_t *ctx)
+{
+    memset(ctx, 0, sizeof(postctx_t));
+}
+/* close obs file streams ----------------------------------------------------*/
+static void closeobsstr(postctx_t *ctx)
+{
+    int i;
+    
+    for (i=0;i<ctx->nrnx;i++) close_rnxobsr(ctx->rnxs+i);
+    free(ctx->rnxs); ctx->rnxs=NULL; ctx->nrnx=0;
+}
+extern void free_postctx(postctx_t *ctx)
+{
+    closeobsstr(ctx);
+    free(ctx->pcvss.pcv); ctx->pcvss.pcv=NULL; ctx->pcvss.n=ctx->pcvss.nmax=0;
+    free(ctx->pcvsr.pcv); ctx->pcvsr.pcv=NULL; ctx->pcvsr.n=ctx->pcvsr.nmax=0;
+    free(ctx->obss.data); ctx->obss.data=NULL; ctx->obss.n=ctx->obss.nmax=0;
+    free(ctx->navs.ion_bdsk9); ctx->navs.ion_bdsk9=NULL;
+    nequick_close(ctx->navs.nequick); ctx->navs.nequick=NULL;
+    if (ctx->fp_rtcm) fclose(ctx->fp_rtcm);
+    ctx->fp_rtcm=NULL;
+}
 /* show message and check break ----------------------------------------------*/
 /* ݣ׼վվϢ˳һ */
-static int checkbrk(const char *format, ...)
+static int checkbrk(postctx_t *ctx, const char *format, ...)
 {
     va_list arg;
     char buff[1024],*p=buff;
@@ -126,9 +131,9 @@ static int checkbrk(const char *format, ...)
     p+=vsprintf(p,format,arg);
     va_end(arg);
     //׼վproc_baseվproc_rovϢ˳㶼ֻһϢֻһ
-    if (*proc_rov&&*proc_base) sprintf(p," (%s-%s)",proc_rov,proc_base);
-    else if (*proc_rov ) sprintf(p," (%s)",proc_rov );
-    else if (*proc_base) sprintf(p," (%s)",proc_base);
+    if (*ctx->proc_rov&&*ctx->proc_base) sprintf(p," (%s-%s)",ctx->proc_rov,ctx->proc_base);
+    else if (*ctx->proc_rov ) sprintf(p," (%s)",ctx->proc_rov );
+    else if (*ctx->proc_base) sprintf(p," (%s)",ctx->proc_base);
     return showmsg(buff);
 }
 /* output reference position -------------------------------------------------*/
@@ -158,7 +163,7 @@ static void outrpos(FILE *fp, const double *r, const solopt_t *opt)
     }
 }
 /* output header -------------------------------------------------------------*/
-static void outheader(FILE *fp, const char **file, int n, const prcopt_t *popt,
+static void outheader(postctx_t *ctx, FILE *fp, const char **file, int n, const prcopt_t *popt,
                       const solopt_t *sopt)
 {
     const char *s1[]={"GPST","UTC","JST"};
@@ -182,11 +187,18 @@ static void outheader(FILE *fp, const char **file, int n, const prcopt_t *popt,
         for (i=0;i<n;i++) {
            // fprintf(fp,"%s inp file  : %s\n",COMMENTH,file[i]);
         }
-        for (i=0;i<obss.n;i++)    if (obss.data[i].rcv==1) break;
-        for (j=obss.n-1;j>=0;j--) if (obss.data[j].rcv==1) break;
-        if (j<i) {fprintf(fp,"\n%s no rover obs data\n",COMMENTH); return;}
-        ts=obss.data[i].time;
-        te=obss.data[j].time;
+        if (ctx->nrnx>0) { /* obs data stream */
+            if (ctx->tspan[0].time==0) {fprintf(fp,"\n%s no rover obs data\n",COMMENTH); return;}
+            ts=ctx->tspan[0];
+            te=ctx->tspan[1];
+        }
+        else {
+            for (i=0;i<ctx->obss.n;i++)    if (ctx->obss.data[i].rcv==1) break;
+            for (j=ctx->obss.n-1;j>=0;j--) if (ctx->obss.data[j].rcv==1) break;
+            if (j<i) {fprintf(fp,"\n%s no rover obs data\n",COMMENTH); return;}
+            ts=ctx->obss.data[i].time;
+            te=ctx->obss.data[j].time;
+        }
         t1=time2gpst(ts,&w1);
         t2=time2gpst(te,&w2);
         if (sopt->times>=1) ts=gpst2utc(ts);
@@ -235,131 +247,260 @@ static int nextobsb(const obs_t *obs, int *i, int rcv)
     }
     return n;
 }
+/* obs data stream -------------------------------------------------------------
+* forward solutions can read the rinex obs files epoch by epoch instead of
+* loading all of the obs data at once. the epochs of the obs files of rover and
+* base are merged by time into a window of ctx->obswin epochs, which is
+* refilled by halves as the processing goes on, so the memory of obs data does
+* not depend on the length of the files. an epoch of a receiver is skipped if
+* the receiver has the epoch in the window already (overlapped obs files).
+*-----------------------------------------------------------------------------*/
+static int obsstream(const postctx_t *ctx, const prcopt_t *popt)
+{
+    /* backward/combined solutions, interpolation of base obs data and averaged
+       single position of station read all of the obs data */
+    return ctx->obswin>0&&(popt->mode==PMODE_SINGLE||popt->soltype==0)&&
+           !(popt->intpref&&PMODE_DGPS<=popt->mode&&popt->mode<=PMODE_FIXED)&&
+           !popt->outsat&&
+           !(popt->mode==PMODE_FIXED&&popt->rovpos==POSOPT_SINGLE)&&
+           !(PMODE_DGPS<=popt->mode&&popt->mode<=PMODE_STATIC&&
+             popt->refpos==POSOPT_SINGLE);
+}
+/* open obs file streams -----------------------------------------------------*/
+static int openobsstr(postctx_t *ctx, const char *file, int rcv, gtime_t ts,
+                      gtime_t te, double ti, const char *opt, nav_t *nav,
+                      sta_t *sta)
+{
+    rnxobsr_t *rnxs;
+    char *files[MAXEXFILE]={0};
+    int i,n,stat=0;
+    
+    for (i=0;i<MAXEXFILE;i++) {
+        if (!(files[i]=(char *)malloc(1024))) {
+            for (i--;i>=0;i--) free(files[i]);
+            return -1;
+        }
+    }
+    n=expath(file,files,MAXEXFILE);
+    
+    for (i=0;i<n&&stat>=0;i++) {
+        if (!(rnxs=(rnxobsr_t *)realloc(ctx->rnxs,sizeof(rnxobsr_t)*(ctx->nrnx+1)))) {
+            stat=-1;
+            break;
+        }
+        ctx->rnxs=rnxs;
+        if ((stat=open_rnxobsr(ctx->rnxs+ctx->nrnx,files[i],rcv,ts,te,ti,opt,nav,
+                               sta))>0) {
+            ctx->nrnx++;
+        }
+    }
+    for (i=0;i<MAXEXFILE;i++) free(files[i]);
+    return stat;
+}
+/* add obs data of epoch of stream to window ---------------------------------*/
+static int addobsepoch(obs_t *obs, rnxobsr_t *rnx)
+{
+    obsd_t *data,d;
+    int i,j,n;
+    
+    /* skip epoch of receiver in window */
+    for (i=obs->n-1;i>=0;i--) {
+        if (timediff(rnx->data[0].time,obs->data[i].time)>DTTOL) break;
+        if (obs->data[i].rcv==rnx->rcv) return 1;
+    }
+    if (obs->n+rnx->n>obs->nmax) {
+        for (n=obs->nmax<=0?MAXOBS*64:obs->nmax*2;n<obs->n+rnx->n;n*=2) ;
+        if (!(data=(obsd_t *)realloc(obs->data,sizeof(obsd_t)*n))) {
+            trace(1,"addobsepoch: memalloc error n=%dx%d\n",sizeof(obsd_t),n);
+            return 0;
+        }
+        obs->data=data;
+        obs->nmax=n;
+    }
+    /* sort by satellite as sortobs() */
+    for (i=1;i<rnx->n;i++) {
+        d=rnx->data[i];
+        for (j=i;j>0&&rnx->data[j-1].sat>d.sat;j--) rnx->data[j]=rnx->data[j-1];
+        rnx->data[j]=d;
+    }
+    for (i=0;i<rnx->n;i++) {
+        if (i>0&&rnx->data[i].sat==rnx->data[i-1].sat) continue;
+        obs->data[obs->n++]=rnx->data[i];
+    }
+    return 1;
+}
+/* refill window of obs data stream --------------------------------------------
+* refill the window when the rover obs data index reaches ctx->iwin. the obs
+* data already processed are discarded and the next half of window is added
+* from the streams in time order. epochs within DTTOL are not split.
+* return : status (1:ok,0:memory allocation error)
+*-----------------------------------------------------------------------------*/
+static int fillobs(postctx_t *ctx)
+{
+    rnxobsr_t *rnx;
+    gtime_t time={0};
+    double tt;
+    int i,k,n,nhalf=ctx->obswin/2>0?ctx->obswin/2:1;
+    
+    if (ctx->nrnx<=0||ctx->iobsu<ctx->iwin) return 1;
+    
+    /* discard processed obs data */
+    if ((n=MIN(ctx->iobsu,ctx->iobsr))>0) {
+        memmove(ctx->obss.data,ctx->obss.data+n,sizeof(obsd_t)*(ctx->obss.n-n));
+        ctx->obss.n-=n; ctx->iobsu-=n; ctx->iobsr-=n;
+    }
+    ctx->iwin=ctx->obss.n;
+    
+    for (k=0;;k++) {
+        
+        /* stream of earliest epoch (rover first in tolerance) */
+        for (i=0,rnx=NULL;i<ctx->nrnx;i++) {
+            if (ctx->rnxs[i].n<=0) continue;
+            if (!rnx||(tt=timediff(ctx->rnxs[i].data[0].time,rnx->data[0].time))<-DTTOL||
+                (tt<=DTTOL&&ctx->rnxs[i].rcv<rnx->rcv)) rnx=ctx->rnxs+i;
+        }
+        if (!rnx) { /* end of streams */
+            if (k==0) ctx->iwin=ctx->obss.n+1;
+            break;
+        }
+        if (k>=nhalf&&timediff(rnx->data[0].time,time)>DTTOL) break;
+        
+        if (!addobsepoch(&ctx->obss,rnx)) return 0;
+        time=rnx->data[0].time;
+        input_rnxobsr(rnx);
+    }
+    trace(4,"fillobs : nobs=%d iobsu=%d iobsr=%d\n",ctx->obss.n,ctx->iobsu,
+          ctx->iobsr);
+    return 1;
+}
 /* update rtcm ssr correction ------------------------------------------------*/
-static void update_rtcm_ssr(gtime_t time)
+static void update_rtcm_ssr(postctx_t *ctx, gtime_t time)
 {
     char path[1024];
     int i;
     
     /* open or swap rtcm file */
-    reppath(rtcm_file,path,time,"","");
+    reppath(ctx->rtcm_file,path,time,"","");
     
-    if (strcmp(path,rtcm_path)) {
-        strcpy(rtcm_path,path);
+    if (strcmp(path,ctx->rtcm_path)) {
+        strcpy(ctx->rtcm_path,path);
         
-        if (fp_rtcm) fclose(fp_rtcm);
-        fp_rtcm=fopen(path,"rb");
-        if (fp_rtcm) {
-            rtcm.time=time;
-            input_rtcm3f(&rtcm,fp_rtcm);
+        if (ctx->fp_rtcm) fclose(ctx->fp_rtcm);
+        ctx->fp_rtcm=fopen(path,"rb");
+        if (ctx->fp_rtcm) {
+            ctx->rtcm.time=time;
+            input_rtcm3f(&ctx->rtcm,ctx->fp_rtcm);
             trace(2,"rtcm file open: %s\n",path);
         }
     }
-    if (!fp_rtcm) return;
+    if (!ctx->fp_rtcm) return;
     
     /* read rtcm file until current time */
-    while (timediff(rtcm.time,time)<1E-3) {
-        if (input_rtcm3f(&rtcm,fp_rtcm)<-1) break;
+    while (timediff(ctx->rtcm.time,time)<1E-3) {
+        if (input_rtcm3f(&ctx->rtcm,ctx->fp_rtcm)<-1) break;
         
         /* update ssr corrections */
         for (i=0;i<MAXSAT;i++) {
-            if (!rtcm.ssr[i].update||
-                rtcm.ssr[i].iod[0]!=rtcm.ssr[i].iod[1]||
-                timediff(time,rtcm.ssr[i].t0[0])<-1E-3) continue;
-            navs.ssr[i]=rtcm.ssr[i];
-            rtcm.ssr[i].update=0;
+            if (!ctx->rtcm.ssr[i].update||
+                ctx->rtcm.ssr[i].iod[0]!=ctx->rtcm.ssr[i].iod[1]||
+                timediff(time,ctx->rtcm.ssr[i].t0[0])<-1E-3) continue;
+            ctx->navs.ssr[i]=ctx->rtcm.ssr[i];
+            ctx->rtcm.ssr[i].update=0;
         }
     }
 }
 /* input obs data, navigation messages and sbas correction -------------------*/
-static int inputobs(obsd_t *obs, int solq, const prcopt_t *popt)
+static int inputobs(postctx_t *ctx, obsd_t *obs, int solq, const prcopt_t *popt)
 {
     gtime_t time={0};
     int i,nu,nr,n=0;
     
-    trace(3,"infunc  : revs=%d iobsu=%d iobsr=%d isbs=%d\n",revs,iobsu,iobsr,isbs);
+    trace(3,"infunc  : revs=%d iobsu=%d iobsr=%d isbs=%d\n",ctx->revs,ctx->iobsu,ctx->iobsr,ctx->isbs);
+    
+    /* refill window of obs data stream */
+    if (!ctx->revs&&!fillobs(ctx)) return -1;
     
-    if (0<=iobsu&&iobsu<obss.n) 
+    if (0<=ctx->iobsu&&ctx->iobsu<ctx->obss.n) 
     {
-        settime((time=obss.data[iobsu].time));
-        //if (checkbrk("processing : %s Q=%d",time_str(time,0),solq)) {
+        settime((time=ctx->obss.data[ctx->iobsu].time));
+        //if (checkbrk(ctx,"processing : %s Q=%d",time_str(time,0),solq)) {
         //    aborts=1; showmsg("aborted"); return -1;
         //}
     }
-    if (!revs) { /* input forward data */
-        if ((nu=nextobsf(&obss,&iobsu,1))<=0) return -1;
+    if (!ctx->revs) { /* input forward data */
+        if ((nu=nextobsf(&ctx->obss,&ctx->iobsu,1))<=0) return -1;
         if (popt->intpref) {
-            for (;(nr=nextobsf(&obss,&iobsr,2))>0;iobsr+=nr)
-                if (timediff(obss.data[iobsr].time,obss.data[iobsu].time)>-DTTOL) break;
+            for (;(nr=nextobsf(&ctx->obss,&ctx->iobsr,2))>0;ctx->iobsr+=nr)
+                if (timediff(ctx->obss.data[ctx->iobsr].time,ctx->obss.data[ctx->iobsu].time)>-DTTOL) break;
         }
         else {
-            for (i=iobsr;(nr=nextobsf(&obss,&i,2))>0;iobsr=i,i+=nr)
-                if (timediff(obss.data[i].time,obss.data[iobsu].time)>DTTOL) break;
+            for (i=ctx->iobsr;(nr=nextobsf(&ctx->obss,&i,2))>0;ctx->iobsr=i,i+=nr)
+                if (timediff(ctx->obss.data[i].time,ctx->obss.data[ctx->iobsu].time)>DTTOL) break;
         }
-        nr=nextobsf(&obss,&iobsr,2);
+        nr=nextobsf(&ctx->obss,&ctx->iobsr,2);
         if (nr<=0) 
         {
-            nr=nextobsf(&obss,&iobsr,2);
+            nr=nextobsf(&ctx->obss,&ctx->iobsr,2);
         }
-        for (i=0;i<nu&&n<MAXOBS*2;i++) obs[n++]=obss.data[iobsu+i];
-        for (i=0;i<nr&&n<MAXOBS*2;i++) obs[n++]=obss.data[iobsr+i];
-        iobsu+=nu;
+        for (i=0;i<nu&&n<MAXOBS*2;i++) obs[n++]=ctx->obss.data[ctx->iobsu+i];
+        for (i=0;i<nr&&n<MAXOBS*2;i++) obs[n++]=ctx->obss.data[ctx->iobsr+i];
+        ctx->iobsu+=nu;
         
         /* update sbas corrections */
-        while (isbs<sbss.n) 
+        while (ctx->isbs<ctx->sbss.n) 
         {
-            time=gpst2time(sbss.msgs[isbs].week,sbss.msgs[isbs].tow);
+            time=gpst2time(ctx->sbss.msgs[ctx->isbs].week,ctx->sbss.msgs[ctx->isbs].tow);
             
-            if (getbitu(sbss.msgs[isbs].msg,8,6)!=9)
+            if (getbitu(ctx->sbss.msgs[ctx->isbs].msg,8,6)!=9)
             { /* except for geo nav */
-                sbsupdatecorr(sbss.msgs+isbs,&navs);
+                sbsupdatecorr(ctx->sbss.msgs+ctx->isbs,&ctx->navs);
             }
             if (timediff(time,obs[0].time)>-1.0-DTTOL) break;
-            isbs++;
+            ctx->isbs++;
         }
         /* update lex corrections */
-        while (ilex<lexs.n) {
-            if (lexupdatecorr(lexs.msgs+ilex,&navs,&time)) {
+        while (ctx->ilex<ctx->lexs.n) {
+            if (lexupdatecorr(ctx->lexs.msgs+ctx->ilex,&ctx->navs,&time)) {
                 if (timediff(time,obs[0].time)>-1.0-DTTOL) break;
             }
-            ilex++;
+            ctx->ilex++;
         }
         /* update rtcm ssr corrections */
-        if (*rtcm_file) {
-            update_rtcm_ssr(obs[0].time);
+        if (*ctx->rtcm_file) {
+            update_rtcm_ssr(ctx,obs[0].time);
         }
     }
     else { /* input backward data */
-        if ((nu=nextobsb(&obss,&iobsu,1))<=0) return -1;
+        if ((nu=nextobsb(&ctx->obss,&ctx->iobsu,1))<=0) return -1;
         if (popt->intpref) {
-            for (;(nr=nextobsb(&obss,&iobsr,2))>0;iobsr-=nr)
-                if (timediff(obss.data[iobsr].time,obss.data[iobsu].time)<DTTOL) break;
+            for (;(nr=nextobsb(&ctx->obss,&ctx->iobsr,2))>0;ctx->iobsr-=nr)
+                if (timediff(ctx->obss.data[ctx->iobsr].time,ctx->obss.data[ctx->iobsu].time)<DTTOL) break;
         }
         else {
-            for (i=iobsr;(nr=nextobsb(&obss,&i,2))>0;iobsr=i,i-=nr)
-                if (timediff(obss.data[i].time,obss.data[iobsu].time)<-DTTOL) break;
+            for (i=ctx->iobsr;(nr=nextobsb(&ctx->obss,&i,2))>0;ctx->iobsr=i,i-=nr)
+                if (timediff(ctx->obss.data[i].time,ctx->obss.data[ctx->iobsu].time)<-DTTOL) break;
         }
-        nr=nextobsb(&obss,&iobsr,2);
-        for (i=0;i<nu&&n<MAXOBS*2;i++) obs[n++]=obss.data[iobsu-nu+1+i];
-        for (i=0;i<nr&&n<MAXOBS*2;i++) obs[n++]=obss.data[iobsr-nr+1+i];
-        iobsu-=nu;
+        nr=nextobsb(&ctx->obss,&ctx->iobsr,2);
+        for (i=0;i<nu&&n<MAXOBS*2;i++) obs[n++]=ctx->obss.data[ctx->iobsu-nu+1+i];
+        for (i=0;i<nr&&n<MAXOBS*2;i++) obs[n++]=ctx->obss.data[ctx->iobsr-nr+1+i];
+        ctx->iobsu-=nu;
         
         /* update sbas corrections */
-        while (isbs>=0) {
-            time=gpst2time(sbss.msgs[isbs].week,sbss.msgs[isbs].tow);
+        while (ctx->isbs>=0) {
+            time=gpst2time(ctx->sbss.msgs[ctx->isbs].week,ctx->sbss.msgs[ctx->isbs].tow);
             
-            if (getbitu(sbss.msgs[isbs].msg,8,6)!=9) { /* except for geo nav */
-                sbsupdatecorr(sbss.msgs+isbs,&navs);
+            if (getbitu(ctx->sbss.msgs[ctx->isbs].msg,8,6)!=9) { /* except for geo nav */
+                sbsupdatecorr(ctx->sbss.msgs+ctx->isbs,&ctx->navs);
             }
             if (timediff(time,obs[0].time)<1.0+DTTOL) break;
-            isbs--;
+            ctx->isbs--;
         }
         /* update lex corrections */
-        while (ilex>=0) {
-            if (lexupdatecorr(lexs.msgs+ilex,&navs,&time)) {
+        while (ctx->ilex>=0) {
+            if (lexupdatecorr(ctx->lexs.msgs+ctx->ilex,&ctx->navs,&time)) {
                 if (timediff(time,obs[0].time)<1.0+DTTOL) break;
             }
-            ilex--;
+            ctx->ilex--;
         }
     }
     return n;
@@ -396,82 +537,439 @@ static void corr_phase_bias_ssr(obsd_t *obs, int n, const nav_t *nav)
         obs[i].L[j]-=nav->ssr[obs[i].sat-1].pbias[code-1]/lam;
     }
 }
+/* initialize rtk control for positioning ------------------------------------*/
+static void initrtkpos(postctx_t *ctx, rtk_t *rtk, const prcopt_t *popt)
+{
+    double pos[3],dr[3];
+    int i;
+    
+    rtkinit(rtk,popt);
+    
+    /* rover position by single point positioning */
+    ecef2pos(popt->ru,pos);
+    enu2ecef(pos,popt->antdel[0],dr);
+    
+    for (i=0;i<3;i++) {
+        rtk->sol.rf[i]=dr[i]+rtk->opt.ru[i];
+        rtk->opt.ru[i]=rtk->sol.rf[i];
+    }
+    rtk->tsys=ctx->navs.obstsys;
+    rtk->sol.obstsys=ctx->navs.obstsys;
+}
+/* read obs data of next epoch -------------------------------------------------
+* input obs data, exclude satellites and correct carrier-phase biases
+* args   : postctx_t *ctx   IO  session
+*          obsd_t *obs      O   obs data of epoch
+*          int    *sat      O   satellites of input obs data
+*          int    *nsat     O   number of satellites of input obs data
+*          prcopt_t *popt   I   processing options
+* return : number of obs data after exclusion (-1: end of data)
+*-----------------------------------------------------------------------------*/
+static int readepoch(postctx_t *ctx, obsd_t *obs, int *sat, int *nsat,
+                     const prcopt_t *popt)
+{
+    int i,n,nobs;
+    
+    if ((nobs=inputobs(ctx,obs,0,popt))<0) return -1;
+    
+    /* exclude satellites */
+    for (i=n=0;i<nobs;i++) {
+        sat[i]=obs[i].sat;
+        if ((satsys(obs[i].sat,NULL)&popt->navsys)&&popt->exsats[obs[i].sat-1]!=1) 
+            obs[n++]=obs[i];
+    }
+    *nsat=nobs;
+    if (n<=0) return 0;
+    
+    /* carrier-phase bias correction */
+    if (ctx->navs.nf>0) {
+        corr_phase_bias_fcb(obs,n,&ctx->navs);
+    }
+    else if (!strstr(popt->pppopt,"-DIS_FCB")) {
+        corr_phase_bias_ssr(obs,n,&ctx->navs);
+    }
+    return n;
+}
+/* input obs data of next epoch for positioning ------------------------------
+* read obs data of next epoch and reset used-satellite flags of solution
+* return : number of obs data (-1: end of data)
+*-----------------------------------------------------------------------------*/
+static int inputepoch(postctx_t *ctx, rtk_t *rtk, obsd_t *obs, const prcopt_t *popt)
+{
+    int i,n,nsat,sat[MAXOBS*2];
+    
+    if ((n=readepoch(ctx,obs,sat,&nsat,popt))<0) return -1;
+    
+    for (i=0;i<nsat;i++) rtk->sol.sat[sat[i]-1]=-1;
+    return n;
+}
+/* show processing progress --------------------------------------------------*/
+static void outprgbar(postctx_t *ctx, gtime_t time, int stat, gtime_t ts, double dt)
+{
+    gtime_t ptime=timeadd(ts,ctx->prgbar*dt);
+    
+    if (!ctx->revs) {
+        if (timediff(time,ptime)>0.0) {
+            printf("processing : %s Q=%d %3.3d%%\n",time_str(time,0),stat,ctx->prgbar);
+            fflush(stdout);
+            ctx->prgbar++;
+        }
+    }
+    else if (timediff(time,ptime)<0.0) {
+        printf("processing : %s Q=%d %3.3d%%\n",time_str(time,0),stat,ctx->prgbar);
+        fflush(stdout);
+        ctx->prgbar--;
+    }
+}
+/* positioning pipeline --------------------------------------------------------
+* procpos() runs in three stages when threads are available. the input thread
+* assembles the obs data of epochs and corrects the phase biases, the calling
+* thread computes the positions and the output thread formats and writes the
+* solutions and the residuals/snr, so positioning does not wait for file
+* output. the stages are connected by bounded single-producer/single-consumer
+* queues without locks. the input stage runs ahead of positioning and must not
+* update the navigation data, so the pipeline is not used with sbas, lex or
+* rtcm ssr corrections.
+*-----------------------------------------------------------------------------*/
+#define PIPEQLEN    64          /* length of pipeline queues (epochs) */
+#define PIPENSPIN   100         /* number of yields before sleep in wait */
+
+typedef struct {                /* pipeline stage statistics type */
+    int n;                      /* number of epochs */
+    unsigned int tick;          /* start tick (ms) */
+    unsigned int tt;            /* elapsed time (ms) */
+    unsigned int wait;          /* time waiting for queues (ms) */
+} pipestat_t;
+
+typedef struct {                /* pipeline queue type */
+    unsigned char *buff;        /* queue buffer */
+    size_t size;                /* size of element (bytes) */
+    std::atomic<unsigned int> wp,rp; /* write/read counts */
+    std::atomic<int> stop;      /* consumer stopped */
+} pipeq_t;
+
+typedef struct {                /* pipeline input epoch type */
+    obsd_t obs[MAXOBS*2];       /* obs data */
+    int sat[MAXOBS*2];          /* satellites of input obs data */
+    int n,nsat;                 /* number of obs data (-1:end)/satellites */
+} pipein_t;
+
+typedef struct {                /* pipeline output epoch type */
+    sol_t sol;                  /* solution */
+    double rb[3];               /* base position for solution output */
+    int out;                    /* output solution (-1:end,0:off,1:on) */
+    int n;                      /* number of obs data */
+    int sat[MAXOBS*2];          /* satellites of obs data */
+    double resp[MAXOBS*2];      /* residuals of pseudorange (m) */
+    double el[MAXOBS*2];        /* elevation angles (rad) */
+    unsigned char snr[MAXOBS*2]; /* signal strength (0.25 dBHz) */
+} pipeout_t;
+
+typedef struct {                /* positioning pipeline type */
+    postctx_t *ctx;             /* session */
+    const prcopt_t *popt;       /* processing options */
+    const solopt_t *sopt;       /* solution options */
+    FILE *fp,*fpres,*fpsnr;     /* output files {solution,residuals,snr} */
+    pipeq_t qin,qout;           /* queues {input->positioning,positioning->output} */
+    pipestat_t stat[3];         /* statistics {input,positioning,output} */
+    thread_t thread[2];         /* threads {input,output} */
+    int run;                    /* pipeline running */
+} pipe_t;
+
+/* wait for pipeline queue ---------------------------------------------------*/
+static void pipeq_wait(int i)
+{
+#ifdef WIN32
+    if (i<PIPENSPIN) SwitchToThread(); else Sleep(1);
+#else
+    if (i<PIPENSPIN) sched_yield(); else sleepms(1);
+#endif
+}
+/* get element to write to pipeline queue --------------------------------------
+* wait while queue is full
+* return : element (NULL: consumer stopped)
+*-----------------------------------------------------------------------------*/
+static void *pipeq_wbuf(pipeq_t *q, pipestat_t *stat)
+{
+    unsigned int wp=q->wp.load(std::memory_order_relaxed),tick=0;
+    int i;
+    
+    for (i=0;wp-q->rp.load(std::memory_order_acquire)>=PIPEQLEN;i++) {
+        if (q->stop.load(std::memory_order_relaxed)) return NULL;
+        if (!tick) tick=tickget();
+        pipeq_wait(i);
+    }
+    if (tick) stat->wait+=tickget()-tick;
+    return q->stop.load(std::memory_order_relaxed)?NULL:q->buff+q->size*(wp%PIPEQLEN);
+}
+/* get element to read from pipeline queue -------------------------------------
+* wait while queue is empty
+* return : element
+*-----------------------------------------------------------------------------*/
+static void *pipeq_rbuf(pipeq_t *q, pipestat_t *stat)
+{
+    unsigned int rp=q->rp.load(std::memory_order_relaxed),tick=0;
+    int i;
+    
+    for (i=0;q->wp.load(std::memory_order_acquire)==rp;i++) {
+        if (!tick) tick=tickget();
+        pipeq_wait(i);
+    }
+    if (tick) stat->wait+=tickget()-tick;
+    return q->buff+q->size*(rp%PIPEQLEN);
+}
+/* commit written/read element of pipeline queue -----------------------------*/
+static void pipeq_push(pipeq_t *q)
+{
+    q->wp.fetch_add(1,std::memory_order_release);
+}
+static void pipeq_pop(pipeq_t *q)
+{
+    q->rp.fetch_add(1,std::memory_order_release);
+}
+/* input stage thread of pipeline --------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI pipeinthread(void *arg)
+#else
+static void *pipeinthread(void *arg)
+#endif
+{
+    pipe_t *p=(pipe_t *)arg;
+    pipein_t *e;
+    int n;
+    
+    p->stat[0].tick=tickget();
+    
+    while ((e=(pipein_t *)pipeq_wbuf(&p->qin,p->stat))) {
+        n=e->n=readepoch(p->ctx,e->obs,e->sat,&e->nsat,p->popt);
+        pipeq_push(&p->qin);
+        if (n<0) break;
+        p->stat[0].n++;
+    }
+    p->stat[0].tt=tickget()-p->stat[0].tick;
+    return 0;
+}
+/* output stage thread of pipeline -------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI pipeoutthread(void *arg)
+#else
+static void *pipeoutthread(void *arg)
+#endif
+{
+    pipe_t *p=(pipe_t *)arg;
+    pipeout_t *e;
+    rtk_t *rtk;
+    obsd_t obs[MAXOBS*2];
+    int i,sat;
+    
+    p->stat[2].tick=tickget();
+    
+    /* rtk control holding residuals/snr for output */
+    if ((rtk=(rtk_t *)calloc(1,sizeof(rtk_t)))) {
+        rtk->opt.navsys=p->popt->navsys;
+        rtk->tsys=p->ctx->navs.obstsys;
+    }
+    while ((e=(pipeout_t *)pipeq_rbuf(&p->qout,p->stat+2))->out>=0) {
+        if (rtk) {
+            rtk->sol.time=e->sol.time;
+            for (i=0;i<e->n;i++) {
+                obs[i].sat=sat=e->sat[i];
+                rtk->ssat[sat-1].resp[0]=e->resp[i];
+                rtk->ssat[sat-1].azel[1]=e->el[i];
+                rtk->ssat[sat-1].snr[0]=e->snr[i];
+            }
+            if (p->fpres) outsatres_single(p->fpres,rtk,obs,e->n);
+            if (p->fpsnr) outsatsnr_single(p->fpsnr,rtk,obs,e->n);
+        }
+        if (e->out) outsol(p->fp,&e->sol,e->rb,p->sopt);
+        pipeq_pop(&p->qout);
+        p->stat[2].n++;
+    }
+    free(rtk);
+    p->stat[2].tt=tickget()-p->stat[2].tick;
+    return 0;
+}
+/* start/stop thread of pipeline ---------------------------------------------*/
+static int startpipet(pipe_t *p, int i)
+{
+#ifdef WIN32
+    return (p->thread[i]=CreateThread(NULL,0,i?pipeoutthread:pipeinthread,p,0,
+                                      NULL))!=NULL;
+#else
+    return !pthread_create(p->thread+i,NULL,i?pipeoutthread:pipeinthread,p);
+#endif
+}
+static void waitpipet(pipe_t *p, int i)
+{
+#ifdef WIN32
+    WaitForSingleObject(p->thread[i],INFINITE);
+    CloseHandle(p->thread[i]);
+#else
+    pthread_join(p->thread[i],NULL);
+#endif
+}
+/* start positioning pipeline --------------------------------------------------
+* the pipeline is not started and procpos() runs the stages in turn if less
+* than two threads are allowed, if the navigation data are updated during
+* processing or if the trace output of the stages would be mixed
+*-----------------------------------------------------------------------------*/
+static void startpipe(pipe_t *p, postctx_t *ctx, FILE *fp, FILE *fpres,
+                      FILE *fpsnr, const prcopt_t *popt, const solopt_t *sopt)
+{
+    memset(p->stat,0,sizeof(p->stat));
+    p->ctx=ctx; p->popt=popt; p->sopt=sopt;
+    p->fp=fp; p->fpres=fpres; p->fpsnr=fpsnr;
+    p->qin.buff=p->qout.buff=NULL;
+    p->run=0;
+    
+    if (ctx->nthread<=1||sopt->trace>=3||ctx->sbss.n>0||ctx->lexs.n>0||
+        *ctx->rtcm_file) return;
+    
+    p->qin.size=sizeof(pipein_t);
+    p->qout.size=sizeof(pipeout_t);
+    p->qin.wp=p->qin.rp=p->qout.wp=p->qout.rp=0;
+    p->qin.stop=p->qout.stop=0;
+    
+    if (!(p->qin .buff=(unsigned char *)malloc(p->qin .size*PIPEQLEN))||
+        !(p->qout.buff=(unsigned char *)malloc(p->qout.size*PIPEQLEN))) {
+        free(p->qin.buff); free(p->qout.buff);
+        return;
+    }
+    /* output stage first to be stopped without losing epochs */
+    if (!startpipet(p,1)) {
+        free(p->qin.buff); free(p->qout.buff);
+        return;
+    }
+    if (!startpipet(p,0)) {
+        ((pipeout_t *)pipeq_wbuf(&p->qout,p->stat+1))->out=-1;
+        pipeq_push(&p->qout);
+        waitpipet(p,1);
+        free(p->qin.buff); free(p->qout.buff);
+        return;
+    }
+    p->stat[1].tick=tickget();
+    p->run=1;
+}
+/* stop positioning pipeline -------------------------------------------------*/
+static void stoppipe(pipe_t *p)
+{
+    const char *name[]={"input","positioning","output"};
+    pipestat_t *s;
+    double tt;
+    int i;
+    
+    if (!p->run) return;
+    
+    p->stat[1].tt=tickget()-p->stat[1].tick;
+    
+    /* stop input stage and flush output stage */
+    p->qin.stop.store(1,std::memory_order_relaxed);
+    ((pipeout_t *)pipeq_wbuf(&p->qout,p->stat+1))->out=-1;
+    pipeq_push(&p->qout);
+    waitpipet(p,0);
+    waitpipet(p,1);
+    free(p->qin.buff); free(p->qout.buff);
+    p->run=0;
+    
+    for (i=0;i<3;i++) {
+        s=p->stat+i;
+        tt=(s->tt-s->wait)*1E-3;
+        trace(2,"pipeline: %-11s epochs=%7d time=%8.2fs wait=%8.2fs rate=%9.1f/s\n",
+              name[i],s->n,s->tt*1E-3,s->wait*1E-3,tt>0.0?s->n/tt:0.0);
+    }
+}
+/* input obs data of next epoch from pipeline --------------------------------*/
+static int pipeinput(pipe_t *p, rtk_t *rtk, obsd_t *obs)
+{
+    pipein_t *e;
+    int i,n;
+    
+    if (!p->run) return inputepoch(p->ctx,rtk,obs,p->popt);
+    
+    e=(pipein_t *)pipeq_rbuf(&p->qin,p->stat+1);
+    
+    if ((n=e->n)>0) memcpy(obs,e->obs,sizeof(obsd_t)*n);
+    for (i=0;i<e->nsat&&n>=0;i++) rtk->sol.sat[e->sat[i]-1]=-1;
+    pipeq_pop(&p->qin);
+    if (n>=0) p->stat[1].n++;
+    return n;
+}
+/* output residuals/snr and solution to pipeline -----------------------------*/
+static void pipeoutput(pipe_t *p, rtk_t *rtk, obsd_t *obs, int n,
+                       const double *rb)
+{
+    pipeout_t *e;
+    int i;
+    
+    if (!p->run) {
+        if (p->fpres) outsatres_single(p->fpres,rtk,obs,n);
+        if (p->fpsnr) outsatsnr_single(p->fpsnr,rtk,obs,n);
+        if (rb) outsol(p->fp,&rtk->sol,rb,p->sopt);
+        return;
+    }
+    if (!p->fpres&&!p->fpsnr&&!rb) return;
+    
+    e=(pipeout_t *)pipeq_wbuf(&p->qout,p->stat+1);
+    e->sol=rtk->sol;
+    e->out=rb?1:0;
+    for (i=0;i<3&&rb;i++) e->rb[i]=rb[i];
+    for (i=0;i<n;i++) {
+        e->sat [i]=obs[i].sat;
+        e->resp[i]=rtk->ssat[obs[i].sat-1].resp[0];
+        e->el  [i]=rtk->ssat[obs[i].sat-1].azel[1];
+        e->snr [i]=rtk->ssat[obs[i].sat-1].snr[0];
+    }
+    e->n=n;
+    pipeq_push(&p->qout);
+}
 /* process positioning -------------------------------------------------------*/
-static void procpos(FILE *fp, const prcopt_t *popt, const solopt_t *sopt,
+static void procpos(postctx_t *ctx, FILE *fp, const prcopt_t *popt, const solopt_t *sopt,
                     int mode)
 {
     gtime_t time={0},ts,te;
     sol_t sol={{0}};
     rtk_t rtk;
+    pipe_t pipe;
     obsd_t obs[MAXOBS*2]; /* for rover and base */
     double rb[3]={0};
 	FILE *fpres = NULL, *fpsnr = NULL;
-    int i,j,nobs,n,solstatic,pri[]={0,1,2,3,4,5,1,6};
+    int i,j,n,solstatic,pri[]={0,1,2,3,4,5,1,6};
 	double dt;
-	gtime_t ptime;
 	int flag1, flag2, flag3;
 	char filestr[1024];
-	double pos[3], dr[3];
 
     trace(3,"procpos : mode=%d\n",mode);
     
     solstatic=((sopt->solstatic)&&(popt->mode==PMODE_STATIC||popt->mode==PMODE_PPP_STATIC));
     
-    rtkinit(&rtk,popt);
-    rtcm_path[0]='\0';
+    initrtkpos(ctx,&rtk,popt);
+    ctx->rtcm_path[0]='\0';
     
-	ts = obss.data[0].time;
-	te = obss.data[obss.n - 1].time;
+	if (ctx->nrnx > 0) { /* obs data stream */
+		ts = ctx->tspan[0];
+		te = ctx->tspan[1];
+	}
+	else {
+		ts = ctx->obss.data[0].time;
+		te = ctx->obss.data[ctx->obss.n - 1].time;
+	}
 	dt = (int)(timediff(te, ts)/100);
 
-	strcpy(filestr, outsppfile);
-	fpres = fopen(strcat(filestr, "psu_res"), "w");
-
-	strcpy(filestr, outsppfile);
-	fpsnr = fopen(strcat(filestr, "psu_snr"), "w");
+	/* residuals/snr of combined solution are output by backward pass */
+	if (mode==0||ctx->revs) {
+		strcpy(filestr, ctx->outsppfile);
+		fpres = fopen(strcat(filestr, "psu_res"), "w");
 
-	/* rover position by single point positioning */
-	ecef2pos(popt->ru, pos);
-	enu2ecef(pos, popt->antdel[0], dr);
-	
-	for (i = 0; i < 3; i++)
-    {
-		rtk.sol.rf[i] = dr[i] + rtk.opt.ru[i];
-		rtk.opt.ru[i] = rtk.sol.rf[i];
+		strcpy(filestr, ctx->outsppfile);
+		fpsnr = fopen(strcat(filestr, "psu_snr"), "w");
 	}
-	rtk.tsys = navs.obstsys;
-	rtk.sol.obstsys = navs.obstsys;
-    while ((nobs=inputobs(obs,rtk.sol.stat,popt))>=0) {
-        /* exclude satellites */
-        for (i=n=0;i<nobs;i++) {
-			rtk.sol.sat[obs[i].sat - 1] = -1;
-            if ((satsys(obs[i].sat,NULL)&popt->navsys)&&popt->exsats[obs[i].sat-1]!=1) 
-                obs[n++]=obs[i];
-        }
+    startpipe(&pipe,ctx,fp,fpres,fpsnr,popt,sopt);
+    
+    while ((n=pipeinput(&pipe,&rtk,obs))>=0) {
         if (n<=0) continue;
-		ptime = timeadd(ts, prgbar*dt);
-		if (!revs){
-			if (timediff(obs[0].time, ptime)>0.0){
-				printf("processing : %s Q=%d %3.3d%%\n", time_str(obs[0].time, 0), rtk.sol.stat, prgbar);
-				fflush(stdin);
-				fflush(stdout);
-				prgbar++;
-			}
-		}
-		else if(timediff(obs[0].time, ptime)<0.0){
-			printf("processing : %s Q=%d %3.3d%%\n", time_str(obs[0].time, 0), rtk.sol.stat, prgbar);
-			fflush(stdin);
-			fflush(stdout);
-		    prgbar--;
-		}
-
-        /* carrier-phase bias correction */
-        if (navs.nf>0) {
-            corr_phase_bias_fcb(obs,n,&navs);
-        }
-        else if (!strstr(popt->pppopt,"-DIS_FCB")) {
-            corr_phase_bias_ssr(obs,n,&navs);
-        }
+        
+        outprgbar(ctx,obs[0].time,rtk.sol.stat,ts,dt);
+        
         /* disable obstype unnessary */
 #if 1
 		int flag = 0;
@@ -535,17 +1033,17 @@ static void procpos(FILE *fp, const prcopt_t *popt, const solopt_t *sopt,
 		}
 	*/
 #endif
-        if (!rtkpos(&rtk,obs,n,&navs)) continue;
+        if (!rtkpos(&rtk,obs,n,&ctx->navs)) continue;
+        
+        /* output residuals/snr and solution of forward/backward */
+        if (mode==0&&!solstatic) {
+            for (i=0;i<3;i++) rb[i]=rtk.opt.mode==PMODE_SINGLE?rtk.opt.ru[i]:rtk.rb[i];
+            pipeoutput(&pipe,&rtk,obs,n,rb);
+        }
+        else pipeoutput(&pipe,&rtk,obs,n,NULL);
         
-		outsatres_single(fpres, &rtk, obs, n);
-		outsatsnr_single(fpsnr, &rtk, obs, n);
-
         if (mode==0) { /* forward/backward */
-            if (!solstatic) {
-				for (i = 0; i < 3; i++) rb[i] = rtk.opt.ru[i];
-				rtk.opt.mode == PMODE_SINGLE ? outsol(fp, &rtk.sol, rb, sopt) : outsol(fp, &rtk.sol, rtk.rb, sopt);
-            }
-			else if (rtk.sol.stat != SOLQ_NONE&&(time.time == 0 || pri[rtk.sol.stat] <= pri[sol.stat])) {
+			if (solstatic&&rtk.sol.stat != SOLQ_NONE&&(time.time == 0 || pri[rtk.sol.stat] <= pri[sol.stat])) {
                 sol=rtk.sol;
                 for (i=0;i<3;i++) rb[i]=rtk.rb[i];
                 if (time.time==0||timediff(rtk.sol.time,time)>0.0) {
@@ -553,33 +1051,388 @@ static void procpos(FILE *fp, const prcopt_t *popt, const solopt_t *sopt,
                 }
             }
         }
-        else if (!revs) { /* combined-forward */
-            if (isolf>=nepoch) return;
-            solf[isolf]=rtk.sol;
-            for (i=0;i<3;i++) rbf[i+isolf*3]=rtk.rb[i];
-            isolf++;
+        else if (!ctx->revs) { /* combined-forward */
+            if (ctx->isolf>=ctx->nepoch) break;
+            ctx->solf[ctx->isolf]=rtk.sol;
+            for (i=0;i<3;i++) ctx->rbf[i+ctx->isolf*3]=rtk.rb[i];
+            ctx->isolf++;
         }
         else { /* combined-backward */
-            if (isolb>=nepoch) return;
-            solb[isolb]=rtk.sol;
-            for (i=0;i<3;i++) rbb[i+isolb*3]=rtk.rb[i];
-            isolb++;
+            if (ctx->isolb>=ctx->nepoch) break;
+            ctx->solb[ctx->isolb]=rtk.sol;
+            for (i=0;i<3;i++) ctx->rbb[i+ctx->isolb*3]=rtk.rb[i];
+            ctx->isolb++;
         }
     }
+    stoppipe(&pipe);
+    
     if (mode==0&&solstatic&&time.time!=0.0) {
         sol.time=time;
         outsol(fp,&sol,rb,sopt);
     }
-    if (prgbar < 25)
+    if (ctx->prgbar < 25)
     {
-        SolFlag = 1;
+        ctx->solflag = 1;
     }
-    else if (prgbar >= 99)
+    else if (ctx->prgbar >= 99)
     {
-        SolFlag = 0;
+        ctx->solflag = 0;
     }
+    if (fpres) fclose(fpres);
+    if (fpsnr) fclose(fpsnr);
     rtkfree(&rtk);
 }
+/* open/close nequick-g model context ----------------------------------------
+* the context is work area of the model, so a session and each of its copies
+* run by other threads need their own one
+*-----------------------------------------------------------------------------*/
+static int opennequick(nav_t *nav, const prcopt_t *popt)
+{
+    nav->nequick=NULL;
+    
+    if (popt->ionoopt!=IONOOPT_GALION) return 1;
+    
+    if (!(nav->nequick=nequick_open(NULL,NULL))) {
+        trace(1,"nequick-g modip/ccir data open error\n");
+        return 0;
+    }
+    if (!nequick_setmode(nav->nequick,popt->nqmode)) {
+        trace(1,"nequick-g integration mode error: nqmode=%d\n",popt->nqmode);
+    }
+    return 1;
+}
+static void closenequick(nav_t *nav)
+{
+    nequick_close(nav->nequick);
+    nav->nequick=NULL;
+}
+/* epoch-parallel single point positioning -------------------------------------
+* spp keeps no state between epochs but the a-priori position and the used-
+* satellite flags of the solution. the obs data are split into chunks which
+* are solved by worker threads, each seeded with the approximate rover
+* position. the calling thread puts the chunks together in time order: the
+* head epochs of a chunk are solved again from the preceding solution until the
+* position agrees bit by bit with the chunk, and the rest of the chunk is taken
+* as it is. so the output is identical to that of procpos().
+*-----------------------------------------------------------------------------*/
+#define SPPNEPOCH   600         /* min number of epochs of spp chunk */
+#define SPPNCHUNK   4           /* number of spp chunks per thread */
+
+typedef struct {                /* spp epoch type */
+    sol_t sol;                  /* solution */
+    int stat;                   /* status of rtkpos() */
+    int index;                  /* index of residual/snr data */
+} sppepoch_t;
+
+typedef struct {                /* spp chunk type */
+    postctx_t *ctx;             /* session copy for worker thread */
+    const prcopt_t *popt;       /* processing options */
+    int iobs,iobe;              /* obs data index range {start,end} */
+    int nep,nemax;              /* number of/allocated epochs */
+    sppepoch_t *ep;             /* epochs */
+    int nd,ndmax;               /* number of/allocated residual/snr data */
+    double *resp;               /* pseudorange residuals (m) */
+    double *el;                 /* elevation angles (rad) */
+    unsigned char *snr;         /* signal strength (0.25 dBHz) */
+    thread_t thread;            /* worker thread */
+    int run;                    /* worker thread running */
+} sppchunk_t;
+
+/* add epoch to spp chunk ----------------------------------------------------*/
+static int addsppepoch(sppchunk_t *c, const rtk_t *rtk, const obsd_t *obs, int n,
+                       int stat)
+{
+    sppepoch_t *ep;
+    double *resp,*el;
+    unsigned char *snr;
+    int i,nmax;
+    
+    if (c->nep>=c->nemax) {
+        nmax=c->nemax<=0?SPPNEPOCH:c->nemax*2;
+        if (!(ep=(sppepoch_t *)realloc(c->ep,sizeof(sppepoch_t)*nmax))) return 0;
+        c->ep=ep; c->nemax=nmax;
+    }
+    if (c->nd+n>c->ndmax) {
+        for (nmax=c->ndmax<=0?SPPNEPOCH*32:c->ndmax*2;nmax<c->nd+n;nmax*=2) ;
+        if (!(resp=(double *)realloc(c->resp,sizeof(double)*nmax))) return 0;
+        c->resp=resp;
+        if (!(el=(double *)realloc(c->el,sizeof(double)*nmax))) return 0;
+        c->el=el;
+        if (!(snr=(unsigned char *)realloc(c->snr,nmax))) return 0;
+        c->snr=snr; c->ndmax=nmax;
+    }
+    c->ep[c->nep].sol=rtk->sol;
+    c->ep[c->nep].stat=stat;
+    c->ep[c->nep++].index=c->nd;
+    
+    for (i=0;i<n;i++,c->nd++) {
+        c->resp[c->nd]=rtk->ssat[obs[i].sat-1].resp[0];
+        c->el  [c->nd]=rtk->ssat[obs[i].sat-1].azel[1];
+        c->snr [c->nd]=rtk->ssat[obs[i].sat-1].snr[0];
+    }
+    return 1;
+}
+/* free spp chunk ------------------------------------------------------------*/
+static void freesppchunk(sppchunk_t *c)
+{
+    if (c->ctx) closenequick(&c->ctx->navs);
+    free(c->ctx); free(c->ep); free(c->resp); free(c->el); free(c->snr);
+    memset(c,0,sizeof(sppchunk_t));
+}
+/* spp chunk thread ----------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI sppthread(void *arg)
+#else
+static void *sppthread(void *arg)
+#endif
+{
+    sppchunk_t *c=(sppchunk_t *)arg;
+    rtk_t rtk;
+    obsd_t obs[MAXOBS*2];
+    int i,n,stat;
+    
+    initrtkpos(c->ctx,&rtk,c->popt);
+    
+    /* seed with approximate rover position */
+    for (i=0;i<3;i++) rtk.sol.rr[i]=rtk.opt.ru[i];
+    
+    for (;;) {
+        i=c->ctx->iobsu;
+        if (nextobsf(&c->ctx->obss,&i,1)<=0||i>=c->iobe) break;
+        if ((n=inputepoch(c->ctx,&rtk,obs,c->popt))<=0) continue;
+        stat=rtkpos(&rtk,obs,n,&c->ctx->navs);
+        if (!addsppepoch(c,&rtk,obs,stat?n:0,stat)) break;
+    }
+    rtkfree(&rtk);
+    return 0;
+}
+/* start/wait spp chunk thread -----------------------------------------------*/
+static void startspp(sppchunk_t *c, postctx_t *ctx, const prcopt_t *popt)
+{
+    if (!(c->ctx=(postctx_t *)malloc(sizeof(postctx_t)))) return;
+    *c->ctx=*ctx;
+    c->ctx->iobsu=c->iobs; c->ctx->iobsr=c->ctx->isbs=c->ctx->ilex=0;
+    c->ctx->revs=0; c->ctx->fp_rtcm=NULL;
+    c->popt=popt;
+    if (!opennequick(&c->ctx->navs,popt)) {
+        free(c->ctx); c->ctx=NULL;
+        return;
+    }
+#ifdef WIN32
+    c->run=(c->thread=CreateThread(NULL,0,sppthread,c,0,NULL))!=NULL;
+#else
+    c->run=!pthread_create(&c->thread,NULL,sppthread,c);
+#endif
+}
+static void waitspp(sppchunk_t *c)
+{
+    if (!c->run) return;
+#ifdef WIN32
+    WaitForSingleObject(c->thread,INFINITE);
+    CloseHandle(c->thread);
+#else
+    pthread_join(c->thread,NULL);
+#endif
+    c->run=0;
+}
+/* epoch-parallel spp available ----------------------------------------------*/
+static int sppparallel(const postctx_t *ctx, const prcopt_t *popt,
+                       const solopt_t *sopt)
+{
+    /* sbas/lex/ssr messages, sbas troposphere cache and bdgim model carry
+       state between epochs or threads */
+    return ctx->nthread>1&&popt->mode==PMODE_SINGLE&&ctx->nepoch>SPPNEPOCH&&
+           sopt->sstat<=0&&sopt->trace<=0&&ctx->sbss.n<=0&&ctx->lexs.n<=0&&
+           !*ctx->rtcm_file&&popt->tropopt!=TROPOPT_SBAS&&
+           popt->ionoopt!=IONOOPT_BDSSH9;
+}
+/* process epoch-parallel single point positioning ---------------------------*/
+static void procspp(postctx_t *ctx, FILE *fp, const prcopt_t *popt,
+                    const solopt_t *sopt)
+{
+    sppchunk_t *c;
+    sppepoch_t *e;
+    gtime_t ts,te;
+    rtk_t rtk;
+    obsd_t obs[MAXOBS*2];
+    FILE *fpres=NULL,*fpsnr=NULL;
+    double dt;
+    char filestr[1024];
+    int i,j,k,k0,k1,m,n,nc,nt,nep,stat,sync=0,iep=0,nsolv=0,sat[MAXSAT];
+    
+    /* split obs data into chunks of m epochs */
+    for (i=nep=0;(n=nextobsf(&ctx->obss,&i,1))>0;i+=n) nep++;
+    if ((m=nep/(ctx->nthread*SPPNCHUNK))<SPPNEPOCH) m=SPPNEPOCH;
+    nc=(nep+m-1)/m;
+    nt=ctx->nthread<nc?ctx->nthread:nc;
+    
+    trace(3,"procspp : nepoch=%d nchunk=%d nthread=%d\n",nep,nc,nt);
+    
+    if (!(c=(sppchunk_t *)calloc(nc,sizeof(sppchunk_t)))) {
+        procpos(ctx,fp,popt,sopt,0);
+        return;
+    }
+    for (i=j=k=0;(n=nextobsf(&ctx->obss,&i,1))>0;i+=n,j++) {
+        if (j%m==0) c[k++].iobs=i;
+    }
+    for (k=0;k<nc;k++) c[k].iobe=k<nc-1?c[k+1].iobs:ctx->obss.n;
+    
+    initrtkpos(ctx,&rtk,popt);
+    ctx->rtcm_path[0]='\0';
+    
+    ts=ctx->obss.data[0].time;
+    te=ctx->obss.data[ctx->obss.n-1].time;
+    dt=(int)(timediff(te,ts)/100);
+    
+    strcpy(filestr,ctx->outsppfile);
+    fpres=fopen(strcat(filestr,"psu_res"),"w");
+    strcpy(filestr,ctx->outsppfile);
+    fpsnr=fopen(strcat(filestr,"psu_snr"),"w");
+    
+    for (j=0;j<nt;j++) startspp(c+j,ctx,popt);
+    
+    for (k=k0=0;k0<nc;k0=k1) {
+        k1=k0+nt<nc?k0+nt:nc;
+        
+        /* wait for chunks and solve next chunks by worker threads */
+        for (j=k0;j<k1;j++) waitspp(c+j);
+        for (j=k1;j<k1+nt&&j<nc;j++) startspp(c+j,ctx,popt);
+        
+        /* put together solutions of chunks */
+        for (;;) {
+            i=ctx->iobsu;
+            if (nextobsf(&ctx->obss,&i,1)<=0) break;
+            for (;k<nc-1&&i>=c[k].iobe;k++) sync=iep=0;
+            if (k>=k1) break;
+            
+            if ((n=inputepoch(ctx,&rtk,obs,popt))<=0) continue;
+            
+            outprgbar(ctx,obs[0].time,rtk.sol.stat,ts,dt);
+            
+            e=iep<c[k].nep?c[k].ep+iep:NULL; iep++;
+            
+            if (sync&&e) {
+                for (i=0;i<MAXSAT;i++) sat[i]=rtk.sol.sat[i];
+                for (i=0;i<n;i++) sat[obs[i].sat-1]=e->sol.sat[obs[i].sat-1];
+                rtk.sol=e->sol;
+                for (i=0;i<MAXSAT;i++) rtk.sol.sat[i]=sat[i];
+                
+                if (!(stat=e->stat)) continue;
+                
+                for (i=0;i<n;i++) {
+                    rtk.ssat[obs[i].sat-1].resp[0]=c[k].resp[e->index+i];
+                    rtk.ssat[obs[i].sat-1].azel[1]=c[k].el  [e->index+i];
+                    rtk.ssat[obs[i].sat-1].snr [0]=c[k].snr [e->index+i];
+                }
+            }
+            else {
+                stat=rtkpos(&rtk,obs,n,&ctx->navs);
+                nsolv++;
+                
+                /* same a-priori position for next epoch */
+                if (e&&!memcmp(rtk.sol.rr,e->sol.rr,sizeof(double)*3)) sync=1;
+                
+                if (!stat) continue;
+            }
+            if (fpres) outsatres_single(fpres,&rtk,obs,n);
+            if (fpsnr) outsatsnr_single(fpsnr,&rtk,obs,n);
+            outsol(fp,&rtk.sol,rtk.opt.ru,sopt);
+        }
+        for (j=k0;j<k1;j++) freesppchunk(c+j);
+    }
+    trace(2,"procspp : nchunk=%d epochs solved again=%d\n",nc,nsolv);
+    
+    if (ctx->prgbar<25) ctx->solflag=1;
+    else if (ctx->prgbar>=99) ctx->solflag=0;
+    
+    if (fpres) fclose(fpres);
+    if (fpsnr) fclose(fpsnr);
+    rtkfree(&rtk);
+    free(c);
+}
+/* backward pass thread of combined solution ---------------------------------*/
+typedef struct {                /* combined-backward pass type */
+    postctx_t *ctx;             /* session copy for backward pass */
+    const prcopt_t *popt;       /* processing options */
+    const solopt_t *sopt;       /* solution options */
+} procposb_t;
+
+#ifdef WIN32
+static DWORD WINAPI procposthread(void *arg)
+#else
+static void *procposthread(void *arg)
+#endif
+{
+    procposb_t *b=(procposb_t *)arg;
+    
+    procpos(b->ctx,NULL,b->popt,b->sopt,1);
+    return 0;
+}
+/* process forward/backward passes of combined solution ----------------------
+* the backward pass runs on a copy of the session in a second thread. the copy
+* shares the obs, sbas, lex and navigation data read-only and has its own data
+* cursors, bdgim model state (updated by the bdssh9 model per hour and day)
+* and nequick-g model context. solution status output is process-wide, so the
+* passes are run in turn if it is enabled or a model state is not allocated.
+*-----------------------------------------------------------------------------*/
+static void procposcomb(postctx_t *ctx, const prcopt_t *popt, const solopt_t *sopt)
+{
+    procposb_t b;
+    thread_t thread;
+    BDSSH *ion=NULL;
+    int stat,nqown,ionown=1;
+    
+    trace(3,"procposcomb: nepoch=%d\n",ctx->nepoch);
+    
+    ctx->isolf=ctx->isolb=0;
+    
+    if (!(b.ctx=(postctx_t *)malloc(sizeof(postctx_t)))) {
+        showmsg("error : memory allocation");
+        ctx->aborts=1;
+        return;
+    }
+    *b.ctx=*ctx;
+    b.ctx->revs=1; b.ctx->iobsu=b.ctx->iobsr=ctx->obss.n-1;
+    b.ctx->isbs=ctx->sbss.n-1; b.ctx->ilex=ctx->lexs.n-1;
+    b.ctx->prgbar=100; b.ctx->fp_rtcm=NULL;
+    b.popt=popt;
+    b.sopt=sopt;
+    nqown=opennequick(&b.ctx->navs,popt);
+    
+    if (ctx->navs.ion_bdsk9) {
+        if ((ionown=(ion=(BDSSH *)malloc(sizeof(BDSSH)))!=NULL)) {
+            *ion=*ctx->navs.ion_bdsk9;
+            initbdgim(ion);
+            b.ctx->navs.ion_bdsk9=ion;
+        }
+    }
+#ifdef WIN32
+    stat=nqown&&ionown&&sopt->sstat<=0&&
+         (thread=CreateThread(NULL,0,procposthread,&b,0,NULL))!=NULL;
+#else
+    stat=nqown&&ionown&&sopt->sstat<=0&&
+         !pthread_create(&thread,NULL,procposthread,&b);
+#endif
+    procpos(ctx,NULL,popt,sopt,1); /* forward */
+    
+    if (stat) {
+#ifdef WIN32
+        WaitForSingleObject(thread,INFINITE);
+        CloseHandle(thread);
+#else
+        pthread_join(thread,NULL);
+#endif
+    }
+    else { /* backward */
+        if (!nqown) b.ctx->navs.nequick=ctx->navs.nequick;
+        procpos(b.ctx,NULL,popt,sopt,1);
+    }
+    ctx->isolb=b.ctx->isolb;
+    if (b.ctx->aborts) ctx->aborts=1;
+    if (nqown) closenequick(&b.ctx->navs);
+    free(ion);
+    free(b.ctx);
+}
 /* validation of combined solutions ------------------------------------------*/
 static int valcomb(const sol_t *solf, const sol_t *solb)
 {
@@ -605,67 +1458,67 @@ static int valcomb(const sol_t *solf, const sol_t *solb)
     return 1;
 }
 /* combine forward/backward solutions and output results ---------------------*/
-static void combres(FILE *fp, const prcopt_t *popt, const solopt_t *sopt)
+static void combres(postctx_t *ctx, FILE *fp, const prcopt_t *popt, const solopt_t *sopt)
 {
     gtime_t time={0};
     sol_t sols={{0}},sol={{0}};
     double tt,Qf[9],Qb[9],Qs[9],rbs[3]={0},rb[3]={0},rr_f[3],rr_b[3],rr_s[3];
     int i,j,k,solstatic,pri[]={0,1,2,3,4,5,1,6};
     
-    trace(3,"combres : isolf=%d isolb=%d\n",isolf,isolb);
+    trace(3,"combres : isolf=%d isolb=%d\n",ctx->isolf,ctx->isolb);
     
     solstatic=sopt->solstatic&&
               (popt->mode==PMODE_STATIC||popt->mode==PMODE_PPP_STATIC);
     
-    for (i=0,j=isolb-1;i<isolf&&j>=0;i++,j--) {
+    for (i=0,j=ctx->isolb-1;i<ctx->isolf&&j>=0;i++,j--) {
         
-        if ((tt=timediff(solf[i].time,solb[j].time))<-DTTOL) {
-            sols=solf[i];
-            for (k=0;k<3;k++) rbs[k]=rbf[k+i*3];
+        if ((tt=timediff(ctx->solf[i].time,ctx->solb[j].time))<-DTTOL) {
+            sols=ctx->solf[i];
+            for (k=0;k<3;k++) rbs[k]=ctx->rbf[k+i*3];
             j++;
         }
         else if (tt>DTTOL) {
-            sols=solb[j];
-            for (k=0;k<3;k++) rbs[k]=rbb[k+j*3];
+            sols=ctx->solb[j];
+            for (k=0;k<3;k++) rbs[k]=ctx->rbb[k+j*3];
             i--;
         }
-        else if (solf[i].stat<solb[j].stat) {
-            sols=solf[i];
-            for (k=0;k<3;k++) rbs[k]=rbf[k+i*3];
+        else if (ctx->solf[i].stat<ctx->solb[j].stat) {
+            sols=ctx->solf[i];
+            for (k=0;k<3;k++) rbs[k]=ctx->rbf[k+i*3];
         }
-        else if (solf[i].stat>solb[j].stat) {
-            sols=solb[j];
-            for (k=0;k<3;k++) rbs[k]=rbb[k+j*3];
+        else if (ctx->solf[i].stat>ctx->solb[j].stat) {
+            sols=ctx->solb[j];
+            for (k=0;k<3;k++) rbs[k]=ctx->rbb[k+j*3];
         }
         else {
-            sols=solf[i];
+            sols=ctx->solf[i];
             sols.time=timeadd(sols.time,-tt/2.0);
             
             if ((popt->mode==PMODE_KINEMA||popt->mode==PMODE_MOVEB)&&
                 sols.stat==SOLQ_FIX) {
                 
                 /* degrade fix to float if validation failed */
-                if (!valcomb(solf+i,solb+j)) sols.stat=SOLQ_FLOAT;
+                if (!valcomb(ctx->solf+i,ctx->solb+j)) sols.stat=SOLQ_FLOAT;
             }
             for (k=0;k<3;k++) {
-                Qf[k+k*3]=solf[i].qr[k];
-                Qb[k+k*3]=solb[j].qr[k];
+                Qf[k+k*3]=ctx->solf[i].qr[k];
+                Qb[k+k*3]=ctx->solb[j].qr[k];
             }
-            Qf[1]=Qf[3]=solf[i].qr[3];
-            Qf[5]=Qf[7]=solf[i].qr[4];
-            Qf[2]=Qf[6]=solf[i].qr[5];
-            Qb[1]=Qb[3]=solb[j].qr[3];
-            Qb[5]=Qb[7]=solb[j].qr[4];
-            Qb[2]=Qb[6]=solb[j].qr[5];
+            Qf[1]=Qf[3]=ctx->solf[i].qr[3];
+            Qf[5]=Qf[7]=ctx->solf[i].qr[4];
+            Qf[2]=Qf[6]=ctx->solf[i].qr[5];
+            Qb[1]=Qb[3]=ctx->solb[j].qr[3];
+            Qb[5]=Qb[7]=ctx->solb[j].qr[4];
+            Qb[2]=Qb[6]=ctx->solb[j].qr[5];
             
             if (popt->mode==PMODE_MOVEB) {
-                for (k=0;k<3;k++) rr_f[k]=solf[i].rr[k]-rbf[k+i*3];
-                for (k=0;k<3;k++) rr_b[k]=solb[j].rr[k]-rbb[k+j*3];
+                for (k=0;k<3;k++) rr_f[k]=ctx->solf[i].rr[k]-ctx->rbf[k+i*3];
+                for (k=0;k<3;k++) rr_b[k]=ctx->solb[j].rr[k]-ctx->rbb[k+j*3];
                 if (smoother(rr_f,Qf,rr_b,Qb,3,rr_s,Qs)) continue;
                 for (k=0;k<3;k++) sols.rr[k]=rbs[k]+rr_s[k];
             }
             else {
-                if (smoother(solf[i].rr,Qf,solb[j].rr,Qb,3,sols.rr,Qs)) continue;
+                if (smoother(ctx->solf[i].rr,Qf,ctx->solb[j].rr,Qb,3,sols.rr,Qs)) continue;
             }
             sols.qr[0]=(float)Qs[0];
             sols.qr[1]=(float)Qs[4];
@@ -677,16 +1530,16 @@ static void combres(FILE *fp, const prcopt_t *popt, const solopt_t *sopt)
             /* smoother for velocity solution */
             if (popt->dynamics) {
                 for (k=0;k<3;k++) {
-                    Qf[k+k*3]=solf[i].qv[k];
-                    Qb[k+k*3]=solb[j].qv[k];
+                    Qf[k+k*3]=ctx->solf[i].qv[k];
+                    Qb[k+k*3]=ctx->solb[j].qv[k];
                 }
-                Qf[1]=Qf[3]=solf[i].qv[3];
-                Qf[5]=Qf[7]=solf[i].qv[4];
-                Qf[2]=Qf[6]=solf[i].qv[5];
-                Qb[1]=Qb[3]=solb[j].qv[3];
-                Qb[5]=Qb[7]=solb[j].qv[4];
-                Qb[2]=Qb[6]=solb[j].qv[5];
-                if (smoother(solf[i].rr+3,Qf,solb[j].rr+3,Qb,3,sols.rr+3,Qs)) continue;
+                Qf[1]=Qf[3]=ctx->solf[i].qv[3];
+                Qf[5]=Qf[7]=ctx->solf[i].qv[4];
+                Qf[2]=Qf[6]=ctx->solf[i].qv[5];
+                Qb[1]=Qb[3]=ctx->solb[j].qv[3];
+                Qb[5]=Qb[7]=ctx->solb[j].qv[4];
+                Qb[2]=Qb[6]=ctx->solb[j].qv[5];
+                if (smoother(ctx->solf[i].rr+3,Qf,ctx->solb[j].rr+3,Qb,3,sols.rr+3,Qs)) continue;
                 sols.qv[0]=(float)Qs[0];
                 sols.qv[1]=(float)Qs[4];
                 sols.qv[2]=(float)Qs[8];
@@ -712,7 +1565,7 @@ static void combres(FILE *fp, const prcopt_t *popt, const solopt_t *sopt)
     }
 }
 /* read prec ephemeris, sbas data, lex data, tec grid and open rtcm ----------*/
-static void readpreceph(char **infile, int n, const prcopt_t *prcopt,
+static void readpreceph(postctx_t *ctx, char **infile, int n, const prcopt_t *prcopt,
                         nav_t *nav, sbs_t *sbs, lex_t *lex)
 {
     seph_t seph0={0};
@@ -775,19 +1628,19 @@ static void readpreceph(char **infile, int n, const prcopt_t *prcopt,
     for (i=0;i<nav->ns;i++) nav->seph[i]=seph0;
     
     /* set rtcm file and initialize rtcm struct */
-    rtcm_file[0]=rtcm_path[0]='\0'; fp_rtcm=NULL;
+    ctx->rtcm_file[0]=ctx->rtcm_path[0]='\0'; ctx->fp_rtcm=NULL;
     
     for (i=0;i<n;i++) {
         if ((ext=strrchr(infile[i],'.'))&&
             (!strcmp(ext,".rtcm3")||!strcmp(ext,".RTCM3"))) {
-            strcpy(rtcm_file,infile[i]);
-            init_rtcm(&rtcm);
+            strcpy(ctx->rtcm_file,infile[i]);
+            init_rtcm(&ctx->rtcm);
             break;
         }
     }
 }
 /* free prec ephemeris and sbas data -----------------------------------------*/
-static void freepreceph(nav_t *nav, sbs_t *sbs, lex_t *lex)
+static void freepreceph(postctx_t *ctx, nav_t *nav, sbs_t *sbs, lex_t *lex)
 {
     int i;
     
@@ -805,68 +1658,161 @@ static void freepreceph(nav_t *nav, sbs_t *sbs, lex_t *lex)
     }
     free(nav->tec ); nav->tec =NULL; nav->nt=nav->ntmax=0;
     
-    if (fp_rtcm) fclose(fp_rtcm);
-    free_rtcm(&rtcm);
+    if (ctx->fp_rtcm) fclose(ctx->fp_rtcm);
+    free_rtcm(&ctx->rtcm);
+}
+/* attach/detach shared products to session navigation data -----------------*/
+static void attachprod(nav_t *nav, const postprod_t *prod)
+{
+    BDSSH *ion=nav->ion_bdsk9;
+    
+    *nav=prod->nav; /* ephemeris, clock, tec and erp arrays are shared */
+    *ion=*prod->nav.ion_bdsk9;
+    nav->ion_bdsk9=ion;
+}
+static void detachprod(nav_t *nav)
+{
+    nav->eph =NULL; nav->n =nav->nmax =0;
+    nav->geph=NULL; nav->ng=nav->ngmax=0;
+    nav->seph=NULL; nav->ns=nav->nsmax=0;
+    nav->ephidx=NULL;
+    nav->cheb=NULL;
+    nav->peph=NULL; nav->ne=nav->nemax=0;
+    nav->pclk=NULL; nav->nc=nav->ncmax=0;
+    nav->alm =NULL; nav->na=nav->namax=0;
+    nav->tec =NULL; nav->nt=nav->ntmax=0;
+    nav->fcb =NULL; nav->nf=nav->nfmax=0;
+    nav->erp.data=NULL; nav->erp.n=nav->erp.nmax=0;
 }
 /* read obs and nav data -----------------------------------------------------*/
-static int readobsnav(gtime_t ts, gtime_t te, double ti, const char **infile,
+/* read/free chebyshev orbit/clock file -------------------------------------*/
+static int ischeb(const char *file)
+{
+    const char *ext=strrchr(file,'.');
+    
+    return ext&&(!strcmp(ext,".cheb")||!strcmp(ext,".CHEB"));
+}
+static void readchebf(const char *file, nav_t *nav)
+{
+    cheb_t *cheb;
+    
+    if (nav->cheb) return; /* first file only */
+    
+    if (!(cheb=(cheb_t *)malloc(sizeof(cheb_t)))) return;
+    if (!readcheb(file,cheb)) {
+        showmsg("error : chebyshev orbit/clock %s",file);
+        free(cheb);
+        return;
+    }
+    nav->cheb=cheb;
+}
+static void freechebf(nav_t *nav)
+{
+    if (nav->cheb) freecheb(nav->cheb);
+    free(nav->cheb); nav->cheb=NULL;
+}
+static int readobsnav(postctx_t *ctx, gtime_t ts, gtime_t te, double ti, const char **infile,
                       const int *index, int n, const prcopt_t *prcopt,
                       obs_t *obs, nav_t *nav, sta_t *sta)
 {
-    int i,j,ind=0,nobs=0,rcv=1;
+    int i,j,ind=0,nobs=0,rcv=1,stream=obsstream(ctx,prcopt);
     
     trace(3,"readobsnav: ts=%s n=%d\n",time_str(ts,0),n);
     // ʼ
-    init_nav(&navs);
-    init_obs(&obss);
+    init_nav(nav);
+    init_obs(obs);
+    if (ctx->prod) attachprod(nav,ctx->prod);
     nav->galfreq = prcopt->freqopt;
-    nepoch=0;
+    ctx->nepoch=0;
+    ctx->tspan[0].time=ctx->tspan[1].time=0;
+    ctx->tspan[0].sec=ctx->tspan[1].sec=0.0;
     
     for (i=0;i<n;i++) {
-        if (checkbrk("")) return 0;
+        if (checkbrk(ctx,"")) {closeobsstr(ctx); return 0;}
         
         if (index[i]!=ind) {
-            if (obs->n>nobs) rcv++;
-            ind=index[i]; nobs=obs->n; 
+            if ((stream?ctx->nrnx:obs->n)>nobs) rcv++;
+            ind=index[i]; nobs=stream?ctx->nrnx:obs->n;
+        }
+        if (ischeb(infile[i])) { /* chebyshev orbit/clock */
+            if (!ctx->prod) readchebf(infile[i],nav);
+            continue;
+        }
+        if (stream) { /* open obs file streams and read nav files */
+            if (openobsstr(ctx,infile[i],rcv,ts,te,ti,prcopt->rnxopt[rcv<=1?0:1],
+                           nav,rcv<=2?sta+rcv-1:NULL)<0) {
+                checkbrk(ctx,"error : insufficient memory");
+                trace(1,"insufficient memory\n");
+                closeobsstr(ctx);
+                return 0;
+            }
+            continue;
         }
         /* read rinex obs and nav file/ ļ庯 */
         if (readrnxt(infile[i],rcv,ts,te,ti,prcopt->rnxopt[rcv<=1?0:1],obs,nav,
                      rcv<=2?sta+rcv-1:NULL)<0) {
-            checkbrk("error : insufficient memory");
+            checkbrk(ctx,"error : insufficient memory");
             trace(1,"insufficient memory\n");
             return 0;
         }
+    }
+    if (stream) {
+        for (i=0;i<ctx->nrnx;i++) {
+            memcpy(obs->isci,ctx->rnxs[i].isci,sizeof(obs->isci));
+            if (ctx->rnxs[i].rcv!=1) continue;
+            if (ctx->rnxs[i].n>0&&(ctx->tspan[0].time==0||
+                timediff(ctx->rnxs[i].data[0].time,ctx->tspan[0])<0.0)) {
+                ctx->tspan[0]=ctx->rnxs[i].data[0].time;
+            }
+            if (timediff(ctx->rnxs[i].tend,ctx->tspan[1])>0.0) {
+                ctx->tspan[1]=ctx->rnxs[i].tend;
+            }
+        }
+        if (ctx->tspan[1].time==0) ctx->tspan[1]=te;
+        ctx->iwin=0;
+        if (!fillobs(ctx)) {
+            checkbrk(ctx,"error : insufficient memory");
+            closeobsstr(ctx);
+            return 0;
+        }
     }
 	if (obs->n <= 0 && prcopt->outsat == 0) {
-        checkbrk("error : no obs data");
+        checkbrk(ctx,"error : no obs data");
         trace(1,"\n");
+        closeobsstr(ctx);
         return 0;
     }
-    if (nav->n<=0&&nav->ng<=0&&nav->ns<=0) {
-        checkbrk("error : no nav data");
+    if (nav->n<=0&&nav->ng<=0&&nav->ns<=0&&!nav->cheb) {
+        checkbrk(ctx,"error : no nav data");
         trace(1,"\n");
+        closeobsstr(ctx);
         return 0;
     }
-    /* sort observation data */
-    nepoch=sortobs(obs);
+    /* sort observation data (obs data stream sorted by fillobs()) */
+    if (!stream) ctx->nepoch=sortobs(obs);
     
 	/* copy isc index from obs to nav*/
 	for (i = 0; i < 7; i++)for (j = 0; j < MAXFREQ; j++){
 		nav->isci[i][j] = obs->isci[i][j];
 	}
-    /* delete duplicated ephemeris */
-    uniqnav(nav);
+    /* delete duplicated ephemeris (shared products are already unique) */
+    if (!ctx->prod) uniqnav(nav);
     
 	/* delete duplicated ion */
 	double ep[6];
-	if (obs->n > 0)
+	if (obs->n > 0 && !ctx->prod)
     {
 		time2epoch(obs->data[0].time, ep);
         char iftrue = uniqion(ep, nav->ion_bdsk9);
 	}
 
     /* set time span for progress display */
-    if (ts.time==0||te.time==0) {
+    if (stream) {
+        if (ctx->tspan[0].time&&timediff(ctx->tspan[1],ctx->tspan[0])>0.0) {
+            settspan(ctx->tspan[0],ctx->tspan[1]);
+        }
+    }
+    else if (ts.time==0||te.time==0) {
         for (i=0;   i<obs->n;i++) if (obs->data[i].rcv==1) break;
         for (j=obs->n-1;j>=0;j--) if (obs->data[j].rcv==1) break;
         if (i<j) {
@@ -875,17 +1821,30 @@ static int readobsnav(gtime_t ts, gtime_t te, double ti, const char **infile,
             settspan(ts,te);
         }
     }
+    /* nequick-g model */
+    if (!opennequick(nav,prcopt)) {
+        checkbrk(ctx,"error : no nequick-g modip/ccir data");
+        closeobsstr(ctx);
+        return 0;
+    }
     return 1;
 }
 /* free obs and nav data -----------------------------------------------------*/
-static void freeobsnav(obs_t *obs, nav_t *nav)
+static void freeobsnav(postctx_t *ctx, obs_t *obs, nav_t *nav)
 {
     trace(3,"freeobsnav:\n");
     
+    closeobsstr(ctx);
+    if (ctx->prod) detachprod(nav);
+    
     free(obs->data); obs->data=NULL; obs->n =obs->nmax =0;
     free(nav->eph ); nav->eph =NULL; nav->n =nav->nmax =0;
     free(nav->geph); nav->geph=NULL; nav->ng=nav->ngmax=0;
     free(nav->seph); nav->seph=NULL; nav->ns=nav->nsmax=0;
+    free(nav->ephidx); nav->ephidx=NULL;
+    freechebf(nav);
+    free(nav->ion_bdsk9); nav->ion_bdsk9=NULL;
+    closenequick(nav);
 }
 /* average of single position ------------------------------------------------*/
 static int avepos(double *ra, int rcv, const obs_t *obs, const nav_t *nav,
@@ -973,50 +1932,60 @@ static int antpos(prcopt_t *opt, int rcvno, const obs_t *obs, const nav_t *nav,
         }
     }
     else if (postype==POSOPT_FILE) { /* read from position file */
-        name=stas[rcvno==1?0:1].name;
+        name=(char *)sta[rcvno==1?0:1].name;
         if (!getstapos(posfile,name,rr)) {
             showmsg("error : no position of %s in %s",name,posfile);
             return 0;
         }
     }
     else if (postype==POSOPT_RINEX) { /* get from rinex header */
-        if (norm(stas[rcvno==1?0:1].pos,3)<=0.0) {
+        if (norm(sta[rcvno==1?0:1].pos,3)<=0.0) {
             showmsg("error : no position in rinex header");
             trace(1,"no position position in rinex header\n");
             return 0;
         }
         /* antenna delta */
-        if (stas[rcvno==1?0:1].deltype==0) { /* enu */
-            for (i=0;i<3;i++) del[i]=stas[rcvno==1?0:1].del[i];
-            del[2]+=stas[rcvno==1?0:1].hgt;
-            ecef2pos(stas[rcvno==1?0:1].pos,pos);
+        if (sta[rcvno==1?0:1].deltype==0) { /* enu */
+            for (i=0;i<3;i++) del[i]=sta[rcvno==1?0:1].del[i];
+            del[2]+=sta[rcvno==1?0:1].hgt;
+            ecef2pos(sta[rcvno==1?0:1].pos,pos);
             enu2ecef(pos,del,dr);
         }
         else { /* xyz */
-            for (i=0;i<3;i++) dr[i]=stas[rcvno==1?0:1].del[i];
+            for (i=0;i<3;i++) dr[i]=sta[rcvno==1?0:1].del[i];
         }
-        for (i=0;i<3;i++) rr[i]=stas[rcvno==1?0:1].pos[i]+dr[i];
+        for (i=0;i<3;i++) rr[i]=sta[rcvno==1?0:1].pos[i]+dr[i];
     }
     return 1;
 }
+/* use L2 offset/variation for L5 if L5 ones do not exist --------------------*/
+static void setpcvl5(pcvs_t *pcvs)
+{
+    int i;
+    
+    for (i=0;i<pcvs->n;i++) {
+        if (norm(pcvs->pcv[i].off[2],3)>0.0) continue;
+        matcpy(pcvs->pcv[i].off[2],pcvs->pcv[i].off[1], 3,1);
+        matcpy(pcvs->pcv[i].var[2],pcvs->pcv[i].var[1],19,1);
+    }
+}
 /* open processing session ----------------------------------------------------
     pcvs ָϢ
     pcvr ָջϢ */
-static int openses(const prcopt_t *popt, const solopt_t *sopt,
+static int openses(postctx_t *ctx, const prcopt_t *popt, const solopt_t *sopt,
                    const filopt_t *fopt, nav_t *nav, pcvs_t *pcvs, pcvs_t *pcvr)
 {
-    int i;
     trace(3,"openses :\n");
     // ûϢҶȡҲȡͱlevel-1
     /* read satellite antenna parameters */
-    if (*fopt->satantp&&!(readpcv(fopt->satantp,pcvs))) 
+    if (!ctx->prod&&*fopt->satantp&&!(readpcv(fopt->satantp,pcvs))) 
     {
         showmsg("error : no sat ant pcv in %s",fopt->satantp);
         trace(1,"sat antenna pcv read error: %s\n",fopt->satantp);
         return 0;
     }
     /* read receiver antenna parameters */
-    if (*fopt->rcvantp&&!(readpcv(fopt->rcvantp,pcvr))) 
+    if (!ctx->prod&&*fopt->rcvantp&&!(readpcv(fopt->rcvantp,pcvr))) 
     {
         showmsg("error : no rec ant pcv in %s",fopt->rcvantp);
         trace(1,"rec antenna pcv read error: %s\n",fopt->rcvantp);
@@ -1031,25 +2000,18 @@ static int openses(const prcopt_t *popt, const solopt_t *sopt,
             showmsg("error : no geoid data %s",fopt->geoid);
             trace(2,"no geoid data %s\n",fopt->geoid);
         }
+        else ctx->opengeoid=1;
     }
 
 
     /* use satellite L2 offset if L5 offset does not exists */
-    for (i=0;i<pcvs->n;i++) {
-        if (norm(pcvs->pcv[i].off[2],3)>0.0) continue;
-        matcpy(pcvs->pcv[i].off[2],pcvs->pcv[i].off[1], 3,1);
-        matcpy(pcvs->pcv[i].var[2],pcvs->pcv[i].var[1],19,1);
-    }
-    for (i=0;i<pcvr->n;i++) {
-        if (norm(pcvr->pcv[i].off[2],3)>0.0) continue;
-        matcpy(pcvr->pcv[i].off[2],pcvr->pcv[i].off[1], 3,1);
-        matcpy(pcvr->pcv[i].var[2],pcvr->pcv[i].var[1],19,1);
-    }
+    setpcvl5(pcvs);
+    setpcvl5(pcvr);
     return 1;
 }
 /* close procssing session ---------------------------------------------------*/
 /*  */
-static void closeses(nav_t *nav, pcvs_t *pcvs, pcvs_t *pcvr)
+static void closeses(postctx_t *ctx, nav_t *nav, pcvs_t *pcvs, pcvs_t *pcvr)
 {
     trace(3,"closeses:\n");
     
@@ -1058,14 +2020,16 @@ static void closeses(nav_t *nav, pcvs_t *pcvs, pcvs_t *pcvr)
     free(pcvr->pcv); pcvr->pcv=NULL; pcvr->n=pcvr->nmax=0;
     
     /* close geoid data */
-    closegeoid();
+    if (ctx->opengeoid) closegeoid();
     
     /* free erp data */
     free(nav->erp.data); nav->erp.data=NULL; nav->erp.n=nav->erp.nmax=0;
     
-    /* close solution statistics and debug trace */
-    rtkclosestat();
-    traceclose();
+    /* close solution statistics and debug trace (process-wide, so only if
+       this session opened them) */
+    if (ctx->openstat) rtkclosestat();
+    if (ctx->opentrace) traceclose();
+    ctx->opengeoid=ctx->openstat=ctx->opentrace=0;
 }
 /* set antenna parameters ----------------------------------------------------*/
 static void setpcv(gtime_t time, prcopt_t *popt, nav_t *nav, const pcvs_t *pcvs,
@@ -1097,7 +2061,7 @@ static void setpcv(gtime_t time, prcopt_t *popt, nav_t *nav, const pcvs_t *pcvs,
                 }
             }
             else { /* enu */
-                for (j=0;j<3;j++) popt->antdel[i][j]=stas[i].del[j];
+                for (j=0;j<3;j++) popt->antdel[i][j]=sta[i].del[j];
             }
         }
         if (!(pcv=searchpcv(0,popt->anttype[i],time,pcvr))) {
@@ -1119,7 +2083,7 @@ static void readotl(prcopt_t *popt, const char *file, const sta_t *sta)
     }
 }
 /* write header to output file -----------------------------------------------*/
-static int outhead(const char *outfile, const char **infile, int n,
+static int outhead(postctx_t *ctx, const char *outfile, const char **infile, int n,
                    const prcopt_t *popt, const solopt_t *sopt)
 {
     FILE *fp=stdout;
@@ -1135,7 +2099,7 @@ static int outhead(const char *outfile, const char **infile, int n,
         }
     }
     /* output header */
-    outheader(fp,infile,n,popt,sopt);
+    outheader(ctx,fp,infile,n,popt,sopt);
     
     if (*outfile) fclose(fp);
     
@@ -1150,7 +2114,7 @@ static FILE *openfile(const char *outfile)
 }
 /* execute processing session ------------------------------------------------*/
 //̻Ự
-static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
+static int execses(postctx_t *ctx, gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
                    const solopt_t *sopt, const filopt_t *fopt, int flag,
     const char **infile, const int *index, int n, const char *outfile)
 {
@@ -1182,21 +2146,22 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
         traceclose();
         traceopen(tracefile);
         tracelevel(sopt->trace);
+        ctx->opentrace=1;
     }
     /* read ionosphere data file */
-	if (*fopt->iono && (ext = (char*)strrchr(fopt->iono, '.'))) 
+	if (!ctx->prod && *fopt->iono && (ext = (char*)strrchr(fopt->iono, '.'))) 
     {
         if (strlen(ext)==4&&(ext[3]=='i'||ext[3]=='I')) 
         {
             reppath(fopt->iono,path,ts,"","");
-            readtec(path,&navs,1);
+            readtec(path,&ctx->navs,1);
         }
     }
     /* read erp data */
-    if (*fopt->eop) {
-        free(navs.erp.data); navs.erp.data=NULL; navs.erp.n=navs.erp.nmax=0;
+    if (!ctx->prod && *fopt->eop) {
+        free(ctx->navs.erp.data); ctx->navs.erp.data=NULL; ctx->navs.erp.n=ctx->navs.erp.nmax=0;
         reppath(fopt->eop,path,ts,"","");
-        if (!readerp(path,&navs.erp)) {
+        if (!readerp(path,&ctx->navs.erp)) {
             showmsg("error : no erp data %s",path);
             trace(2,"no erp data %s\n",path);
         }
@@ -1204,33 +2169,36 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
     /* read obs and nav data */
     //ȡ۲ֵ
 	printf("processing : reading data... \n");
-	prgbar = 0;
-    if (!readobsnav(ts,te,ti,infile,index,n,&popt_,&obss,&navs,stas)) return 0;
-    
+	ctx->prgbar = 0;
+    if (!readobsnav(ctx,ts,te,ti,infile,index,n,&popt_,&ctx->obss,&ctx->navs,ctx->stas)) {
+        if (ctx->prod) detachprod(&ctx->navs);
+        return 0;
+    }
     /* read dcb parameters */
-    if (*fopt->dcb) {
+    if (!ctx->prod && *fopt->dcb) {
         reppath(fopt->dcb,path,ts,"","");
-        readdcb(path,&navs,stas);
+        readdcb(path,&ctx->navs,ctx->stas);
     }
     /* set antenna paramters */
     if (popt_.mode!=PMODE_SINGLE) {
-        setpcv(obss.n>0?obss.data[0].time:timeget(),&popt_,&navs,&pcvss,&pcvsr,
-               stas);
+        setpcv(ctx->obss.n>0?ctx->obss.data[0].time:timeget(),&popt_,&ctx->navs,
+               ctx->prod?&ctx->prod->pcvs:&ctx->pcvss,
+               ctx->prod?&ctx->prod->pcvr:&ctx->pcvsr,ctx->stas);
     }
     /* read ocean tide loading parameters */
     if (popt_.mode>PMODE_SINGLE&&*fopt->blq) {
-        readotl(&popt_,fopt->blq,stas);
+        readotl(&popt_,fopt->blq,ctx->stas);
     }
     /* rover/reference fixed position */
     if (popt_.mode==PMODE_FIXED) {
-        if (!antpos(&popt_,1,&obss,&navs,stas,fopt->stapos)) {
-            freeobsnav(&obss,&navs);
+        if (!antpos(&popt_,1,&ctx->obss,&ctx->navs,ctx->stas,fopt->stapos)) {
+            freeobsnav(ctx,&ctx->obss,&ctx->navs);
             return 0;
         }
     }
     else if (PMODE_DGPS<=popt_.mode&&popt_.mode<=PMODE_STATIC) {
-        if (!antpos(&popt_,2,&obss,&navs,stas,fopt->stapos)) {
-            freeobsnav(&obss,&navs);
+        if (!antpos(&popt_,2,&ctx->obss,&ctx->navs,ctx->stas,fopt->stapos)) {
+            freeobsnav(ctx,&ctx->obss,&ctx->navs);
             return 0;
         }
     }
@@ -1240,35 +2208,35 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
         strcpy(statfile,outfile);
         strcat(statfile,".stat");
         rtkclosestat();
-        rtkopenstat(statfile,sopt->sstat);
+        ctx->openstat=rtkopenstat(statfile,sopt->sstat);
     }
     /* write header to output file */
-    if (flag&&!outhead(outfile,infile,n,&popt_,sopt)) {
-        freeobsnav(&obss,&navs);
+    if (flag&&!outhead(ctx,outfile,infile,n,&popt_,sopt)) {
+        freeobsnav(ctx,&ctx->obss,&ctx->navs);
         return 0;
     }
-    iobsu=iobsr=isbs=ilex=revs=aborts=0;
-	strcpy(outsppfile, outfile);
+    ctx->iobsu=ctx->iobsr=ctx->isbs=ctx->ilex=ctx->revs=ctx->aborts=0;
+	strcpy(ctx->outsppfile, outfile);
 	/* sat position only */
 	if (popt_.outsat != 0)
 	{
-		strcpy(filestr, outsppfile);
+		strcpy(filestr, ctx->outsppfile);
 		fpout = fopen(filestr, "w");
 		fclose(fpout);
-		strcpy(filestr, outsppfile);
+		strcpy(filestr, ctx->outsppfile);
 		fpout = fopen(strcat(filestr, "psu_snr"), "w");
 		fclose(fpout);
 
 
-		strcpy(filestr, outsppfile);
-		strcpy(dopdatafile, outsppfile);
-		strcpy(figurefile, outsppfile);
+		strcpy(filestr, ctx->outsppfile);
+		strcpy(dopdatafile, ctx->outsppfile);
+		strcpy(figurefile, ctx->outsppfile);
 		strcat(dopdatafile, "psu_dop");
 		strcat(figurefile, "psu_dop.png");
 		fdop = fopen(strcat(filestr, "psu_dop"), "w");
 
 
-		strcpy(filestr, outsppfile);
+		strcpy(filestr, ctx->outsppfile);
 		fpres = fopen(strcat(filestr, "psu_res"), "w");
 		if (timediff(te, ts) == 0.0){ teph = timeget();}
 		else{ teph = te; }
@@ -1297,7 +2265,8 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
 			}
 			fprintf(fpres, "\n");
 			rs = mat(6, nobs); dts = mat(2, nobs); var = mat(1, nobs);
-			satposs(teph, obs, nobs, &navs, &popt_,popt_.sateph, rs, dts, var, svh);
+			satposs(teph, obs, nobs, &ctx->navs, &popt_,
+				ctx->navs.cheb ? EPHOPT_CHEB : popt_.sateph, rs, dts, var, svh);
 
 			time2str(teph, timestr, 3);
 			fprintf(fpres, "%23s ", timestr);
@@ -1367,58 +2336,58 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
         system(cmd_str);
 
 		fclose(fpres);
-		fclose(fdop);
 		free(rs); free(dts); free(var);
+		freeobsnav(ctx, &ctx->obss, &ctx->navs);
 		return 1;
 	}
 
     if (popt_.mode==PMODE_SINGLE||popt_.soltype==0) {
         if ((fp=openfile(outfile))) {
-            procpos(fp,&popt_,sopt,0); /* forward */
+            if (sppparallel(ctx,&popt_,sopt)) {
+                procspp(ctx,fp,&popt_,sopt); /* epoch-parallel */
+            }
+            else procpos(ctx,fp,&popt_,sopt,0); /* forward */
             fclose(fp);
         }
     }
     else if (popt_.soltype==1) {
         if ((fp=openfile(outfile))) {
-            revs=1; iobsu=iobsr=obss.n-1; isbs=sbss.n-1; ilex=lexs.n-1;
-            procpos(fp,&popt_,sopt,0); /* backward */
+            ctx->revs=1; ctx->iobsu=ctx->iobsr=ctx->obss.n-1; ctx->isbs=ctx->sbss.n-1; ctx->ilex=ctx->lexs.n-1;
+            procpos(ctx,fp,&popt_,sopt,0); /* backward */
             fclose(fp);
         }
     }
     else { /* combined */
-        solf=(sol_t *)malloc(sizeof(sol_t)*nepoch);
-        solb=(sol_t *)malloc(sizeof(sol_t)*nepoch);
-        rbf=(double *)malloc(sizeof(double)*nepoch*3);
-        rbb=(double *)malloc(sizeof(double)*nepoch*3);
+        ctx->solf=(sol_t *)malloc(sizeof(sol_t)*ctx->nepoch);
+        ctx->solb=(sol_t *)malloc(sizeof(sol_t)*ctx->nepoch);
+        ctx->rbf=(double *)malloc(sizeof(double)*ctx->nepoch*3);
+        ctx->rbb=(double *)malloc(sizeof(double)*ctx->nepoch*3);
         
-        if (solf&&solb) {
-            isolf=isolb=0;
-            procpos(NULL,&popt_,sopt,1); /* forward */
-            revs=1; iobsu=iobsr=obss.n-1; isbs=sbss.n-1; ilex=lexs.n-1;
-            procpos(NULL,&popt_,sopt,1); /* backward */
+        if (ctx->solf&&ctx->solb) {
+            procposcomb(ctx,&popt_,sopt); /* forward/backward */
             
             /* combine forward/backward solutions */
-            if (!aborts&&(fp=openfile(outfile))) {
-                combres(fp,&popt_,sopt);
+            if (!ctx->aborts&&(fp=openfile(outfile))) {
+                combres(ctx,fp,&popt_,sopt);
                 fclose(fp);
             }
         }
         else showmsg("error : memory allocation");
-        free(solf);
-        free(solb);
-        free(rbf);
-        free(rbb);
+        free(ctx->solf);
+        free(ctx->solb);
+        free(ctx->rbf);
+        free(ctx->rbb);
     }
     /* free obs and nav data */
-    freeobsnav(&obss,&navs);
+    freeobsnav(ctx,&ctx->obss,&ctx->navs);
     
     //return aborts?1:0;
-    return SolFlag;
+    return ctx->solflag;
 }
 /* execute processing session for each rover ---------------------------------
 * ΪÿվִдỰ߼execses_b
 */
-static int execses_r(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
+static int execses_r(postctx_t *ctx, gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
                      const solopt_t *sopt, const filopt_t *fopt, int flag,
                      const char **infile, const int *index, int n, const char *outfile,
                      const char *rov)
@@ -1447,9 +2416,9 @@ static int execses_r(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
             if ((q=strchr(p,' '))) *q='\0';
             
             if (*p) {
-                strcpy(proc_rov,p);
+                strcpy(ctx->proc_rov,p);
                 if (ts.time) time2str(ts,s,0); else *s='\0';
-                if (checkbrk("reading    : %s",s)) {
+                if (checkbrk(ctx,"reading    : %s",s)) {
                     stat=1;
                     break;
                 }
@@ -1459,7 +2428,7 @@ static int execses_r(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
                 /* execute processing session */
                 for (int i = 0; i < MAXINFILE; i++)local_ifile[i] = ifile[i];
                 local_ofile = ofile;
-                stat=execses(ts,te,ti,popt,sopt,fopt,flag, local_ifile,index,n, local_ofile);
+                stat=execses(ctx,ts,te,ti,popt,sopt,fopt,flag, local_ifile,index,n, local_ofile);
             }
             if (stat==1||!q) break;
         }
@@ -1467,12 +2436,12 @@ static int execses_r(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
     }
     else {
         /* execute processing session */
-        stat=execses(ts,te,ti,popt,sopt,fopt,flag,infile,index,n,outfile);
+        stat=execses(ctx,ts,te,ti,popt,sopt,fopt,flag,infile,index,n,outfile);
     }
     return stat;
 }
 /* execute processing session for each base station --------------------------*/
-static int execses_b(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
+static int execses_b(postctx_t *ctx, gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
                      const solopt_t *sopt, const filopt_t *fopt, int flag,
     const char **infile, const int *index, int n, const char *outfile,
                      const char *rov, const char *base)
@@ -1485,7 +2454,7 @@ static int execses_b(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
     trace(3,"execses_b: n=%d outfile=%s\n",n,outfile);
     
     /* read prec ephemeris and sbas data */
-   // readpreceph(infile,n,popt,&navs,&sbss,&lexs);
+   // readpreceph(ctx,infile,n,popt,&navs,&sbss,&lexs);
    // 
     // ļַдڡ%bbreak
     for (i=0;i<n;i++) if (strstr(infile[i],"%b")) break;
@@ -1496,7 +2465,7 @@ static int execses_b(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
         if (!(base_=(char *)malloc(strlen(base)+1))) 
         {
             //ڴǷ񲻹һЩļڴ
-            freepreceph(&navs,&sbss,&lexs);
+            freepreceph(ctx,&ctx->navs,&ctx->sbss,&ctx->lexs);
             return 0;
         }
         strcpy(base_,base);
@@ -1506,7 +2475,7 @@ static int execses_b(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
             {
                 //ڴǷ񲻹һЩļڴ棬ǰbase_ & ifile[]ļڴ
                 free(base_); for (;i>=0;i--) free(ifile[i]);
-                freepreceph(&navs,&sbss,&lexs);
+                freepreceph(ctx,&ctx->navs,&ctx->sbss,&ctx->lexs);
                 return 0;
             }
         }
@@ -1517,10 +2486,10 @@ static int execses_b(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
             if (*p) 
             {
                 //*pҲbase_Ϊգִݣ
-                strcpy(proc_base,p);
+                strcpy(ctx->proc_base,p);
                 //ts.timeй۲ֵתΪstringssΪ
                 if (ts.time) time2str(ts,s,0); else *s='\0';
-                if (checkbrk("reading    : %s",s)) //sΪ
+                if (checkbrk(ctx,"reading    : %s",s)) //sΪ
                 {
                     stat=1;
                     break;
@@ -1529,23 +2498,119 @@ static int execses_b(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
                 reppath(outfile,ofile,t0,"",p);
                 for (int i = 0; i < MAXINFILE; i++)local_ifile[i] = ifile[i];
                 local_ofile = ofile;
-                stat = execses_r(ts, te, ti, popt, sopt, fopt, flag, local_ifile, index, n, local_ofile, rov);
+                stat = execses_r(ctx, ts, te, ti, popt, sopt, fopt, flag, local_ifile, index, n, local_ofile, rov);
             }
             if (stat==1||!q) break;
         }
         free(base_); for (i=0;i<n;i++) free(ifile[i]);
     }
     else {
-        stat=execses_r(ts,te,ti,popt,sopt,fopt,flag,infile,index,n,outfile,rov);
+        stat=execses_r(ctx,ts,te,ti,popt,sopt,fopt,flag,infile,index,n,outfile,rov);
     }
     /* free prec ephemeris and sbas data */
-    freepreceph(&navs,&sbss,&lexs);
+    freepreceph(ctx,&ctx->navs,&ctx->sbss,&ctx->lexs);
     
     return stat;
 }
+/* read/free shared processing products ---------------------------------------
+* read navigation products once for several processing sessions
+* args   : postprod_t *prod IO  shared products
+*          char   **infile  I   navigation/product files (rinex nav/clock,
+*                               sp3 and ionex, see postpos_ctx())
+*          int    n         I   number of files
+*          prcopt_t *popt   I   processing options
+*          filopt_t *fopt   I   file options (iono, eop, dcb, antenna pcv)
+* return : status (1:ok,0:error)
+* notes  : set ctx->prod to the products before postpos_ctx(). the session
+*          then reads only its own observation files and the products are
+*          used read-only, so any number of sessions can share them.
+*-----------------------------------------------------------------------------*/
+extern int readpostprod(postprod_t *prod, const char **infile, int n,
+                        const prcopt_t *popt, const filopt_t *fopt)
+{
+    nav_t *nav=&prod->nav;
+    gtime_t t0={0};
+    double ep[6]={0};
+    char path[1024];
+    const char *ext;
+    int i;
+    
+    trace(3,"readpostprod: n=%d\n",n);
+    
+    init_nav(nav);
+    memset(&prod->pcvs,0,sizeof(pcvs_t));
+    memset(&prod->pcvr,0,sizeof(pcvs_t));
+    nav->galfreq=popt->freqopt;
+    
+    for (i=0;i<n;i++) {
+        if (ischeb(infile[i])) {
+            readchebf(infile[i],nav);
+            continue;
+        }
+        if (readrnxt(infile[i],0,t0,t0,0.0,popt->rnxopt[0],NULL,nav,NULL)<0) {
+            showmsg("error : insufficient memory");
+            return 0;
+        }
+        readsp3(infile[i],nav,0);
+        readrnxc(infile[i],nav);
+    }
+    if (nav->n<=0&&nav->ng<=0&&nav->ns<=0&&!nav->cheb) {
+        showmsg("error : no nav data");
+        return 0;
+    }
+    uniqnav(nav);
+    uniqion(ep,nav->ion_bdsk9);
+    
+    if (*fopt->iono&&(ext=strrchr(fopt->iono,'.'))&&strlen(ext)==4&&
+        (ext[3]=='i'||ext[3]=='I')) {
+        reppath(fopt->iono,path,t0,"","");
+        readtec(path,nav,1);
+    }
+    if (*fopt->eop) {
+        reppath(fopt->eop,path,t0,"","");
+        if (!readerp(path,&nav->erp)) {
+            showmsg("error : no erp data %s",path);
+        }
+    }
+    if (*fopt->dcb) {
+        reppath(fopt->dcb,path,t0,"","");
+        readdcb(path,nav,NULL);
+    }
+    if (*fopt->satantp&&!readpcv(fopt->satantp,&prod->pcvs)) {
+        showmsg("error : no sat ant pcv in %s",fopt->satantp);
+        return 0;
+    }
+    if (*fopt->rcvantp&&!readpcv(fopt->rcvantp,&prod->pcvr)) {
+        showmsg("error : no rec ant pcv in %s",fopt->rcvantp);
+        return 0;
+    }
+    setpcvl5(&prod->pcvs);
+    setpcvl5(&prod->pcvr);
+    return 1;
+}
+extern void freepostprod(postprod_t *prod)
+{
+    nav_t *nav=&prod->nav;
+    int i;
+    
+    trace(3,"freepostprod:\n");
+    
+    for (i=0;i<nav->nt;i++) {
+        free(nav->tec[i].data);
+        free(nav->tec[i].rms );
+    }
+    free(nav->eph ); free(nav->geph); free(nav->seph); free(nav->peph);
+    free(nav->pclk); free(nav->alm ); free(nav->tec ); free(nav->fcb );
+    free(nav->ephidx);
+    freechebf(nav);
+    free(nav->erp.data); free(nav->ion_bdsk9);
+    free(prod->pcvs.pcv); free(prod->pcvr.pcv);
+    memset(prod,0,sizeof(postprod_t));
+}
 /* post-processing positioning -------------------------------------------------
 * post-processing positioning
-* args   : gtime_t ts       I   processing start time (ts.time==0: no limit)
+* args   : postctx_t *ctx   IO  processing session (see init_postctx())
+*          gtime_t ts       I   processing start time (ts.time==0: no limit)
 *        : gtime_t te       I   processing end time   (te.time==0: no limit)
 *          double ti        I   processing interval  /ʱ (s) (0:all)
 *          double tu        I   processing unit time /λʱ (s) (0:all)
@@ -1572,6 +2637,7 @@ static int execses_b(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
 *              .rtcm3,.RTCM3        : ssr message log files (rtcm3)
 *              .*i,.*I              : tec grid files (ionex)
 *              .fcb,.FCB            : satellite fcb
+*              .cheb,.CHEB          : chebyshev orbit/clock (writecheb())
 *              others               : rinex obs, nav, gnav, hnav, qnav or clock
 *
 *          inputs files can include wild-cards (*). if an file includes
@@ -1587,14 +2653,20 @@ static int execses_b(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
 *          are output to a single output file.
 *
 *          ssr corrections are valid only for forward estimation.
+*
+*          all of the session state lives in ctx, so several sessions can run
+*          concurrently on different threads. the debug trace, the solution
+*          status file and the external geoid are process-wide, so concurrent
+*          sessions should run with sopt->trace<0, sopt->sstat=0 and the
+*          embedded geoid.
 *-----------------------------------------------------------------------------*/
 /*  **infile߼
 *   óʹchar *infile[16]洢ļַÿһinfile[x]һļַָ
 *   *infile[x]ļַһַ硰D:\AAA-Study\SPP-PPP\LXZ-rtklib\data\AC230650.25O
 *   **infile[x]õַµļʵоΪOļ
 */
-extern int postpos(gtime_t ts, gtime_t te, double ti, double tu,
-    const prcopt_t* popt, const solopt_t* sopt,
+extern int postpos_ctx(postctx_t *ctx, gtime_t ts, gtime_t te, double ti,
+    double tu, const prcopt_t* popt, const solopt_t* sopt,
     const filopt_t* fopt, const char** infile, int n, const char* outfile,
     const char* rov, const char* base)
 {
@@ -1609,7 +2681,7 @@ extern int postpos(gtime_t ts, gtime_t te, double ti, double tu,
 
     /* open processing session */
     //ȡߵϢûϢǷ0
-    if (!openses(popt, sopt, fopt, &navs, &pcvss, &pcvsr)) return -1;
+    if (!openses(ctx, popt, sopt, fopt, &ctx->navs, &ctx->pcvss, &ctx->pcvsr)) return -1;
 
     //ʼʱڣҵλʱڣ
     if (ts.time != 0 && te.time != 0 && tu >= 0.0)
@@ -1617,14 +2689,14 @@ extern int postpos(gtime_t ts, gtime_t te, double ti, double tu,
         if (timediff(te, ts) < 0.0)
         {
             showmsg("error : no period");
-            closeses(&navs, &pcvss, &pcvsr);  //رնԻͷڴ
+            closeses(ctx, &ctx->navs, &ctx->pcvss, &ctx->pcvsr);  //رնԻͷڴ
             return 0;
         }
         for (i = 0; i < MAXINFILE; i++)
         {
             if (!(ifile[i] = (char*)malloc(1024))) {
                 for (; i >= 0; i--) free(ifile[i]);
-                closeses(&navs, &pcvss, &pcvsr);
+                closeses(ctx, &ctx->navs, &ctx->pcvss, &ctx->pcvsr);
                 return -1;
             }
         }
@@ -1641,9 +2713,9 @@ extern int postpos(gtime_t ts, gtime_t te, double ti, double tu,
             if (timediff(tts, ts) < 0.0) tts = ts;
             if (timediff(tte, te) > 0.0) tte = te;
 
-            strcpy(proc_rov, "");
-            strcpy(proc_base, "");
-            if (checkbrk("reading    : %s", time_str(tts, 0))) {
+            strcpy(ctx->proc_rov, "");
+            strcpy(ctx->proc_base, "");
+            if (checkbrk(ctx,"reading    : %s", time_str(tts, 0))) {
                 stat = 1;
                 break;
             }
@@ -1678,7 +2750,7 @@ extern int postpos(gtime_t ts, gtime_t te, double ti, double tu,
             /* execute processing session */
             for (int i = 0; i < MAXINFILE; i++)local_ifile[i] = ifile[i];
             local_ofile = ofile;
-            stat = execses_b(tts, tte, ti, popt, sopt, fopt, flag, local_ifile, index, nf, local_ofile,
+            stat = execses_b(ctx, tts, tte, ti, popt, sopt, fopt, flag, local_ifile, index, nf, local_ofile,
                 rov, base);
 
             if (stat == 1) break;
@@ -1699,7 +2771,7 @@ extern int postpos(gtime_t ts, gtime_t te, double ti, double tu,
         /* execute processing session */
         for (int i = 0; i < MAXINFILE; i++)local_ifile[i] = ifile[i];
         local_ofile = ofile;
-        stat = execses_b(tts, tte, ti, popt, sopt, fopt, flag, local_ifile, index, nf, local_ofile,
+        stat = execses_b(ctx, tts, tte, ti, popt, sopt, fopt, flag, local_ifile, index, nf, local_ofile,
             rov, base);
 
         for (i = 0; i < n && i < MAXINFILE; i++) free(ifile[i]);
@@ -1709,11 +2781,34 @@ extern int postpos(gtime_t ts, gtime_t te, double ti, double tu,
 
         /* execute processing session */
         if (popt->mode == PMODE_SINGLE)
-            stat = execses(ts, te, ti, popt, sopt, fopt, 1, infile, index, n, outfile);
+            stat = execses(ctx, ts, te, ti, popt, sopt, fopt, 1, infile, index, n, outfile);
         else
-            stat = execses_b(ts, te, ti, popt, sopt, fopt, 1, infile, index, n, outfile, rov, base);
+            stat = execses_b(ctx, ts, te, ti, popt, sopt, fopt, 1, infile, index, n, outfile, rov, base);
     }
     /* close processing session */
-    closeses(&navs, &pcvss, &pcvsr);
+    closeses(ctx, &ctx->navs, &ctx->pcvss, &ctx->pcvsr);
+    return stat;
+}
+/* post-processing positioning with a private session --------------------------
+* post-processing positioning. same as postpos_ctx() with a session allocated
+* for the call.
+*-----------------------------------------------------------------------------*/
+extern int postpos(gtime_t ts, gtime_t te, double ti, double tu,
+    const prcopt_t* popt, const solopt_t* sopt,
+    const filopt_t* fopt, const char** infile, int n, const char* outfile,
+    const char* rov, const char* base)
+{
+    postctx_t *ctx;
+    int stat;
+
+    if (!(ctx = (postctx_t*)malloc(sizeof(postctx_t)))) {
+        showmsg("error : memory allocation");
+        return -1;
+    }
+    init_postctx(ctx);
+    stat = postpos_ctx(ctx, ts, te, ti, tu, popt, sopt, fopt, infile, n, outfile,
+        rov, base);
+    free_postctx(ctx);
+    free(ctx);
     return stat;
 }
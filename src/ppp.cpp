@@ -851,8 +851,8 @@ static int model_iono(gtime_t time, const double *pos, const double *azel,
                       const prcopt_t *opt, int sat, const double *x,
                       const nav_t *nav, double *dion, double *var)
 {
-    static double iono_p[MAXSAT]={0},std_p[MAXSAT]={0};
-    static gtime_t time_p;
+    static thread_local double iono_p[MAXSAT]={0},std_p[MAXSAT]={0};
+    static thread_local gtime_t time_p;
     
     if (opt->ionoopt==IONOOPT_SBAS) {
         return sbsioncorr(time,nav,pos,azel,dion,var);
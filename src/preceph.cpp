@@ -41,6 +41,13 @@
 *           2015/05/10 1.15 add api readfcb()
 *                           modify api readdcb()
 *           2017/04/11 1.16 fix bug on antenna offset correction in peph2pos()
+*           2025/07/06 1.17 read compressed sp3 files (.gz,.Z) in memory
+*           2025/07/08 1.18 read sp3 files through binary cache
+*           2025/07/30 1.19 interpolate precise orbit by barycentric weights
+*                           search nodes of precise ephemeris/clock by hint
+*                           add api peph2pos_batch()
+*           2025/08/04 1.20 share nodes and weights of the batch in
+*                           peph2pos_batch()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -121,7 +128,7 @@ static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
 {
     peph_t peph;
     gtime_t time;
-    double val,std,base;
+    double val,std,base,vals[4];
     int i,j,sat,sys,prn,n=ns*(type=='P'?1:2),pred_o,pred_c,v;
     char buff[1024];
     
@@ -166,6 +173,8 @@ static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
                 pred_c=strlen(buff)>=76&&buff[75]=='P';
                 pred_o=strlen(buff)>=80&&buff[79]=='P';
             }
+            str2nums(buff,4,14,4,vals);
+            
             for (j=0;j<4;j++) {
                 
                 /* read option for predicted value */
@@ -174,7 +183,7 @@ static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
                 if (j==3&&(opt&1)&& pred_c) continue;
                 if (j==3&&(opt&2)&&!pred_c) continue;
                 
-                val=str2num(buff, 4+j*14,14);
+                val=vals[j];
                 std=str2num(buff,61+j* 3,j<3?2:3);
                 
                 if (buff[0]=='P') { /* position */
@@ -237,6 +246,58 @@ static void combpeph(nav_t *nav, int opt)
     
     trace(4,"combpeph: ne=%d\n",nav->ne);
 }
+/* read sp3 body through binary cache ----------------------------------------*/
+static int readsp3cache(const char *file, int index, int opt, nav_t *nav)
+{
+    FILE *fp;
+    uncfile_t unc;
+    cache_t cache;
+    cacheblk_t blk;
+    peph_t *nav_peph;
+    gtime_t time={0};
+    const void *p;
+    double bfact[2]={0};
+    size_t size;
+    int ne=nav->ne,n,ns,sats[MAXSAT]={0};
+    char key[64],type=' ',tsys[4]="";
+    
+    sprintf(key,"sp3 index=%d opt=%d",index,opt);
+    
+    if (opencache(&cache,file,key)) {
+        if ((p=getcacheblk(cache.blk,cache.n,1,&size))&&
+            (n=(int)(size/sizeof(peph_t)))>0) {
+            if (nav->ne+n>nav->nemax) {
+                if (!(nav_peph=(peph_t *)realloc(nav->peph,
+                                                 sizeof(peph_t)*(nav->ne+n)))) {
+                    trace(1,"readsp3cache malloc error n=%d\n",nav->ne+n);
+                    free(nav->peph); nav->peph=NULL; nav->ne=nav->nemax=0;
+                    closecache(&cache);
+                    return 0;
+                }
+                nav->peph=nav_peph; nav->nemax=nav->ne+n;
+            }
+            memcpy(nav->peph+nav->ne,p,size);
+            nav->ne+=n;
+        }
+        closecache(&cache);
+        return 1;
+    }
+    if (!(fp=open_uncfile(&unc,file,0))) {
+        trace(2,"sp3 file open error %s\n",file);
+        return 0;
+    }
+    ns=readsp3h(fp,&time,&type,sats,bfact,tsys);
+    readsp3b(fp,type,sats,ns,bfact,tsys,index,opt,nav);
+    close_uncfile(&unc);
+    
+    /* ephemeris appended by the file */
+    if (nav->ne<ne) return 1;
+    blk.id=1;
+    blk.data=nav->peph+ne;
+    blk.size=sizeof(peph_t)*(nav->ne-ne);
+    writecache(file,key,&blk,1);
+    return 1;
+}
 /* read sp3 precise ephemeris file ---------------------------------------------
 * read sp3 precise ephemeris/clock files and set them to navigation data
 * args   : char   *file       I   sp3-c precise ephemeris file
@@ -250,14 +311,17 @@ static void combpeph(nav_t *nav, int opt)
 *          nav->peph and nav->ne must by properly initialized before calling the
 *          function
 *          only files with extensions of .sp3, .SP3, .eph* and .EPH* are read
+*          the files may be compressed by gzip or compress (.gz,.GZ,.Z,.z)
+*          with setrdcache(1), the files are read through binary cache files
 *-----------------------------------------------------------------------------*/
 extern void readsp3(const char *file, nav_t *nav, int opt)
 {
     FILE *fp;
+    uncfile_t unc;
     gtime_t time={0};
     double bfact[2]={0};
     int i,j,n,ns,sats[MAXSAT]={0};
-    char *efiles[MAXEXFILE],*ext,type=' ',tsys[4]="";
+    char *efiles[MAXEXFILE],*ext,type=' ',tsys[4]="",path[1024];
     
     trace(3,"readpephs: file=%s\n",file);
     
@@ -271,12 +335,21 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
     n=expath(file,efiles,MAXEXFILE);
     
     for (i=j=0;i<n;i++) {
-        if (!(ext=strrchr(efiles[i],'.'))) continue;
         
-        if (!strstr(ext+1,"sp3")&&!strstr(ext+1,".SP3")&&
-            !strstr(ext+1,"eph")&&!strstr(ext+1,".EPH")) continue;
+        /* extension except for compression */
+        sprintf(path,"%.1023s",efiles[i]);
+        if ((ext=strrchr(path,'.'))&&(!strcmp(ext,".gz")||!strcmp(ext,".GZ")||
+            !strcmp(ext,".Z")||!strcmp(ext,".z"))) *ext='\0';
+        if (!(ext=strrchr(path,'.'))) continue;
+        
+        if (!strstr(ext+1,"sp3")&&!strstr(ext+1,"SP3")&&
+            !strstr(ext+1,"eph")&&!strstr(ext+1,"EPH")) continue;
         
-        if (!(fp=fopen(efiles[i],"r"))) {
+        if (getrdcache()) {
+            if (readsp3cache(efiles[i],j,opt,nav)) j++;
+            continue;
+        }
+        if (!(fp=open_uncfile(&unc,efiles[i],0))) {
             trace(2,"sp3 file open error %s\n",efiles[i]);
             continue;
         }
@@ -286,7 +359,7 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
         /* read sp3 body */
         readsp3b(fp,type,sats,ns,bfact,tsys,j++,opt,nav);
         
-        fclose(fp);
+        close_uncfile(&unc);
     }
     for (i=0;i<MAXEXFILE;i++) free(efiles[i]);
     
@@ -494,69 +567,122 @@ extern int readfcb(const char *file, nav_t *nav)
     }
     return 1;
 }
-/* polynomial interpolation by Neville's algorithm ---------------------------*/
-static double interppol(const double *x, double *y, int n)
+/* precise orbit interpolation weights ---------------------------------------*/
+typedef struct {        /* precise orbit interpolation weights type */
+    gtime_t time[NMAX+1]; /* time of nodes */
+    double w[NMAX+1];   /* barycentric weights of nodes */
+    double sina[NMAX+1],cosa[NMAX+1]; /* sin/cos of earth rotation from node 0 */
+} pephw_t;
+
+static thread_local int pephhint=0,pclkhint=0; /* last bracketing indices */
+static thread_local pephw_t pephwc[2];  /* last interpolation weights */
+
+/* search bracketing index of time ---------------------------------------------
+* search index of the last node before time in nodes sorted by time. the
+* hint (the index of the last search) is tested before the binary search.
+* args   : gtime_t time     I   time
+*          void   *data     I   nodes (gtime_t as first member)
+*          size_t size      I   size of node
+*          int    n         I   number of nodes (n>=2)
+*          int    *hint     IO  index of first node at or after time
+* return : index of the node (0<=index<=n-2)
+*-----------------------------------------------------------------------------*/
+static int searchnode(gtime_t time, const void *data, size_t size, int n,
+                      int *hint)
 {
-    int i,j;
+    const char *p=(const char *)data;
+    int i=*hint,j,k;
     
-    for (j=1;j<n;j++) {
-        for (i=0;i<n-j;i++) {
-            y[i]=(x[i+j]*y[i]-x[i]*y[i+1])/(x[i+j]-x[i]);
+#define NODETIME(k) (*(const gtime_t *)(p+size*(k)))
+    
+    if (i<0||i>=n||(i>0&&timediff(NODETIME(i-1),time)>=0.0)||
+        (i<n-1&&timediff(NODETIME(i),time)<0.0)) {
+        for (i=0,j=n-1;i<j;) {
+            k=(i+j)/2;
+            if (timediff(NODETIME(k),time)<0.0) i=k+1; else j=k;
         }
     }
-    return y[0];
+#undef NODETIME
+    *hint=i;
+    return i<=0?0:i-1;
 }
-/* satellite position by precise ephemeris -----------------------------------*/
-static int pephpos(gtime_t time, int sat, const nav_t *nav, double *rs,
-                   double *dts, double *vare, double *varc)
+/* barycentric weights of nodes for polynomial interpolation -----------------
+* the weights depend only on the node times. the last two sets (nodes of time
+* and time+tt in peph2pos()) are kept and shared by the satellites.
+*-----------------------------------------------------------------------------*/
+static const pephw_t *pephweight(const nav_t *nav, int i)
 {
-    double t[NMAX+1],p[3][NMAX+1],c[2],*pos,std=0.0,s[3],sinl,cosl;
-    int i,j,k,index;
-    
-    trace(4,"pephpos : time=%s sat=%2d\n",time_str(time,3),sat);
-    
-    rs[0]=rs[1]=rs[2]=dts[0]=0.0;
+    pephw_t *pw;
+    double t[NMAX+1],prod;
+    int j,k;
+    
+    for (k=0;k<2;k++) {
+        pw=pephwc+k;
+        for (j=0;j<=NMAX;j++) {
+            if (pw->time[j].time!=nav->peph[i+j].time.time||
+                pw->time[j].sec !=nav->peph[i+j].time.sec) break;
+        }
+        if (j>NMAX) return pw;
+    }
+    pephwc[1]=pephwc[0];
+    pw=pephwc;
     
-    if (nav->ne<NMAX+1||
-        timediff(time,nav->peph[0].time)<-MAXDTE||
-        timediff(time,nav->peph[nav->ne-1].time)>MAXDTE) {
-        trace(3,"no prec ephem %s sat=%2d\n",time_str(time,0),sat);
-        return 0;
+    for (j=0;j<=NMAX;j++) {
+        pw->time[j]=nav->peph[i+j].time;
+        t[j]=timediff(nav->peph[i+j].time,nav->peph[i].time);
+        pw->sina[j]=sin(OMGE*t[j]);
+        pw->cosa[j]=cos(OMGE*t[j]);
     }
-    /* binary search */
-    for (i=0,j=nav->ne-1;i<j;) {
-        k=(i+j)/2;
-        if (timediff(nav->peph[k].time,time)<0.0) i=k+1; else j=k;
+    for (j=0;j<=NMAX;j++) {
+        for (k=0,prod=1.0;k<=NMAX;k++) {
+            if (k!=j) prod*=t[j]-t[k];
+        }
+        pw->w[j]=1.0/prod;
     }
-    index=i<=0?0:i-1;
+    return pw;
+}
+/* satellite position by precise ephemeris with interpolation weights --------*/
+static int pephposw(gtime_t time, int sat, const nav_t *nav, int index, int i0,
+                    const pephw_t *pw, double *rs, double *dts, double *vare,
+                    double *varc)
+{
+    double t[NMAX+1],l[NMAX+1],p[3][NMAX+1],c[2],*pos,std=0.0,s[3],sinl,cosl;
+    double sinb,cosb,prod;
+    int i,j;
     
-    /* polynomial interpolation for orbit */
-    i=index-(NMAX+1)/2;
-    if (i<0) i=0; else if (i+NMAX>=nav->ne) i=nav->ne-NMAX-1;
+    rs[0]=rs[1]=rs[2]=dts[0]=0.0;
     
     for (j=0;j<=NMAX;j++) {
-        t[j]=timediff(nav->peph[i+j].time,time);
-        if (norm(nav->peph[i+j].pos[sat-1],3)<=0.0) {
+        t[j]=timediff(nav->peph[i0+j].time,time);
+        if (norm(nav->peph[i0+j].pos[sat-1],3)<=0.0) {
             trace(3,"prec ephem outage %s sat=%2d\n",time_str(time,0),sat);
             return 0;
         }
     }
+    /* correciton for earh rotation ver.2.4.0 by rotation from node 0 */
+    sinb=sin(OMGE*t[0]);
+    cosb=cos(OMGE*t[0]);
     for (j=0;j<=NMAX;j++) {
-        pos=nav->peph[i+j].pos[sat-1];
-#if 0
-        p[0][j]=pos[0];
-        p[1][j]=pos[1];
-#else
-        /* correciton for earh rotation ver.2.4.0 */
-        sinl=sin(OMGE*t[j]);
-        cosl=cos(OMGE*t[j]);
+        pos=nav->peph[i0+j].pos[sat-1];
+        sinl=pw->sina[j]*cosb+pw->cosa[j]*sinb;
+        cosl=pw->cosa[j]*cosb-pw->sina[j]*sinb;
         p[0][j]=cosl*pos[0]-sinl*pos[1];
         p[1][j]=sinl*pos[0]+cosl*pos[1];
-#endif
         p[2][j]=pos[2];
     }
-    for (i=0;i<3;i++) {
-        rs[i]=interppol(t,p[i],NMAX+1);
+    /* polynomial interpolation for orbit by barycentric formula (1st form) */
+    for (j=0,prod=1.0;j<=NMAX;j++) prod*=-t[j];
+    for (j=0;j<=NMAX;j++) if (t[j]==0.0) break;
+    if (j<=NMAX) {
+        for (i=0;i<3;i++) rs[i]=p[i][j];
+    }
+    else {
+        for (j=0;j<=NMAX;j++) l[j]=prod*pw->w[j]/-t[j];
+        for (j=0;j<=NMAX;j++) {
+            rs[0]+=l[j]*p[0][j];
+            rs[1]+=l[j]*p[1][j];
+            rs[2]+=l[j]*p[2][j];
+        }
     }
     if (vare) {
         for (i=0;i<3;i++) s[i]=nav->peph[index].std[sat-1][i];
@@ -594,14 +720,69 @@ static int pephpos(gtime_t time, int sat, const nav_t *nav, double *rs,
     if (varc) *varc=SQR(std);
     return 1;
 }
+/* bracketing index and first node of precise ephemeris ----------------------*/
+static int pephnode(gtime_t time, const nav_t *nav, int *index)
+{
+    int i;
+    
+    if (nav->ne<NMAX+1||
+        timediff(time,nav->peph[0].time)<-MAXDTE||
+        timediff(time,nav->peph[nav->ne-1].time)>MAXDTE) {
+        return -1;
+    }
+    *index=searchnode(time,nav->peph,sizeof(peph_t),nav->ne,&pephhint);
+    
+    i=*index-(NMAX+1)/2;
+    if (i<0) i=0; else if (i+NMAX>=nav->ne) i=nav->ne-NMAX-1;
+    return i;
+}
+/* satellite position by precise ephemeris -----------------------------------*/
+static int pephpos(gtime_t time, int sat, const nav_t *nav, double *rs,
+                   double *dts, double *vare, double *varc)
+{
+    int i,index;
+    
+    //trace(4,"pephpos : time=%s sat=%2d\n",time_str(time,3),sat);
+    
+    if ((i=pephnode(time,nav,&index))<0) {
+        rs[0]=rs[1]=rs[2]=dts[0]=0.0;
+        trace(3,"no prec ephem %s sat=%2d\n",time_str(time,0),sat);
+        return 0;
+    }
+    return pephposw(time,sat,nav,index,i,pephweight(nav,i),rs,dts,vare,varc);
+}
+/* precise ephemeris node shared by batch -------------------------------------
+* the bracketing index, first node and weights are kept while the times of
+* the batch are in the same interval of the nodes (peph[index],peph[index+1]]
+*-----------------------------------------------------------------------------*/
+typedef struct {        /* precise ephemeris node of batch type */
+    int index,i0;       /* bracketing index and first node (index<0: not set) */
+    pephw_t w;          /* interpolation weights */
+} pephn_t;
+
+static int pephposn(gtime_t time, int sat, const nav_t *nav, pephn_t *nd,
+                    double *rs, double *dts, double *vare, double *varc)
+{
+    if (nd->index<0||timediff(time,nav->peph[nd->index  ].time)<=0.0||
+                     timediff(time,nav->peph[nd->index+1].time)> 0.0) {
+        if ((nd->i0=pephnode(time,nav,&nd->index))<0) {
+            nd->index=-1;
+            rs[0]=rs[1]=rs[2]=dts[0]=0.0;
+            trace(3,"no prec ephem %s sat=%2d\n",time_str(time,0),sat);
+            return 0;
+        }
+        nd->w=*pephweight(nav,nd->i0);
+    }
+    return pephposw(time,sat,nav,nd->index,nd->i0,&nd->w,rs,dts,vare,varc);
+}
 /* satellite clock by precise clock ------------------------------------------*/
 static int pephclk(gtime_t time, int sat, const nav_t *nav, double *dts,
                    double *varc)
 {
     double t[2],c[2],std;
-    int i,j,k,index;
+    int i,index;
     
-    trace(4,"pephclk : time=%s sat=%2d\n",time_str(time,3),sat);
+    //trace(4,"pephclk : time=%s sat=%2d\n",time_str(time,3),sat);
     
     if (nav->nc<2||
         timediff(time,nav->pclk[0].time)<-MAXDTE||
@@ -609,12 +790,7 @@ static int pephclk(gtime_t time, int sat, const nav_t *nav, double *dts,
         trace(3,"no prec clock %s sat=%2d\n",time_str(time,0),sat);
         return 1;
     }
-    /* binary search */
-    for (i=0,j=nav->nc-1;i<j;) {
-        k=(i+j)/2;
-        if (timediff(nav->pclk[k].time,time)<0.0) i=k+1; else j=k;
-    }
-    index=i<=0?0:i-1;
+    index=searchnode(time,nav->pclk,sizeof(pclk_t),nav->nc,&pclkhint);
     
     /* linear interpolation for clock */
     t[0]=timediff(time,nav->pclk[index  ].time);
@@ -691,41 +867,24 @@ extern void satantoff(gtime_t time, const double *rs, int sat, const nav_t *nav,
         dant[i]=C1*dant1+C2*dant2;
     }
 }
-/* satellite position/clock by precise ephemeris/clock -------------------------
-* compute satellite position/clock with precise ephemeris/clock
-* args   : gtime_t time       I   time (gpst)
-*          int    sat         I   satellite number
-*          nav_t  *nav        I   navigation data
-*          int    opt         I   sat postion option
-*                                 (0: center of mass, 1: antenna phase center)
-*          double *rs         O   sat position and velocity (ecef)
-*                                 {x,y,z,vx,vy,vz} (m|m/s)
-*          double *dts        O   sat clock {bias,drift} (s|s/s)
-*          double *var        IO  sat position and clock error variance (m)
-*                                 (NULL: no output)
-* return : status (1:ok,0:error or data outage)
-* notes  : clock includes relativistic correction but does not contain code bias
-*          before calling the function, nav->peph, nav->ne, nav->pclk and
-*          nav->nc must be set by calling readsp3(), readrnx() or readrnxt()
-*          if precise clocks are not set, clocks in sp3 are used instead
-*-----------------------------------------------------------------------------*/
-extern int peph2pos(gtime_t time, int sat, const nav_t *nav, int opt,
-                    double *rs, double *dts, double *var)
+/* satellite position/clock by precise ephemeris/clock with batch nodes ----*/
+static int peph2posn(gtime_t time, int sat, const nav_t *nav, int opt,
+                     pephn_t *nd, double *rs, double *dts, double *var)
 {
     gtime_t time_tt;
     double rss[3],rst[3],dtss[1],dtst[1],dant[3]={0},vare=0.0,varc=0.0,tt=1E-3;
     int i;
     
-    trace(4,"peph2pos: time=%s sat=%2d opt=%d\n",time_str(time,3),sat,opt);
-    
     if (sat<=0||MAXSAT<sat) return 0;
     
     /* satellite position and clock bias */
-    if (!pephpos(time,sat,nav,rss,dtss,&vare,&varc)||
+    if (!(nd?pephposn(time,sat,nav,nd,rss,dtss,&vare,&varc):
+             pephpos(time,sat,nav,rss,dtss,&vare,&varc))||
         !pephclk(time,sat,nav,dtss,&varc)) return 0;
     
     time_tt=timeadd(time,tt);
-    if (!pephpos(time_tt,sat,nav,rst,dtst,NULL,NULL)||
+    if (!(nd?pephposn(time_tt,sat,nav,nd+1,rst,dtst,NULL,NULL):
+             pephpos(time_tt,sat,nav,rst,dtst,NULL,NULL))||
         !pephclk(time_tt,sat,nav,dtst,NULL)) return 0;
     
     /* satellite antenna offset correction */
@@ -748,3 +907,64 @@ extern int peph2pos(gtime_t time, int sat, const nav_t *nav, int opt,
     
     return 1;
 }
+/* satellite position/clock by precise ephemeris/clock -------------------------
+* compute satellite position/clock with precise ephemeris/clock
+* args   : gtime_t time       I   time (gpst)
+*          int    sat         I   satellite number
+*          nav_t  *nav        I   navigation data
+*          int    opt         I   sat postion option
+*                                 (0: center of mass, 1: antenna phase center)
+*          double *rs         O   sat position and velocity (ecef)
+*                                 {x,y,z,vx,vy,vz} (m|m/s)
+*          double *dts        O   sat clock {bias,drift} (s|s/s)
+*          double *var        IO  sat position and clock error variance (m)
+*                                 (NULL: no output)
+* return : status (1:ok,0:error or data outage)
+* notes  : clock includes relativistic correction but does not contain code bias
+*          before calling the function, nav->peph, nav->ne, nav->pclk and
+*          nav->nc must be set by calling readsp3(), readrnx() or readrnxt()
+*          if precise clocks are not set, clocks in sp3 are used instead
+*-----------------------------------------------------------------------------*/
+extern int peph2pos(gtime_t time, int sat, const nav_t *nav, int opt,
+                    double *rs, double *dts, double *var)
+{
+    //trace(4,"peph2pos: time=%s sat=%2d opt=%d\n",time_str(time,3),sat,opt);
+    
+    return peph2posn(time,sat,nav,opt,NULL,rs,dts,var);
+}
+/* precise ephemeris to satellite positions and clocks of batch ----------------
+* compute satellite positions/velocities and clocks of a batch of satellites
+* with precise ephemeris/clock
+* args   : gtime_t *time      I   times (gpst) {time[0],time[1],...}
+*          int    *sat        I   satellite numbers {sat[0],sat[1],...}
+*          int    n           I   number of batch
+*          nav_t  *nav        I   navigation data
+*          int    opt         I   sat postion option (same as peph2pos())
+*          double *rs         O   sat positions and velocities {rs[0-5],...}
+*          double *dts        O   sat clocks {dts[0-1],...}
+*          double *var        O   sat position and clock error variances
+*                                 {var[0],...} (NULL: no output)
+*          int    *stat       O   status {stat[0],...} (1:ok,0:error)
+* return : number of status ok
+* notes  : same as peph2pos() for each of the batch. the bracketing node and
+*          the interpolation weights of time and time+1ms are searched and
+*          computed once and applied to the following satellites while their
+*          times are in the same interval of the nodes (usually all of the
+*          satellites of an epoch)
+*-----------------------------------------------------------------------------*/
+extern int peph2pos_batch(const gtime_t *time, const int *sat, int n,
+                          const nav_t *nav, int opt, double *rs, double *dts,
+                          double *var, int *stat)
+{
+    pephn_t nd[2];
+    int i,nok=0;
+    
+    nd[0].index=nd[1].index=-1;
+    
+    for (i=0;i<n;i++) {
+        stat[i]=peph2posn(time[i],sat[i],nav,opt,nd,rs+i*6,dts+i*2,
+                          var?var+i:NULL);
+        if (stat[i]) nok++;
+    }
+    return nok;
+}
@@ -0,0 +1,295 @@
+/*------------------------------------------------------------------------------
+* rdcache.cpp : binary cache of read input files
+*
+*          the data read from a text input file (rinex obs/nav/clock, sp3) are
+*          saved as blocks of binary records in a cache file <file>.rtkc next
+*          to the input. the cache is valid as long as the path, size and
+*          modified time of the input, the read options and the layout of the
+*          records are not changed. the valid cache file is memory-mapped and
+*          the blocks are copied instead of parsing the text again.
+*
+*          cache file format (native byte order) :
+*
+*            header   : cachehead_t
+*            index    : cacheidx_t x nblk
+*            blocks   : block data aligned to 8 bytes
+*
+* version : $Revision: 1.1 $ $Date: 2025/07/08 $
+* history : 2025/07/08 1.0  new
+*-----------------------------------------------------------------------------*/
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <io.h>
+#include <sys/stat.h>
+#endif
+#include "rtklib.h"
+
+#define CACHEVER    1                   /* cache file format version */
+#define CACHEEXT    ".rtkc"             /* extension of cache file */
+#define NSIG        16                  /* number of layout signatures */
+
+typedef struct {            /* cache file header type */
+    char magic[8];          /* "RTKCACHE" */
+    int ver;                /* format version */
+    int nblk;               /* number of data blocks */
+    int sig[NSIG];          /* layout signature of records */
+    long long fsize;        /* size of input file (bytes) */
+    long long mtime;        /* modified time of input file (s) */
+    char path[1024];        /* path of input file */
+    char key[512];          /* read options */
+} cachehead_t;
+
+typedef struct {            /* cache file index type */
+    int id;                 /* block id */
+    int reserved;
+    long long off;          /* offset of block in file (bytes) */
+    long long size;         /* size of block (bytes) */
+} cacheidx_t;
+
+static int rdcache=0;       /* binary cache of read input files (0:off,1:on) */
+
+/* layout signature of records -----------------------------------------------*/
+static void setsig(int *sig)
+{
+    int i=0;
+
+    sig[i++]=(int)sizeof(obsd_t);
+    sig[i++]=(int)sizeof(eph_t);
+    sig[i++]=(int)sizeof(geph_t);
+    sig[i++]=(int)sizeof(seph_t);
+    sig[i++]=(int)sizeof(peph_t);
+    sig[i++]=(int)sizeof(pclk_t);
+    sig[i++]=(int)sizeof(sta_t);
+    sig[i++]=(int)sizeof(bds_ion_t);
+    sig[i++]=(int)sizeof(void *);
+    sig[i++]=MAXSAT;
+    sig[i++]=NFREQ;
+    sig[i++]=NEXOBS;
+    sig[i++]=MAXOBSTYPE;
+    sig[i++]=MAXPRNGLO;
+    while (i<NSIG) sig[i++]=0;
+}
+/* size and modified time of input file --------------------------------------*/
+static int filestat(const char *file, long long *size, long long *mtime)
+{
+    struct stat st;
+
+    if (stat(file,&st)||!(st.st_mode&S_IFREG)) return 0;
+    *size =(long long)st.st_size;
+    *mtime=(long long)st.st_mtime;
+    return 1;
+}
+/* set/get binary cache of read input files ------------------------------------
+* enable or disable binary cache of rinex obs/nav/clock and sp3 files read by
+* readrnxt(), readrnxc() and readsp3()
+* args   : int    ena       I   binary cache (0:off,1:on)
+* return : none (getrdcache(): binary cache (0:off,1:on))
+*-----------------------------------------------------------------------------*/
+extern void setrdcache(int ena)
+{
+    rdcache=ena;
+}
+extern int getrdcache(void)
+{
+    return rdcache;
+}
+/* open binary cache -----------------------------------------------------------
+* map binary cache file of an input file if the cache is valid
+* args   : cache_t *cache   O   binary cache
+*          char   *file     I   input file path
+*          char   *key      I   read options of input file
+* return : status (1:valid cache opened,0:no valid cache)
+* notes  : close the cache by closecache(). the data blocks point into the
+*          mapped file and are valid until closecache().
+*-----------------------------------------------------------------------------*/
+extern int opencache(cache_t *cache, const char *file, const char *key)
+{
+    FILE *fp;
+    cachehead_t head;
+    cacheidx_t idx;
+    long long fsize,mtime;
+    char path[1100];
+    int i,sig[NSIG];
+#ifdef WIN32
+    HANDLE hfile;
+    LARGE_INTEGER size;
+#else
+    struct stat st;
+    void *addr;
+#endif
+
+    cache->addr=NULL; cache->size=0; cache->n=0;
+
+    if (!rdcache||!filestat(file,&fsize,&mtime)) return 0;
+
+    sprintf(path,"%.1023s%s",file,CACHEEXT);
+    if (!(fp=fopen(path,"rb"))) return 0;
+#ifdef WIN32
+    hfile=(HANDLE)_get_osfhandle(_fileno(fp));
+    if (hfile==INVALID_HANDLE_VALUE||!GetFileSizeEx(hfile,&size)||
+        size.QuadPart<(LONGLONG)sizeof(cachehead_t)||
+        !(cache->hmap=CreateFileMapping(hfile,NULL,PAGE_READONLY,0,0,NULL))) {
+        fclose(fp);
+        return 0;
+    }
+    if (!(cache->addr=(const char *)MapViewOfFile(cache->hmap,FILE_MAP_READ,0,0,
+                                                  0))) {
+        CloseHandle(cache->hmap);
+        fclose(fp);
+        return 0;
+    }
+    cache->size=(size_t)size.QuadPart;
+#else
+    if (fstat(fileno(fp),&st)||st.st_size<(off_t)sizeof(cachehead_t)) {
+        fclose(fp);
+        return 0;
+    }
+    addr=mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fileno(fp),0);
+    if (addr==MAP_FAILED) {
+        fclose(fp);
+        return 0;
+    }
+    cache->addr=(const char *)addr;
+    cache->size=(size_t)st.st_size;
+#endif
+    fclose(fp); /* mapping is kept after close */
+
+    /* validate header */
+    memcpy(&head,cache->addr,sizeof(head));
+    setsig(sig);
+    head.path[sizeof(head.path)-1]=head.key[sizeof(head.key)-1]='\0';
+
+    if (memcmp(head.magic,"RTKCACHE",8)||head.ver!=CACHEVER||
+        memcmp(head.sig,sig,sizeof(sig))||head.fsize!=fsize||
+        head.mtime!=mtime||strcmp(head.path,file)||strcmp(head.key,key)||
+        head.nblk<0||head.nblk>MAXCACHEBLK||
+        cache->size<sizeof(head)+sizeof(idx)*head.nblk) {
+        trace(3,"opencache: invalid cache file=%s\n",path);
+        closecache(cache);
+        return 0;
+    }
+    for (i=0;i<head.nblk;i++) {
+        memcpy(&idx,cache->addr+sizeof(head)+sizeof(idx)*i,sizeof(idx));
+        if (idx.off<0||idx.size<0||(unsigned long long)(idx.off+idx.size)>
+            (unsigned long long)cache->size) {
+            trace(2,"opencache: broken cache file=%s\n",path);
+            closecache(cache);
+            return 0;
+        }
+        cache->blk[i].id  =idx.id;
+        cache->blk[i].size=(size_t)idx.size;
+        cache->blk[i].data=cache->addr+idx.off;
+    }
+    cache->n=head.nblk;
+
+    trace(3,"opencache: file=%s nblk=%d size=%ld\n",path,cache->n,
+          (long)cache->size);
+    return 1;
+}
+/* close binary cache ----------------------------------------------------------
+* unmap binary cache file opened by opencache()
+* args   : cache_t *cache   IO  binary cache
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void closecache(cache_t *cache)
+{
+    if (!cache->addr) return;
+#ifdef WIN32
+    UnmapViewOfFile(cache->addr);
+    CloseHandle(cache->hmap);
+#else
+    munmap((void *)cache->addr,cache->size);
+#endif
+    cache->addr=NULL; cache->size=0; cache->n=0;
+}
+/* write binary cache ----------------------------------------------------------
+* write data blocks read from an input file to the binary cache file
+* args   : char   *file     I   input file path
+*          char   *key      I   read options of input file
+*          cacheblk_t *blk  I   data blocks
+*          int    n         I   number of data blocks
+* return : status (1:ok,0:error or cache disabled)
+* notes  : the cache file is written to a temporary file and renamed so that
+*          a partially written cache is never opened
+*-----------------------------------------------------------------------------*/
+extern int writecache(const char *file, const char *key, const cacheblk_t *blk,
+                      int n)
+{
+    FILE *fp;
+    cachehead_t head={{0}};
+    cacheidx_t idx={0};
+    char path[1100],tmp[1100],pad[8]={0};
+    long long off;
+    int i,stat=1;
+
+    if (!rdcache||n>MAXCACHEBLK) return 0;
+
+    if (!filestat(file,&head.fsize,&head.mtime)) return 0;
+    memcpy(head.magic,"RTKCACHE",8);
+    head.ver=CACHEVER;
+    head.nblk=n;
+    setsig(head.sig);
+    sprintf(head.path,"%.1023s",file);
+    sprintf(head.key,"%.511s",key);
+
+    sprintf(path,"%.1023s%s",file,CACHEEXT);
+    sprintf(tmp,"%.1090s.tmp",path);
+    if (!(fp=fopen(tmp,"wb"))) {
+        trace(2,"writecache: file open error %s\n",tmp);
+        return 0;
+    }
+    if (fwrite(&head,sizeof(head),1,fp)!=1) stat=0;
+
+    off=(long long)(sizeof(head)+sizeof(idx)*n);
+    for (i=0;i<n&&stat;i++) {
+        off=(off+7)/8*8;
+        idx.id  =blk[i].id;
+        idx.off =off;
+        idx.size=(long long)blk[i].size;
+        if (fwrite(&idx,sizeof(idx),1,fp)!=1) stat=0;
+        off+=idx.size;
+    }
+    off=(long long)(sizeof(head)+sizeof(idx)*n);
+    for (i=0;i<n&&stat;i++) {
+        if (off%8&&fwrite(pad,8-off%8,1,fp)!=1) stat=0;
+        off=(off+7)/8*8;
+        if (blk[i].size>0&&fwrite(blk[i].data,blk[i].size,1,fp)!=1) stat=0;
+        off+=(long long)blk[i].size;
+    }
+    if (fclose(fp)) stat=0;
+
+    if (stat) {
+        remove(path);
+        stat=!rename(tmp,path);
+    }
+    if (!stat) {
+        trace(2,"writecache: file write error %s\n",path);
+        remove(tmp);
+        return 0;
+    }
+    trace(3,"writecache: file=%s nblk=%d size=%ld\n",path,n,(long)off);
+    return 1;
+}
+/* get data block of binary cache ----------------------------------------------
+* search data block by block id
+* args   : cacheblk_t *blk  I   data blocks
+*          int    n         I   number of data blocks
+*          int    id        I   block id
+*          size_t *size     O   block size (bytes) (0: no block)
+* return : block data (NULL: no block)
+*-----------------------------------------------------------------------------*/
+extern const void *getcacheblk(const cacheblk_t *blk, int n, int id,
+                               size_t *size)
+{
+    int i;
+
+    for (i=0;i<n;i++) {
+        if (blk[i].id!=id) continue;
+        *size=blk[i].size;
+        return blk[i].data;
+    }
+    *size=0;
+    return NULL;
+}
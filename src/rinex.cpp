@@ -92,7 +92,17 @@
 *           2016/10/10 1.27 add api outrnxinavh()
 *           2018/10/10 1.28 support galileo sisa value for rinex nav output
 *                           fix bug on handling beidou B1 code in rinex 3.03
+*           2025/07/02 1.29 read rinex obs data body by memory-mapped file
+*           2025/07/06 1.30 read compressed files uncompressed in memory
+*           2025/07/08 1.31 read rinex files through binary cache
 *-----------------------------------------------------------------------------*/
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <io.h>
+#endif
+#include <stddef.h>
 #include "rtklib.h"
 
 /* constants/macros ----------------------------------------------------------*/
@@ -101,6 +111,7 @@
 
 #define NUMSYS      7                   /* number of systems */
 #define MAXRNXLEN   (16*MAXOBSTYPE+4)   /* max rinex record length */
+#define MAXRNXTAIL  262144              /* max tail size to search last epoch */
 #define MAXPOSHEAD  1024                /* max head line position */
 #define MINFREQ_GLO -7                  /* min frequency number glonass */
 #define MAXFREQ_GLO 13                  /* max frequency number glonass */
@@ -833,52 +844,11 @@ static int decode_obsepoch(FILE *fp, char *buff, double ver, gtime_t *time,
     //trace(4,"decode_obsepoch: time=%s flag=%d\n",time_str(*time,3),*flag);
     return n;
 }
-/* decode obs data -----------------------------------------------------------*/
-/* ȡ */
-static int decode_obsdata(FILE *fp, char *buff, double ver, int mask,
-                          sigind_t *index, obsd_t *obs)
+/* set obs data fields -------------------------------------------------------*/
+static void setobsdata(double ver, const sigind_t *ind, const double *val,
+                       const unsigned char *lli, obsd_t *obs)
 {
-    sigind_t *ind;
-    double val[MAXOBSTYPE]={0};
-    unsigned char lli[MAXOBSTYPE]={0};
-    char satid[8]="";
-    int i,j,n,m,stat=1,p[MAXOBSTYPE],k[16],l[16];
-    
-   // trace(4,"decode_obsdata: ver=%.2f\n",ver);
-    
-    if (ver>2.99) 
-    { /* ver.3 */ 
-        strncpy(satid,buff,3);
-        obs->sat=(unsigned char)satid2no(satid);
-    }
-    if (!obs->sat) {
-       // trace(4,"decode_obsdata: unsupported sat sat=%s\n",satid);
-        stat=0;
-    }
-    else if (!(satsys(obs->sat,NULL)&mask)) {
-        stat=0;
-    }
-    /* read obs data fields */
-    switch (satsys(obs->sat,NULL)) {
-        case SYS_GLO: ind=index+1; break;
-        case SYS_GAL: ind=index+2; break;
-        case SYS_QZS: ind=index+3; break;
-        case SYS_SBS: ind=index+4; break;
-        case SYS_CMP: ind=index+5; break;
-        default:      ind=index  ; break;
-    }
-    for (i=0,j=ver<=2.99?0:3;i<ind->n;i++,j+=16) {
-        
-        if (ver<=2.99&&j>=80) { /* ver.2 */
-            if (!fgets(buff,MAXRNXLEN,fp)) break;
-            j=0;
-        }
-        if (stat) {
-            val[i] = str2num(buff, j, 14) + ind->shift[i];
-            lli[i] = (unsigned char)str2num(buff, j + 14, 1) & 3;   // "&3"ȼ"%4" 0255 ΧЧ
-        }
-    }
-    if (!stat) return 0;
+    int i,n,m,p[MAXOBSTYPE],k[16],l[16];
     
     for (i=0;i<NFREQ+NEXOBS;i++) {
         obs->P[i]=obs->L[i]=0.0; obs->D[i]=0.0f;
@@ -944,6 +914,56 @@ static int decode_obsdata(FILE *fp, char *buff, double ver, int mask,
             case 3: obs->SNR[p[i]]=(unsigned char)(val[i]*4.0+0.5);    break;
         }
     }
+}
+/* decode obs data -----------------------------------------------------------*/
+/* ȡ */
+static int decode_obsdata(FILE *fp, char *buff, double ver, int mask,
+                          sigind_t *index, obsd_t *obs)
+{
+    sigind_t *ind;
+    double val[MAXOBSTYPE]={0};
+    unsigned char lli[MAXOBSTYPE]={0};
+    char satid[8]="";
+    int i,j,stat=1;
+    
+   // trace(4,"decode_obsdata: ver=%.2f\n",ver);
+    
+    if (ver>2.99) 
+    { /* ver.3 */ 
+        strncpy(satid,buff,3);
+        obs->sat=(unsigned char)satid2no(satid);
+    }
+    if (!obs->sat) {
+       // trace(4,"decode_obsdata: unsupported sat sat=%s\n",satid);
+        stat=0;
+    }
+    else if (!(satsys(obs->sat,NULL)&mask)) {
+        stat=0;
+    }
+    /* read obs data fields */
+    switch (satsys(obs->sat,NULL)) {
+        case SYS_GLO: ind=index+1; break;
+        case SYS_GAL: ind=index+2; break;
+        case SYS_QZS: ind=index+3; break;
+        case SYS_SBS: ind=index+4; break;
+        case SYS_CMP: ind=index+5; break;
+        default:      ind=index  ; break;
+    }
+    for (i=0,j=ver<=2.99?0:3;i<ind->n;i++,j+=16) {
+        
+        if (ver<=2.99&&j>=80) { /* ver.2 */
+            if (!fgets(buff,MAXRNXLEN,fp)) break;
+            j=0;
+        }
+        if (stat) {
+            val[i] = str2num(buff, j, 14) + ind->shift[i];
+            lli[i] = (unsigned char)str2num(buff, j + 14, 1) & 3;   // "&3"ȼ"%4" 0255 ΧЧ
+        }
+    }
+    if (!stat) return 0;
+    
+    setobsdata(ver,ind,val,lli,obs);
+    
     //trace(4,"decode_obsdata: time=%s sat=%2d\n",time_str(obs->time,0),obs->sat);
     return 1;
 }
@@ -1169,6 +1189,21 @@ static void set_isc_index(int sys,char tobs[MAXOBSTYPE][4], sigind_t *ind,int *i
 	}
 #endif
 }
+/* set signal and isc index of all systems -----------------------------------*/
+static void set_obsindex(double ver, const char *opt, char tobs[][MAXOBSTYPE][4],
+                         sigind_t *index, int isci[][MAXFREQ])
+{
+    const int sys[]={SYS_GPS,SYS_GLO,SYS_GAL,SYS_QZS,SYS_SBS,SYS_CMP,SYS_IRN};
+    int i,j;
+    
+    for (i=0;i<7;i++) {
+        set_index(ver,sys[i],opt,tobs[i],index+i);
+    }
+    for (i=0;i<7;i++) for (j=0;j<MAXFREQ;j++) isci[i][j]=0;
+    for (i=0;i<7;i++) {
+        set_isc_index(sys[i],tobs[i],index+i,isci[i]);
+    }
+}
 /* read rinex obs data body --------------------------------------------------*/
 static int readrnxobsb(FILE *fp, const char *opt, double ver, int *tsys,
                        char tobs[][MAXOBSTYPE][4], int *flag, obsd_t *data,
@@ -1222,6 +1257,262 @@ static int readrnxobsb(FILE *fp, const char *opt, double ver, int *tsys,
     }
     return -1;
 }
+/* memory-mapped rinex obs data body -------------------------------------------
+* the obs data body is parsed in place from the memory-mapped file instead of
+* fgets() and str2num(). the records are the same as readrnxobsb(). lines are
+* split at MAXRNXLEN-1 bytes as fgets() does and the header records of event
+* flag 3 or 4 are handed over to decode_obsh() through the file pointer.
+* a file uncompressed in memory is parsed in the same way without mapping.
+*-----------------------------------------------------------------------------*/
+typedef struct {            /* memory-mapped rinex file type */
+    FILE *fp;               /* file pointer of mapped file */
+    const char *addr;       /* mapped address */
+    size_t size;            /* mapped size (bytes) */
+    const char *p;          /* read pointer */
+    int mask;               /* system mask */
+    int mapped;             /* mapped file (0: uncompressed data in memory) */
+#ifdef WIN32
+    HANDLE hmap;            /* file mapping handle */
+#endif
+} rnxmap_t;
+
+/* map rinex file from current position of file pointer ----------------------*/
+static int openmap(rnxmap_t *map, FILE *fp, const char *opt,
+                   const uncfile_t *unc)
+{
+    long pos;
+#ifdef WIN32
+    HANDLE hfile;
+    LARGE_INTEGER size;
+#else
+    struct stat st;
+    void *addr;
+#endif
+    
+    if ((pos=ftell(fp))<0) return 0;
+    
+    if (unc&&unc->buff) { /* uncompressed data in memory */
+        if ((size_t)pos>=unc->size) return 0;
+        map->addr=unc->buff;
+        map->size=unc->size;
+        map->mapped=0;
+    }
+    else {
+#ifdef WIN32
+        hfile=(HANDLE)_get_osfhandle(_fileno(fp));
+        if (hfile==INVALID_HANDLE_VALUE||GetFileType(hfile)!=FILE_TYPE_DISK||
+            !GetFileSizeEx(hfile,&size)||size.QuadPart<=pos) return 0;
+        if (!(map->hmap=CreateFileMapping(hfile,NULL,PAGE_READONLY,0,0,NULL))) {
+            return 0;
+        }
+        if (!(map->addr=(const char *)MapViewOfFile(map->hmap,FILE_MAP_READ,0,0,
+                                                    0))) {
+            CloseHandle(map->hmap);
+            return 0;
+        }
+        map->size=(size_t)size.QuadPart;
+#else
+        if (fstat(fileno(fp),&st)||!S_ISREG(st.st_mode)||st.st_size<=pos) {
+            return 0;
+        }
+        addr=mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fileno(fp),0);
+        if (addr==MAP_FAILED) return 0;
+        madvise(addr,(size_t)st.st_size,MADV_SEQUENTIAL);
+        map->addr=(const char *)addr;
+        map->size=(size_t)st.st_size;
+#endif
+        map->mapped=1;
+    }
+    map->fp=fp;
+    map->p=map->addr+pos;
+    map->mask=set_sysmask(opt);
+    trace(4,"openmap: size=%ld pos=%ld\n",(long)map->size,pos);
+    return 1;
+}
+/* unmap rinex file and set file pointer to read pointer ---------------------*/
+static void closemap(rnxmap_t *map)
+{
+    fseek(map->fp,(long)(map->p-map->addr),SEEK_SET);
+    if (map->mapped) {
+#ifdef WIN32
+        UnmapViewOfFile(map->addr);
+        CloseHandle(map->hmap);
+#else
+        munmap((void *)map->addr,map->size);
+#endif
+    }
+    map->addr=map->p=NULL;
+}
+/* get next line of mapped file (without null-termination) -------------------*/
+static int mapgets(rnxmap_t *map, const char **s)
+{
+    const char *q;
+    size_t n=map->addr+map->size-map->p;
+    
+    if (n<=0) return 0;
+    if (n>MAXRNXLEN-1) n=MAXRNXLEN-1;
+    if ((q=(const char *)memchr(map->p,'\n',n))) n=q-map->p+1;
+    *s=map->p;
+    map->p+=n;
+    return (int)n;
+}
+/* copy field of line to string ----------------------------------------------*/
+static void mapfield(const char *s, int len, int i, int n, char *str)
+{
+    for (s+=i,len-=i;len>0&&n>0;len--,n--) *str++=*s++;
+    *str='\0';
+}
+/* field of line to number (same as str2num()) -------------------------------*/
+static double mapnum(const char *s, int len, int i, int n)
+{
+    double val;
+    char str[256];
+    
+    if (i<0||len<i||(int)sizeof(str)-1<n) return 0.0;
+    if (parsenum(s+i,len<i+n?len-i:n,&val)>=0) return val;
+    mapfield(s,len,i,n,str);
+    return str2num(str,0,n);
+}
+/* field of line to time (same as str2time()) --------------------------------*/
+static int maptime(const char *s, int len, int i, int n, gtime_t *t)
+{
+    char str[256];
+    
+    if (i<0||len<i||(int)sizeof(str)-1<n) return -1;
+    mapfield(s,len,i,n,str);
+    return str2time(str,0,n,t);
+}
+/* decode obs epoch of mapped file -------------------------------------------*/
+static int decode_obsepochm(rnxmap_t *map, const char *s, int len, double ver,
+                            gtime_t *time, int *flag, int *sats)
+{
+    int i,j,n;
+    char satid[8]="";
+    
+    if (ver<=2.99) { /* ver.2 */
+        if ((n=(int)mapnum(s,len,29,3))<=0) return 0;
+        
+        /* epoch flag: 3:new site,4:header info,5:external event */
+        *flag=(int)mapnum(s,len,28,1);
+        
+        if (3<=*flag&&*flag<=5) return n;
+        
+        if (maptime(s,len,0,26,time)) {
+            trace(2,"rinex obs invalid epoch: epoch=%.*s\n",len<26?len:26,s);
+            return 0;
+        }
+        for (i=0,j=32;i<n;i++,j+=3) {
+            if (j>=68) {
+                if (!(len=mapgets(map,&s))) break;
+                j=32;
+            }
+            if (i<MAXOBS) {
+                mapfield(s,len,j,3,satid);
+                sats[i]=satid2no(satid);
+            }
+        }
+    }
+    else { /* ver.3 */
+        if ((n=(int)mapnum(s,len,32,3))<=0) return 0;
+        
+        *flag=(int)mapnum(s,len,31,1);
+        
+        if (3<=*flag&&*flag<=5) return n;
+        
+        if (s[0]!='>'||maptime(s,len,1,28,time)) {
+            trace(2,"rinex obs invalid epoch: epoch=%.*s\n",len<29?len:29,s);
+            return 0;
+        }
+    }
+    return n;
+}
+/* decode obs data of mapped file --------------------------------------------*/
+static int decode_obsdatam(rnxmap_t *map, const char *s, int len, double ver,
+                           sigind_t *index, obsd_t *obs)
+{
+    sigind_t *ind;
+    double val[MAXOBSTYPE]={0};
+    unsigned char lli[MAXOBSTYPE]={0};
+    char satid[8]="";
+    int i,j,stat=1;
+    
+    if (ver>2.99) { /* ver.3 */
+        mapfield(s,len,0,3,satid);
+        obs->sat=(unsigned char)satid2no(satid);
+    }
+    if (!obs->sat||!(satsys(obs->sat,NULL)&map->mask)) {
+        stat=0;
+    }
+    switch (satsys(obs->sat,NULL)) {
+        case SYS_GLO: ind=index+1; break;
+        case SYS_GAL: ind=index+2; break;
+        case SYS_QZS: ind=index+3; break;
+        case SYS_SBS: ind=index+4; break;
+        case SYS_CMP: ind=index+5; break;
+        default:      ind=index  ; break;
+    }
+    for (i=0,j=ver<=2.99?0:3;i<ind->n;i++,j+=16) {
+        
+        if (ver<=2.99&&j>=80) { /* ver.2 */
+            if (!(len=mapgets(map,&s))) break;
+            j=0;
+        }
+        if (stat) {
+            val[i]=mapnum(s,len,j,14)+ind->shift[i];
+            lli[i]=(unsigned char)mapnum(s,len,j+14,1)&3;
+        }
+    }
+    if (!stat) return 0;
+    
+    setobsdata(ver,ind,val,lli,obs);
+    return 1;
+}
+/* decode obs header record of mapped file -----------------------------------*/
+static void decode_obshm(rnxmap_t *map, const char *s, int len, double ver,
+                         int *tsys, char tobs[][MAXOBSTYPE][4], sta_t *sta)
+{
+    char buff[MAXRNXLEN];
+    
+    /* continuation lines are read by fgets() in decode_obsh() */
+    mapfield(s,len,0,len,buff);
+    fseek(map->fp,(long)(map->p-map->addr),SEEK_SET);
+    decode_obsh(map->fp,buff,ver,tsys,tobs,NULL,sta);
+    map->p=map->addr+ftell(map->fp);
+}
+/* read rinex obs data body of mapped file -----------------------------------*/
+static int readrnxobsm(rnxmap_t *map, double ver, int *tsys,
+                       char tobs[][MAXOBSTYPE][4], int *flag, obsd_t *data,
+                       sta_t *sta, sigind_t *index)
+{
+    gtime_t time={0};
+    const char *s;
+    int i=0,n=0,len,nsat=0,sats[MAXOBS]={0};
+    
+    while ((len=mapgets(map,&s))>0) {
+        
+        /* decode obs epoch */
+        if (i==0) {
+            if ((nsat=decode_obsepochm(map,s,len,ver,&time,flag,sats))<=0) {
+                continue;
+            }
+        }
+        else if (*flag<=2||*flag==6) {
+            
+            data[n].time=time;
+            data[n].sat=(unsigned char)sats[i-1];
+            
+            /* decode obs data */
+            if (decode_obsdatam(map,s,len,ver,index,data+n)&&n<MAXOBS) n++;
+        }
+        else if (*flag==3||*flag==4) { /* new site or header info follows */
+            
+            /* decode obs header */
+            decode_obshm(map,s,len,ver,tsys,tobs,sta);
+        }
+        if (++i>nsat) return n;
+    }
+    return -1;
+}
 /* read rinex obs ------------------------------------------------------------*/
 /* ˴tobsһά飬һάϵͳڶάƵʣάź
    豱һƵC1X߼ϵӦģ
@@ -1229,13 +1520,15 @@ static int readrnxobsb(FILE *fp, const char *opt, double ver, int *tsys,
    tobs[5][0]ϵͳĵһƵ㣬ݰ{C,1,X}char͵ĸ
    tobs[5][0][0]ϵͳĵһƵĵһĸ'C'   
     */
-static int readrnxobs(FILE *fp, gtime_t ts, gtime_t te, double tint,
-                      const char *opt, int rcv, double ver, int *tsys,
-                      char tobs[][MAXOBSTYPE][4], obs_t *obs, sta_t *sta)
+static int readrnxobs(FILE *fp, const uncfile_t *unc, gtime_t ts, gtime_t te,
+                      double tint, const char *opt, int rcv, double ver,
+                      int *tsys, char tobs[][MAXOBSTYPE][4], obs_t *obs,
+                      sta_t *sta)
 {
     obsd_t *data;
+    rnxmap_t map;
     unsigned char slips[MAXSAT][NFREQ]={{0}};
-    int i,n,flag=0,stat=0;
+    int i,n,flag=0,stat=0,mapped;
 	sigind_t index[7] = { { 0 } };
 
     trace(4,"readrnxobs: rcv=%d ver=%.2f tsys=%d\n",rcv,ver,tsys);
@@ -1244,27 +1537,15 @@ static int readrnxobs(FILE *fp, gtime_t ts, gtime_t te, double tint,
     
     if (!(data=(obsd_t *)malloc(sizeof(obsd_t)*MAXOBS))) return 0;
     
-	set_index(ver, SYS_GPS, opt, tobs[0], index);
-	set_index(ver, SYS_GLO, opt, tobs[1], index + 1);
-	set_index(ver, SYS_GAL, opt, tobs[2], index + 2);
-	set_index(ver, SYS_QZS, opt, tobs[3], index + 3);
-	set_index(ver, SYS_SBS, opt, tobs[4], index + 4);
-	set_index(ver, SYS_CMP, opt, tobs[5], index + 5);
-	set_index(ver, SYS_IRN, opt, tobs[6], index + 6);
-
-	for (i = 0; i < 7; i++)for (n = 0; n < MAXFREQ; n++)obs->isci[i][n] = 0;
-	set_isc_index(SYS_GPS, tobs[0], index + 0, obs->isci[0]);
-	set_isc_index(SYS_GLO, tobs[1], index + 1, obs->isci[1]);
-	set_isc_index(SYS_GAL, tobs[2], index + 2, obs->isci[2]);
-	set_isc_index(SYS_QZS, tobs[3], index + 3, obs->isci[3]);
-	set_isc_index(SYS_SBS, tobs[4], index + 4, obs->isci[4]);
-	set_isc_index(SYS_CMP, tobs[5], index + 5, obs->isci[5]);
-	set_isc_index(SYS_IRN, tobs[6], index + 6, obs->isci[6]);
-
-
+    set_obsindex(ver,opt,tobs,index,obs->isci);
+    
+    /* map obs data body (fgets() for stdin or pipe) */
+    mapped=openmap(&map,fp,opt,unc);
+    
     /* read rinex obs data body one record at a time */
-     while ((n=readrnxobsb(fp,opt,ver,tsys,tobs,&flag,data,sta, index))>=0&&stat>=0) 
-    {
+    while ((n=mapped?readrnxobsm(&map,ver,tsys,tobs,&flag,data,sta,index):
+                     readrnxobsb(fp,opt,ver,tsys,tobs,&flag,data,sta,index))>=0&&
+           stat>=0) {
         for (i=0;i<n;i++) {
             
             /* utc -> gpst */
@@ -1293,6 +1574,7 @@ static int readrnxobs(FILE *fp, gtime_t ts, gtime_t te, double tint,
     }
     trace(4,"readrnxobs: nobs=%d stat=%d\n",obs->n,stat);
     
+    if (mapped) closemap(&map);
     free(data);
     
     return stat;
@@ -1809,8 +2091,8 @@ static int readrnxnavb(FILE *fp, const char *opt, double ver, int sys,
 {
     gtime_t toc;
     double data[64];
-	int i = 0, j, prn, sat = 0, sp = 3, mask;
-    char buff[MAXRNXLEN],id[8]="",*p,recType[128],megType[128];
+	int i = 0, prn, sat = 0, sp = 3, mask;
+    char buff[MAXRNXLEN],id[8]="",recType[128],megType[128];
     
    // trace(4,"readrnxnavb: ver=%.2f sys=%d\n",ver,sys);
     
@@ -1866,17 +2148,15 @@ static int readrnxnavb(FILE *fp, const char *opt, double ver, int sys,
 				data[i++] = 0.0; data[i++] = 0.0; data[i++] = 0.0;
 			}
 			else{
-				for (j = 0, p = buff + sp + 19; j < 3; j++, p += 19) {
-					data[i++] = str2num(p, 0, 19);
-				}
+				str2nums(buff, sp + 19, 19, 3, data + i);
+				i += 3;
 			}
         }
 		else 
         {
 			/* decode data fields */
-			for (j = 0, p = buff + sp; j < 4; j++, p += 19) {
-				data[i++] = str2num(p, 0, 19);
-			}
+			str2nums(buff, sp, 19, 4, data + i);
+			i += 4;
 
 			if (i >= 61){
 				printf("read file error! i>=%d\n", i);
@@ -2162,10 +2442,29 @@ static int readrnxclk(FILE *fp, const char *opt, int index, nav_t *nav)
     }
     return nav->nc>0;
 }
+/* read rinex body -----------------------------------------------------------*/
+static int readrnxb(FILE *fp, const uncfile_t *unc, gtime_t ts, gtime_t te,
+                    double tint, const char *opt, int index, char type,
+                    double ver, int sys, int *tsys, char tobs[][MAXOBSTYPE][4],
+                    obs_t *obs, nav_t *nav, sta_t *sta)
+{
+    switch (type) {
+        case 'O': return readrnxobs(fp,unc,ts,te,tint,opt,index,ver,tsys,tobs,
+                                    obs,sta);
+        case 'N': return readrnxnav(fp,opt,ver,sys    ,nav);
+        case 'G': return readrnxnav(fp,opt,ver,SYS_GLO,nav);
+        case 'H': return readrnxnav(fp,opt,ver,SYS_SBS,nav);
+        case 'J': return readrnxnav(fp,opt,ver,SYS_QZS,nav); /* extension */
+        case 'L': return readrnxnav(fp,opt,ver,SYS_GAL,nav); /* extension */
+        case 'C': return readrnxclk(fp,opt,index,nav);
+    }
+    trace(2,"unsupported rinex type ver=%.2f type=%c\n",ver,type);
+    return 0;
+}
 /* read rinex file -----------------------------------------------------------*/
-static int readrnxfp(FILE *fp, gtime_t ts, gtime_t te, double tint,
-                     const char *opt, int flag, int index, char *type,
-                     obs_t *obs, nav_t *nav, sta_t *sta)
+static int readrnxfp(FILE *fp, const uncfile_t *unc, gtime_t ts, gtime_t te,
+                     double tint, const char *opt, int flag, int index,
+                     char *type, obs_t *obs, nav_t *nav, sta_t *sta)
 {
     double ver;
     int sys,tsys=TSYS_GPS;
@@ -2180,19 +2479,8 @@ static int readrnxfp(FILE *fp, gtime_t ts, gtime_t te, double tint,
     /* flag=0:except for clock,1:clock */
     if ((!flag&&*type=='C')||(flag&&*type!='C')) return 0;
     
-    /* read rinex body */
-    switch (*type) {
-        case 'O': return readrnxobs(fp,ts,te,tint,opt,index,ver,&tsys,tobs,obs,
-                                    sta);
-        case 'N': return readrnxnav(fp,opt,ver,sys    ,nav);
-        case 'G': return readrnxnav(fp,opt,ver,SYS_GLO,nav);
-        case 'H': return readrnxnav(fp,opt,ver,SYS_SBS,nav);
-        case 'J': return readrnxnav(fp,opt,ver,SYS_QZS,nav); /* extension */
-        case 'L': return readrnxnav(fp,opt,ver,SYS_GAL,nav); /* extension */
-        case 'C': return readrnxclk(fp,opt,index,nav);
-    }
-    trace(2,"unsupported rinex type ver=%.2f type=%c\n",ver,*type);
-    return 0;
+    return readrnxb(fp,unc,ts,te,tint,opt,index,*type,ver,sys,&tsys,tobs,obs,
+                    nav,sta);
 }
 static  int isiGMAS(const char *sitname)
 {
@@ -2238,6 +2526,254 @@ static  int isiGMAS(const char *sitname)
 	return -1;
 
 }
+/* binary cache of rinex file ------------------------------------------------*/
+#define CBLK_STAT   1                   /* read status and file type */
+#define CBLK_OBS    2                   /* observation data */
+#define CBLK_EPH    3                   /* GPS/QZS/GAL/BDS/IRN ephemeris */
+#define CBLK_GEPH   4                   /* GLONASS ephemeris */
+#define CBLK_SEPH   5                   /* SBAS ephemeris */
+#define CBLK_PCLK   6                   /* precise clock */
+#define CBLK_BDSK8  7                   /* BDS klobuchar parameters */
+#define CBLK_BDSSH9 8                   /* BDS sh9 parameters */
+#define CBLK_STA    9                   /* station parameters */
+#define CBLK_ISCI   10                  /* isc index of signals */
+#define CBLK_TSYS   11                  /* time system of obs data */
+#define CBLK_NAVH   16                  /* nav header parameters (+index) */
+
+static const struct {                   /* nav header parameters in cache */
+    size_t off,size;                    /* offset and size in nav_t (bytes) */
+    size_t elem;                        /* size of parameter set at once */
+} navhead[]={
+    {offsetof(nav_t,utc_gps   ),sizeof(double)*4      ,sizeof(double)*4},
+    {offsetof(nav_t,utc_glo   ),sizeof(double)*4      ,sizeof(double)*4},
+    {offsetof(nav_t,utc_gal   ),sizeof(double)*4      ,sizeof(double)*4},
+    {offsetof(nav_t,utc_qzs   ),sizeof(double)*4      ,sizeof(double)*4},
+    {offsetof(nav_t,utc_cmp   ),sizeof(double)*4      ,sizeof(double)*4},
+    {offsetof(nav_t,utc_irn   ),sizeof(double)*4      ,sizeof(double)*4},
+    {offsetof(nav_t,ion_gps   ),sizeof(double)*8      ,sizeof(double)*4},
+    {offsetof(nav_t,ion_gal   ),sizeof(double)*4      ,sizeof(double)*4},
+    {offsetof(nav_t,ion_qzs   ),sizeof(double)*8      ,sizeof(double)*4},
+    {offsetof(nav_t,ion_cmp   ),sizeof(double)*8      ,sizeof(double)*4},
+    {offsetof(nav_t,ion_irn   ),sizeof(double)*8      ,sizeof(double)*4},
+    {offsetof(nav_t,leaps     ),sizeof(int)           ,sizeof(int)     },
+    {offsetof(nav_t,wlbias    ),sizeof(double)*MAXSAT ,sizeof(double)  },
+    {offsetof(nav_t,glo_cpbias),sizeof(double)*4      ,sizeof(double)  },
+    {offsetof(nav_t,glo_fcn   ),MAXPRNGLO+1           ,1               }
+};
+/* all bytes zero ------------------------------------------------------------*/
+static int iszero(const void *p, size_t n)
+{
+    const unsigned char *q=(const unsigned char *)p;
+    
+    while (n>0&&!*q) {q++; n--;}
+    return n==0;
+}
+/* append records of cache block to data array -------------------------------*/
+static int addblk(void **data, int *n, int *nmax, const cacheblk_t *blk,
+                  int nblk, int id, size_t size, int skip)
+{
+    const char *p;
+    void *data_p;
+    size_t bytes;
+    int m;
+    
+    if (!(p=(const char *)getcacheblk(blk,nblk,id,&bytes))||
+        (m=(int)(bytes/size)-skip)<=0) {
+        return 1;
+    }
+    p+=size*skip;
+    if (*n+m>*nmax) {
+        if (!(data_p=realloc(*data,size*(*n+m)))) {
+            trace(1,"addblk malloc error: n=%d\n",*n+m);
+            free(*data); *data=NULL; *n=*nmax=0;
+            return 0;
+        }
+        *data=data_p; *nmax=*n+m;
+    }
+    memcpy((char *)*data+size*(*n),p,size*m);
+    *n+=m;
+    return 1;
+}
+/* append rinex file data in cache blocks to obs/nav/sta ---------------------*/
+static int loadrnxblk(const cacheblk_t *blk, int nblk, int flag, char *type,
+                      obs_t *obs, nav_t *nav, sta_t *sta)
+{
+    bds_ion_t *ion;
+    const pclk_t *pclk;
+    const char *p;
+    size_t size,j;
+    int i,n,st[2],skip=0;
+    
+    if (!(p=(const char *)getcacheblk(blk,nblk,CBLK_STAT,&size))||
+        size!=sizeof(st)) {
+        return -1;
+    }
+    memcpy(st,p,sizeof(st));
+    if (st[1]!=' ') *type=(char)st[1];
+    
+    if (obs) {
+        if (!addblk((void **)&obs->data,&obs->n,&obs->nmax,blk,nblk,CBLK_OBS,
+                    sizeof(obsd_t),0)) return -1;
+        if ((p=(const char *)getcacheblk(blk,nblk,CBLK_ISCI,&size))&&
+            size==sizeof(obs->isci)) {
+            memcpy(obs->isci,p,size);
+        }
+    }
+    if (sta&&(p=(const char *)getcacheblk(blk,nblk,CBLK_STA,&size))&&
+        size==sizeof(sta_t)) {
+        memcpy(sta,p,size);
+    }
+    if (!nav) return st[0];
+    
+    if (!addblk((void **)&nav->eph,&nav->n,&nav->nmax,blk,nblk,CBLK_EPH,
+                sizeof(eph_t),0)||
+        !addblk((void **)&nav->geph,&nav->ng,&nav->ngmax,blk,nblk,CBLK_GEPH,
+                sizeof(geph_t),0)||
+        !addblk((void **)&nav->seph,&nav->ns,&nav->nsmax,blk,nblk,CBLK_SEPH,
+                sizeof(seph_t),0)) return -1;
+    /* clocks of same epoch as last one are merged (see readrnxclk()) */
+    if (nav->nc>0&&(p=(const char *)getcacheblk(blk,nblk,CBLK_PCLK,&size))&&
+        size>=sizeof(pclk_t)) {
+        pclk=(const pclk_t *)p;
+        if (fabs(timediff(pclk->time,nav->pclk[nav->nc-1].time))<=1E-9) {
+            for (i=0;i<MAXSAT;i++) {
+                if (pclk->clk[i][0]==0.0&&pclk->std[i][0]==0.0f) continue;
+                nav->pclk[nav->nc-1].clk[i][0]=pclk->clk[i][0];
+                nav->pclk[nav->nc-1].std[i][0]=pclk->std[i][0];
+            }
+            skip=1;
+        }
+    }
+    if (!addblk((void **)&nav->pclk,&nav->nc,&nav->ncmax,blk,nblk,CBLK_PCLK,
+                sizeof(pclk_t),skip)) return -1;
+    ion=&nav->ion_bdsk9->bds_ion;
+    if ((p=(const char *)getcacheblk(blk,nblk,CBLK_BDSK8,&size))) {
+        n=(int)(size/sizeof(bdsk8_t));
+        if (n>1024-ion->nk8) n=1024-ion->nk8;
+        memcpy(ion->bdsk8+ion->nk8,p,sizeof(bdsk8_t)*n);
+        ion->nk8+=n;
+    }
+    if ((p=(const char *)getcacheblk(blk,nblk,CBLK_BDSSH9,&size))) {
+        n=(int)(size/sizeof(bdssh9_t));
+        if (n>1024-ion->nsh9) n=1024-ion->nsh9;
+        memcpy(ion->bdssh9+ion->nsh9,p,sizeof(bdssh9_t)*n);
+        ion->nsh9+=n;
+    }
+    /* header parameters set by the file */
+    for (i=0;i<(int)(sizeof(navhead)/sizeof(*navhead));i++) {
+        if (!(p=(const char *)getcacheblk(blk,nblk,CBLK_NAVH+i,&size))||
+            size!=navhead[i].size) continue;
+        for (j=0;j<size;j+=navhead[i].elem) {
+            if (iszero(p+j,navhead[i].elem)) continue;
+            memcpy((char *)nav+navhead[i].off+j,p+j,navhead[i].elem);
+        }
+    }
+    if ((p=(const char *)getcacheblk(blk,nblk,CBLK_TSYS,&size))&&
+        size==sizeof(int)) {
+        memcpy(&nav->obstsys,p,size);
+    }
+    /* clock file is ok if any clock is read before (see readrnxclk()) */
+    if (flag&&st[0]==0&&st[1]=='C'&&nav->nc>0) return 1;
+    
+    return st[0];
+}
+/* read rinex file through binary cache ----------------------------------------
+* the file is read to empty data, saved to cache blocks and then appended to
+* obs/nav/sta in the same way as loaded from a valid cache file
+*-----------------------------------------------------------------------------*/
+static int readrnxcache(const char *file, gtime_t ts, gtime_t te, double tint,
+                        const char *opt, int flag, int index, char *type,
+                        obs_t *obs, nav_t *nav, sta_t *sta)
+{
+    FILE *fp;
+    uncfile_t unc;
+    cache_t cache;
+    cacheblk_t blk[MAXCACHEBLK];
+    obs_t obs0={0};
+    nav_t *nav0=NULL;
+    sta_t sta0;
+    bds_ion_t *ion;
+    char key[512],type0=' ';
+    int i,n=0,st[2],stat;
+    
+    trace(3,"readrnxcache: file=%s flag=%d index=%d\n",file,flag,index);
+    
+    sprintf(key,"rinex ts=%.3f te=%.3f tint=%.3f flag=%d index=%d in=%d%d%d "
+            "opt=%.256s",ts.time+ts.sec,te.time+te.sec,tint,flag,index,
+            obs!=NULL,nav!=NULL,sta!=NULL,opt);
+    
+    if (opencache(&cache,file,key)) {
+        if (nav&&isiGMAS(file)!=-1) nav->igmasta=isiGMAS(file);
+        stat=loadrnxblk(cache.blk,cache.n,flag,type,obs,nav,sta);
+        closecache(&cache);
+        return stat;
+    }
+    if (!(fp=open_uncfile(&unc,file,0))) {
+        trace(2,"rinex file open error: %s\n",file);
+        return 0;
+    }
+    if (nav&&isiGMAS(file)!=-1) nav->igmasta=isiGMAS(file);
+    
+    if (nav&&(!(nav0=(nav_t *)calloc(1,sizeof(nav_t)))||
+              !(nav0->ion_bdsk9=(BDSSH *)calloc(1,sizeof(BDSSH))))) {
+        free(nav0);
+        close_uncfile(&unc);
+        return -1;
+    }
+    init_sta(&sta0);
+    st[0]=readrnxfp(fp,&unc,ts,te,tint,opt,flag,index,&type0,obs?&obs0:NULL,
+                    nav0,sta?&sta0:NULL);
+    st[1]=type0;
+    close_uncfile(&unc);
+    
+    blk[n].id=CBLK_STAT; blk[n].data=st; blk[n++].size=sizeof(st);
+    if (obs) {
+        blk[n].id=CBLK_OBS; blk[n].data=obs0.data;
+        blk[n++].size=sizeof(obsd_t)*obs0.n;
+        if (type0=='O'&&index<=MAXRCV) {
+            blk[n].id=CBLK_ISCI; blk[n].data=obs0.isci;
+            blk[n++].size=sizeof(obs0.isci);
+        }
+    }
+    if (sta) {
+        blk[n].id=CBLK_STA; blk[n].data=&sta0; blk[n++].size=sizeof(sta_t);
+    }
+    if (nav0) {
+        ion=&nav0->ion_bdsk9->bds_ion;
+        blk[n].id=CBLK_EPH; blk[n].data=nav0->eph;
+        blk[n++].size=sizeof(eph_t)*nav0->n;
+        blk[n].id=CBLK_GEPH; blk[n].data=nav0->geph;
+        blk[n++].size=sizeof(geph_t)*nav0->ng;
+        blk[n].id=CBLK_SEPH; blk[n].data=nav0->seph;
+        blk[n++].size=sizeof(seph_t)*nav0->ns;
+        blk[n].id=CBLK_PCLK; blk[n].data=nav0->pclk;
+        blk[n++].size=sizeof(pclk_t)*nav0->nc;
+        blk[n].id=CBLK_BDSK8; blk[n].data=ion->bdsk8;
+        blk[n++].size=sizeof(bdsk8_t)*ion->nk8;
+        blk[n].id=CBLK_BDSSH9; blk[n].data=ion->bdssh9;
+        blk[n++].size=sizeof(bdssh9_t)*ion->nsh9;
+        if (type0=='O') {
+            blk[n].id=CBLK_TSYS; blk[n].data=&nav0->obstsys;
+            blk[n++].size=sizeof(int);
+        }
+        for (i=0;i<(int)(sizeof(navhead)/sizeof(*navhead));i++) {
+            if (iszero((char *)nav0+navhead[i].off,navhead[i].size)) continue;
+            blk[n].id=CBLK_NAVH+i; blk[n].data=(char *)nav0+navhead[i].off;
+            blk[n++].size=navhead[i].size;
+        }
+    }
+    /* cache only complete reading */
+    if (st[0]>=0) writecache(file,key,blk,n);
+    
+    stat=loadrnxblk(blk,n,flag,type,obs,nav,sta);
+    
+    free(obs0.data);
+    if (nav0) {
+        free(nav0->eph); free(nav0->geph); free(nav0->seph); free(nav0->pclk);
+        free(nav0->ion_bdsk9); free(nav0);
+    }
+    return stat;
+}
 /* uncompress and read rinex file --------------------------------------------*/
 /* ѹȡrinexļ -----------------------------------------------------*/
 static int readrnxfile(const char *file, gtime_t ts, gtime_t te, double tint,
@@ -2245,32 +2781,29 @@ static int readrnxfile(const char *file, gtime_t ts, gtime_t te, double tint,
                        obs_t *obs, nav_t *nav, sta_t *sta)
 {
     FILE *fp;
-    int cstat,stat;
-    char tmpfile[1024];
+    uncfile_t unc;
+    int stat;
     
     trace(3,"readrnxfile: file=%s flag=%d index=%d\n",file,flag,index);
     
     if (sta) init_sta(sta); //ʼվ
     
-    /* uncompress file */
-    if ((cstat=rtk_uncompress(file,tmpfile))<0) {
-        trace(2,"rinex file uncompact error: %s\n",file);
-        return 0;
+    /* read through binary cache */
+    if (getrdcache()) {
+        return readrnxcache(file,ts,te,tint,opt,flag,index,type,obs,nav,sta);
     }
-    if (!(fp=fopen(cstat?tmpfile:file,"r"))) {
-        trace(2,"rinex file open error: %s\n",cstat?tmpfile:file);
+    /* open file uncompressed in memory */
+    if (!(fp=open_uncfile(&unc,file,0))) {
+        trace(2,"rinex file open error: %s\n",file);
         return 0;
     }
      
 	if (isiGMAS(file) != -1)
         nav->igmasta = isiGMAS(file);
     /* read rinex file */
-    stat=readrnxfp(fp,ts,te,tint,opt,flag,index,type,obs,nav,sta);
-    
-    fclose(fp);
+    stat=readrnxfp(fp,&unc,ts,te,tint,opt,flag,index,type,obs,nav,sta);
     
-    /* delete temporary file */
-    if (cstat) remove(tmpfile);
+    close_uncfile(&unc);
     
     return stat;
 }
@@ -2319,7 +2852,7 @@ extern int readrnxt(const char *file, int rcv, gtime_t ts, gtime_t te,
     
     if (!*file) 
     {
-        return readrnxfp(stdin,ts,te,tint,opt,0,1,&type,obs,nav,sta);
+        return readrnxfp(stdin,NULL,ts,te,tint,opt,0,1,&type,obs,nav,sta);
     }
     //ʼfilesڴ
     for (i=0;i<MAXEXFILE;i++) 
@@ -2357,6 +2890,178 @@ extern int readrnx(const char *file, int rcv, const char *opt, obs_t *obs,
     
     return readrnxt(file,rcv,t,t,0.0,opt,obs,nav,sta);
 }
+/* time of last obs epoch in rinex obs file ----------------------------------*/
+static gtime_t lastobsepoch(FILE *fp, double ver, int tsys)
+{
+    gtime_t time={0},t;
+    char buff[MAXRNXLEN];
+    long pos=ftell(fp),size;
+    
+    if (pos<0||fseek(fp,0,SEEK_END)||(size=ftell(fp))<0) return time;
+    
+    fseek(fp,size-MAXRNXTAIL>pos?size-MAXRNXTAIL:pos,SEEK_SET);
+    
+    while (fgets(buff,MAXRNXLEN,fp)) {
+        if (ver<=2.99) { /* ver.2 */
+            if (strlen(buff)<32||buff[0]!=' '||buff[26]!=' '||buff[27]!=' '||
+                buff[28]<'0'||buff[28]>'1'||str2num(buff,29,3)<=0.0||
+                str2time(buff,0,26,&t)) continue;
+        }
+        else if (buff[0]!='>'||str2time(buff,1,28,&t)) continue; /* ver.3 */
+        time=t;
+    }
+    fseek(fp,pos,SEEK_SET);
+    
+    if (time.time==0) return time;
+    if (tsys==TSYS_UTC) return utc2gpst(time);
+    if (tsys==TSYS_CMP) return bdt2gpst(time);
+    return time;
+}
+/* open rinex obs file stream --------------------------------------------------
+* open rinex obs file to read obs data epoch by epoch instead of reading all of
+* the obs data by readrnxt(). files other than obs files are read at once as
+* readrnxt() does. the first epoch is read into the stream buffer
+* args   : rnxobsr_t *rnx   O   rinex obs file stream
+*          char   *file     I   file path (no wild-card)
+*          int    rcv       I   receiver number for obs data
+*          gtime_t ts,te    I   observation time start/end (time==0: no limit)
+*          double tint      I   observation time interval (s) (0:all)
+*          char   *opt      I   rinex options (see readrnxt())
+*          nav_t  *nav      IO  navigation data
+*          sta_t  *sta      IO  station parameters (NULL: no input)
+* return : status (1:obs file opened,0:no obs file,-1:error)
+* notes  : close the stream by close_rnxobsr() if the status is 1
+*-----------------------------------------------------------------------------*/
+extern int open_rnxobsr(rnxobsr_t *rnx, const char *file, int rcv, gtime_t ts,
+                        gtime_t te, double tint, const char *opt, nav_t *nav,
+                        sta_t *sta)
+{
+    FILE *fp;
+    uncfile_t unc;
+    sigind_t *index;
+    double ver;
+    int i,j,sys,tsys=TSYS_GPS,stat;
+    char type=' ',tobs[NUMSYS][MAXOBSTYPE][4]={{""}};
+    const char *p;
+    
+    trace(3,"open_rnxobsr: file=%s rcv=%d\n",file,rcv);
+    
+    rnx->unc.fp=NULL; rnx->unc.buff=NULL; rnx->index=NULL; rnx->map=NULL;
+    rnx->n=-1;
+    
+    if (sta) init_sta(sta);
+    
+    /* open file uncompressed in memory */
+    if (!(fp=open_uncfile(&unc,file,0))) {
+        trace(2,"rinex file open error: %s\n",file);
+        return 0;
+    }
+    if (isiGMAS(file)!=-1) nav->igmasta=isiGMAS(file);
+    
+    if (!readrnxh(fp,&ver,&type,&sys,&tsys,tobs,nav,sta)) type=' ';
+    
+    /* read other than obs file at once */
+    if (type!='O'||rcv>MAXRCV) {
+        stat=type=='C'||type==' '?0:readrnxb(fp,&unc,ts,te,tint,opt,rcv,type,
+                                             ver,sys,&tsys,tobs,NULL,nav,sta);
+        close_uncfile(&unc);
+        return stat<0?-1:0;
+    }
+    nav->obstsys=tsys;
+    
+    if (!(index=(sigind_t *)calloc(NUMSYS,sizeof(sigind_t)))) {
+        close_uncfile(&unc);
+        return -1;
+    }
+    set_obsindex(ver,opt,tobs,index,rnx->isci);
+    
+    rnx->unc=unc;
+    rnx->rcv=rcv;
+    rnx->ver=ver;
+    rnx->tsys=tsys;
+    for (i=0;i<NUMSYS;i++) for (j=0;j<MAXOBSTYPE;j++) {
+        strcpy(rnx->tobs[i][j],tobs[i][j]);
+    }
+    rnx->index=index;
+    rnx->sta=sta;
+    rnx->ts=ts; rnx->te=te; rnx->tint=tint;
+    sprintf(rnx->opt,"%.255s",opt);
+    memset(rnx->slips,0,sizeof(rnx->slips));
+    rnx->tend=lastobsepoch(fp,ver,tsys);
+    
+    /* map obs data body */
+    if ((rnx->map=malloc(sizeof(rnxmap_t)))&&
+        !openmap((rnxmap_t *)rnx->map,fp,opt,&rnx->unc)) {
+        free(rnx->map);
+        rnx->map=NULL;
+    }
+    
+    /* if station name empty, set 4-char name from file head */
+    if (sta&&!*sta->name) {
+        if (!(p=strrchr(file,FILEPATHSEP))) p=file-1;
+        setstr(sta->name,p+1,4);
+    }
+    input_rnxobsr(rnx);
+    return 1;
+}
+/* input rinex obs file stream -------------------------------------------------
+* read obs data of next epoch screened by time into stream buffer
+* args   : rnxobsr_t *rnx   IO  rinex obs file stream
+* return : number of obs data (-1: end of file)
+*-----------------------------------------------------------------------------*/
+extern int input_rnxobsr(rnxobsr_t *rnx)
+{
+    int i,n,flag=0;
+    
+    trace(4,"input_rnxobsr: rcv=%d\n",rnx->rcv);
+    
+    if (!rnx->unc.fp) return rnx->n=-1;
+    
+    while ((n=rnx->map?readrnxobsm((rnxmap_t *)rnx->map,rnx->ver,&rnx->tsys,
+                                   rnx->tobs,&flag,rnx->data,rnx->sta,
+                                   (sigind_t *)rnx->index):
+                       readrnxobsb(rnx->unc.fp,rnx->opt,rnx->ver,&rnx->tsys,
+                                   rnx->tobs,&flag,rnx->data,rnx->sta,
+                                   (sigind_t *)rnx->index))>=0) {
+        for (i=0;i<n;i++) {
+            
+            /* utc/bdt -> gpst */
+            if (rnx->tsys==TSYS_UTC) rnx->data[i].time=utc2gpst(rnx->data[i].time);
+            if (rnx->tsys==TSYS_CMP) rnx->data[i].time=bdt2gpst(rnx->data[i].time);
+            
+            /* save cycle-slip */
+            saveslips(rnx->slips,rnx->data+i);
+        }
+        /* screen data by time */
+        if (n<=0||!screent(rnx->data[0].time,rnx->ts,rnx->te,rnx->tint)) continue;
+        
+        for (i=0;i<n;i++) {
+            
+            /* restore cycle-slip */
+            restslips(rnx->slips,rnx->data+i);
+            
+            rnx->data[i].rcv=(unsigned char)rnx->rcv;
+        }
+        return rnx->n=n;
+    }
+    return rnx->n=-1;
+}
+/* close rinex obs file stream -------------------------------------------------
+* close rinex obs file stream and free uncompressed data
+* args   : rnxobsr_t *rnx   IO  rinex obs file stream
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void close_rnxobsr(rnxobsr_t *rnx)
+{
+    trace(3,"close_rnxobsr: rcv=%d\n",rnx->rcv);
+    
+    if (rnx->map) closemap((rnxmap_t *)rnx->map);
+    close_uncfile(&rnx->unc);
+    free(rnx->map);
+    free(rnx->index);
+    rnx->index=NULL; rnx->map=NULL;
+    rnx->n=-1;
+}
 /* compare precise clock -----------------------------------------------------*/
 static int cmppclk(const void *p1, const void *p2)
 {
@@ -125,6 +125,11 @@
 *           2016/09/19 1.42 modify api deg2dms() to consider numerical error
 *           2017/04/11 1.43 delete EXPORT for global variables
 *           2018/10/10 1.44 modify api satexclude()
+*           2025/07/05 1.45 parse numbers of str2num(),str2time() in place
+*                           add api parsenum(),str2nums()
+*           2025/07/06 1.46 uncompress files in process by rtk_uncompress()
+*           2025/07/24 1.47 index ephemerides by uniqnav()
+*           2025/07/26 1.48 compile indexed ephemerides by uniqnav()
 *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 199506
 #include <stdarg.h>
@@ -149,6 +154,7 @@
 
 #define SQR(x)      ((x)*(x))
 #define MAX_VAR_EPH SQR(300.0)  /* max variance eph to reject satellite (m^2) */
+#define MAXHEADSIZE 65536       /* size of compressed file to read header (bytes) */
 
 static const double gpst0[]={1980,1, 6,0,0,0}; /* gps time reference            /GPS参考时间 */
 static const double gst0 []={1999,8,22,0,0,0}; /* galileo system time reference /GLONASS参考时间 */
@@ -1286,6 +1292,48 @@ extern void matprint(const double A[], int n, int m, int p, int q)
 {
     matfprint(A,n,m,p,q,stdout);
 }
+/* parse number in place -----------------------------------------------------*/
+static int parsenumx(const char *s, int n, int dexp, double *val)
+{
+    static const double pow10[]={
+        1E0 ,1E1 ,1E2 ,1E3 ,1E4 ,1E5 ,1E6 ,1E7 ,1E8 ,1E9 ,1E10,1E11,
+        1E12,1E13,1E14,1E15,1E16,1E17,1E18,1E19,1E20,1E21,1E22
+    };
+    const char *p=s,*e=s+n;
+    long long m=0;
+    int nd=0,nf=-1,ne=0,ex=0,neg=0,nege=0;
+    
+    *val=0.0;
+    for (;p<e&&*p&&isspace((unsigned char)*p);p++) ;
+    if (p>=e||!*p) return 0;
+    if (*p=='-'||*p=='+') neg=*p++=='-';
+    
+    for (;p<e;p++) { /* mantissa */
+        if ('0'<=*p&&*p<='9') {
+            if (++nd<=15) m=m*10+(*p-'0');
+            if (nf>=0) nf++;
+        }
+        else if (*p=='.'&&nf<0) nf=0;
+        else break;
+    }
+    if (nd<=0||nd>15) return -1;
+    
+    if (p<e&&(*p=='E'||*p=='e'||(dexp&&(*p=='D'||*p=='d')))) { /* exponent */
+        if (++p<e&&(*p=='-'||*p=='+')) nege=*p++=='-';
+        for (;p<e&&'0'<=*p&&*p<='9';p++) {
+            if (++ne<=3) ex=ex*10+(*p-'0');
+        }
+        if (ne<=0||ne>3) return -1;
+        if (nege) ex=-ex;
+    }
+    if (p<e&&isalnum((unsigned char)*p)) return -1;
+    
+    if (nf>0) ex-=nf;
+    if (ex<-22||ex>22) return -1;
+    *val=ex<0?(double)m/pow10[-ex]:(double)m*pow10[ex];
+    if (neg) *val=-*val;
+    return (int)(p-s);
+}
 /* string to number ------------------------------------------------------------
 * convert substring in string to number
 * 指针向后移i个位置，从第i+1个字符开始，提取n个字符并转换为double
@@ -1300,11 +1348,51 @@ extern double str2num(const char *s, int i, int n)
     double value;
     char str[256],*p=str;
     
-    if (i<0||(int)strlen(s)<i||(int)sizeof(str)-1<n) return 0.0;    //起始位置不能为负，不能超出s长度，提取数目不能超过str长度
+    if (i<0||memchr(s,'\0',i)||(int)sizeof(str)-1<n) return 0.0;    //起始位置不能为负，不能超出s长度，提取数目不能超过str长度
+    if (parsenumx(s+i,n,1,&value)>=0) return value;
     for (s += i; *s && --n >= 0; s++) *p++ = *s == 'd' || *s == 'D' ? 'E' : *s;
     *p='\0';
     return sscanf(str,"%lf",&value)==1?value:0.0;
 }
+/* parse number in fixed-width field -------------------------------------------
+* parse decimal number "[sign]digits[.digits][(E|D)[sign]digits]" after spaces
+* in place without copying the field
+* args   : char   *s        I   field (up to n chars or null)
+*          int    n         I   field width
+*          double *val      O   number (0.0: blank field)
+* return : number of chars parsed (0: blank field, -1: unsupported number)
+* notes  : a mantissa of 15 digits or less and a power of 10 of 22 or less are
+*          exact in double, so the value is correctly rounded and the same as
+*          sscanf(). convert the field by str2num() if the return value is -1.
+*-----------------------------------------------------------------------------*/
+extern int parsenum(const char *s, int n, double *val)
+{
+    return parsenumx(s,n,1,val);
+}
+/* string to numbers of fixed-width fields -------------------------------------
+* convert n consecutive fixed-width fields in string to numbers, the same as
+* str2num() for each field
+* args   : char   *s        I   string ("... nnn.nnn nnn.nnn ...")
+*          int    i         I   position of the first field
+*          int    w         I   field width
+*          int    n         I   number of fields
+*          double *val      O   converted numbers (0.0: error)
+* return : number of fields starting in string
+*-----------------------------------------------------------------------------*/
+extern int str2nums(const char *s, int i, int w, int n, double *val)
+{
+    int j,m=0,len=(int)strlen(s);
+    
+    for (j=0;j<n;j++,i+=w) {
+        if (i<0||len<i) {
+            val[j]=0.0;
+            continue;
+        }
+        if (parsenumx(s+i,w,1,val+j)<0) val[j]=str2num(s,i,w);
+        if (i<len) m++;
+    }
+    return m;
+}
 /* string to time --------------------------------------------------------------
 * convert substring in string to gtime_t struct
 * args   : char   *s        I   string ("... yyyy mm dd hh mm ss ...")
@@ -1316,12 +1404,20 @@ extern int str2time(const char *s, int i, int n, gtime_t *t)
 {
     double ep[6];
     char str[256],*p=str;
+    int j,k,m;
     
-    if (i<0||(int)strlen(s)<i||(int)sizeof(str)-1<i) return -1;
-    for (s+=i;*s&&--n>=0;) *p++=*s++;
-    *p='\0';
-    if (sscanf(str,"%lf %lf %lf %lf %lf %lf",ep,ep+1,ep+2,ep+3,ep+4,ep+5)<6)
-        return -1;
+    if (i<0||memchr(s,'\0',i)||(int)sizeof(str)-1<i) return -1;
+    
+    /* parse fields in place */
+    for (j=0,k=i;j<6;j++,k+=m) {
+        if ((m=parsenumx(s+k,n-(k-i),0,ep+j))<=0) break;
+    }
+    if (j<6) {
+        for (s+=i;*s&&--n>=0;) *p++=*s++;
+        *p='\0';
+        if (sscanf(str,"%lf %lf %lf %lf %lf %lf",ep,ep+1,ep+2,ep+3,ep+4,ep+5)<6)
+            return -1;
+    }
     if (ep[0]<100.0) ep[0]+=ep[0]<80.0?2000.0:1900.0;
     *t=epoch2time(ep);
     return 0;
@@ -1711,11 +1807,11 @@ extern void time2str(gtime_t t, char *s, int n)
 * args   : gtime_t t        I   gtime_t struct
 *          int    n         I   number of decimals
 * return : time string
-* notes  : not reentrant, do not use multiple in a function
+* notes  : not reentrant, do not use multiple in a function (thread-local)
 *-----------------------------------------------------------------------------*/
 extern char *time_str(gtime_t t, int n)
 {
-    static char buff[64];
+    static thread_local char buff[64];
     time2str(t,buff,n);
     return buff;
 }
@@ -2104,13 +2200,13 @@ static void nut_iau1980(double t, const double *f, double *dpsi, double *deps)
 *                               (NULL: no output)
 * return : none
 * note   : see ref [3] chap 5
-*          not thread-safe
+*          cache of the last transformation is thread-local
 *-----------------------------------------------------------------------------*/
 extern void eci2ecef(gtime_t tutc, const double *erpv, double *U, double *gmst)
 {
     const double ep2000[]={2000,1,1,12,0,0};
-    static gtime_t tutc_;
-    static double U_[9],gmst_;
+    static thread_local gtime_t tutc_;
+    static thread_local double U_[9],gmst_;
     gtime_t tgps;
     double eps,ze,th,z,t,t2,t3,dpsi,deps,gast,f[5];
     double R1[9],R2[9],R3[9],R[9],W[9],N[9],P[9],NP[9];
@@ -2753,10 +2849,86 @@ static void uniqseph(nav_t *nav)
     
     trace(4,"uniqseph: ns=%d\n",nav->ns);
 }
+/* ephemeris index type of ephemeris -----------------------------------------*/
+static int ephidxtype(const eph_t *eph)
+{
+    if (satsys(eph->sat,NULL)==SYS_GAL&&(eph->code&(1<<8))) return EPHIDX_FNAV;
+    return 0<=eph->code&&eph->code<EPHIDX_FNAV?eph->code:-1;
+}
+/* compare ephemeris index entries -------------------------------------------*/
+typedef struct {
+    int key;                /* satellite/type */
+    gtime_t toe;            /* toe */
+    int i;                  /* index of ephemeris */
+} idxent_t;
+
+static int cmpidxent(const void *p1, const void *p2)
+{
+    idxent_t *q1=(idxent_t *)p1,*q2=(idxent_t *)p2;
+    double tt;
+    if (q1->key!=q2->key) return q1->key-q2->key;
+    if ((tt=timediff(q1->toe,q2->toe))!=0.0) return tt<0.0?-1:1;
+    return q1->i-q2->i;
+}
+/* index ephemerides -----------------------------------------------------------
+* build index of ephemerides sorted by toe for each satellite and type, used
+* by the ephemeris selection instead of the linear search of all ephemerides.
+* the types are eph->code 0-3 (gps/qzs/bds lnav, bds cnav1-3) and galileo
+* f/nav. the index is valid while nav->eph/geph and nav->n/ng are unchanged.
+* the ephemerides are also compiled to the constants for eph2pos().
+*-----------------------------------------------------------------------------*/
+static void indexnav(nav_t *nav)
+{
+    ephidx_t *x;
+    idxent_t *ent;
+    int i,n=0,type;
+    
+    trace(3,"indexnav: n=%d ng=%d\n",nav->n,nav->ng);
+    
+    free(nav->ephidx); nav->ephidx=NULL;
+    
+    if (!(x=(ephidx_t *)malloc(sizeof(ephidx_t)+sizeof(ephc_t)*nav->n+
+                               sizeof(int)*(nav->n+nav->ng+1)))||
+        !(ent=(idxent_t *)malloc(sizeof(idxent_t)*(nav->n+nav->ng+1)))) {
+        free(x);
+        return;
+    }
+    x->ec=(ephc_t *)(x+1);
+    x->idx=(int *)(x->ec+nav->n);
+    x->eph =nav->eph;  x->n =nav->n;
+    x->geph=nav->geph; x->ng=nav->ng;
+    
+    for (i=0;i<nav->n;i++) {
+        compeph(nav->eph+i,x->ec+i);
+        if ((type=ephidxtype(nav->eph+i))<0) continue;
+        ent[n].key=(nav->eph[i].sat-1)*NEPHIDX+type;
+        ent[n].toe=nav->eph[i].toe;
+        ent[n++].i=i;
+    }
+    qsort(ent,n,sizeof(idxent_t),cmpidxent);
+    for (i=0;i<n;i++) x->idx[i]=ent[i].i;
+    for (i=0,x->ie[0]=0;i<MAXSAT*NEPHIDX;i++) {
+        for (x->ie[i+1]=x->ie[i];x->ie[i+1]<n&&ent[x->ie[i+1]].key==i;x->ie[i+1]++) ;
+    }
+    for (i=n=0;i<nav->ng;i++) {
+        ent[n].key=nav->geph[i].sat-1;
+        ent[n].toe=nav->geph[i].toe;
+        ent[n++].i=i;
+    }
+    qsort(ent,n,sizeof(idxent_t),cmpidxent);
+    for (i=0;i<n;i++) x->idx[x->ie[MAXSAT*NEPHIDX]+i]=ent[i].i;
+    for (i=0,x->ig[0]=x->ie[MAXSAT*NEPHIDX];i<MAXSAT;i++) {
+        for (x->ig[i+1]=x->ig[i];x->ig[i+1]<x->ig[0]+n&&
+             ent[x->ig[i+1]-x->ig[0]].key==i;x->ig[i+1]++) ;
+    }
+    free(ent);
+    nav->ephidx=x;
+}
 /* unique ephemerides ----------------------------------------------------------
 * unique ephemerides in navigation data and update carrier wave length
 * args   : nav_t *nav    IO     navigation data
 * return : number of epochs
+* notes  : nav->ephidx is also built. free it by freenav() or free()
 *-----------------------------------------------------------------------------*/
 extern void uniqnav(nav_t *nav)
 {
@@ -2769,6 +2941,9 @@ extern void uniqnav(nav_t *nav)
     uniqgeph(nav);
     uniqseph(nav);
     
+    /* index of ephemerides for selection */
+    indexnav(nav);
+    
     /* update carrier wave length */
     for (i=0;i<MAXSAT;i++) for (j=0;j<NFREQ;j++) {
         nav->lam[i][j]=satwavelen(i+1,j,nav);
@@ -2981,6 +3156,7 @@ extern void freeobs(obs_t *obs)
 *-----------------------------------------------------------------------------*/
 extern void freenav(nav_t *nav, int opt)
 {
+    if (opt&0x03) {free(nav->ephidx); nav->ephidx=NULL;}
     if (opt&0x01) {free(nav->eph ); nav->eph =NULL; nav->n =nav->nmax =0;}
     if (opt&0x02) {free(nav->geph); nav->geph=NULL; nav->ng=nav->ngmax=0;}
     if (opt&0x04) {free(nav->seph); nav->seph=NULL; nav->ns=nav->nsmax=0;}
@@ -4018,12 +4194,16 @@ extern void csmooth(obs_t *obs, int ns)
 *          char   *uncfile  O   uncompressed file
 * return : status (-1:error,0:not compressed file,1:uncompress completed)
 * note   : creates uncompressed file in tempolary directory
-*          gzip and crx2rnx commands have to be installed in commands path
+*          gzip, compress, zip and hatanaka-compressed files are uncompressed
+*          by rtk_uncompbuff(). tar command has to be installed in commands path
+*          to extract tar file
 *-----------------------------------------------------------------------------*/
 extern int rtk_uncompress(const char *file, char *uncfile)
 {
+    FILE *fp;
+    size_t size;
     int stat=0;
-    char* p, cmd[2048] = "", tmpfile[1024] = "", buff[1024], * fname;
+    char* p, cmd[2048] = "", tmpfile[1024] = "", buff[1024], * fname, * data;
     const char* dir = "";
     
     trace(3,"rtk_uncompress: file=%s\n",file);
@@ -4031,20 +4211,30 @@ extern int rtk_uncompress(const char *file, char *uncfile)
     strcpy(tmpfile,file);
     if (!(p=strrchr(tmpfile,'.'))) return 0;
     
-    /* uncompress by gzip */
-    if (!strcmp(p,".z"  )||!strcmp(p,".Z"  )||
-        !strcmp(p,".gz" )||!strcmp(p,".GZ" )||
-        !strcmp(p,".zip")||!strcmp(p,".ZIP")) {
-        
-        strcpy(uncfile,tmpfile); uncfile[p-tmpfile]='\0';
-        sprintf(cmd,"gzip -f -d -c \"%s\" > \"%s\"",tmpfile,uncfile);
-        
-        if (execcmd(cmd)) {
+    /* uncompress gzip/compress/zip and hatanaka-compressed file */
+    if ((stat=rtk_uncompbuff(file,0,&data,&size))<0) return -1;
+    
+    if (stat) {
+        strcpy(uncfile,tmpfile);
+        if (!strcmp(p,".z"  )||!strcmp(p,".Z"  )||
+            !strcmp(p,".gz" )||!strcmp(p,".GZ" )||
+            !strcmp(p,".zip")||!strcmp(p,".ZIP")) {
+            uncfile[p-tmpfile]='\0';
+        }
+        if ((p=strrchr(uncfile,'.'))&&strlen(p)==4) {
+            if      (!strcmp(p,".crx")) strcpy(p,".rnx");
+            else if (!strcmp(p,".CRX")) strcpy(p,".RNX");
+            else if (p[3]=='d'||p[3]=='D') p[3]=p[3]=='D'?'O':'o';
+        }
+        if (!(fp=fopen(uncfile,"wb"))||fwrite(data,1,size,fp)!=size) {
+            if (fp) fclose(fp);
             remove(uncfile);
+            free(data);
             return -1;
         }
+        fclose(fp);
+        free(data);
         strcpy(tmpfile,uncfile);
-        stat=1;
     }
     /* extract tar file */
     if ((p=strrchr(tmpfile,'.'))&&!strcmp(p,".tar")) {
@@ -4071,21 +4261,6 @@ extern int rtk_uncompress(const char *file, char *uncfile)
         if (stat) remove(tmpfile);
         stat=1;
     }
-    /* extract hatanaka-compressed file by cnx2rnx */
-    else if ((p=strrchr(tmpfile,'.'))&&strlen(p)>3&&(*(p+3)=='d'||*(p+3)=='D')) {
-        
-        strcpy(uncfile,tmpfile);
-        uncfile[p-tmpfile+3]=*(p+3)=='D'?'O':'o';
-        sprintf(cmd,"crx2rnx < \"%s\" > \"%s\"",tmpfile,uncfile);
-        
-        if (execcmd(cmd)) {
-            remove(uncfile);
-            if (stat) remove(tmpfile);
-            return -1;
-        }
-        if (stat) remove(tmpfile);
-        stat=1;
-    }
     trace(3,"rtk_uncompress: stat=%d\n",stat);
     return stat;
 }
@@ -4236,7 +4411,8 @@ extern void OutLog(char* stm, time_t EndTime, const char* logfilepath, prcopt_t
 
 extern int ReadPosAndAnt(char** infile, prcopt_t* opt)
 {
-    FILE* fp = fopen(infile[1], "r");
+    uncfile_t unc;
+    FILE* fp = open_uncfile(&unc, infile[1], MAXHEADSIZE);
     double ant[3] = { 0 }, pos[3] = { 0 };
     char temp[1024] = "";
     while (fgets(temp, 100, fp))
@@ -4267,13 +4443,14 @@ extern int ReadPosAndAnt(char** infile, prcopt_t* opt)
         opt->ru[1] = pos[1];
         opt->ru[2] = pos[2];
     }
-    fclose(fp);
+    close_uncfile(&unc);
     return 0;
 }
 
 extern int OutfilePathSet(char** infile, char* outfile, prcopt_t opt)
 {
-    FILE *fp=fopen(infile[1], "r");
+    uncfile_t unc;
+    FILE *fp=open_uncfile(&unc, infile[1], MAXHEADSIZE);
     char* p;
     char temp[1024], temp2[1024];
     char sitename[5];
@@ -4308,8 +4485,8 @@ extern int OutfilePathSet(char** infile, char* outfile, prcopt_t opt)
     fgets(temp, 100, fp);
     if (!strstr(temp, "OBSERVATION DATA"))
     {
-        fclose(fp);
-        fp = fopen(infile[0], "r");
+        close_uncfile(&unc);
+        fp = open_uncfile(&unc, infile[0], MAXHEADSIZE);
     }
     while (fgets(temp, 100, fp))
     {
@@ -4389,13 +4566,14 @@ extern int OutfilePathSet(char** infile, char* outfile, prcopt_t opt)
         }
     }
     strcpy(outfile, temp2);
-    fclose(fp);
+    close_uncfile(&unc);
     return 1;
 }
 
 extern int LogfilePathSet(char** infile, char* logfile, prcopt_t opt)
 {
-    FILE* fp = fopen(infile[1], "r");
+    uncfile_t unc;
+    FILE* fp = open_uncfile(&unc, infile[1], MAXHEADSIZE);
     char* p;
     char temp[1024], temp2[1024];
     char sitename[5];
@@ -4430,8 +4608,8 @@ extern int LogfilePathSet(char** infile, char* logfile, prcopt_t opt)
     fgets(temp, 100, fp);
     if (!strstr(temp, "OBSERVATION DATA"))
     {
-        fclose(fp);
-        fp = fopen(infile[0], "r");
+        close_uncfile(&unc);
+        fp = open_uncfile(&unc, infile[0], MAXHEADSIZE);
     }
     while (fgets(temp, 100, fp))
     {
@@ -4507,7 +4685,7 @@ extern int LogfilePathSet(char** infile, char* logfile, prcopt_t opt)
         }
     }
     strcpy(logfile, temp2);
-    fclose(fp);
+    close_uncfile(&unc);
     return 1;
 }
 
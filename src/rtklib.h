@@ -249,6 +249,7 @@ extern "C" {
 #define INT_SWAP_STAT 86400.0           /* swap interval of solution status file (s) */
 
 #define MAXEXFILE   1024                /* max number of expanded files */
+#define MAXCACHEBLK 32                  /* max number of blocks in cache file */
 #define MAXSBSAGEF  30.0                /* max age of SBAS fast correction (s) */
 #define MAXSBSAGEL  1800.0              /* max age of SBAS long term corr (s) */
 #define MAXSBSURA   8                   /* max URA of SBAS satellite */
@@ -392,6 +393,10 @@ extern "C" {
 #define IONOOPT_BDSION 13                /* ionosphere option: BDS SH9 parameters*/
 #define IONOOPT_GALION 14                /* ionosphere option: Galileo niquick 3 parameters */
 
+#define NQMODE_REF  0                   /* nequick-g integration: reference (specification) */
+#define NQMODE_FAST 1                   /* nequick-g integration: looser tolerance+profile reuse */
+#define NQMODE_FIXED 2                  /* nequick-g integration: fixed-order quadrature */
+
 #define TROPOPT_OFF 0                   /* troposphere option: correction off */
 #define TROPOPT_SAAS 1                  /* troposphere option: Saastamoinen model */
 #define TROPOPT_SBAS 2                  /* troposphere option: SBAS model */
@@ -405,6 +410,10 @@ extern "C" {
 #define EPHOPT_SSRAPC 3                 /* ephemeris option: broadcast + SSR_APC */
 #define EPHOPT_SSRCOM 4                 /* ephemeris option: broadcast + SSR_COM */
 #define EPHOPT_LEX  5                   /* ephemeris option: QZSS LEX ephemeris */
+#define EPHOPT_CHEB 6                   /* ephemeris option: chebyshev orbit/clock */
+
+#define NEPHIDX     5                   /* ephemeris index types (code 0-3,gal f/nav) */
+#define EPHIDX_FNAV 4                   /* ephemeris index type: galileo f/nav */
 
 #define ARMODE_OFF  0                   /* AR mode: off */
 #define ARMODE_CONT 1                   /* AR mode: continuous */
@@ -883,6 +892,55 @@ typedef struct {        /* ppp corrections type */
 
 
 
+typedef struct {        /* compiled broadcast ephemeris type */
+    int sys;            /* navigation system */
+    int geo;            /* beidou geo satellite (0:no,1:yes) */
+    int cnav;           /* beidou cnav with Adot/ndot (0:no,1:yes) */
+    double mu,omge;     /* gravitational constant, earth angular velocity */
+    double n;           /* mean motion (rad/s) (cnav: without delta n) */
+    double sqe;         /* sqrt(1-e^2) */
+    double OMGd;        /* rate of OMEGA - earth angular velocity (geo: OMGd) */
+    double OMGt;        /* earth angular velocity * toes (rad) */
+    double rel;         /* 2*sqrt(mu*A)*e for relativity correction (lnav) */
+    double var;         /* position and clock error variance (m^2) */
+} ephc_t;
+
+typedef struct {        /* ephemeris index type */
+    const eph_t *eph;   /* indexed ephemeris */
+    const geph_t *geph; /* indexed glonass ephemeris */
+    int n,ng;           /* number of indexed ephemeris/glonass ephemeris */
+    int *idx;           /* ephemeris indices sorted by toe in satellite/type */
+    ephc_t *ec;         /* compiled ephemerides of indexed ephemeris */
+    int ie[MAXSAT*NEPHIDX+1]; /* start of satellite/type in idx (ephemeris) */
+    int ig[MAXSAT+1];   /* start of satellite in idx (glonass ephemeris) */
+} ephidx_t;
+
+typedef struct {        /* chebyshev series type */
+    int deg;            /* degree of polynomials */
+    int nc;             /* number of components (orbit:3,clock:1) */
+    int ns;             /* number of segments */
+    int *m;             /* number of segments in blocks (0:no data) */
+    int *off;           /* index of first segment in blocks */
+    float *var;         /* variance of blocks (m^2) */
+    double *c;          /* coefficients of segments {c0..cdeg} x nc (m) */
+} chebs_t;
+
+typedef struct {        /* chebyshev orbit/clock arc of satellite type */
+    int sat;            /* satellite number */
+    int *svh;           /* sv health of blocks */
+    chebs_t s[2];       /* series {orbit,clock} */
+} chebarc_t;
+
+typedef struct {        /* chebyshev orbit/clock type */
+    gtime_t ts;         /* start time of blocks (gpst) */
+    double tblk;        /* block length (s) */
+    double tol;         /* accuracy target of fitting (m) */
+    int nb;             /* number of blocks */
+    int n;              /* number of arcs */
+    chebarc_t *arc;     /* arcs of satellites */
+    int idx[MAXSAT];    /* arc index of satellites (-1:no arc) */
+} cheb_t;
+
 typedef struct {        /* navigation data type */
     int n,nmax;         /* number of broadcast ephemeris */
     int ng,ngmax;       /* number of glonass ephemeris */
@@ -895,6 +953,8 @@ typedef struct {        /* navigation data type */
     eph_t *eph;         /* GPS/QZS/GAL ephemeris */
     geph_t *geph;       /* GLONASS ephemeris */
     seph_t *seph;       /* SBAS ephemeris */
+    ephidx_t *ephidx;   /* ephemeris index by uniqnav() (NULL: no index) */
+    cheb_t *cheb;       /* chebyshev orbit/clock (NULL: no data) */
     peph_t *peph;       /* precise ephemeris */
     pclk_t *pclk;       /* precise clock */
     alm_t *alm;         /* almanac data */
@@ -929,6 +989,7 @@ typedef struct {        /* navigation data type */
     lexion_t lexion;    /* LEX ionosphere correction */
     pppcorr_t pppcorr;  /* ppp corrections */
 	BDSSH  *ion_bdsk9;   /* BeiDou iono model parameters k9*/
+	void   *nequick;     /* Galileo NeQuick-G model context (nequick_open()) */
 	double tgd[MAXSAT][NFREQ]; /* tgd (s),B1I/2I/3I/1C/2a */
 	int galfreq, galcode;   /* */
 	int obstsys;
@@ -1049,6 +1110,47 @@ typedef struct {        /* rinex control struct type */
     char   opt[256];    /* rinex dependent options */
 } rnxctr_t;
 
+typedef struct {        /* uncompressed input file type */
+    FILE   *fp;         /* file pointer (NULL: closed) */
+    char   *buff;       /* data uncompressed in memory (NULL: not compressed) */
+    size_t size;        /* size of uncompressed data (bytes) */
+} uncfile_t;
+
+typedef struct {        /* binary cache data block type */
+    int    id;          /* block id */
+    size_t size;        /* block size (bytes) */
+    const void *data;   /* block data */
+} cacheblk_t;
+
+typedef struct {        /* binary cache file type */
+    cacheblk_t blk[MAXCACHEBLK]; /* data blocks */
+    int    n;           /* number of data blocks */
+    const char *addr;   /* mapped cache file (NULL: not opened) */
+    size_t size;        /* size of cache file (bytes) */
+#ifdef WIN32
+    HANDLE hmap;        /* file mapping handle */
+#endif
+} cache_t;
+
+typedef struct {        /* rinex obs file stream type */
+    uncfile_t unc;      /* input file (unc.fp=NULL: closed) */
+    int    rcv;         /* receiver number */
+    double ver;         /* rinex version */
+    int    tsys;        /* time system */
+    char   tobs[7][MAXOBSTYPE][4]; /* rinex obs types */
+    void   *index;      /* signal index */
+    int    isci[7][MAXFREQ]; /* isc index of signals */
+    void   *map;        /* memory-mapped obs data body (NULL: fgets()) */
+    sta_t  *sta;        /* station parameters (NULL: no input) */
+    gtime_t ts,te;      /* observation time start/end (time==0: no limit) */
+    double tint;        /* observation time interval (s) (0:all) */
+    char   opt[256];    /* rinex options */
+    gtime_t tend;       /* time of last epoch in file (time==0: unknown) */
+    unsigned char slips[MAXSAT][NFREQ]; /* cycle-slips of screened epochs */
+    obsd_t data[MAXOBS]; /* obs data of current epoch */
+    int    n;           /* number of obs data of current epoch (-1: end) */
+} rnxobsr_t;
+
 typedef struct {        /* download url type */
     char type[32];      /* data type */
     char path[1024];    /* url path */
@@ -1139,6 +1241,7 @@ typedef struct {        /* processing options type */
     char pppopt[256];   /* ppp option */
 	double  coordfixed;      /* nalysis only.0: SPP, unlimited~1E6: fixed to known position. Default: 0 */
 	int  outsat;
+    int  nqmode;        /* nequick-g integration mode (NQMODE_???) */
 } prcopt_t;
 
 typedef struct {        /* solution options type */
@@ -1445,6 +1548,54 @@ typedef struct {        /* imu type */
     unsigned char buff[256]; /* imu data buffer */
 } imu_t;
 
+typedef struct {        /* shared post-processing products type */
+    nav_t nav;          /* broadcast/precise ephemeris, clock, tec, dcb, erp */
+    pcvs_t pcvs;        /* satellite antenna parameters */
+    pcvs_t pcvr;        /* receiver antenna parameters */
+} postprod_t;
+
+typedef struct {        /* post-processing session type */
+    pcvs_t pcvss;       /* satellite antenna parameters */
+    pcvs_t pcvsr;       /* receiver antenna parameters */
+    obs_t obss;         /* observation data */
+    nav_t navs;         /* navigation data */
+    sbs_t sbss;         /* sbas messages */
+    lex_t lexs;         /* lex messages */
+    sta_t stas[MAXRCV]; /* station infomation */
+    int nepoch;         /* number of observation epochs */
+    int iobsu;          /* current rover observation data index */
+    int iobsr;          /* current reference observation data index */
+    int isbs;           /* current sbas message index */
+    int ilex;           /* current lex message index */
+    int revs;           /* analysis direction (0:forward,1:backward) */
+    int prgbar;         /* progress bar */
+    int aborts;         /* abort status */
+    sol_t *solf;        /* forward solutions */
+    sol_t *solb;        /* backward solutions */
+    double *rbf;        /* forward base positions */
+    double *rbb;        /* backward base positions */
+    int isolf;          /* current forward solutions index */
+    int isolb;          /* current backward solutions index */
+    char proc_rov [64]; /* rover for current processing */
+    char proc_base[64]; /* base station for current processing */
+    char rtcm_file[1024]; /* rtcm data file */
+    char rtcm_path[1024]; /* rtcm data path */
+    rtcm_t rtcm;        /* rtcm control struct */
+    FILE *fp_rtcm;      /* rtcm data file pointer */
+    char outsppfile[1024]; /* output file path (psu_res/psu_snr prefix) */
+    int solflag;        /* solution status (0:ok,1:no available satellite) */
+    int opengeoid;      /* geoid data opened by this session (0:no,1:yes) */
+    int opentrace;      /* debug trace opened by this session (0:no,1:yes) */
+    int openstat;       /* solution status opened by this session (0:no,1:yes) */
+    const postprod_t *prod; /* shared products (NULL: read by the session) */
+    int nthread;        /* number of threads for epoch-parallel spp (0,1:off) */
+    int obswin;         /* window of obs data stream (epochs) (0:read all obs) */
+    rnxobsr_t *rnxs;    /* obs file streams */
+    int nrnx;           /* number of obs file streams */
+    int iwin;           /* obs data index to refill window */
+    gtime_t tspan[2];   /* rover obs time span of streams {start,end} */
+} postctx_t;
+
 typedef void fatalfunc_t(const char *); /* fatal callback function type */
 
 /* global variables ----------------------------------------------------------*/
@@ -1498,6 +1649,8 @@ EXPORT void add_fatal(fatalfunc_t *func);
 
 /* time and string functions -------------------------------------------------*/
 EXPORT double  str2num(const char *s, int i, int n);
+EXPORT int     str2nums(const char *s, int i, int w, int n, double *val);
+EXPORT int     parsenum(const char *s, int n, double *val);
 EXPORT int     str2time(const char *s, int i, int n, gtime_t *t);
 EXPORT void    time2str(gtime_t t, char *str, int n);
 EXPORT gtime_t epoch2time(const double *ep);
@@ -1595,7 +1748,12 @@ EXPORT double tropmapf(gtime_t time, const double *pos, const double *azel,
                        double *mapfw);
 EXPORT int iontec(gtime_t time, const nav_t *nav, const double *pos,
                   const double *azel, int opt, double *delay, double *var);
+EXPORT int iontecn(gtime_t time, const nav_t *nav, const double *pos,
+                   const double *azel, int n, int opt, double *delay,
+                   double *var, int *stat);
 EXPORT void readtec(const char *file, nav_t *nav, int opt);
+EXPORT int writetec(const char *file, const tec_t *tec, int n, int opt,
+                    const char *comment);
 EXPORT int ionocorr(prcopt_t opt,gtime_t time, const nav_t *nav, int sat, const double *pos,const double *satpos,
                     const double *azel, int ionoopt, double *ion, double *var);
 EXPORT int tropcorr(gtime_t time, const nav_t *nav, const double *pos,
@@ -1646,11 +1804,28 @@ EXPORT int outrnxnavb (FILE *fp, const rnxopt_t *opt, const eph_t *eph);
 EXPORT int outrnxgnavb(FILE *fp, const rnxopt_t *opt, const geph_t *geph);
 EXPORT int outrnxhnavb(FILE *fp, const rnxopt_t *opt, const seph_t *seph);
 EXPORT int rtk_uncompress(const char *file, char *uncfile);
+EXPORT int rtk_uncompbuff(const char *file, size_t maxsize, char **buff,
+                          size_t *size);
+EXPORT FILE *open_uncfile(uncfile_t *unc, const char *file, size_t maxsize);
+EXPORT void close_uncfile(uncfile_t *unc);
+EXPORT void setrdcache(int ena);
+EXPORT int  getrdcache(void);
+EXPORT int  opencache (cache_t *cache, const char *file, const char *key);
+EXPORT void closecache(cache_t *cache);
+EXPORT int  writecache(const char *file, const char *key, const cacheblk_t *blk,
+                       int n);
+EXPORT const void *getcacheblk(const cacheblk_t *blk, int n, int id,
+                               size_t *size);
 EXPORT int convrnx(int format, rnxopt_t *opt, const char *file, char **ofile);
 EXPORT int  init_rnxctr (rnxctr_t *rnx);
 EXPORT void free_rnxctr (rnxctr_t *rnx);
 EXPORT int  open_rnxctr (rnxctr_t *rnx, FILE *fp);
 EXPORT int  input_rnxctr(rnxctr_t *rnx, FILE *fp);
+EXPORT int  open_rnxobsr (rnxobsr_t *rnx, const char *file, int rcv, gtime_t ts,
+                          gtime_t te, double tint, const char *opt, nav_t *nav,
+                          sta_t *sta);
+EXPORT int  input_rnxobsr(rnxobsr_t *rnx);
+EXPORT void close_rnxobsr(rnxobsr_t *rnx);
 
 /* ephemeris and clock functions ---------------------------------------------*/
 EXPORT double eph2clk (gtime_t time, const eph_t  *eph);
@@ -1658,12 +1833,19 @@ EXPORT double geph2clk(gtime_t time, const geph_t *geph);
 EXPORT double seph2clk(gtime_t time, const seph_t *seph);
 EXPORT void eph2pos (gtime_t time, const eph_t  *eph,  double *rs, double *dts,
                      double *var);
+EXPORT void compeph (const eph_t *eph, ephc_t *ec);
+EXPORT void eph2pos_batch(const gtime_t *time, const eph_t **eph,
+                          const ephc_t **ec, int n, double *rs, double *dts,
+                          double *var);
 EXPORT void geph2pos(gtime_t time, const geph_t *geph, double *rs, double *dts,
                      double *var);
 EXPORT void seph2pos(gtime_t time, const seph_t *seph, double *rs, double *dts,
                      double *var);
 EXPORT int  peph2pos(gtime_t time, int sat, const nav_t *nav, int opt,
                      double *rs, double *dts, double *var);
+EXPORT int  peph2pos_batch(const gtime_t *time, const int *sat, int n,
+                           const nav_t *nav, int opt, double *rs, double *dts,
+                           double *var, int *stat);
 EXPORT void satantoff(gtime_t time, const double *rs, int sat, const nav_t *nav,
                       double *dant);
 EXPORT int  satpos(gtime_t time, gtime_t teph, int sat, int ephopt,
@@ -1675,6 +1857,14 @@ extern void satposs(gtime_t teph, const obsd_t *obs, int n, const nav_t *nav,
 	const prcopt_t *opt, int ephopt, double *rs, double *dts, double *var, int *svh);
 
 EXPORT void satseleph(int sys, int sel);
+EXPORT int  fitcheb (gtime_t ts, gtime_t te, double tblk, const int *deg,
+                     double tol, const prcopt_t *opt, const nav_t *nav,
+                     cheb_t *cheb);
+EXPORT int  chebpos (gtime_t time, int sat, const cheb_t *cheb, double *rs,
+                     double *dts, double *var, int *svh);
+EXPORT int  readcheb (const char *file, cheb_t *cheb);
+EXPORT int  writecheb(const char *file, const cheb_t *cheb);
+EXPORT void freecheb (cheb_t *cheb);
 EXPORT void readsp3(const char *file, nav_t *nav, int opt);
 EXPORT int  readsap(const char *file, gtime_t time, nav_t *nav);
 EXPORT int  readdcb(const char *file, nav_t *nav, const sta_t *sta);
@@ -1897,6 +2087,15 @@ EXPORT int postpos(gtime_t ts, gtime_t te, double ti, double tu,
     const prcopt_t* popt, const solopt_t* sopt,
     const filopt_t* fopt, const char** infile, int n, const char* outfile,
     const char* rov, const char* base);
+EXPORT void init_postctx(postctx_t *ctx);
+EXPORT void free_postctx(postctx_t *ctx);
+EXPORT int  readpostprod(postprod_t *prod, const char **infile, int n,
+                         const prcopt_t *popt, const filopt_t *fopt);
+EXPORT void freepostprod(postprod_t *prod);
+EXPORT int postpos_ctx(postctx_t *ctx, gtime_t ts, gtime_t te, double ti,
+    double tu, const prcopt_t* popt, const solopt_t* sopt,
+    const filopt_t* fopt, const char** infile, int n, const char* outfile,
+    const char* rov, const char* base);
 
 /* stream server functions ---------------------------------------------------*/
 EXPORT void strsvrinit (strsvr_t *svr, int nout);
@@ -1961,6 +2160,17 @@ EXPORT int lexioncorr(gtime_t time, const nav_t *nav, const double *pos,
                       const double *azel, double *delay, double *var);
 extern double ionmodel_BDSK8(gtime_t t, const double *ion, const double *pos, const double *azel);
 extern double ionmodel_BDSK9(gtime_t t, const BDSSH *bdssh, const double *pos, const double *azel);
+extern int ionmodel_BDSK9n(gtime_t t, const BDSSH *bdssh, const double *pos,
+                           const double *rs, int stride, int n, double *ion);
+extern void *nequick_open(const char *modip, const char *ccirdir);
+extern void nequick_close(void *nq);
+extern int nequick_stec(void *nq, const double *ai, int month, double utc,
+                        const double *rpos, const double *spos, double *stec);
+extern int nequick_stecn(void *nq, const double *ai, int month, double utc,
+                         const double *rpos, const double *spos, int n,
+                         double *stec, int *stat);
+extern int nequick_setint(void *nq, double tolfact, int nint, double reuse);
+extern int nequick_setmode(void *nq, int mode);
 
 extern double ionmodel_BDSK9_2(gtime_t time, double* brdPara, const double *pos, const double *satxyz);
 
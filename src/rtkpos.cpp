@@ -1410,10 +1410,10 @@ static int ddres(rtk_t *rtk, const nav_t *nav, double dt, const double *x,
 static double intpres(gtime_t time, const obsd_t *obs, int n, const nav_t *nav,
                       rtk_t *rtk, double *y)
 {
-    static obsd_t obsb[MAXOBS];
-    static double yb[MAXOBS*NFREQ*2],rs[MAXOBS*6],dts[MAXOBS*2],var[MAXOBS];
-    static double e[MAXOBS*3],azel[MAXOBS*2];
-    static int nb=0,svh[MAXOBS*2];
+    static thread_local obsd_t obsb[MAXOBS];
+    static thread_local double yb[MAXOBS*NFREQ*2],rs[MAXOBS*6],dts[MAXOBS*2],var[MAXOBS];
+    static thread_local double e[MAXOBS*3],azel[MAXOBS*2];
+    static thread_local int nb=0,svh[MAXOBS*2];
     prcopt_t *opt=&rtk->opt;
     double tt=timediff(time,obs[0].time),ttb,*p,*q;
     int i,j,k,nf=NF(opt);
@@ -1211,7 +1211,7 @@ static int outenu(unsigned char *buff, const char *s, const sol_t *sol,
 /* output solution in the form of nmea RMC sentence --------------------------*/
 extern int outnmea_rmc(unsigned char *buff, const sol_t *sol)
 {
-    static double dirp=0.0;
+    static thread_local double dirp=0.0;
     gtime_t time;
     double ep[6],pos[3],enuv[3],dms1[3],dms2[3],vel,dir,amag=0.0;
     char* p = (char*)buff, * q, sum;
@@ -8,7 +8,6 @@
 
 static int edited = 0;
 static int IsWriteHeader = 0;
-static int IsWriteSNRHeader = 0;
 //sys,selectedfrq
 static int selectedfrqs[6][7] = { 0 };
 double *Az, *El, *Nadir, *AzInSa, *Mp[NFREQ + NEXOBS];
@@ -235,7 +234,7 @@ extern void outsatres_single(FILE *fpSat_p, rtk_t* rtk, obsd_t *obs, int n)
 	//rtk->opt.
 	//if(!IsOpen)fpSat=fopen("E:\\learnprogram\\ReBuild_RTKLIB\\option\\SatStatis.txt","w");
 
-	if (!IsWriteHeader)
+	if (ftell(fpSat_p) == 0) /* header once per file */
 	{
 		sprintf(line, "%23s", "%BDT            Obs_Time"); fputs(line, fpSat_p);
 		for (i = 0; i<6; i++)
@@ -246,8 +245,6 @@ extern void outsatres_single(FILE *fpSat_p, rtk_t* rtk, obsd_t *obs, int n)
 			fputs(line, fpSat_p);
 		}
 		fputs("\n", fpSat_p);
-		//rtk->opt.navsys
-		IsWriteHeader++;
 	}
 	time = rtk->sol.time;
 	if (rtk->tsys == TSYS_CMP){
@@ -312,7 +309,7 @@ extern void outsatsnr_single(FILE *fpSat_snr, rtk_t* rtk, obsd_t *obs, int n)
 	//	strcpy(line, outpath);
 	//	fpSat_snr = fopen(strcat(line, "psu_snr"), "w");
 	//}
-	if (!IsWriteSNRHeader)
+	if (ftell(fpSat_snr) == 0) /* header once per file */
 	{
 		sprintf(line, "%23s", "%BDT           Obs_Time"); fputs(line, fpSat_snr);
 		for (i = 0; i<6; i++)
@@ -323,8 +320,6 @@ extern void outsatsnr_single(FILE *fpSat_snr, rtk_t* rtk, obsd_t *obs, int n)
 			fputs(line, fpSat_snr);
 		}
 		fputs("\n", fpSat_snr);
-		//rtk->opt.navsys
-		IsWriteSNRHeader++;
 	}
 
 	time = rtk->sol.time;
@@ -0,0 +1,966 @@
+/*------------------------------------------------------------------------------
+* uncomp.cpp : uncompress gzip/compress/zip and hatanaka-compressed files
+*
+* references :
+*     [1] P.Deutsch, DEFLATE Compressed Data Format Specification version 1.3,
+*         RFC 1951, May 1996
+*     [2] P.Deutsch, GZIP file format specification version 4.3, RFC 1952,
+*         May 1996
+*     [3] Y.Hatanaka, A Compression Format and Tools for GNSS Observation
+*         Data, Bulletin of the Geospatial Information Authority of Japan, 55,
+*         21-30, 2008
+*     [4] PKWARE Inc., .ZIP File Format Specification version 6.3.9, 2020
+*
+* version : $Revision: 1.1 $ $Date: 2025/07/06 $
+* history : 2025/07/06 1.0  new (uncompress in memory instead of gzip and
+*                           crx2rnx commands)
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define POLYCRC32   0xEDB88320u /* CRC32 polynomial */
+#define MAXBITS     15          /* max bits of deflate huffman code */
+#define FASTBITS    10          /* bits of fast huffman decoding table */
+#define MAXLZWBITS  16          /* max bits of lzw code */
+#define CRX_MAXORD  9           /* max order of difference of crx data arc */
+#define CRX_MAXSAT  256         /* max number of satellites in crx epoch */
+#define CRX_MAXLINE 4096        /* max length of crx line */
+
+typedef struct {            /* output buffer type */
+    unsigned char *buff;    /* data */
+    size_t n,nmax;          /* size and allocated size of data (bytes) */
+    size_t limit;           /* size to stop uncompressing (0: no limit) */
+    int trunc;              /* data truncated by limit */
+} outbuf_t;
+
+typedef struct {            /* deflate input bit stream type */
+    const unsigned char *p,*end; /* read pointer and end of data */
+    unsigned long long bb;  /* bit buffer */
+    int bc;                 /* number of bits in bit buffer */
+    int err;                /* end of data error */
+} inbits_t;
+
+typedef struct {            /* huffman decoding table type */
+    unsigned short fast[1<<FASTBITS]; /* fast table (symbol|length<<9,0:slow) */
+    short count[MAXBITS+1]; /* number of codes of each length */
+    short symbol[288];      /* symbols ordered by code */
+} huff_t;
+
+typedef struct {            /* crx data arc type */
+    int ord;                /* current order of difference (-1: no data) */
+    int arc;                /* order of difference of arc */
+    long long u[CRX_MAXORD+1]; /* value and differences */
+} crxarc_t;
+
+typedef struct {            /* crx satellite data type */
+    char id[4];             /* satellite id */
+    crxarc_t d[MAXOBSTYPE]; /* data arcs of obs types */
+    char flag[MAXOBSTYPE*2+1]; /* lli and signal strength flags */
+} crxsat_t;
+
+/* length/distance base and extra bits of deflate (ref [1] 3.2.5) ------------*/
+static const short lbase[]={
+    3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,
+    195,227,258
+};
+static const short lext[]={
+    0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0
+};
+static const int dbase[]={
+    1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,
+    3073,4097,6145,8193,12289,16385,24577
+};
+static const short dext[]={
+    0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13
+};
+/* test limit of output buffer ---------------------------------------------*/
+static int limitbuff(outbuf_t *out)
+{
+    if (out->limit<=0||out->n<out->limit) return 0;
+    out->trunc=1;
+    return 1;
+}
+/* reserve output buffer -----------------------------------------------------*/
+static int reserve(outbuf_t *out, size_t n)
+{
+    unsigned char *p;
+    size_t nmax;
+
+    if (out->n+n<=out->nmax) return 1;
+    for (nmax=out->nmax<=0?65536:out->nmax*2;nmax<out->n+n;nmax*=2) ;
+    if (!(p=(unsigned char *)realloc(out->buff,nmax+1))) {
+        trace(1,"uncompress: memory allocation error n=%ld\n",(long)nmax);
+        return 0;
+    }
+    out->buff=p;
+    out->nmax=nmax;
+    return 1;
+}
+/* append data to output buffer ----------------------------------------------*/
+static int putbuff(outbuf_t *out, const void *data, size_t n)
+{
+    if (!reserve(out,n)) return 0;
+    memcpy(out->buff+out->n,data,n);
+    out->n+=n;
+    return 1;
+}
+/* crc32 of gzip/zip (ref [2]) -----------------------------------------------*/
+static unsigned int crc32z(const unsigned char *buff, size_t n)
+{
+    unsigned int crc=0xFFFFFFFFu,tbl[256],c;
+    int i,j;
+
+    for (i=0;i<256;i++) {
+        for (c=(unsigned int)i,j=0;j<8;j++) c=(c&1)?(c>>1)^POLYCRC32:c>>1;
+        tbl[i]=c;
+    }
+    while (n--) crc=tbl[(crc^*buff++)&0xFF]^(crc>>8);
+    return crc^0xFFFFFFFFu;
+}
+/* get bits of deflate stream (lsb first) ------------------------------------*/
+static int needbits(inbits_t *in, int n)
+{
+    while (in->bc<=56&&in->p<in->end) {
+        in->bb|=(unsigned long long)*in->p++<<in->bc;
+        in->bc+=8;
+    }
+    return in->bc>=n;
+}
+static unsigned int getbits(inbits_t *in, int n)
+{
+    unsigned int val;
+
+    if (n<=0) return 0;
+    if (in->bc<n&&!needbits(in,n)) {
+        in->bb=0; in->bc=0; in->err=1;
+        return 0;
+    }
+    val=(unsigned int)(in->bb&((1u<<n)-1));
+    in->bb>>=n;
+    in->bc-=n;
+    return val;
+}
+/* generate huffman decoding table (ref [1] 3.2.2) ---------------------------*/
+static int genhuff(huff_t *h, const unsigned char *len, int n)
+{
+    short offs[MAXBITS+1];
+    unsigned int code,next[MAXBITS+2],rev;
+    int i,j,left;
+
+    memset(h->count,0,sizeof(h->count));
+    memset(h->fast,0,sizeof(h->fast));
+    for (i=0;i<n;i++) h->count[len[i]]++;
+    if (h->count[0]==n) return 1; /* no codes */
+
+    for (i=1,left=1;i<=MAXBITS;i++) { /* over-subscribed */
+        left<<=1;
+        if ((left-=h->count[i])<0) return 0;
+    }
+    for (offs[1]=0,i=1;i<MAXBITS;i++) offs[i+1]=offs[i]+h->count[i];
+    for (i=0;i<n;i++) if (len[i]) h->symbol[offs[len[i]]++]=(short)i;
+
+    for (next[1]=0,i=1;i<=MAXBITS;i++) next[i+1]=(next[i]+h->count[i])<<1;
+    for (i=0;i<n;i++) {
+        if (!len[i]) continue;
+        code=next[len[i]]++;
+        if (len[i]>FASTBITS) continue;
+        for (rev=0,j=0;j<len[i];j++) rev|=((code>>j)&1)<<(len[i]-1-j);
+        for (j=(int)rev;j<(1<<FASTBITS);j+=1<<len[i]) {
+            h->fast[j]=(unsigned short)(i|(len[i]<<9));
+        }
+    }
+    return 1;
+}
+/* decode huffman code -------------------------------------------------------*/
+static int decode(inbits_t *in, const huff_t *h)
+{
+    int len,code=0,first=0,index=0,count;
+    unsigned int e;
+
+    if (in->bc<MAXBITS) needbits(in,MAXBITS);
+
+    if ((e=h->fast[in->bb&((1<<FASTBITS)-1)])&&(int)(e>>9)<=in->bc) {
+        in->bb>>=e>>9;
+        in->bc-=e>>9;
+        return (int)(e&0x1FF);
+    }
+    /* canonical decoding bit by bit for long codes */
+    for (len=1;len<=MAXBITS&&in->bc>0;len++) {
+        code|=(int)(in->bb&1);
+        in->bb>>=1; in->bc--;
+        count=h->count[len];
+        if (code-count<first) return h->symbol[index+(code-first)];
+        index+=count;
+        first+=count;
+        first<<=1;
+        code<<=1;
+    }
+    return -1;
+}
+/* inflate huffman-coded block -----------------------------------------------*/
+static int inflate_codes(inbits_t *in, const huff_t *hl, const huff_t *hd,
+                         outbuf_t *out)
+{
+    size_t dist,len;
+    unsigned char *p,*q;
+    int sym;
+
+    for (;;) {
+        if ((sym=decode(in,hl))<0) return 0;
+
+        if (sym<256) { /* literal */
+            if (out->n>=out->nmax&&!reserve(out,1)) return 0;
+            out->buff[out->n++]=(unsigned char)sym;
+            continue;
+        }
+        if (sym==256||limitbuff(out)) return 1; /* end of block or limit */
+        if ((sym-=257)>=29) return 0;
+        len=lbase[sym]+getbits(in,lext[sym]);
+        if ((sym=decode(in,hd))<0||sym>=30) return 0;
+        dist=dbase[sym]+getbits(in,dext[sym]);
+        if (in->err||dist>out->n||!reserve(out,len)) return 0;
+
+        /* copy may overlap output */
+        p=out->buff+out->n; q=p-dist;
+        out->n+=len;
+        while (len--) *p++=*q++;
+    }
+}
+/* inflate stored block ------------------------------------------------------*/
+static int inflate_stored(inbits_t *in, outbuf_t *out)
+{
+    size_t len;
+
+    /* return whole bytes in bit buffer to input */
+    in->p-=in->bc/8;
+    in->bb=0; in->bc=0;
+
+    if (in->end-in->p<4) return 0;
+    len=in->p[0]|(in->p[1]<<8);
+    if ((len^(in->p[2]|(in->p[3]<<8)))!=0xFFFF) return 0;
+    in->p+=4;
+    if ((size_t)(in->end-in->p)<len) return 0;
+    if (!putbuff(out,in->p,len)) return 0;
+    in->p+=len;
+    return 1;
+}
+/* inflate fixed huffman block -----------------------------------------------*/
+static int inflate_fixed(inbits_t *in, outbuf_t *out, huff_t *hl, huff_t *hd)
+{
+    unsigned char len[288];
+    int i;
+
+    for (i=0;i<144;i++) len[i]=8;
+    for (;i<256;i++) len[i]=9;
+    for (;i<280;i++) len[i]=7;
+    for (;i<288;i++) len[i]=8;
+    genhuff(hl,len,288);
+    for (i=0;i<30;i++) len[i]=5;
+    genhuff(hd,len,30);
+    return inflate_codes(in,hl,hd,out);
+}
+/* inflate dynamic huffman block (ref [1] 3.2.7) -----------------------------*/
+static int inflate_dynamic(inbits_t *in, outbuf_t *out, huff_t *hl, huff_t *hd)
+{
+    static const unsigned char order[19]={
+        16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15
+    };
+    unsigned char len[320]={0};
+    int i,nlen,ndist,ncode,sym,prev,rep;
+
+    if (!needbits(in,14)) return 0;
+    nlen =getbits(in,5)+257;
+    ndist=getbits(in,5)+1;
+    ncode=getbits(in,4)+4;
+    if (nlen>286||ndist>30) return 0;
+
+    for (i=0;i<ncode;i++) {
+        if (!needbits(in,3)) return 0;
+        len[order[i]]=(unsigned char)getbits(in,3);
+    }
+    if (!genhuff(hl,len,19)) return 0;
+
+    for (i=0;i<nlen+ndist;) {
+        if ((sym=decode(in,hl))<0) return 0;
+        if (sym<16) {
+            len[i++]=(unsigned char)sym;
+            continue;
+        }
+        if (!needbits(in,7)) return 0;
+        if (sym==16) {
+            if (i==0) return 0;
+            prev=len[i-1];
+            rep=3+getbits(in,2);
+        }
+        else {
+            prev=0;
+            rep=sym==17?3+getbits(in,3):11+getbits(in,7);
+        }
+        if (i+rep>nlen+ndist) return 0;
+        while (rep--) len[i++]=(unsigned char)prev;
+    }
+    if (!len[256]) return 0; /* no end of block code */
+
+    if (!genhuff(hl,len,nlen)||!genhuff(hd,len+nlen,ndist)) return 0;
+    return inflate_codes(in,hl,hd,out);
+}
+/* inflate deflate stream ------------------------------------------------------
+* inflate deflate stream and append data to output buffer (ref [1])
+* args   : unsigned char *buff I deflate stream
+*          size_t n         I   size of deflate stream (bytes)
+*          outbuf_t *out    IO  output buffer
+* return : size of deflate stream used (bytes) (0: error)
+*-----------------------------------------------------------------------------*/
+static size_t inflate(const unsigned char *buff, size_t n, outbuf_t *out)
+{
+    inbits_t in;
+    huff_t *hl,*hd;
+    int last,type,stat=1;
+
+    if (!(hl=(huff_t *)malloc(sizeof(huff_t)*2))) return 0;
+    hd=hl+1;
+
+    in.p=buff; in.end=buff+n; in.bb=0; in.bc=0; in.err=0;
+
+    do {
+        if (!needbits(&in,3)) {stat=0; break;}
+        last=getbits(&in,1);
+        type=getbits(&in,2);
+
+        switch (type) {
+            case 0 : stat=inflate_stored(&in,out);         break;
+            case 1 : stat=inflate_fixed  (&in,out,hl,hd);  break;
+            case 2 : stat=inflate_dynamic(&in,out,hl,hd);  break;
+            default: stat=0;
+        }
+    } while (stat&&!last&&!in.err&&!limitbuff(out));
+
+    free(hl);
+
+    if (!stat||in.err) {
+        trace(2,"inflate: invalid deflate stream n=%ld\n",(long)(in.p-buff));
+        return 0;
+    }
+    return (size_t)(in.p-buff)-in.bc/8;
+}
+/* uncompress gzip file (ref [2]) --------------------------------------------*/
+static int ungzip(const unsigned char *buff, size_t n, outbuf_t *out)
+{
+    const unsigned char *p=buff,*end=buff+n;
+    size_t m,n0;
+    unsigned int crc,size;
+    int flag;
+
+    /* concatenated members */
+    while (end-p>=18&&p[0]==0x1F&&p[1]==0x8B) {
+        if (p[2]!=8) {
+            trace(2,"gzip: unsupported method %d\n",p[2]);
+            return 0;
+        }
+        flag=p[3];
+        p+=10;
+        if (flag&0x04) { /* FEXTRA */
+            if (end-p<2) return 0;
+            p+=2+(p[0]|(p[1]<<8));
+        }
+        if (flag&0x08) { /* FNAME */
+            while (p<end&&*p) p++;
+            p++;
+        }
+        if (flag&0x10) { /* FCOMMENT */
+            while (p<end&&*p) p++;
+            p++;
+        }
+        if (flag&0x02) p+=2; /* FHCRC */
+        if (p>=end) return 0;
+
+        n0=out->n;
+        if (!(m=inflate(p,end-p,out))) return 0;
+        if (out->trunc) break;
+        if (end-(p+=m)<8) return 0;
+
+        crc =p[0]|(p[1]<<8)|(p[2]<<16)|((unsigned int)p[3]<<24);
+        size=p[4]|(p[5]<<8)|(p[6]<<16)|((unsigned int)p[7]<<24);
+        p+=8;
+
+        if (crc32z(out->buff+n0,out->n-n0)!=crc||
+            (unsigned int)(out->n-n0)!=size) {
+            trace(2,"gzip: crc or size error\n");
+            return 0;
+        }
+    }
+    return 1;
+}
+/* uncompress zip file (first entry) (ref [4]) -------------------------------*/
+static int unzip(const unsigned char *buff, size_t n, outbuf_t *out)
+{
+    size_t off,csize,usize;
+    unsigned int crc;
+    int flag,method;
+
+    if (n<30) return 0;
+    flag  =buff[6]|(buff[7]<<8);
+    method=buff[8]|(buff[9]<<8);
+    crc   =buff[14]|(buff[15]<<8)|(buff[16]<<16)|((unsigned int)buff[17]<<24);
+    csize =buff[18]|(buff[19]<<8)|(buff[20]<<16)|((size_t)buff[21]<<24);
+    usize =buff[22]|(buff[23]<<8)|(buff[24]<<16)|((size_t)buff[25]<<24);
+    off=30+(buff[26]|(buff[27]<<8))+(buff[28]|(buff[29]<<8));
+
+    if (off>n||(flag&0x01)) {
+        trace(2,"zip: invalid or encrypted entry\n");
+        return 0;
+    }
+    if (method==0) {
+        if ((flag&0x08)||csize>n-off) return 0;
+        if (out->limit>0&&csize>out->limit) { /* stop at limit as inflate() */
+            out->trunc=1;
+            return putbuff(out,buff+off,out->limit);
+        }
+        if (!putbuff(out,buff+off,csize)) return 0;
+    }
+    else if (method==8) {
+        if (!inflate(buff+off,n-off,out)) return 0;
+        if (out->trunc) return 1;
+    }
+    else {
+        trace(2,"zip: unsupported method %d\n",method);
+        return 0;
+    }
+    /* crc and sizes follow data if flag bit 3 set */
+    if (!(flag&0x08)&&(crc32z(out->buff,out->n)!=crc||out->n!=usize)) {
+        trace(2,"zip: crc or size error\n");
+        return 0;
+    }
+    return 1;
+}
+/* uncompress unix compress (lzw) file -----------------------------------------
+* codes are packed in groups of 8 codes. the rest of group is skipped when code
+* length increases or clear code appears as compress command does.
+*-----------------------------------------------------------------------------*/
+static int unlzw(const unsigned char *buff, size_t n, outbuf_t *out)
+{
+    unsigned short *prefix;
+    unsigned char *suffix,*stack,*sp,fin=0;
+    size_t pos,base,nbits_all;
+    int maxbits,block,nbits=9,code,incode,oldcode=-1,maxcode,maxmax,free_ent,g;
+
+    if (n<3) return 0;
+    maxbits=buff[2]&0x1F;
+    block=buff[2]&0x80;
+    if (maxbits<9||maxbits>MAXLZWBITS) {
+        trace(2,"lzw: unsupported max bits %d\n",maxbits);
+        return 0;
+    }
+    maxmax=1<<maxbits;
+    if (!(prefix=(unsigned short *)malloc(sizeof(short)*maxmax))||
+        !(suffix=(unsigned char *)malloc(maxmax*2))) {
+        free(prefix);
+        return 0;
+    }
+    stack=suffix+maxmax;
+    for (code=0;code<256;code++) {prefix[code]=0; suffix[code]=(unsigned char)code;}
+
+    free_ent=block?257:256;
+    maxcode=(1<<nbits)-1;
+    pos=base=0; buff+=3; nbits_all=(n-3)*8;
+
+    while (pos+nbits<=nbits_all) {
+
+        if (free_ent>maxcode) { /* code length increases */
+            g=nbits*8;
+            pos=base+(pos-base+g-1)/g*g;
+            base=pos;
+            nbits++;
+            maxcode=nbits==maxbits?maxmax:(1<<nbits)-1;
+            continue;
+        }
+        code=(int)((buff[pos>>3]|(pos/8+1<n-3?buff[(pos>>3)+1]<<8:0)|
+                    (pos/8+2<n-3?buff[(pos>>3)+2]<<16:0))>>(pos&7))&((1<<nbits)-1);
+        pos+=nbits;
+
+        if (oldcode==-1) {
+            if (code>=256) break;
+            fin=(unsigned char)(oldcode=code);
+            if (!putbuff(out,&fin,1)) break;
+            continue;
+        }
+        if (code==256&&block) { /* clear */
+            free_ent=256;
+            g=nbits*8;
+            pos=base+(pos-base+g-1)/g*g;
+            base=pos;
+            nbits=9;
+            maxcode=(1<<nbits)-1;
+            continue;
+        }
+        incode=code;
+        sp=stack+maxmax;
+
+        if (code>=free_ent) { /* KwKwK */
+            if (code>free_ent) break;
+            *--sp=fin;
+            code=oldcode;
+        }
+        while (code>=256) {
+            *--sp=suffix[code];
+            code=prefix[code];
+        }
+        *--sp=fin=suffix[code];
+        if (!putbuff(out,sp,stack+maxmax-sp)||limitbuff(out)) break;
+
+        if (free_ent<maxmax) {
+            prefix[free_ent]=(unsigned short)oldcode;
+            suffix[free_ent]=fin;
+            free_ent++;
+        }
+        oldcode=incode;
+    }
+    free(prefix); free(suffix);
+
+    if (!out->trunc&&pos+nbits<=nbits_all) {
+        trace(2,"lzw: invalid code\n");
+        return 0;
+    }
+    return 1;
+}
+/* next line of text ---------------------------------------------------------*/
+static int nextline(const char **p, const char *end, char *line)
+{
+    const char *q;
+    int len;
+
+    if (*p>=end) return -1;
+    if (!(q=(const char *)memchr(*p,'\n',end-*p))) q=end;
+    len=(int)(q-*p);
+    if (len>0&&(*p)[len-1]=='\r') len--;
+    if (len>=CRX_MAXLINE) {
+        trace(2,"crx: too long line\n");
+        return -1;
+    }
+    memcpy(line,*p,len);
+    line[len]='\0';
+    *p=q<end?q+1:end;
+    return len;
+}
+/* repair text by difference (' ':unchanged,'&':space) (ref [3]) -------------*/
+static void repair(char *s, const char *ds)
+{
+    for (;*s&&*ds;s++,ds++) {
+        if (*ds!=' ') *s=*ds=='&'?' ':*ds;
+    }
+    if (!*ds) return;
+    for (;*ds;s++,ds++) *s=*ds=='&'?' ':*ds;
+    *s='\0';
+}
+/* decode crx difference ("k&value": initialize arc, "value": difference) ----*/
+static int decode_diff(const char **p, const crxarc_t *prev, crxarc_t *arc)
+{
+    const char *q=*p;
+    long long val=0;
+    int i,sign=1,init=-1;
+
+    if (*q>='0'&&*q<='9'&&q[1]=='&') {
+        init=*q-'0';
+        q+=2;
+    }
+    if (*q=='-') {sign=-1; q++;}
+    if (*q<'0'||*q>'9') return 0;
+    for (;*q>='0'&&*q<='9';q++) val=val*10+(*q-'0');
+    if (*q&&*q!=' ') return 0;
+    *p=*q?q+1:q;
+    val*=sign;
+
+    if (init>=0) {
+        arc->arc=init;
+        arc->ord=0;
+        arc->u[0]=val;
+        return 1;
+    }
+    if (!prev||prev->ord<0) {
+        trace(2,"crx: arc not initialized\n");
+        return 0;
+    }
+    arc->arc=prev->arc;
+    arc->ord=prev->ord<prev->arc?prev->ord+1:prev->arc;
+    arc->u[arc->ord]=val;
+    for (i=arc->ord;i>0;i--) arc->u[i-1]=prev->u[i-1]+arc->u[i];
+    return 1;
+}
+/* print fixed-point number as printf("%w.df") ------------------------------*/
+static int printfix(char *s, long long val, int w, int d)
+{
+    char buff[48];
+    long long a=val<0?-val:val,scale=1;
+    int i;
+
+    for (i=0;i<d;i++) scale*=10;
+    sprintf(buff,"%s%lld.%0*lld",val<0?"-":"",a/scale,d,a%scale);
+    return sprintf(s,"%*s",w,buff);
+}
+/* output obs data fields of satellite ---------------------------------------*/
+static int outcrxobs(outbuf_t *out, const crxsat_t *sat, int ntype, int ver)
+{
+    char buff[MAXOBSTYPE*16+16],*p=buff,*q;
+    int i,n=(int)strlen(sat->flag);
+
+    if (ver>=3) p+=sprintf(p,"%.3s",sat->id);
+
+    for (i=0;i<ntype;i++) {
+        if (sat->d[i].ord>=0) p+=printfix(p,sat->d[i].u[0],14,3);
+        else p+=sprintf(p,"%14s","");
+        *p++=2*i  <n?sat->flag[2*i  ]:' ';
+        *p++=2*i+1<n?sat->flag[2*i+1]:' ';
+
+        /* 5 obs per line for ver.2 */
+        if ((ver<3&&i%5==4)||i==ntype-1) {
+            for (q=p;q>buff&&q[-1]==' ';q--) ;
+            *q++='\n';
+            if (!putbuff(out,buff,q-buff)) return 0;
+            p=buff;
+        }
+    }
+    if (ntype<=0&&ver>=3) { /* no obs types */
+        *p++='\n';
+        if (!putbuff(out,buff,p-buff)) return 0;
+    }
+    return 1;
+}
+/* output epoch record of crx ------------------------------------------------*/
+static int outcrxepoch(outbuf_t *out, const char *ep, int ver, int nsat,
+                       int clk, long long clkval)
+{
+    char buff[CRX_MAXLINE+64],*p=buff;
+    int i,n=(int)strlen(ep);
+
+    if (ver>=3) { /* "> yyyy mm dd hh mm ss.sssssss  f nnn" + clock */
+        p+=sprintf(p,"%-35.35s",ep);
+        if (clk) {
+            p+=sprintf(p,"%6s","");
+            p+=printfix(p,clkval,15,12);
+        }
+    }
+    else { /* " yy mm dd hh mm ss.sssssss  f nn" + 12 sats/line + clock */
+        p+=sprintf(p,"%-32.32s",ep);
+        for (i=0;i<nsat;i++) {
+            if (i>0&&i%12==0) {
+                if (i==12&&clk) {
+                    p+=sprintf(p,"%*s",(int)(buff+68-p),"");
+                    p+=printfix(p,clkval,12,9);
+                }
+                p+=sprintf(p,"\n%32s","");
+            }
+            p+=sprintf(p,"%-3.3s",32+i*3<n?ep+32+i*3:"");
+        }
+        if (nsat<=12&&clk) {
+            p+=sprintf(p,"%*s",(int)(buff+68-p),"");
+            p+=printfix(p,clkval,12,9);
+        }
+    }
+    *p++='\n';
+    return putbuff(out,buff,p-buff);
+}
+/* get number of obs types from rinex header ---------------------------------*/
+static void crxobstype(const char *line, int ver, int *ntype)
+{
+    const char *label=line+60;
+
+    if (strlen(line)<61) return;
+
+    if (ver<3&&strstr(label,"# / TYPES OF OBSERV")) {
+        if (line[5]!=' ') ntype[0]=atoi(line); /* except continuation */
+    }
+    else if (ver>=3&&strstr(label,"SYS / # / OBS TYPES")) {
+        if (line[0]!=' ') ntype[(unsigned char)line[0]]=atoi(line+3);
+    }
+}
+/* uncompact hatanaka-compressed rinex obs (crx ver.1.0/3.0) (ref [3]) -------*/
+static int uncrx(const char *buff, size_t n, outbuf_t *out)
+{
+    const char *p=buff,*end=buff+n,*q;
+    crxsat_t *sats,*prev,*cur,*s0;
+    crxarc_t clk[2]={{-1},{-1}},*cp,*cc;
+    char *line,*ep,*ep0;
+    int i,j,k,ver,len,nsat,nprev=0,flag,ntype[256]={0},nt,stat=0,noinit=1;
+    int fpos,npos,spos;
+
+    if (!(line=(char *)malloc(CRX_MAXLINE*3))) return 0;
+    ep=line+CRX_MAXLINE; ep0=ep+CRX_MAXLINE; *ep='\0';
+
+    if (!(sats=(crxsat_t *)malloc(sizeof(crxsat_t)*CRX_MAXSAT*2))) {
+        free(line);
+        return 0;
+    }
+    prev=sats; cur=sats+CRX_MAXSAT;
+
+    /* crx header: "CRINEX VERS / TYPE" and "CRINEX PROG / DATE" */
+    if (nextline(&p,end,line)<61||!strstr(line+60,"CRINEX VERS")||
+        nextline(&p,end,line)<0) {
+        trace(2,"crx: invalid header\n");
+        goto exit;
+    }
+    ver=atof(buff)>=3.0?3:1;
+    fpos=ver>=3?31:28; /* position of epoch flag */
+    npos=ver>=3?32:29; /* position of number of satellites */
+    spos=ver>=3?41:32; /* position of satellite list */
+
+    /* rinex header */
+    while ((len=nextline(&p,end,line))>=0) {
+        line[len]='\n';
+        if (!putbuff(out,line,len+1)) goto exit;
+        line[len]='\0';
+        crxobstype(line,ver,ntype);
+        if (len>=60&&strstr(line+60,"END OF HEADER")) break;
+    }
+    if (len<0) goto exit;
+
+    /* data body */
+    while (!limitbuff(out)&&(len=nextline(&p,end,line))>=0) {
+
+        /* epoch record ('&' or '>' at top: initialized) */
+        if (*line==(ver>=3?'>':'&')) {
+            strcpy(ep0,line);
+            if (ver<3) *ep0=' ';
+            nprev=0; noinit=0;
+        }
+        else if (noinit) {
+            trace(2,"crx: epoch not initialized\n");
+            goto exit;
+        }
+        else {
+            strcpy(ep0,ep);
+            repair(ep0,line);
+        }
+        if ((int)strlen(ep0)<npos+3) {
+            trace(2,"crx: invalid epoch line: %s\n",ep0);
+            goto exit;
+        }
+        flag=ep0[fpos];
+        nsat=(int)str2num(ep0,npos,3);
+        strcpy(ep,ep0);
+
+        /* event flag 2-5: epoch line and following records as is */
+        if (flag>='2'&&flag<='5') {
+            for (q=ep+strlen(ep);q>ep&&q[-1]==' ';q--) ;
+            if (!putbuff(out,ep,q-ep)||!putbuff(out,"\n",1)) goto exit;
+            for (i=0;i<nsat&&(len=nextline(&p,end,line))>=0;i++) {
+                line[len]='\n';
+                if (!putbuff(out,line,len+1)) goto exit;
+                line[len]='\0';
+                crxobstype(line,ver,ntype);
+            }
+            continue;
+        }
+        if (nsat<0||nsat>CRX_MAXSAT||(int)strlen(ep)<spos+3*nsat) {
+            trace(2,"crx: invalid satellite list: %s\n",ep);
+            goto exit;
+        }
+        /* receiver clock offset */
+        if (nextline(&p,end,line)<0) goto exit;
+        cp=clk; cc=clk+1; q=line;
+        if (!*line) cc->ord=-1;
+        else if (!decode_diff(&q,cp->ord>=0?cp:NULL,cc)) goto exit;
+        clk[0]=clk[1];
+
+        if (!outcrxepoch(out,ep,ver,nsat,cc->ord>=0,cc->u[0])) goto exit;
+
+        /* obs data of satellites */
+        for (i=0;i<nsat;i++) {
+            if (nextline(&p,end,line)<0) goto exit;
+
+            sprintf(cur[i].id,"%-3.3s",ep+spos+3*i);
+            nt=ntype[ver>=3?(unsigned char)cur[i].id[0]:0];
+            if (nt>MAXOBSTYPE) goto exit;
+
+            /* same satellite in previous epoch */
+            s0=i<nprev&&!strcmp(prev[i].id,cur[i].id)?prev+i:NULL;
+            for (k=0;!s0&&k<nprev;k++) {
+                if (!strcmp(prev[k].id,cur[i].id)) s0=prev+k;
+            }
+            for (j=0,q=line;j<nt;j++) {
+                if (!*q||*q==' ') { /* blank field */
+                    cur[i].d[j].ord=-1;
+                    if (*q) q++;
+                }
+                else if (!decode_diff(&q,s0?s0->d+j:NULL,cur[i].d+j)) {
+                    trace(2,"crx: invalid data sat=%s\n",cur[i].id);
+                    goto exit;
+                }
+            }
+            strcpy(cur[i].flag,s0?s0->flag:"");
+            if ((int)strlen(q)>MAXOBSTYPE*2) goto exit;
+            repair(cur[i].flag,q);
+
+            if (!outcrxobs(out,cur+i,nt,ver)) goto exit;
+        }
+        s0=prev; prev=cur; cur=s0;
+        nprev=nsat;
+    }
+    stat=1;
+exit:
+    free(line); free(sats);
+    return stat;
+}
+/* read whole file -----------------------------------------------------------*/
+static int readfile(const char *file, outbuf_t *buff)
+{
+    FILE *fp;
+    long size;
+
+    if (!(fp=fopen(file,"rb"))) {
+        trace(2,"file open error: %s\n",file);
+        return 0;
+    }
+    if (fseek(fp,0,SEEK_END)||(size=ftell(fp))<0||fseek(fp,0,SEEK_SET)||
+        !reserve(buff,(size_t)size)||
+        fread(buff->buff,1,(size_t)size,fp)!=(size_t)size) {
+        fclose(fp);
+        return 0;
+    }
+    buff->n=(size_t)size;
+    fclose(fp);
+    return 1;
+}
+/* uncompress file to memory ---------------------------------------------------
+* uncompress gzip (.gz,.z,.Z,.zip) and/or hatanaka-compressed (.crx,.??d) file
+* to memory without external commands
+* args   : char   *file     I   input file
+*          size_t maxsize   I   size to stop uncompressing (bytes) (0: all)
+*          char   **buff    O   uncompressed data (null-terminated)
+*          size_t *size     O   size of uncompressed data (bytes)
+* return : status (-1:error,0:not compressed file,1:uncompress completed)
+* notes  : free *buff by free() if the status is 1
+*          gzip or zip is detected by the magic number and unix compress file
+*          (.Z) is also uncompressed as gzip command does
+*          tar file is not supported
+*          with maxsize>0, uncompressing stops at a line boundary after maxsize
+*          bytes to read only the header. the last epoch may be incomplete.
+*-----------------------------------------------------------------------------*/
+extern int rtk_uncompbuff(const char *file, size_t maxsize, char **buff,
+                          size_t *size)
+{
+    outbuf_t in={0},out={0},tmp;
+    char name[1024],*p;
+    int stat=0,zip=0,crx=0,trunc=0;
+
+    trace(3,"rtk_uncompbuff: file=%s maxsize=%ld\n",file,(long)maxsize);
+
+    sprintf(name,"%.1023s",file);
+    if (!(p=strrchr(name,'.'))||strrchr(name,FILEPATHSEP)>p) return 0;
+
+    if (!strcmp(p,".z"  )||!strcmp(p,".Z"  )||!strcmp(p,".gz" )||
+        !strcmp(p,".GZ" )||!strcmp(p,".zip")||!strcmp(p,".ZIP")) {
+        zip=1;
+        *p='\0';
+        if (!(p=strrchr(name,'.'))||strrchr(name,FILEPATHSEP)>p) p=name+strlen(name);
+    }
+    if (!strcmp(p,".crx")||!strcmp(p,".CRX")||
+        (strlen(p)==4&&(p[3]=='d'||p[3]=='D'))) {
+        crx=1;
+    }
+    if (!zip&&!crx) return 0;
+
+    if (!readfile(file,&in)) {
+        free(in.buff);
+        return -1;
+    }
+    out.limit=maxsize;
+
+    if (zip) {
+        if (in.n>=2&&in.buff[0]==0x1F&&in.buff[1]==0x8B) {
+            stat=ungzip(in.buff,in.n,&out);
+        }
+        else if (in.n>=2&&in.buff[0]==0x1F&&in.buff[1]==0x9D) {
+            stat=unlzw(in.buff,in.n,&out);
+        }
+        else if (in.n>=4&&!memcmp(in.buff,"PK\x03\x04",4)) {
+            stat=unzip(in.buff,in.n,&out);
+        }
+        else trace(2,"unknown compressed file: %s\n",file);
+
+        tmp=in; in=out; out=tmp; out.n=0;
+        if (!stat) goto exit;
+
+        /* cut incomplete line at end of truncated data */
+        if ((trunc=in.trunc)!=0) {
+            while (in.n>0&&in.buff[in.n-1]!='\n') in.n--;
+        }
+        out.limit=maxsize; out.trunc=0;
+    }
+    /* hatanaka-compressed file starts with "CRINEX VERS / TYPE" */
+    if (crx&&in.n>=80&&!strncmp((char *)in.buff+60,"CRINEX VERS",11)) {
+        stat=uncrx((char *)in.buff,in.n,&out);
+
+        /* truncated input may end in epoch record */
+        if (!stat&&(!trunc||out.n<=0)) goto exit;
+        tmp=in; in=out; out=tmp;
+    }
+    else if (!zip) { /* not compressed */
+        free(in.buff);
+        return 0;
+    }
+    if (!reserve(&in,1)) {stat=0; goto exit;}
+    in.buff[in.n]='\0';
+    *buff=(char *)in.buff;
+    *size=in.n;
+    free(out.buff);
+    trace(3,"rtk_uncompbuff: size=%ld\n",(long)*size);
+    return 1;
+exit:
+    trace(2,"uncompress error: %s\n",file);
+    free(in.buff); free(out.buff);
+    return -1;
+}
+/* open uncompressed file ------------------------------------------------------
+* open file to read with uncompressing it in memory if compressed
+* args   : uncfile_t *unc   O   uncompressed file
+*          char   *file     I   file path
+*          size_t maxsize   I   size to stop uncompressing (bytes) (0: all)
+* return : file pointer (NULL: error)
+* notes  : uncompressed data are read through the file pointer from memory
+*          (temporary file by tmpfile() for WIN32). close the file by
+*          close_uncfile().
+*-----------------------------------------------------------------------------*/
+extern FILE *open_uncfile(uncfile_t *unc, const char *file, size_t maxsize)
+{
+    int stat;
+
+    trace(3,"open_uncfile: file=%s\n",file);
+
+    unc->fp=NULL; unc->buff=NULL; unc->size=0;
+
+    if ((stat=rtk_uncompbuff(file,maxsize,&unc->buff,&unc->size))<0) {
+        return NULL;
+    }
+    if (stat==0) {
+        if (!(unc->fp=fopen(file,"r"))) {
+            trace(2,"file open error: %s\n",file);
+        }
+        return unc->fp;
+    }
+#ifdef WIN32
+    if ((unc->fp=tmpfile())&&
+        (fwrite(unc->buff,1,unc->size,unc->fp)!=unc->size||
+         fseek(unc->fp,0,SEEK_SET))) {
+        fclose(unc->fp);
+        unc->fp=NULL;
+    }
+#else
+    unc->fp=fmemopen(unc->buff,unc->size>0?unc->size:1,"r");
+#endif
+    if (!unc->fp) {
+        trace(2,"uncompressed file open error: %s\n",file);
+        free(unc->buff);
+        unc->buff=NULL;
+    }
+    return unc->fp;
+}
+/* close uncompressed file -----------------------------------------------------
+* close file opened by open_uncfile() and free uncompressed data
+* args   : uncfile_t *unc   IO  uncompressed file
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void close_uncfile(uncfile_t *unc)
+{
+    if (unc->fp) fclose(unc->fp);
+    free(unc->buff);
+    unc->fp=NULL; unc->buff=NULL; unc->size=0;
+}